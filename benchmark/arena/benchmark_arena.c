@@ -0,0 +1,131 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define N_SCRATCH 256
+#define N_NODE 256
+
+static uint64_t elapsed_ns(struct timespec *start, struct timespec *end)
+{
+	return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000 +
+		(uint64_t)end->tv_nsec - (uint64_t)start->tv_nsec;
+}
+
+static int cmp_int(const void *d1, const void *d2)
+{
+	intptr_t a = (intptr_t)d1;
+	intptr_t b = (intptr_t)d2;
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+/**
+ * @brief per request scratch allocations with mixed sizes, then release
+ * all of them
+ */
+static void benchmark_scratch(int n_request)
+{
+	void *ptrs[N_SCRATCH];
+	struct timespec start, end;
+
+	muggle_realtime_get(start);
+	for (int r = 0; r < n_request; r++)
+	{
+		for (int i = 0; i < N_SCRATCH; i++)
+		{
+			size_t n = 16 + (size_t)((i * 37) % 240);
+			ptrs[i] = malloc(n);
+			memset(ptrs[i], 0, 16);
+		}
+		for (int i = 0; i < N_SCRATCH; i++)
+		{
+			free(ptrs[i]);
+		}
+	}
+	muggle_realtime_get(end);
+	MUGGLE_LOG_INFO("scratch malloc: %.1f ns/alloc",
+		(double)elapsed_ns(&start, &end) / ((uint64_t)n_request * N_SCRATCH));
+
+	muggle_arena_t arena;
+	muggle_arena_init(&arena, 0);
+	muggle_realtime_get(start);
+	for (int r = 0; r < n_request; r++)
+	{
+		for (int i = 0; i < N_SCRATCH; i++)
+		{
+			size_t n = 16 + (size_t)((i * 37) % 240);
+			ptrs[i] = muggle_arena_alloc(&arena, n);
+			memset(ptrs[i], 0, 16);
+		}
+		muggle_arena_reset(&arena);
+	}
+	muggle_realtime_get(end);
+	muggle_arena_destroy(&arena);
+	MUGGLE_LOG_INFO("scratch arena: %.1f ns/alloc",
+		(double)elapsed_ns(&start, &end) / ((uint64_t)n_request * N_SCRATCH));
+}
+
+/**
+ * @brief per request avl tree, build it and drop it
+ */
+static void benchmark_avl_tree(const char *name, int n_request, size_t capacity, muggle_arena_t *arena)
+{
+	struct timespec start, end;
+
+	muggle_realtime_get(start);
+	for (int r = 0; r < n_request; r++)
+	{
+		muggle_avl_tree_t tree;
+		if (arena)
+		{
+			muggle_avl_tree_init_arena(&tree, cmp_int, arena);
+		}
+		else
+		{
+			muggle_avl_tree_init(&tree, cmp_int, capacity);
+		}
+
+		for (intptr_t i = 0; i < N_NODE; i++)
+		{
+			muggle_avl_tree_insert(&tree, (void*)((i * 7919) % N_NODE), NULL);
+		}
+
+		if (arena)
+		{
+			muggle_arena_reset(arena);
+		}
+		else
+		{
+			muggle_avl_tree_destroy(&tree, NULL, NULL, NULL, NULL);
+		}
+	}
+	muggle_realtime_get(end);
+
+	MUGGLE_LOG_INFO("avl tree %s: %.1f ns/node", name,
+		(double)elapsed_ns(&start, &end) / ((uint64_t)n_request * N_NODE));
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	muggle_benchmark_config_output(&config);
+
+	int n_request = (int)(config.rounds * config.record_per_round);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	benchmark_scratch(n_request);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	benchmark_avl_tree("malloc", n_request, 0, NULL);
+	benchmark_avl_tree("memory_pool", n_request, N_NODE, NULL);
+
+	muggle_arena_t arena;
+	muggle_arena_init(&arena, 0);
+	benchmark_avl_tree("arena", n_request, 0, &arena);
+	muggle_arena_destroy(&arena);
+
+	return 0;
+}
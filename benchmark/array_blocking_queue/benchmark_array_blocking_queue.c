@@ -48,6 +48,100 @@ void benchmark_array_blocking_queue(muggle_benchmark_config_t *config, const cha
 	muggle_array_blocking_queue_destroy(&queue);
 }
 
+typedef struct
+{
+	muggle_array_blocking_queue_t *queue;
+	int batch;
+	int cnt;
+} batch_producer_args_t;
+
+static muggle_thread_ret_t batch_producer(void *p_args)
+{
+	batch_producer_args_t *args = (batch_producer_args_t*)p_args;
+
+	void **datas = (void**)malloc(sizeof(void*) * args->batch);
+	for (int i = 0; i < args->batch; i++)
+	{
+		datas[i] = (void*)args;
+	}
+
+	int remain = args->cnt;
+	while (remain > 0)
+	{
+		int n = remain < args->batch ? remain : args->batch;
+		if (args->batch == 1)
+		{
+			muggle_array_blocking_queue_put(args->queue, datas[0]);
+		}
+		else
+		{
+			muggle_array_blocking_queue_put_n(args->queue, datas, n);
+		}
+		remain -= n;
+	}
+
+	free(datas);
+
+	return 0;
+}
+
+void benchmark_array_blocking_queue_batch(muggle_benchmark_config_t *config, int n_producer, int batch)
+{
+	muggle_array_blocking_queue_t queue;
+	muggle_array_blocking_queue_init(&queue, config->capacity);
+
+	int cnt = (int)(config->rounds * config->record_per_round);
+
+	batch_producer_args_t args;
+	args.queue = &queue;
+	args.batch = batch;
+	args.cnt = cnt;
+
+	struct timespec start, end;
+	muggle_realtime_get(start);
+
+	muggle_thread_t *producers = (muggle_thread_t*)malloc(sizeof(muggle_thread_t) * n_producer);
+	for (int i = 0; i < n_producer; i++)
+	{
+		muggle_thread_create(&producers[i], batch_producer, &args);
+	}
+
+	// single consumer drain queue
+	void **datas = (void**)malloc(sizeof(void*) * batch);
+	int total = cnt * n_producer;
+	int recv = 0;
+	while (recv < total)
+	{
+		if (batch == 1)
+		{
+			muggle_array_blocking_queue_take(&queue);
+			recv++;
+		}
+		else
+		{
+			recv += muggle_array_blocking_queue_take_all(&queue, datas, batch);
+		}
+	}
+	free(datas);
+
+	muggle_realtime_get(end);
+
+	for (int i = 0; i < n_producer; i++)
+	{
+		muggle_thread_join(&producers[i]);
+	}
+	free(producers);
+
+	muggle_array_blocking_queue_destroy(&queue);
+
+	uint64_t elapsed_ns =
+		(uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 +
+		(uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+	MUGGLE_LOG_INFO("producer=%d, batch=%d, messages=%d, elapsed %llu ns, %.1f ns/msg",
+		n_producer, batch, total, (unsigned long long)elapsed_ns,
+		(double)elapsed_ns / total);
+}
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -63,5 +157,15 @@ int main(int argc, char *argv[])
 	MUGGLE_LOG_INFO("run array blocking queue");
 	benchmark_array_blocking_queue(&config, "array_blocking_queue");
 
+	// array_blocking_queue - sweep batch size of put_n and take_all
+	int n_producer = config.producer > 0 ? config.producer : 1;
+	int batches[] = { 1, 4, 16, 64, 256 };
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("run array blocking queue batch");
+	for (int i = 0; i < (int)(sizeof(batches) / sizeof(batches[0])); i++)
+	{
+		benchmark_array_blocking_queue_batch(&config, n_producer, batches[i]);
+	}
+
 	return 0;
 }
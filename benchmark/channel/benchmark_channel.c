@@ -15,12 +15,18 @@ void* chan_read(void *user_args, int consumer_id)
 
 void producer_complete_cb(muggle_benchmark_config_t *config, void *user_args)
 {
-	MUGGLE_UNUSED(config);
-
 	static muggle_benchmark_thread_message_t end_msg;
 	memset(&end_msg, 0, sizeof(end_msg));
 	end_msg.id = UINT64_MAX;
-	chan_write(user_args, (void*)&end_msg);
+
+	// every consumer need an end message
+	for (int i = 0; i < config->consumer; i++)
+	{
+		while (chan_write(user_args, (void*)&end_msg) != 0)
+		{
+			muggle_thread_yield();
+		}
+	}
 }
 
 void benchmark_chan(muggle_benchmark_config_t *config, int flags, const char *name)
@@ -52,6 +58,128 @@ void benchmark_chan(muggle_benchmark_config_t *config, int flags, const char *na
 	muggle_channel_destroy(&chan);
 }
 
+#define BATCH_MAX_SIZE 256
+
+typedef struct
+{
+	muggle_channel_t *chan;
+	muggle_benchmark_thread_message_t *messages;
+	uint64_t cnt;
+	uint32_t batch_size;
+} batch_producer_args_t;
+
+static muggle_thread_ret_t batch_producer(void *p_args)
+{
+	batch_producer_args_t *args = (batch_producer_args_t*)p_args;
+	void *datas[BATCH_MAX_SIZE];
+
+	uint64_t idx = 0;
+	while (idx < args->cnt)
+	{
+		uint32_t n = args->batch_size;
+		if ((uint64_t)n > args->cnt - idx)
+		{
+			n = (uint32_t)(args->cnt - idx);
+		}
+		for (uint32_t i = 0; i < n; i++)
+		{
+			datas[i] = &args->messages[idx + i];
+		}
+
+		uint32_t offset = 0;
+		while (offset < n)
+		{
+			offset += muggle_channel_write_n(
+				args->chan, datas + offset, n - offset);
+		}
+		idx += n;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief run channel batch throughput
+ *
+ * every producer write message with muggle_channel_write_n and consumer read
+ * message with muggle_channel_read_n, both use the same batch size
+ */
+void benchmark_chan_batch(
+	muggle_benchmark_config_t *config, int flags, const char *name,
+	uint32_t batch_size, FILE *fp)
+{
+	muggle_channel_t chan;
+	muggle_channel_init(&chan, (muggle_sync_t)config->capacity, flags);
+
+	uint64_t cnt_per_producer = config->rounds * config->record_per_round;
+	uint64_t total = cnt_per_producer * config->producer;
+	muggle_benchmark_thread_message_t *messages =
+		(muggle_benchmark_thread_message_t*)malloc(
+			sizeof(muggle_benchmark_thread_message_t) * total);
+	batch_producer_args_t *args = (batch_producer_args_t*)malloc(
+		sizeof(batch_producer_args_t) * config->producer);
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(
+		sizeof(muggle_thread_t) * config->producer);
+	if (messages == NULL || args == NULL || threads == NULL)
+	{
+		MUGGLE_LOG_ERROR("failed allocate memory for batch benchmark");
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint64_t i = 0; i < total; i++)
+	{
+		messages[i].id = i;
+	}
+
+	muggle_time_counter_t tc;
+	muggle_time_counter_init(&tc);
+	muggle_time_counter_start(&tc);
+
+	for (int i = 0; i < config->producer; i++)
+	{
+		args[i].chan = &chan;
+		args[i].messages = messages + cnt_per_producer * i;
+		args[i].cnt = cnt_per_producer;
+		args[i].batch_size = batch_size;
+		muggle_thread_create(&threads[i], batch_producer, &args[i]);
+	}
+
+	void *datas[BATCH_MAX_SIZE];
+	uint64_t recv_cnt = 0;
+	while (recv_cnt < total)
+	{
+		recv_cnt += muggle_channel_read_n(&chan, datas, batch_size);
+	}
+
+	muggle_time_counter_end(&tc);
+
+	for (int i = 0; i < config->producer; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+
+	int64_t elapsed_ns = muggle_time_counter_interval_ns(&tc);
+	double msg_per_sec = 0.0;
+	if (elapsed_ns > 0)
+	{
+		msg_per_sec = (double)total * 1000000000.0 / (double)elapsed_ns;
+	}
+	MUGGLE_LOG_INFO("%s batch %u: %llu messages, elapsed %lld ns, %.0f msg/s",
+		name, (unsigned int)batch_size, (unsigned long long)total,
+		(long long)elapsed_ns, msg_per_sec);
+	if (fp)
+	{
+		fprintf(fp, "%s,%d,%u,%llu,%lld,%.0f\n",
+			name, config->producer, (unsigned int)batch_size,
+			(unsigned long long)total, (long long)elapsed_ns, msg_per_sec);
+	}
+
+	free(threads);
+	free(args);
+	free(messages);
+	muggle_channel_destroy(&chan);
+}
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -62,12 +190,12 @@ int main(int argc, char *argv[])
 	muggle_benchmark_config_parse_cli(&config, argc, argv);
 	muggle_benchmark_config_output(&config);
 
-	// channel must guarantee only one reader
+	// channel must guarantee only one reader, except lock-free mode
 	if (config.consumer != 1)
 	{
-		MUGGLE_LOG_ERROR(
-			"user must guarantee only one reader consume message from channel");
-		exit(EXIT_FAILURE);
+		MUGGLE_LOG_WARNING(
+			"only lock-free channel allow multiple readers, other write "
+			"modes will be skipped");
 	}
 
 	int flags = 0;
@@ -76,7 +204,10 @@ int main(int argc, char *argv[])
 		MUGGLE_CHANNEL_FLAG_WRITE_SYNC,
 		MUGGLE_CHANNEL_FLAG_WRITE_MUTEX,
 		MUGGLE_CHANNEL_FLAG_WRITE_SPIN,
+		MUGGLE_CHANNEL_FLAG_WRITE_TICKET,
+		MUGGLE_CHANNEL_FLAG_WRITE_MCS,
 		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE,
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE,
 	};
 
 	int r_flags[] = {
@@ -85,6 +216,13 @@ int main(int argc, char *argv[])
 		MUGGLE_CHANNEL_FLAG_READ_BUSY,
 	};
 
+	uint32_t batch_sizes[] = { 1, 4, 16, 64, BATCH_MAX_SIZE };
+	FILE *fp_batch = fopen("benchmark_channel_batch.csv", "wb");
+	if (fp_batch)
+	{
+		fprintf(fp_batch, "name,producer,batch_size,total,elapsed_ns,msg_per_sec\n");
+	}
+
 	const char *str_w_flags = NULL;
 	const char *str_r_flags = NULL;
 	char name[64];
@@ -101,6 +239,11 @@ int main(int argc, char *argv[])
 				continue;
 			}
 
+			if (wflag != MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE && config.consumer != 1)
+			{
+				continue;
+			}
+
 			switch (wflag)
 			{
 				case MUGGLE_CHANNEL_FLAG_WRITE_SYNC:
@@ -115,10 +258,22 @@ int main(int argc, char *argv[])
 					{
 						str_w_flags = "spin";
 					}break;
+				case MUGGLE_CHANNEL_FLAG_WRITE_TICKET:
+					{
+						str_w_flags = "ticket";
+					}break;
+				case MUGGLE_CHANNEL_FLAG_WRITE_MCS:
+					{
+						str_w_flags = "mcs";
+					}break;
 				case MUGGLE_CHANNEL_FLAG_WRITE_SINGLE:
 					{
 						str_w_flags = "single";
 					}break;
+				case MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE:
+					{
+						str_w_flags = "lockfree";
+					}break;
 				default:
 					{
 						MUGGLE_LOG_ERROR("unrecognized write flags: %d", w);
@@ -149,17 +304,33 @@ int main(int argc, char *argv[])
 
 			flags = wflag | rflag;
 			memset(name, 0, sizeof(name));
-			snprintf(name, sizeof(name), "channel_%d_%s_w_%s_r",
-					num_producer, str_w_flags, str_r_flags);
+			snprintf(name, sizeof(name), "channel_%d_%s_w_%d_%s_r",
+					num_producer, str_w_flags, config.consumer, str_r_flags);
 
 			config.producer = num_producer;
 
 			MUGGLE_LOG_INFO("--------------------------------------------------------");
-			MUGGLE_LOG_INFO("run channel - %d %s write and %s read",
-					num_producer, str_w_flags, str_r_flags);
+			MUGGLE_LOG_INFO("run channel - %d %s write and %d %s read",
+					num_producer, str_w_flags, config.consumer, str_r_flags);
 			benchmark_chan(&config, flags, name);
+
+			MUGGLE_LOG_INFO("run channel batch - %d %s write and %s read",
+					num_producer, str_w_flags, str_r_flags);
+			// batch benchmark always run with a single reader
+			memset(name, 0, sizeof(name));
+			snprintf(name, sizeof(name), "channel_%d_%s_w_1_%s_r",
+					num_producer, str_w_flags, str_r_flags);
+			for (int b = 0; b < (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0])); b++)
+			{
+				benchmark_chan_batch(&config, flags, name, batch_sizes[b], fp_batch);
+			}
 		}
 	}
 
+	if (fp_batch)
+	{
+		fclose(fp_batch);
+	}
+
 	return 0;
 }
@@ -23,9 +23,21 @@ void func_ma_ring_write(void *args, uint64_t idx)
 	muggle_ma_ring_move(ring);
 }
 
+void func_ma_ring_write_bytes(void *args, uint64_t idx)
+{
+	MUGGLE_UNUSED(args);
+	muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_get();
+
+	data_t *data = (data_t *)muggle_ma_ring_alloc_bytes(ring, sizeof(data_t));
+	data->u32 = idx;
+	muggle_ma_ring_move(ring);
+}
+
 void benchmark_ma_ring(muggle_benchmark_config_t *config,
-					   fn_muggle_benchmark_func func, const char *name)
+					   fn_muggle_benchmark_func func, const char *name,
+					   bool varlen)
 {
+	muggle_ma_ring_ctx_set_varlen(varlen);
 	muggle_ma_ring_ctx_set_capacity(TOTAL_CNT);
 	muggle_ma_ring_ctx_set_data_size(sizeof(data_t));
 	muggle_ma_ring_ctx_set_callback(fn_backend_callback);
@@ -47,6 +59,10 @@ void benchmark_ma_ring(muggle_benchmark_config_t *config,
 
 	// destroy benchmark function handle
 	muggle_benchmark_func_destroy(&benchmark);
+
+	// stop backend
+	muggle_ma_ring_thread_ctx_cleanup();
+	muggle_ma_ring_backend_stop();
 }
 
 int main(int argc, char *argv[])
@@ -60,7 +76,9 @@ int main(int argc, char *argv[])
 	config.producer = 1;
 	muggle_benchmark_config_output(&config);
 
-	benchmark_ma_ring(&config, func_ma_ring_write, "ma_ring");
+	benchmark_ma_ring(&config, func_ma_ring_write, "ma_ring", false);
+	benchmark_ma_ring(&config, func_ma_ring_write_bytes, "ma_ring_varlen",
+					  true);
 
 	return 0;
 }
@@ -0,0 +1,275 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define MAX_CHUNK_SIZE 4096
+#define N_SIZE 4096
+
+/**
+ * @brief writer put byte stream in chunks of random size (like recv from
+ * socket), reader take messages of other random size from the stream, so
+ * messages cross the wrap point of buffer at any offset
+ */
+typedef struct
+{
+	int  *w_sizes;   //!< writer chunk sizes
+	int  *r_sizes;   //!< reader message sizes
+	char *src;       //!< source of writer
+	char *dst;       //!< destination of copy read
+	int   n_round;   //!< number of rounds
+	int   zero_copy; //!< use writer_fc/reader_fc instead of write/read
+} stream_args_t;
+
+typedef struct
+{
+	uint64_t n_bytes;  //!< total bytes pass through buffer
+	uint64_t n_msg;    //!< number of messages read
+	uint64_t n_copy;   //!< messages can't be accessed in place
+	uint64_t checksum; //!< keep compiler from drop reads
+} stream_result_t;
+
+static int* gen_sizes(int n, int min_size, int max_size)
+{
+	int *sizes = (int*)malloc(sizeof(int) * n);
+	for (int i = 0; i < n; i++)
+	{
+		sizes[i] = min_size + rand() % (max_size - min_size + 1);
+	}
+	return sizes;
+}
+
+static uint64_t consume(const char *p, int n)
+{
+	// touch head and tail of message, like parse a header and a trailer
+	return (uint64_t)(unsigned char)p[0] + (uint64_t)(unsigned char)p[n - 1];
+}
+
+static void stream_bytes_buffer(
+	muggle_bytes_buffer_t *bytes_buf, stream_args_t *args, stream_result_t *result)
+{
+	int wi = 0, ri = 0;
+	for (int round = 0; round < args->n_round; round++)
+	{
+		// fill
+		while (1)
+		{
+			int n = args->w_sizes[wi % N_SIZE];
+			if (args->zero_copy)
+			{
+				void *p = muggle_bytes_buffer_writer_fc(bytes_buf, n);
+				if (p == NULL)
+				{
+					break;
+				}
+				memcpy(p, args->src, n);
+				muggle_bytes_buffer_writer_move_n(bytes_buf, p, n);
+			}
+			else
+			{
+				if (!muggle_bytes_buffer_write(bytes_buf, n, args->src))
+				{
+					break;
+				}
+			}
+			wi++;
+			result->n_bytes += n;
+		}
+
+		// drain
+		while (1)
+		{
+			int n = args->r_sizes[ri % N_SIZE];
+			if (muggle_bytes_buffer_readable(bytes_buf) < n)
+			{
+				break;
+			}
+
+			if (args->zero_copy)
+			{
+				void *p = muggle_bytes_buffer_reader_fc(bytes_buf, n);
+				if (p)
+				{
+					result->checksum += consume((char*)p, n);
+					muggle_bytes_buffer_reader_move(bytes_buf, n);
+				}
+				else
+				{
+					// message cross the wrap point, copy it out
+					muggle_bytes_buffer_read(bytes_buf, n, args->dst);
+					result->checksum += consume(args->dst, n);
+					result->n_copy++;
+				}
+			}
+			else
+			{
+				muggle_bytes_buffer_read(bytes_buf, n, args->dst);
+				result->checksum += consume(args->dst, n);
+				result->n_copy++;
+			}
+			ri++;
+			result->n_msg++;
+		}
+	}
+}
+
+static void stream_mirror_bytes_buffer(
+	muggle_mirror_bytes_buffer_t *bytes_buf, stream_args_t *args, stream_result_t *result)
+{
+	int wi = 0, ri = 0;
+	for (int round = 0; round < args->n_round; round++)
+	{
+		// fill
+		while (1)
+		{
+			int n = args->w_sizes[wi % N_SIZE];
+			if (args->zero_copy)
+			{
+				void *p = muggle_mirror_bytes_buffer_writer_fc(bytes_buf, n);
+				if (p == NULL)
+				{
+					break;
+				}
+				memcpy(p, args->src, n);
+				muggle_mirror_bytes_buffer_writer_move(bytes_buf, n);
+			}
+			else
+			{
+				if (!muggle_mirror_bytes_buffer_write(bytes_buf, n, args->src))
+				{
+					break;
+				}
+			}
+			wi++;
+			result->n_bytes += n;
+		}
+
+		// drain
+		while (1)
+		{
+			int n = args->r_sizes[ri % N_SIZE];
+			if (muggle_mirror_bytes_buffer_readable(bytes_buf) < n)
+			{
+				break;
+			}
+
+			if (args->zero_copy)
+			{
+				void *p = muggle_mirror_bytes_buffer_reader_fc(bytes_buf, n);
+				result->checksum += consume((char*)p, n);
+				muggle_mirror_bytes_buffer_reader_move(bytes_buf, n);
+			}
+			else
+			{
+				muggle_mirror_bytes_buffer_read(bytes_buf, n, args->dst);
+				result->checksum += consume(args->dst, n);
+				result->n_copy++;
+			}
+			ri++;
+			result->n_msg++;
+		}
+	}
+}
+
+static void report(
+	const char *name, stream_result_t *result,
+	struct timespec *start, struct timespec *end)
+{
+	uint64_t elapsed_ns = (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000 +
+		(uint64_t)end->tv_nsec - (uint64_t)start->tv_nsec;
+	MUGGLE_LOG_INFO(
+		"%s: %llu bytes, %llu messages, %.2f%% copied, %.1f ns/msg, %.2f GB/s (checksum=%llu)",
+		name,
+		(unsigned long long)result->n_bytes,
+		(unsigned long long)result->n_msg,
+		result->n_msg ? 100.0 * result->n_copy / result->n_msg : 0.0,
+		result->n_msg ? (double)elapsed_ns / result->n_msg : 0.0,
+		elapsed_ns ? (double)result->n_bytes / elapsed_ns : 0.0,
+		(unsigned long long)result->checksum);
+}
+
+static void benchmark_stream(int capacity, stream_args_t *args)
+{
+	struct timespec start, end;
+	stream_result_t result;
+	char name[64];
+
+	muggle_bytes_buffer_t bytes_buf;
+	if (!muggle_bytes_buffer_init(&bytes_buf, capacity))
+	{
+		MUGGLE_LOG_ERROR("failed init bytes buffer");
+		return;
+	}
+	memset(&result, 0, sizeof(result));
+	muggle_realtime_get(start);
+	stream_bytes_buffer(&bytes_buf, args, &result);
+	muggle_realtime_get(end);
+	snprintf(name, sizeof(name), "bytes_buffer%s", args->zero_copy ? "_fc" : "");
+	report(name, &result, &start, &end);
+	muggle_bytes_buffer_destroy(&bytes_buf);
+
+	muggle_mirror_bytes_buffer_t mirror_buf;
+	if (!muggle_mirror_bytes_buffer_init(&mirror_buf, capacity))
+	{
+		MUGGLE_LOG_ERROR("failed init mirror bytes buffer");
+		return;
+	}
+	memset(&result, 0, sizeof(result));
+	muggle_realtime_get(start);
+	stream_mirror_bytes_buffer(&mirror_buf, args, &result);
+	muggle_realtime_get(end);
+	snprintf(name, sizeof(name), "mirror_bytes_buffer%s", args->zero_copy ? "_fc" : "");
+	report(name, &result, &start, &end);
+	muggle_mirror_bytes_buffer_destroy(&mirror_buf);
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	muggle_benchmark_config_output(&config);
+
+	srand(0);
+
+	stream_args_t args;
+	args.w_sizes = gen_sizes(N_SIZE, 1, MAX_CHUNK_SIZE);
+	args.src = (char*)malloc(MAX_CHUNK_SIZE);
+	args.dst = (char*)malloc(MAX_CHUNK_SIZE);
+	args.n_round = (int)config.rounds * (int)config.record_per_round;
+	for (int i = 0; i < MAX_CHUNK_SIZE; i++)
+	{
+		args.src[i] = (char)i;
+	}
+
+	int capacity = 64 * 1024;
+
+	int msg_ranges[][2] = {
+		{ 16, 128 },
+		{ 64, 512 },
+		{ 512, 4096 },
+	};
+	for (size_t i = 0; i < sizeof(msg_ranges) / sizeof(msg_ranges[0]); i++)
+	{
+		args.r_sizes = gen_sizes(N_SIZE, msg_ranges[i][0], msg_ranges[i][1]);
+
+		MUGGLE_LOG_INFO("--------------------------------------------------------");
+		MUGGLE_LOG_INFO("capacity=%d, message size %d ~ %d",
+			capacity, msg_ranges[i][0], msg_ranges[i][1]);
+
+		args.zero_copy = 0;
+		benchmark_stream(capacity, &args);
+
+		args.zero_copy = 1;
+		benchmark_stream(capacity, &args);
+
+		free(args.r_sizes);
+	}
+
+	free(args.w_sizes);
+	free(args.src);
+	free(args.dst);
+
+	return 0;
+}
@@ -37,6 +37,44 @@ void benchmark_mutex(
 	muggle_mutex_destroy(&mutex);
 }
 
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+void func_adaptivelock(void *args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	muggle_adaptivelock_t *lock = (muggle_adaptivelock_t*)args;
+	muggle_adaptivelock_lock(lock);
+	muggle_adaptivelock_unlock(lock);
+}
+
+void benchmark_adaptivelock(
+	muggle_benchmark_config_t *config,
+	fn_muggle_benchmark_func func,
+	const char *name)
+{
+	muggle_adaptivelock_t lock;
+	muggle_adaptivelock_init(&lock);
+
+	// initialize benchmark memory pool handle
+	muggle_benchmark_func_t benchmark;
+	muggle_benchmark_func_init(
+		&benchmark,
+		config,
+		&lock,
+		func);
+
+	// run
+	muggle_benchmark_func_run(&benchmark);
+
+	// generate report
+	muggle_benchmark_func_gen_report(&benchmark, name);
+
+	// destroy benchmark function handle
+	muggle_benchmark_func_destroy(&benchmark);
+}
+
+#endif
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -53,16 +91,31 @@ int main(int argc, char *argv[])
 	config.producer = 1;
 	benchmark_mutex(&config, func_mutex, "mutex-1");
 
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	MUGGLE_LOG_INFO("run adaptivelock-1");
+	benchmark_adaptivelock(&config, func_adaptivelock, "adaptivelock-1");
+#endif
+
 	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	MUGGLE_LOG_INFO("run mutex-2");
 	config.producer = 2;
 	benchmark_mutex(&config, func_mutex, "mutex-2");
 
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	MUGGLE_LOG_INFO("run adaptivelock-2");
+	benchmark_adaptivelock(&config, func_adaptivelock, "adaptivelock-2");
+#endif
+
 	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	MUGGLE_LOG_INFO("run mutex-4");
 	config.producer = 4;
 	benchmark_mutex(&config, func_mutex, "mutex-4");
 
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	MUGGLE_LOG_INFO("run adaptivelock-4");
+	benchmark_adaptivelock(&config, func_adaptivelock, "adaptivelock-4");
+#endif
+
 	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	int hc = (int)muggle_thread_hardware_concurrency();
 	hc /= 2;
@@ -73,4 +126,9 @@ int main(int argc, char *argv[])
 	MUGGLE_LOG_INFO("run mutex-half-hc(%d)", hc);
 	config.producer = hc;
 	benchmark_mutex(&config, func_mutex, "mutex-half-hc");
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	MUGGLE_LOG_INFO("run adaptivelock-half-hc");
+	benchmark_adaptivelock(&config, func_adaptivelock, "adaptivelock-half-hc");
+#endif
 }
@@ -0,0 +1,177 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+typedef struct {
+	uint64_t seq;
+	uint64_t bid_price;
+	uint64_t bid_qty;
+	uint64_t ask_price;
+	uint64_t ask_qty;
+} top_of_book_t;
+
+enum {
+	SNAPSHOT_LOCK_SEQLOCK,
+	SNAPSHOT_LOCK_SPINLOCK,
+	SNAPSHOT_LOCK_MUTEX,
+};
+
+typedef struct {
+	int lock_type;
+	muggle_seqlock_t seqlock;
+	muggle_spinlock_t spinlock;
+	muggle_mutex_t mutex;
+	top_of_book_t book;
+	muggle_atomic_int stop;
+} snapshot_args_t;
+
+static void snapshot_write(snapshot_args_t *args, uint64_t seq)
+{
+	switch (args->lock_type) {
+	case SNAPSHOT_LOCK_SEQLOCK: {
+		muggle_seqlock_write_begin(&args->seqlock);
+	} break;
+	case SNAPSHOT_LOCK_SPINLOCK: {
+		muggle_spinlock_lock(&args->spinlock);
+	} break;
+	case SNAPSHOT_LOCK_MUTEX: {
+		muggle_mutex_lock(&args->mutex);
+	} break;
+	}
+
+	args->book.seq = seq;
+	args->book.bid_price = seq;
+	args->book.bid_qty = seq * 2;
+	args->book.ask_price = seq + 1;
+	args->book.ask_qty = seq * 3;
+
+	switch (args->lock_type) {
+	case SNAPSHOT_LOCK_SEQLOCK: {
+		muggle_seqlock_write_end(&args->seqlock);
+	} break;
+	case SNAPSHOT_LOCK_SPINLOCK: {
+		muggle_spinlock_unlock(&args->spinlock);
+	} break;
+	case SNAPSHOT_LOCK_MUTEX: {
+		muggle_mutex_unlock(&args->mutex);
+	} break;
+	}
+}
+
+static muggle_thread_ret_t snapshot_writer(void *p_args)
+{
+	snapshot_args_t *args = (snapshot_args_t *)p_args;
+	uint64_t seq = 0;
+	while (!muggle_atomic_load(&args->stop, muggle_memory_order_relaxed)) {
+		snapshot_write(args, ++seq);
+
+		// publish snapshot about every microsecond
+		muggle_nsleep(1000);
+	}
+	return 0;
+}
+
+void func_seqlock_read(void *p_args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	snapshot_args_t *args = (snapshot_args_t *)p_args;
+	top_of_book_t book;
+	muggle_seqlock_read_copy(&args->seqlock, &book, &args->book, sizeof(book));
+}
+
+void func_spinlock_read(void *p_args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	snapshot_args_t *args = (snapshot_args_t *)p_args;
+	top_of_book_t book;
+	muggle_spinlock_lock(&args->spinlock);
+	memcpy(&book, &args->book, sizeof(book));
+	muggle_spinlock_unlock(&args->spinlock);
+}
+
+void func_mutex_read(void *p_args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	snapshot_args_t *args = (snapshot_args_t *)p_args;
+	top_of_book_t book;
+	muggle_mutex_lock(&args->mutex);
+	memcpy(&book, &args->book, sizeof(book));
+	muggle_mutex_unlock(&args->mutex);
+}
+
+void benchmark_snapshot(muggle_benchmark_config_t *config, int lock_type,
+						fn_muggle_benchmark_func func, const char *name)
+{
+	snapshot_args_t args;
+	memset(&args, 0, sizeof(args));
+	args.lock_type = lock_type;
+	muggle_seqlock_init(&args.seqlock);
+	muggle_spinlock_init(&args.spinlock);
+	muggle_mutex_init(&args.mutex);
+
+	// single writer keep publishing snapshots
+	muggle_thread_t writer;
+	muggle_thread_create(&writer, snapshot_writer, &args);
+
+	// initialize benchmark function handle
+	muggle_benchmark_func_t benchmark;
+	muggle_benchmark_func_init(&benchmark, config, &args, func);
+
+	// run
+	muggle_benchmark_func_run(&benchmark);
+
+	// generate report
+	muggle_benchmark_func_gen_report(&benchmark, name);
+
+	// destroy benchmark function handle
+	muggle_benchmark_func_destroy(&benchmark);
+
+	muggle_atomic_store(&args.stop, 1, muggle_memory_order_relaxed);
+	muggle_thread_join(&writer);
+
+	muggle_mutex_destroy(&args.mutex);
+}
+
+void benchmark_readers(muggle_benchmark_config_t *config, int n_reader)
+{
+	char name[64];
+	config->producer = n_reader;
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("run seqlock-%d", n_reader);
+	snprintf(name, sizeof(name), "seqlock-%d", n_reader);
+	benchmark_snapshot(config, SNAPSHOT_LOCK_SEQLOCK, func_seqlock_read, name);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("run spinlock-%d", n_reader);
+	snprintf(name, sizeof(name), "spinlock-%d", n_reader);
+	benchmark_snapshot(config, SNAPSHOT_LOCK_SPINLOCK, func_spinlock_read,
+					   name);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("run mutex-%d", n_reader);
+	snprintf(name, sizeof(name), "mutex-%d", n_reader);
+	benchmark_snapshot(config, SNAPSHOT_LOCK_MUTEX, func_mutex_read, name);
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	config.producer = 0;
+	muggle_benchmark_config_output(&config);
+
+	benchmark_readers(&config, 1);
+	benchmark_readers(&config, 2);
+	benchmark_readers(&config, 4);
+
+	int hc = (int)muggle_thread_hardware_concurrency() - 1;
+	if (hc > 4) {
+		benchmark_readers(&config, hc);
+	}
+
+	return 0;
+}
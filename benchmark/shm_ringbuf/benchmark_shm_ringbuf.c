@@ -5,9 +5,17 @@ typedef struct {
 	void *ptr;
 } data_t;
 
+typedef struct {
+	muggle_shm_ringbuf_t *shm_rbuf;
+	uint32_t batch_size; //!< messages per publish
+	uint32_t n_staged; //!< number of staged messages
+	muggle_shm_ringbuf_r_batch_t r_batch; //!< reader batch iterator
+} shm_ringbuf_args_t;
+
 int shm_ringbuf_write(void *user_args, void *data)
 {
-	muggle_shm_ringbuf_t *shm_rbuf = (muggle_shm_ringbuf_t *)user_args;
+	muggle_shm_ringbuf_t *shm_rbuf =
+		((shm_ringbuf_args_t *)user_args)->shm_rbuf;
 	void **ptr = NULL;
 	do {
 		ptr =
@@ -22,7 +30,8 @@ int shm_ringbuf_write(void *user_args, void *data)
 void *shm_ringbuf_read(void *user_args, int consumer_id)
 {
 	MUGGLE_UNUSED(consumer_id);
-	muggle_shm_ringbuf_t *shm_rbuf = (muggle_shm_ringbuf_t *)user_args;
+	muggle_shm_ringbuf_t *shm_rbuf =
+		((shm_ringbuf_args_t *)user_args)->shm_rbuf;
 	uint32_t n_bytes = 0;
 	void **ptr = NULL;
 	void *data = NULL;
@@ -35,6 +44,44 @@ void *shm_ringbuf_read(void *user_args, int consumer_id)
 	return data;
 }
 
+int shm_ringbuf_write_batch(void *user_args, void *data)
+{
+	shm_ringbuf_args_t *args = (shm_ringbuf_args_t *)user_args;
+	muggle_shm_ringbuf_t *shm_rbuf = args->shm_rbuf;
+	void **ptr = NULL;
+	while ((ptr = (void **)muggle_shm_ringbuf_w_alloc_bytes(
+				shm_rbuf, sizeof(void *))) == NULL) {
+		// publish staged messages, otherwise reader never release space
+		if (args->n_staged > 0) {
+			muggle_shm_ringbuf_w_publish(shm_rbuf);
+			args->n_staged = 0;
+		}
+	}
+	*ptr = data;
+	muggle_shm_ringbuf_w_stage(shm_rbuf);
+
+	if (++args->n_staged >= args->batch_size) {
+		muggle_shm_ringbuf_w_publish(shm_rbuf);
+		args->n_staged = 0;
+	}
+
+	return 0;
+}
+
+void *shm_ringbuf_read_batch(void *user_args, int consumer_id)
+{
+	MUGGLE_UNUSED(consumer_id);
+	shm_ringbuf_args_t *args = (shm_ringbuf_args_t *)user_args;
+	void **ptr = NULL;
+	while ((ptr = (void **)muggle_shm_ringbuf_r_batch_next(&args->r_batch,
+														   NULL)) == NULL) {
+		muggle_shm_ringbuf_r_batch_commit(&args->r_batch);
+		muggle_shm_ringbuf_r_batch_begin(args->shm_rbuf, &args->r_batch);
+	}
+
+	return *ptr;
+}
+
 void producer_complete_cb(muggle_benchmark_config_t *config, void *user_args)
 {
 	MUGGLE_UNUSED(config);
@@ -42,10 +89,18 @@ void producer_complete_cb(muggle_benchmark_config_t *config, void *user_args)
 	static muggle_benchmark_thread_message_t end_msg;
 	memset(&end_msg, 0, sizeof(end_msg));
 	end_msg.id = UINT64_MAX;
-	shm_ringbuf_write(user_args, (void *)&end_msg);
+
+	shm_ringbuf_args_t *args = (shm_ringbuf_args_t *)user_args;
+	if (args->batch_size > 0) {
+		shm_ringbuf_write_batch(user_args, (void *)&end_msg);
+		muggle_shm_ringbuf_w_publish(args->shm_rbuf);
+	} else {
+		shm_ringbuf_write(user_args, (void *)&end_msg);
+	}
 }
 
-void benchmark_shm_ringbuf(muggle_benchmark_config_t *config, const char *name)
+void benchmark_shm_ringbuf(muggle_benchmark_config_t *config, const char *name,
+						   uint32_t batch_size)
 {
 	const char *k_name = "/dev/shm/mugglec_shm_ringbuf_benchmark";
 	int k_num = 5;
@@ -74,11 +129,23 @@ void benchmark_shm_ringbuf(muggle_benchmark_config_t *config, const char *name)
 	shm_rbuf = muggle_shm_ringbuf_open(&shm, k_name, k_num,
 									   MUGGLE_SHM_FLAG_CREAT, n_bytes);
 
+	shm_ringbuf_args_t args;
+	memset(&args, 0, sizeof(args));
+	args.shm_rbuf = shm_rbuf;
+	args.batch_size = batch_size;
+	muggle_shm_ringbuf_r_batch_begin(shm_rbuf, &args.r_batch);
+
 	// initialize thread transfer benchmark
 	muggle_benchmark_thread_trans_t benchmark;
-	muggle_benchmark_thread_trans_init(&benchmark, config, (void *)shm_rbuf,
-									   shm_ringbuf_write, shm_ringbuf_read,
-									   producer_complete_cb);
+	if (batch_size > 0) {
+		muggle_benchmark_thread_trans_init(
+			&benchmark, config, (void *)&args, shm_ringbuf_write_batch,
+			shm_ringbuf_read_batch, producer_complete_cb);
+	} else {
+		muggle_benchmark_thread_trans_init(
+			&benchmark, config, (void *)&args, shm_ringbuf_write,
+			shm_ringbuf_read, producer_complete_cb);
+	}
 
 	// run benchmark
 	muggle_benchmark_thread_trans_run(&benchmark);
@@ -115,5 +182,11 @@ int main(int argc, char *argv[])
 
 	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	MUGGLE_LOG_INFO("run shm_ringbuf");
-	benchmark_shm_ringbuf(&config, "shm_ringbuf_1_w_1_r");
+	benchmark_shm_ringbuf(&config, "shm_ringbuf_1_w_1_r", 0);
+
+	// publish once per round, reader commit once per iterated batch
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("run shm_ringbuf batch");
+	benchmark_shm_ringbuf(&config, "shm_ringbuf_1_w_1_r_batch",
+						  (uint32_t)config.record_per_round);
 }
@@ -0,0 +1,195 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define N_LIVE 64
+
+typedef void* (*fn_alloc)(void *allocator, size_t n_bytes);
+typedef void (*fn_free)(void *allocator, void *ptr);
+
+typedef struct
+{
+	void     *allocator;
+	fn_alloc  alloc;
+	fn_free   free;
+	size_t   *sizes;
+	int       n_size;
+	int       n_round;
+} mix_args_t;
+
+static void* sys_alloc(void *allocator, size_t n_bytes)
+{
+	MUGGLE_UNUSED(allocator);
+	return malloc(n_bytes);
+}
+
+static void sys_free(void *allocator, void *ptr)
+{
+	MUGGLE_UNUSED(allocator);
+	free(ptr);
+}
+
+static void* slab_alloc(void *allocator, size_t n_bytes)
+{
+	return muggle_slab_allocator_alloc((muggle_slab_allocator_t*)allocator, n_bytes);
+}
+
+static void slab_free(void *allocator, void *ptr)
+{
+	muggle_slab_allocator_free((muggle_slab_allocator_t*)allocator, ptr);
+}
+
+static void* ts_slab_alloc(void *allocator, size_t n_bytes)
+{
+	return muggle_ts_slab_allocator_alloc((muggle_ts_slab_allocator_t*)allocator, n_bytes);
+}
+
+static void ts_slab_free(void *allocator, void *ptr)
+{
+	muggle_ts_slab_allocator_free((muggle_ts_slab_allocator_t*)allocator, ptr);
+}
+
+/**
+ * @brief message sizes: most of messages are 64 ~ 512 bytes, some are 4K
+ * and a few are large
+ */
+static size_t* gen_sizes(int n)
+{
+	size_t *sizes = (size_t*)malloc(sizeof(size_t) * n);
+	srand(0);
+	for (int i = 0; i < n; i++)
+	{
+		int r = rand() % 1000;
+		if (r < 900)
+		{
+			sizes[i] = 64 + (size_t)(rand() % 449);
+		}
+		else if (r < 999)
+		{
+			sizes[i] = 4096;
+		}
+		else
+		{
+			sizes[i] = 128 * 1024;
+		}
+	}
+	return sizes;
+}
+
+static muggle_thread_ret_t mix_routine(void *p_args)
+{
+	mix_args_t *args = (mix_args_t*)p_args;
+	void *ptrs[N_LIVE] = { 0 };
+
+	int k = 0;
+	for (int r = 0; r < args->n_round; r++)
+	{
+		for (int i = 0; i < N_LIVE; i++)
+		{
+			size_t n = args->sizes[k++ % args->n_size];
+			ptrs[i] = args->alloc(args->allocator, n);
+			memset(ptrs[i], 0, n < 64 ? n : 64);
+		}
+		for (int i = 0; i < N_LIVE; i++)
+		{
+			args->free(args->allocator, ptrs[i]);
+		}
+	}
+
+	muggle_ts_memory_pool_thread_cache_cleanup();
+
+	return 0;
+}
+
+static void benchmark_mix(
+	const char *name, mix_args_t *args, int n_thread)
+{
+	struct timespec start, end;
+	muggle_realtime_get(start);
+
+	if (n_thread <= 1)
+	{
+		mix_routine(args);
+	}
+	else
+	{
+		muggle_thread_t *threads =
+			(muggle_thread_t*)malloc(sizeof(muggle_thread_t) * n_thread);
+		for (int i = 0; i < n_thread; i++)
+		{
+			muggle_thread_create(&threads[i], mix_routine, args);
+		}
+		for (int i = 0; i < n_thread; i++)
+		{
+			muggle_thread_join(&threads[i]);
+		}
+		free(threads);
+	}
+
+	muggle_realtime_get(end);
+
+	uint64_t elapsed_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 +
+		(uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+	uint64_t n_op = (uint64_t)(n_thread <= 1 ? 1 : n_thread) * args->n_round * N_LIVE;
+	MUGGLE_LOG_INFO("%s thread=%d: %llu alloc/free pairs, %.1f ns/pair",
+		name, n_thread, (unsigned long long)n_op, (double)elapsed_ns / n_op);
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	muggle_benchmark_config_output(&config);
+
+	int n_size = 4096;
+	size_t *sizes = gen_sizes(n_size);
+
+	mix_args_t args;
+	args.sizes = sizes;
+	args.n_size = n_size;
+	args.n_round = (int)(config.rounds * config.record_per_round);
+
+	int n_thread = config.producer > 0 ? config.producer : 4;
+
+	// single thread
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	args.allocator = NULL;
+	args.alloc = sys_alloc;
+	args.free = sys_free;
+	benchmark_mix("malloc", &args, 1);
+
+	muggle_slab_allocator_t slab;
+	muggle_slab_allocator_init(&slab, 0, config.capacity);
+	args.allocator = &slab;
+	args.alloc = slab_alloc;
+	args.free = slab_free;
+	benchmark_mix("slab", &args, 1);
+	muggle_slab_allocator_destroy(&slab);
+
+	// multiple threads
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	args.allocator = NULL;
+	args.alloc = sys_alloc;
+	args.free = sys_free;
+	benchmark_mix("malloc", &args, n_thread);
+
+	muggle_ts_slab_allocator_t ts_slab;
+	muggle_ts_slab_allocator_init(&ts_slab, 0, 1024 * 1024, 0);
+	args.allocator = &ts_slab;
+	args.alloc = ts_slab_alloc;
+	args.free = ts_slab_free;
+	benchmark_mix("ts_slab", &args, n_thread);
+	muggle_ts_slab_allocator_destroy(&ts_slab);
+
+	muggle_ts_slab_allocator_init(&ts_slab, 0, 1024 * 1024, 32);
+	args.allocator = &ts_slab;
+	benchmark_mix("ts_slab_magazine", &args, n_thread);
+	muggle_ts_slab_allocator_destroy(&ts_slab);
+
+	free(sizes);
+
+	return 0;
+}
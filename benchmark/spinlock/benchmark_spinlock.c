@@ -1,12 +1,36 @@
 #include "muggle/c/muggle_c.h"
 #include "muggle_benchmark/muggle_benchmark.h"
 
+typedef struct
+{
+	muggle_spinlock_t spinlock;
+	muggle_ticketlock_t ticketlock;
+	muggle_mcslock_t mcslock;
+} spinlock_args_t;
+
 void func_spinlock(void *args, uint64_t idx)
 {
 	MUGGLE_UNUSED(idx);
-	muggle_spinlock_t *spinlock = (muggle_spinlock_t*)args;
-	muggle_spinlock_lock(spinlock);
-	muggle_spinlock_unlock(spinlock);
+	spinlock_args_t *p = (spinlock_args_t*)args;
+	muggle_spinlock_lock(&p->spinlock);
+	muggle_spinlock_unlock(&p->spinlock);
+}
+
+void func_ticketlock(void *args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	spinlock_args_t *p = (spinlock_args_t*)args;
+	muggle_ticketlock_lock(&p->ticketlock);
+	muggle_ticketlock_unlock(&p->ticketlock);
+}
+
+void func_mcslock(void *args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	spinlock_args_t *p = (spinlock_args_t*)args;
+	muggle_mcslock_node_t node;
+	muggle_mcslock_lock(&p->mcslock, &node);
+	muggle_mcslock_unlock(&p->mcslock, &node);
 }
 
 void benchmark_spinlock(
@@ -14,15 +38,17 @@ void benchmark_spinlock(
 	fn_muggle_benchmark_func func,
 	const char *name)
 {
-	muggle_spinlock_t spinlock;
-	muggle_spinlock_init(&spinlock);
+	spinlock_args_t args;
+	muggle_spinlock_init(&args.spinlock);
+	muggle_ticketlock_init(&args.ticketlock);
+	muggle_mcslock_init(&args.mcslock);
 
 	// initialize benchmark memory pool handle
 	muggle_benchmark_func_t benchmark;
 	muggle_benchmark_func_init(
 		&benchmark,
 		config,
-		&spinlock,
+		&args,
 		func);
 
 	// run
@@ -35,6 +61,26 @@ void benchmark_spinlock(
 	muggle_benchmark_func_destroy(&benchmark);
 }
 
+void benchmark_locks(muggle_benchmark_config_t *config, const char *suffix)
+{
+	char name[64];
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	snprintf(name, sizeof(name), "spinlock-%s", suffix);
+	MUGGLE_LOG_INFO("run %s", name);
+	benchmark_spinlock(config, func_spinlock, name);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	snprintf(name, sizeof(name), "ticketlock-%s", suffix);
+	MUGGLE_LOG_INFO("run %s", name);
+	benchmark_spinlock(config, func_ticketlock, name);
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	snprintf(name, sizeof(name), "mcslock-%s", suffix);
+	MUGGLE_LOG_INFO("run %s", name);
+	benchmark_spinlock(config, func_mcslock, name);
+}
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -46,29 +92,25 @@ int main(int argc, char *argv[])
 	config.producer = 0;
 	muggle_benchmark_config_output(&config);
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run spinlock-1");
 	config.producer = 1;
-	benchmark_spinlock(&config, func_spinlock, "spinlock-1");
+	benchmark_locks(&config, "1");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run spinlock-2");
 	config.producer = 2;
-	benchmark_spinlock(&config, func_spinlock, "spinlock-2");
+	benchmark_locks(&config, "2");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run spinlock-4");
 	config.producer = 4;
-	benchmark_spinlock(&config, func_spinlock, "spinlock-4");
+	benchmark_locks(&config, "4");
+
+	config.producer = 8;
+	benchmark_locks(&config, "8");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	int hc = (int)muggle_thread_hardware_concurrency();
 	hc /= 2;
 	if (hc < 1)
 	{
 		hc = 1;
 	}
-	MUGGLE_LOG_INFO("run spinlock-half-hc(%d)", hc);
+	MUGGLE_LOG_INFO("half hardware concurrency: %d", hc);
 	config.producer = hc;
-	benchmark_spinlock(&config, func_spinlock, "spinlock-half-hc");
+	benchmark_locks(&config, "half-hc");
 }
@@ -3,12 +3,51 @@
 
 #if MUGGLE_C_HAVE_SYNC_OBJ
 
+typedef struct
+{
+	muggle_sync_t synclock;
+	muggle_adaptivelock_t adaptivelock;
+} synclock_args_t;
+
+// simulate critical section, every 16th hold is much longer
+static void critical_section_varhold(uint64_t idx)
+{
+	uint32_t n = (idx % 16 == 0) ? 4096 : 16;
+	for (volatile uint32_t i = 0; i < n; i++)
+	{
+	}
+}
+
 void func_synclock(void *args, uint64_t idx)
 {
 	MUGGLE_UNUSED(idx);
-	muggle_sync_t *synclock = (muggle_sync_t*)args;
-	muggle_synclock_lock(synclock);
-	muggle_synclock_unlock(synclock);
+	synclock_args_t *p = (synclock_args_t*)args;
+	muggle_synclock_lock(&p->synclock);
+	muggle_synclock_unlock(&p->synclock);
+}
+
+void func_adaptivelock(void *args, uint64_t idx)
+{
+	MUGGLE_UNUSED(idx);
+	synclock_args_t *p = (synclock_args_t*)args;
+	muggle_adaptivelock_lock(&p->adaptivelock);
+	muggle_adaptivelock_unlock(&p->adaptivelock);
+}
+
+void func_synclock_varhold(void *args, uint64_t idx)
+{
+	synclock_args_t *p = (synclock_args_t*)args;
+	muggle_synclock_lock(&p->synclock);
+	critical_section_varhold(idx);
+	muggle_synclock_unlock(&p->synclock);
+}
+
+void func_adaptivelock_varhold(void *args, uint64_t idx)
+{
+	synclock_args_t *p = (synclock_args_t*)args;
+	muggle_adaptivelock_lock(&p->adaptivelock);
+	critical_section_varhold(idx);
+	muggle_adaptivelock_unlock(&p->adaptivelock);
 }
 
 void benchmark_synclock(
@@ -16,15 +55,16 @@ void benchmark_synclock(
 	fn_muggle_benchmark_func func,
 	const char *name)
 {
-	muggle_sync_t synclock;
-	muggle_synclock_init(&synclock);
+	synclock_args_t args;
+	muggle_synclock_init(&args.synclock);
+	muggle_adaptivelock_init(&args.adaptivelock);
 
 	// initialize benchmark memory pool handle
 	muggle_benchmark_func_t benchmark;
 	muggle_benchmark_func_init(
 		&benchmark,
 		config,
-		&synclock,
+		&args,
 		func);
 
 	// run
@@ -37,6 +77,28 @@ void benchmark_synclock(
 	muggle_benchmark_func_destroy(&benchmark);
 }
 
+void benchmark_locks(muggle_benchmark_config_t *config, const char *suffix)
+{
+	struct {
+		const char *name;
+		fn_muggle_benchmark_func func;
+	} cases[] = {
+		{ "synclock", func_synclock },
+		{ "adaptivelock", func_adaptivelock },
+		{ "synclock-varhold", func_synclock_varhold },
+		{ "adaptivelock-varhold", func_adaptivelock_varhold },
+	};
+
+	char name[64];
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		MUGGLE_LOG_INFO("--------------------------------------------------------");
+		snprintf(name, sizeof(name), "%s-%s", cases[i].name, suffix);
+		MUGGLE_LOG_INFO("run %s", name);
+		benchmark_synclock(config, cases[i].func, name);
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -48,31 +110,24 @@ int main(int argc, char *argv[])
 	config.producer = 0;
 	muggle_benchmark_config_output(&config);
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run synclock-1");
 	config.producer = 1;
-	benchmark_synclock(&config, func_synclock, "synclock-1");
+	benchmark_locks(&config, "1");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run synclock-2");
 	config.producer = 2;
-	benchmark_synclock(&config, func_synclock, "synclock-2");
+	benchmark_locks(&config, "2");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
-	MUGGLE_LOG_INFO("run synclock-4");
 	config.producer = 4;
-	benchmark_synclock(&config, func_synclock, "synclock-4");
+	benchmark_locks(&config, "4");
 
-	MUGGLE_LOG_INFO("--------------------------------------------------------");
 	int hc = (int)muggle_thread_hardware_concurrency();
 	hc /= 2;
 	if (hc < 1)
 	{
 		hc = 1;
 	}
-	MUGGLE_LOG_INFO("run synclock-half-hc(%d)", hc);
+	MUGGLE_LOG_INFO("half hardware concurrency: %d", hc);
 	config.producer = hc;
-	benchmark_synclock(&config, func_synclock, "synclock-half-hc");
+	benchmark_locks(&config, "half-hc");
 }
 
 #else
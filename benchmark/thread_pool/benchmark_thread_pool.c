@@ -0,0 +1,221 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+#define TASK_WORK 64
+
+typedef struct
+{
+	muggle_atomic_int done;
+	uint64_t sink;
+} task_ctx_t;
+
+static void do_task_work(task_ctx_t *ctx)
+{
+	uint64_t v = 0;
+	for (volatile int i = 0; i < TASK_WORK; i++)
+	{
+		v += (uint64_t)i;
+	}
+	ctx->sink = v;
+}
+
+static void pool_task(void *args)
+{
+	task_ctx_t *ctx = (task_ctx_t*)args;
+	do_task_work(ctx);
+}
+
+static void pool_range(void *args, uint64_t begin, uint64_t end)
+{
+	task_ctx_t *ctx = (task_ctx_t*)args;
+	for (uint64_t i = begin; i < end; i++)
+	{
+		do_task_work(ctx);
+	}
+}
+
+static uint64_t elapsed_ns(struct timespec *start, struct timespec *end)
+{
+	return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000 +
+		(uint64_t)end->tv_nsec - (uint64_t)start->tv_nsec;
+}
+
+/***************** array blocking queue dispatch *****************/
+
+typedef struct
+{
+	muggle_array_blocking_queue_t *queue;
+	task_ctx_t *ctx;
+} abq_worker_args_t;
+
+static int s_abq_stop_msg = 0;
+
+static muggle_thread_ret_t abq_worker(void *p_args)
+{
+	abq_worker_args_t *args = (abq_worker_args_t*)p_args;
+	while (1)
+	{
+		void *data = muggle_array_blocking_queue_take(args->queue);
+		if (data == &s_abq_stop_msg)
+		{
+			break;
+		}
+
+		do_task_work(args->ctx);
+		muggle_atomic_fetch_add(&args->ctx->done, 1, muggle_memory_order_release);
+	}
+	return 0;
+}
+
+static uint64_t benchmark_abq(int n_worker, int n_task)
+{
+	task_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+
+	muggle_array_blocking_queue_t queue;
+	muggle_array_blocking_queue_init(&queue, 4096);
+
+	abq_worker_args_t args;
+	args.queue = &queue;
+	args.ctx = &ctx;
+
+	muggle_thread_t *threads =
+		(muggle_thread_t*)malloc(sizeof(muggle_thread_t) * n_worker);
+	for (int i = 0; i < n_worker; i++)
+	{
+		muggle_thread_create(&threads[i], abq_worker, &args);
+	}
+
+	struct timespec start, end;
+	muggle_realtime_get(start);
+	for (int i = 0; i < n_task; i++)
+	{
+		muggle_array_blocking_queue_put(&queue, &ctx);
+	}
+	while (muggle_atomic_load(&ctx.done, muggle_memory_order_acquire) != n_task)
+	{
+		muggle_thread_yield();
+	}
+	muggle_realtime_get(end);
+
+	for (int i = 0; i < n_worker; i++)
+	{
+		muggle_array_blocking_queue_put(&queue, &s_abq_stop_msg);
+	}
+	for (int i = 0; i < n_worker; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+	free(threads);
+	muggle_array_blocking_queue_destroy(&queue);
+
+	return elapsed_ns(&start, &end);
+}
+
+/***************** thread pool *****************/
+
+static uint64_t benchmark_pool_submit(int n_worker, int n_task)
+{
+	task_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+
+	muggle_thread_pool_t pool;
+	muggle_thread_pool_init(&pool, (uint32_t)n_worker, 4096, 0);
+
+	struct timespec start, end;
+	muggle_realtime_get(start);
+
+	muggle_thread_pool_group_t group;
+	muggle_thread_pool_group_init(&group);
+	for (int i = 0; i < n_task; i++)
+	{
+		muggle_thread_pool_submit(&pool, &group, pool_task, &ctx);
+	}
+	muggle_thread_pool_group_wait(&pool, &group);
+
+	muggle_realtime_get(end);
+
+	muggle_thread_pool_destroy(&pool);
+
+	return elapsed_ns(&start, &end);
+}
+
+static uint64_t benchmark_pool_parallel_for(int n_worker, int n_task)
+{
+	task_ctx_t ctx;
+	memset(&ctx, 0, sizeof(ctx));
+
+	muggle_thread_pool_t pool;
+	muggle_thread_pool_init(&pool, (uint32_t)n_worker, 4096, 0);
+
+	struct timespec start, end;
+	muggle_realtime_get(start);
+	muggle_thread_pool_parallel_for(
+		&pool, 0, (uint64_t)n_task, 16, pool_range, &ctx);
+	muggle_realtime_get(end);
+
+	muggle_thread_pool_destroy(&pool);
+
+	return elapsed_ns(&start, &end);
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	muggle_benchmark_config_output(&config);
+
+	int n_task = (int)(config.rounds * config.record_per_round) * 20;
+
+	FILE *fp = fopen("benchmark_thread_pool.csv", "wb");
+	if (fp)
+	{
+		fprintf(fp, "name,worker,tasks,elapsed_ns,task_per_sec\n");
+	}
+
+	int hc = (int)muggle_thread_hardware_concurrency();
+	int workers[] = { 1, 2, 4, hc > 4 ? hc : 8 };
+	for (int i = 0; i < (int)(sizeof(workers) / sizeof(workers[0])); i++)
+	{
+		int n_worker = workers[i];
+
+		struct {
+			const char *name;
+			uint64_t (*fn)(int, int);
+		} cases[] = {
+			{ "array_blocking_queue", benchmark_abq },
+			{ "thread_pool_submit", benchmark_pool_submit },
+			{ "thread_pool_parallel_for", benchmark_pool_parallel_for },
+		};
+
+		for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); c++)
+		{
+			MUGGLE_LOG_INFO("--------------------------------------------------------");
+			MUGGLE_LOG_INFO("run %s, worker=%d, tasks=%d",
+				cases[c].name, n_worker, n_task);
+
+			uint64_t ns = cases[c].fn(n_worker, n_task);
+			double task_per_sec = (double)n_task * 1000000000.0 / (double)ns;
+			MUGGLE_LOG_INFO("elapsed %llu ns, %.0f tasks/sec",
+				(unsigned long long)ns, task_per_sec);
+
+			if (fp)
+			{
+				fprintf(fp, "%s,%d,%d,%llu,%.0f\n",
+					cases[c].name, n_worker, n_task,
+					(unsigned long long)ns, task_per_sec);
+			}
+		}
+	}
+
+	if (fp)
+	{
+		fclose(fp);
+	}
+
+	return 0;
+}
@@ -43,6 +43,75 @@ void benchmark_threadsafe_memory_pool(muggle_benchmark_config_t *config,
 	muggle_ts_memory_pool_destroy(&pool);
 }
 
+typedef struct
+{
+	muggle_ts_memory_pool_t *pool;
+	int n_live;
+	int n_round;
+} churn_args_t;
+
+static muggle_thread_ret_t churn_routine(void *p_args)
+{
+	churn_args_t *args = (churn_args_t *)p_args;
+	void **datas = (void **)malloc(sizeof(void *) * args->n_live);
+
+	for (int r = 0; r < args->n_round; r++) {
+		for (int i = 0; i < args->n_live; i++) {
+			datas[i] = threadsafe_memory_pool_alloc(args->pool, 0);
+		}
+		for (int i = 0; i < args->n_live; i++) {
+			muggle_ts_memory_pool_free(datas[i]);
+		}
+	}
+
+	muggle_ts_memory_pool_thread_cache_cleanup();
+	free(datas);
+
+	return 0;
+}
+
+/**
+ * @brief every thread allocate and free blocks of the same pool in a tight
+ * loop, measure how shared cursors scale with and without magazine
+ */
+void benchmark_churn(muggle_benchmark_config_t *config, int n_thread,
+					 muggle_sync_t magazine_size)
+{
+	muggle_ts_memory_pool_t pool;
+	muggle_ts_memory_pool_init(&pool, config->capacity, 128);
+	muggle_ts_memory_pool_set_magazine(&pool, magazine_size);
+
+	churn_args_t args;
+	args.pool = &pool;
+	args.n_live = 8;
+	args.n_round = (int)(config->rounds * config->record_per_round);
+
+	struct timespec start, end;
+	muggle_realtime_get(start);
+
+	muggle_thread_t *threads =
+		(muggle_thread_t *)malloc(sizeof(muggle_thread_t) * n_thread);
+	for (int i = 0; i < n_thread; i++) {
+		muggle_thread_create(&threads[i], churn_routine, &args);
+	}
+	for (int i = 0; i < n_thread; i++) {
+		muggle_thread_join(&threads[i]);
+	}
+	free(threads);
+
+	muggle_realtime_get(end);
+
+	uint64_t elapsed_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000 +
+						  (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+	uint64_t n_op = (uint64_t)n_thread * args.n_round * args.n_live;
+	MUGGLE_LOG_INFO("churn thread=%d, magazine=%d: %llu alloc/free pairs, "
+					"%.1f ns/pair",
+					n_thread, (int)magazine_size, (unsigned long long)n_op,
+					(double)elapsed_ns / n_op);
+
+	muggle_ts_memory_pool_destroy(&pool);
+}
+
 int main(int argc, char *argv[])
 {
 	// initialize log
@@ -105,5 +174,15 @@ int main(int argc, char *argv[])
 	MUGGLE_LOG_INFO("run %s", name);
 	benchmark_threadsafe_memory_pool(&config, name);
 
+	// multi-thread alloc/free churn
+	MUGGLE_LOG_INFO(
+			"--------------------------------------------------------");
+	int hc = (int)muggle_thread_hardware_concurrency();
+	int n_threads[] = { 1, 2, 4, hc > 4 ? hc : 8 };
+	for (int i = 0; i < (int)(sizeof(n_threads) / sizeof(n_threads[0])); i++) {
+		benchmark_churn(&config, n_threads[i], 0);
+		benchmark_churn(&config, n_threads[i], 32);
+	}
+
 	return 0;
 }
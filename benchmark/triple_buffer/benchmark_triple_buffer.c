@@ -0,0 +1,218 @@
+#include "muggle/c/muggle_c.h"
+#include "muggle_benchmark/muggle_benchmark.h"
+
+typedef struct {
+	uint64_t seq;
+	uint64_t ts_ns;
+	uint64_t values[6];
+} state_t;
+
+enum {
+	LATEST_STATE_TRIPLE_BUFFER,
+	LATEST_STATE_SEQLOCK,
+	LATEST_STATE_DOUBLE_BUFFER,
+};
+
+typedef struct {
+	int type;
+	uint64_t cnt;
+	uint64_t interval_ns;
+
+	muggle_triple_buffer_t tbuf;
+	muggle_seqlock_t seqlock;
+	state_t seqlock_state;
+	muggle_double_buffer_t dbuf;
+	state_t *dbuf_states;
+
+	uint64_t writer_elapsed_ns;
+	uint64_t *latencies;
+	uint64_t n_latency;
+} latest_state_args_t;
+
+static uint64_t now_ns()
+{
+	struct timespec ts;
+	muggle_realtime_get(ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void state_fill(state_t *state, uint64_t seq)
+{
+	state->seq = seq;
+	for (int i = 0; i < 6; i++) {
+		state->values[i] = seq + i;
+	}
+	state->ts_ns = now_ns();
+}
+
+static muggle_thread_ret_t latest_state_writer(void *p_args)
+{
+	latest_state_args_t *args = (latest_state_args_t *)p_args;
+
+	uint64_t elapsed = 0;
+	uint64_t next_ts = now_ns();
+	for (uint64_t seq = 1; seq <= args->cnt; seq++) {
+		// keep publish interval without sleep
+		while (now_ns() < next_ts) {
+		}
+		next_ts += args->interval_ns;
+
+		uint64_t start = now_ns();
+		switch (args->type) {
+		case LATEST_STATE_TRIPLE_BUFFER: {
+			state_t *state = (state_t *)muggle_triple_buffer_w_buf(&args->tbuf);
+			state_fill(state, seq);
+			muggle_triple_buffer_w_publish(&args->tbuf);
+		} break;
+		case LATEST_STATE_SEQLOCK: {
+			muggle_seqlock_write_begin(&args->seqlock);
+			state_fill(&args->seqlock_state, seq);
+			muggle_seqlock_write_end(&args->seqlock);
+		} break;
+		case LATEST_STATE_DOUBLE_BUFFER: {
+			state_t *state = &args->dbuf_states[seq - 1];
+			state_fill(state, seq);
+			muggle_double_buffer_write(&args->dbuf, state);
+		} break;
+		}
+		elapsed += now_ns() - start;
+	}
+	args->writer_elapsed_ns = elapsed;
+
+	return 0;
+}
+
+static void latest_state_record(latest_state_args_t *args, state_t *state,
+								uint64_t *last_seq)
+{
+	if (state->seq == *last_seq) {
+		return;
+	}
+	*last_seq = state->seq;
+	args->latencies[args->n_latency++] = now_ns() - state->ts_ns;
+}
+
+static void latest_state_reader(latest_state_args_t *args)
+{
+	uint64_t last_seq = 0;
+	while (last_seq != args->cnt) {
+		switch (args->type) {
+		case LATEST_STATE_TRIPLE_BUFFER: {
+			bool updated = false;
+			state_t *state =
+				(state_t *)muggle_triple_buffer_r_fetch(&args->tbuf, &updated);
+			if (updated) {
+				latest_state_record(args, state, &last_seq);
+			}
+		} break;
+		case LATEST_STATE_SEQLOCK: {
+			state_t state;
+			muggle_seqlock_read_copy(&args->seqlock, &state,
+									 &args->seqlock_state, sizeof(state));
+			latest_state_record(args, &state, &last_seq);
+		} break;
+		case LATEST_STATE_DOUBLE_BUFFER: {
+			// only care about the latest state in buffer
+			muggle_single_buffer_t *buf = muggle_double_buffer_read(&args->dbuf);
+			state_t *state = (state_t *)buf->datas[buf->cnt - 1];
+			latest_state_record(args, state, &last_seq);
+		} break;
+		}
+	}
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void benchmark_latest_state(uint64_t cnt, uint64_t interval_ns,
+								   int type, const char *name, FILE *fp)
+{
+	latest_state_args_t args;
+	memset(&args, 0, sizeof(args));
+	args.type = type;
+	args.cnt = cnt;
+	args.interval_ns = interval_ns;
+	args.latencies = (uint64_t *)malloc(sizeof(uint64_t) * cnt);
+
+	muggle_triple_buffer_init(&args.tbuf, sizeof(state_t));
+	muggle_seqlock_init(&args.seqlock);
+	muggle_double_buffer_init(&args.dbuf, 1024, 0);
+	args.dbuf_states = (state_t *)malloc(sizeof(state_t) * cnt);
+
+	muggle_thread_t writer;
+	muggle_thread_create(&writer, latest_state_writer, &args);
+	latest_state_reader(&args);
+	muggle_thread_join(&writer);
+
+	qsort(args.latencies, args.n_latency, sizeof(uint64_t), cmp_u64);
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < args.n_latency; i++) {
+		sum += args.latencies[i];
+	}
+
+	uint64_t n = args.n_latency;
+	uint64_t avg = n ? sum / n : 0;
+	uint64_t p50 = n ? args.latencies[n / 2] : 0;
+	uint64_t p99 = n ? args.latencies[n * 99 / 100] : 0;
+	uint64_t max = n ? args.latencies[n - 1] : 0;
+	uint64_t writer_ns = args.writer_elapsed_ns / cnt;
+
+	MUGGLE_LOG_INFO("%s: observed %llu/%llu states, latency(ns) avg=%llu "
+					"p50=%llu p99=%llu max=%llu, writer publish %llu ns/op",
+					name, (unsigned long long)n, (unsigned long long)cnt,
+					(unsigned long long)avg, (unsigned long long)p50,
+					(unsigned long long)p99, (unsigned long long)max,
+					(unsigned long long)writer_ns);
+	if (fp) {
+		fprintf(fp, "%s,%llu,%llu,%llu,%llu,%llu,%llu\n", name,
+				(unsigned long long)n, (unsigned long long)avg,
+				(unsigned long long)p50, (unsigned long long)p99,
+				(unsigned long long)max, (unsigned long long)writer_ns);
+	}
+
+	free(args.dbuf_states);
+	muggle_double_buffer_destroy(&args.dbuf);
+	muggle_triple_buffer_destroy(&args.tbuf);
+	free(args.latencies);
+}
+
+int main(int argc, char *argv[])
+{
+	// initialize log
+	muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO);
+
+	// initialize benchmark config
+	muggle_benchmark_config_t config;
+	muggle_benchmark_config_parse_cli(&config, argc, argv);
+	muggle_benchmark_config_output(&config);
+
+	uint64_t cnt = config.rounds * config.record_per_round;
+	uint64_t interval_ns = (uint64_t)config.round_interval_ns /
+						   (config.record_per_round ? config.record_per_round : 1);
+
+	FILE *fp = fopen("benchmark_triple_buffer.csv", "wb");
+	if (fp) {
+		fprintf(fp, "name,observed,avg,p50,p99,max,writer_ns\n");
+	}
+
+	MUGGLE_LOG_INFO("--------------------------------------------------------");
+	MUGGLE_LOG_INFO("publish %llu states, interval %llu ns",
+					(unsigned long long)cnt, (unsigned long long)interval_ns);
+
+	benchmark_latest_state(cnt, interval_ns, LATEST_STATE_TRIPLE_BUFFER,
+						   "triple_buffer", fp);
+	benchmark_latest_state(cnt, interval_ns, LATEST_STATE_SEQLOCK, "seqlock",
+						   fp);
+	benchmark_latest_state(cnt, interval_ns, LATEST_STATE_DOUBLE_BUFFER,
+						   "double_buffer", fp);
+
+	if (fp) {
+		fclose(fp);
+	}
+
+	return 0;
+}
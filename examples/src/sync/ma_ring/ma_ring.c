@@ -56,6 +56,8 @@ int main()
 
 	muggle_ma_ring_thread_ctx_cleanup();
 
+	muggle_ma_ring_backend_stop();
+
 	LOG_INFO("bye");
 
 	return 0;
@@ -19,7 +19,11 @@
 static muggle_avl_tree_node_t* muggle_avl_tree_allocate_node(muggle_avl_tree_t *p_avl_tree)
 {
 	muggle_avl_tree_node_t *node = NULL;
-	if (p_avl_tree->pool)
+	if (p_avl_tree->arena)
+	{
+		node = (muggle_avl_tree_node_t*)muggle_arena_alloc(p_avl_tree->arena, sizeof(muggle_avl_tree_node_t));
+	}
+	else if (p_avl_tree->pool)
 	{
 		node = (muggle_avl_tree_node_t*)muggle_memory_pool_alloc(p_avl_tree->pool);
 	}
@@ -89,7 +93,11 @@ static void muggle_avl_tree_erase_node(
 		}
 	}
 
-	if (p_avl_tree->pool)
+	if (p_avl_tree->arena)
+	{
+		// node memory is released with arena
+	}
+	else if (p_avl_tree->pool)
 	{
 		muggle_memory_pool_free(p_avl_tree->pool, node);
 	}
@@ -487,6 +495,22 @@ bool muggle_avl_tree_init(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cm
 	return true;
 }
 
+bool muggle_avl_tree_init_arena(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena)
+{
+	if (arena == NULL)
+	{
+		return false;
+	}
+
+	if (!muggle_avl_tree_init(p_avl_tree, cmp, 0))
+	{
+		return false;
+	}
+	p_avl_tree->arena = arena;
+
+	return true;
+}
+
 void muggle_avl_tree_destroy(muggle_avl_tree_t *p_avl_tree, 
 	muggle_dsaa_data_free key_func_free, void *key_pool,
 	muggle_dsaa_data_free value_func_free, void *value_pool)
@@ -36,6 +36,7 @@ typedef struct muggle_avl_tree
 	muggle_avl_tree_node_t *root;  //!< root node of avl tree
 	muggle_dsaa_data_cmp   cmp;    //!< pointer to compare function for data
 	muggle_memory_pool_t   *pool;  //!< memory pool of tree, if it's NULL, use malloc and free by default
+	muggle_arena_t         *arena; //!< arena of tree, if it's not NULL, nodes are allocated from arena
 }muggle_avl_tree_t;
 
 /**
@@ -50,6 +51,22 @@ typedef struct muggle_avl_tree
 MUGGLE_C_EXPORT
 bool muggle_avl_tree_init(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cmp, size_t capacity);
 
+/**
+ * @brief initialize avl tree, nodes are allocated from arena
+ *
+ * @param p_avl_tree pointer to avl tree
+ * @param cmp        pointer to compare function
+ * @param arena      arena of nodes, owned by caller
+ *
+ * @return boolean
+ *
+ * @NOTE
+ *     removed nodes are not reused, their memory is released when arena
+ *     reset or rollback; avl tree must not be used after that
+ */
+MUGGLE_C_EXPORT
+bool muggle_avl_tree_init_arena(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena);
+
 /**
  * @brief destroy avl tree
  *
@@ -16,6 +16,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "muggle/c/memory/memory_pool.h"
+#include "muggle/c/memory/arena.h"
 
 EXTERN_C_BEGIN
 
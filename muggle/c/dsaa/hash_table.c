@@ -90,6 +90,22 @@ bool muggle_hash_table_init(muggle_hash_table_t *p_hash_table, size_t table_size
 	return true;
 }
 
+bool muggle_hash_table_init_arena(muggle_hash_table_t *p_hash_table, size_t table_size, func_muggle_hash hash, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena)
+{
+	if (arena == NULL)
+	{
+		return false;
+	}
+
+	if (!muggle_hash_table_init(p_hash_table, table_size, hash, cmp, 0))
+	{
+		return false;
+	}
+	p_hash_table->arena = arena;
+
+	return true;
+}
+
 void muggle_hash_table_destroy(muggle_hash_table_t *p_hash_table,
 	muggle_dsaa_data_free key_func_free, void *key_pool,
 	muggle_dsaa_data_free value_func_free, void *value_pool)
@@ -166,7 +182,11 @@ muggle_hash_table_node_t* muggle_hash_table_put(muggle_hash_table_t *p_hash_tabl
 	}
 
 	muggle_hash_table_node_t *new_node = NULL;
-	if (p_hash_table->pool)
+	if (p_hash_table->arena)
+	{
+		new_node = (muggle_hash_table_node_t*)muggle_arena_alloc(p_hash_table->arena, sizeof(muggle_hash_table_node_t));
+	}
+	else if (p_hash_table->pool)
 	{
 		new_node = (muggle_hash_table_node_t*)muggle_memory_pool_alloc(p_hash_table->pool);
 	}
@@ -231,7 +251,11 @@ void muggle_hash_table_remove(
 		next->prev = prev;
 	}
 
-	if (p_hash_table->pool)
+	if (p_hash_table->arena)
+	{
+		// node memory is released with arena
+	}
+	else if (p_hash_table->pool)
 	{
 		muggle_memory_pool_free(p_hash_table->pool, node);
 	}
@@ -38,6 +38,7 @@ typedef struct muggle_hash_table
 	func_muggle_hash         hash;        //!< pointer to hash function
 	muggle_dsaa_data_cmp     cmp;         //!< pointer to compare function
 	muggle_memory_pool_t     *pool;       //!< memory pool of tree, if it's NULL, use malloc and free by default
+	muggle_arena_t           *arena;      //!< arena of nodes, if it's not NULL, nodes are allocated from arena
 }muggle_hash_table_t;
 
 #define MUGGLE_HASH_TABLE_SIZE_10007 10007
@@ -56,6 +57,25 @@ typedef struct muggle_hash_table
 MUGGLE_C_EXPORT
 bool muggle_hash_table_init(muggle_hash_table_t *p_hash_table, size_t table_size, func_muggle_hash hash, muggle_dsaa_data_cmp cmp, size_t capacity);
 
+/**
+ * @brief initialize hash table, nodes are allocated from arena
+ *
+ * @param p_hash_table  pointer to hash table
+ * @param table_size    table size
+ * @param hash          hash function, if it's NULL, use default hash function
+ * @param cmp           compare function for key
+ * @param arena         arena of nodes, owned by caller
+ *
+ * @return boolean
+ *
+ * @NOTE
+ *     removed nodes are not reused, their memory is released when arena
+ *     reset or rollback; hash table must not be used after that, but
+ *     muggle_hash_table_destroy is still needed to free the table
+ */
+MUGGLE_C_EXPORT
+bool muggle_hash_table_init_arena(muggle_hash_table_t *p_hash_table, size_t table_size, func_muggle_hash hash, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena);
+
 // 
 MUGGLE_C_EXPORT
 /**
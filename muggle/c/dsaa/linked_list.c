@@ -16,7 +16,11 @@
 static muggle_linked_list_node_t* muggle_linked_list_allocate_node(muggle_linked_list_t *p_linked_list)
 {
 	muggle_linked_list_node_t *node = NULL;
-	if (p_linked_list->pool)
+	if (p_linked_list->arena)
+	{
+		node = (muggle_linked_list_node_t*)muggle_arena_alloc(p_linked_list->arena, sizeof(muggle_linked_list_node_t));
+	}
+	else if (p_linked_list->pool)
 	{
 		node = (muggle_linked_list_node_t*)muggle_memory_pool_alloc(p_linked_list->pool);
 	}
@@ -42,7 +46,11 @@ static void muggle_linked_list_free_node(muggle_linked_list_t *p_linked_list, mu
 	node->next->prev = node->prev;
 
 	// free node memory
-	if (p_linked_list->pool)
+	if (p_linked_list->arena)
+	{
+		// node memory is released with arena
+	}
+	else if (p_linked_list->pool)
 	{
 		muggle_memory_pool_free(p_linked_list->pool, node);
 	}
@@ -100,6 +108,22 @@ bool muggle_linked_list_init(muggle_linked_list_t *p_linked_list, size_t capacit
 	return true;
 }
 
+bool muggle_linked_list_init_arena(muggle_linked_list_t *p_linked_list, muggle_arena_t *arena)
+{
+	if (arena == NULL)
+	{
+		return false;
+	}
+
+	if (!muggle_linked_list_init(p_linked_list, 0))
+	{
+		return false;
+	}
+	p_linked_list->arena = arena;
+
+	return true;
+}
+
 void muggle_linked_list_destroy(muggle_linked_list_t *p_linked_list, muggle_dsaa_data_free func_free, void *pool)
 {
 	// clear linked list
@@ -33,6 +33,7 @@ typedef struct muggle_linked_list
 	muggle_linked_list_node_t head;   //!< head node of linked list
 	muggle_linked_list_node_t tail;   //!< tail node of linked list
 	muggle_memory_pool_t      *pool;  //!< memory pool of linked list nodes, if it's NULL, use malloc and free by default
+	muggle_arena_t            *arena; //!< arena of linked list nodes, if it's not NULL, nodes are allocated from arena
 	uint64_t                  size;   //!< number of elements in list
 }muggle_linked_list_t;
 
@@ -48,6 +49,21 @@ typedef struct muggle_linked_list
 MUGGLE_C_EXPORT
 bool muggle_linked_list_init(muggle_linked_list_t *p_linked_list, size_t capacity);
 
+/**
+ * @brief initialize linked list, nodes are allocated from arena
+ *
+ * @param p_linked_list  pointer to linked list
+ * @param arena          arena of nodes, owned by caller
+ *
+ * @return boolean
+ *
+ * @NOTE
+ *     removed nodes are not reused, their memory is released when arena
+ *     reset or rollback; linked list must not be used after that
+ */
+MUGGLE_C_EXPORT
+bool muggle_linked_list_init_arena(muggle_linked_list_t *p_linked_list, muggle_arena_t *arena);
+
 /**
  * @brief destroy linked list
  *
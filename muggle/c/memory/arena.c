@@ -0,0 +1,252 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/utils.h"
+#if MUGGLE_PLATFORM_LINUX && \
+	MUGGLE_C_HAVE_ALIGNED_ALLOC && \
+	MUGGLE_C_HAVE_MADV_HUGEPAGE
+	#include <sys/mman.h>
+	#define MUGGLE_ARENA_SUPPORT_THP 1
+#endif
+
+#define MUGGLE_ARENA_SIZE_2MB ((size_t)2 * 1024 * 1024)
+
+#define MUGGLE_ARENA_CHUNK_DATA(chunk) ((char*)((chunk) + 1))
+#define MUGGLE_ARENA_CHUNK_END(chunk) ((char*)(chunk) + (chunk)->size)
+
+static muggle_arena_chunk_t* muggle_arena_chunk_new(
+	muggle_arena_t *arena, size_t size)
+{
+	muggle_arena_chunk_t *chunk = NULL;
+
+#if MUGGLE_ARENA_SUPPORT_THP
+	if (arena->flag & MUGGLE_ARENA_THP)
+	{
+		size = MUGGLE_ROUND_UP_POW_OF_2_MUL(size, MUGGLE_ARENA_SIZE_2MB);
+		chunk = (muggle_arena_chunk_t*)aligned_alloc(MUGGLE_ARENA_SIZE_2MB, size);
+		if (chunk == NULL)
+		{
+			return NULL;
+		}
+
+		if (madvise(chunk, size, MADV_HUGEPAGE) != 0)
+		{
+			free(chunk);
+			return NULL;
+		}
+	}
+	else
+#endif
+	{
+		chunk = (muggle_arena_chunk_t*)malloc(size);
+		if (chunk == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	chunk->prev = NULL;
+	chunk->size = size;
+
+	return chunk;
+}
+
+static void muggle_arena_chunk_release(
+	muggle_arena_t *arena, muggle_arena_chunk_t *chunk)
+{
+	if (chunk->size == arena->chunk_size)
+	{
+		chunk->prev = arena->spare;
+		arena->spare = chunk;
+	}
+	else
+	{
+		// oversize chunk only serve single allocation, don't keep it
+		free(chunk);
+	}
+}
+
+static void muggle_arena_use_chunk(
+	muggle_arena_t *arena, muggle_arena_chunk_t *chunk)
+{
+	chunk->prev = arena->chunk;
+	arena->chunk = chunk;
+	arena->pos = MUGGLE_ARENA_CHUNK_DATA(chunk);
+	arena->end = MUGGLE_ARENA_CHUNK_END(chunk);
+}
+
+static bool muggle_arena_init_flag(
+	muggle_arena_t *arena, size_t chunk_size, uint32_t flag)
+{
+	memset(arena, 0, sizeof(*arena));
+
+	if (chunk_size == 0)
+	{
+		chunk_size = MUGGLE_ARENA_DEFAULT_CHUNK_SIZE;
+	}
+	if (chunk_size < sizeof(muggle_arena_chunk_t) * 2)
+	{
+		chunk_size = sizeof(muggle_arena_chunk_t) * 2;
+	}
+
+#if MUGGLE_ARENA_SUPPORT_THP
+	if (flag & MUGGLE_ARENA_THP)
+	{
+		chunk_size = MUGGLE_ROUND_UP_POW_OF_2_MUL(chunk_size, MUGGLE_ARENA_SIZE_2MB);
+	}
+#else
+	flag &= ~MUGGLE_ARENA_THP;
+#endif
+
+	arena->chunk_size = chunk_size;
+	arena->flag = flag;
+
+	// the bottom chunk is always a regular chunk and never released before
+	// destroy
+	muggle_arena_chunk_t *chunk = muggle_arena_chunk_new(arena, chunk_size);
+	if (chunk == NULL)
+	{
+		return false;
+	}
+	muggle_arena_use_chunk(arena, chunk);
+
+	return true;
+}
+
+bool muggle_arena_init(muggle_arena_t *arena, size_t chunk_size)
+{
+	return muggle_arena_init_flag(arena, chunk_size, 0);
+}
+
+bool muggle_arena_init_thp(muggle_arena_t *arena, size_t chunk_size)
+{
+	return muggle_arena_init_flag(arena, chunk_size, MUGGLE_ARENA_THP);
+}
+
+void muggle_arena_destroy(muggle_arena_t *arena)
+{
+	muggle_arena_chunk_t *lists[2] = { arena->chunk, arena->spare };
+	for (int i = 0; i < 2; i++)
+	{
+		muggle_arena_chunk_t *chunk = lists[i];
+		while (chunk)
+		{
+			muggle_arena_chunk_t *prev = chunk->prev;
+			free(chunk);
+			chunk = prev;
+		}
+	}
+
+	memset(arena, 0, sizeof(*arena));
+}
+
+void* muggle_arena_alloc(muggle_arena_t *arena, size_t n_bytes)
+{
+	return muggle_arena_alloc_aligned(arena, n_bytes, MUGGLE_ARENA_DEFAULT_ALIGN);
+}
+
+void* muggle_arena_alloc_aligned(
+	muggle_arena_t *arena, size_t n_bytes, size_t align)
+{
+	if (align == 0 || (align & (align - 1)) != 0)
+	{
+		return NULL;
+	}
+
+	char *p = (char*)MUGGLE_ROUND_UP_POW_OF_2_MUL((uintptr_t)arena->pos, align);
+	if (p <= arena->end && n_bytes <= (size_t)(arena->end - p))
+	{
+		arena->pos = p + n_bytes;
+		return p;
+	}
+
+	// current chunk is full
+	size_t head_size = sizeof(muggle_arena_chunk_t);
+	if (n_bytes > SIZE_MAX - head_size - align)
+	{
+		return NULL;
+	}
+	size_t need = head_size + n_bytes + align - 1;
+
+	muggle_arena_chunk_t *chunk = NULL;
+	if (need <= arena->chunk_size)
+	{
+		if (arena->spare)
+		{
+			chunk = arena->spare;
+			arena->spare = chunk->prev;
+		}
+		else
+		{
+			chunk = muggle_arena_chunk_new(arena, arena->chunk_size);
+		}
+	}
+	else
+	{
+		chunk = muggle_arena_chunk_new(arena, need);
+	}
+
+	if (chunk == NULL)
+	{
+		return NULL;
+	}
+	muggle_arena_use_chunk(arena, chunk);
+
+	p = (char*)MUGGLE_ROUND_UP_POW_OF_2_MUL((uintptr_t)arena->pos, align);
+	arena->pos = p + n_bytes;
+
+	return p;
+}
+
+char* muggle_arena_strndup(muggle_arena_t *arena, const char *str, size_t n)
+{
+	size_t len = 0;
+	while (len < n && str[len] != '\0')
+	{
+		len++;
+	}
+
+	char *p = (char*)muggle_arena_alloc_aligned(arena, len + 1, 1);
+	if (p == NULL)
+	{
+		return NULL;
+	}
+	memcpy(p, str, len);
+	p[len] = '\0';
+
+	return p;
+}
+
+muggle_arena_mark_t muggle_arena_save(muggle_arena_t *arena)
+{
+	muggle_arena_mark_t mark;
+	mark.chunk = arena->chunk;
+	mark.pos = arena->pos;
+	return mark;
+}
+
+void muggle_arena_rollback(muggle_arena_t *arena, muggle_arena_mark_t mark)
+{
+	while (arena->chunk != mark.chunk)
+	{
+		muggle_arena_chunk_t *chunk = arena->chunk;
+		arena->chunk = chunk->prev;
+		muggle_arena_chunk_release(arena, chunk);
+	}
+
+	arena->pos = mark.pos;
+	arena->end = MUGGLE_ARENA_CHUNK_END(arena->chunk);
+}
+
+void muggle_arena_reset(muggle_arena_t *arena)
+{
+	while (arena->chunk->prev)
+	{
+		muggle_arena_chunk_t *chunk = arena->chunk;
+		arena->chunk = chunk->prev;
+		muggle_arena_chunk_release(arena, chunk);
+	}
+
+	arena->pos = MUGGLE_ARENA_CHUNK_DATA(arena->chunk);
+	arena->end = MUGGLE_ARENA_CHUNK_END(arena->chunk);
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+ *  @file         arena.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec bump pointer arena
+ *
+ *  arena hand out memory by bumping a pointer inside the current chunk, and
+ *  chain a new chunk when current chunk is full; there is no per allocation
+ *  free, memory is released all at once by muggle_arena_reset or back to a
+ *  save point by muggle_arena_rollback, released chunks are kept and reused
+ *  by later allocations
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_ARENA_H_
+#define MUGGLE_C_ARENA_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+// arena flag
+#define MUGGLE_ARENA_THP 0x01 //!< arena chunks use THP
+
+#define MUGGLE_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024) //!< default chunk size
+#define MUGGLE_ARENA_DEFAULT_ALIGN 16 //!< default alignment of allocation
+
+/**
+ * @brief arena chunk head, data follow the head
+ */
+typedef struct muggle_arena_chunk
+{
+	struct muggle_arena_chunk *prev; //!< previous chunk
+	size_t                     size; //!< bytes of chunk, include head
+} muggle_arena_chunk_t;
+
+/**
+ * @brief bump pointer arena
+ */
+typedef struct muggle_arena
+{
+	muggle_arena_chunk_t *chunk;      //!< current chunk
+	char                 *pos;        //!< next allocation position
+	char                 *end;        //!< end of current chunk
+	muggle_arena_chunk_t *spare;      //!< released chunks wait for reuse
+	size_t                chunk_size; //!< size of regular chunk
+	uint32_t              flag;       //!< flags
+} muggle_arena_t;
+
+/**
+ * @brief save point of arena
+ */
+typedef struct muggle_arena_mark
+{
+	muggle_arena_chunk_t *chunk; //!< current chunk when save
+	char                 *pos;   //!< allocation position when save
+} muggle_arena_mark_t;
+
+/**
+ * @brief initialize arena
+ *
+ * @param arena       pointer to arena
+ * @param chunk_size  size of regular chunk, 0 means
+ *                    MUGGLE_ARENA_DEFAULT_CHUNK_SIZE
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_arena_init(muggle_arena_t *arena, size_t chunk_size);
+
+/**
+ * @brief initialize arena and use THP
+ *
+ * @param arena       pointer to arena
+ * @param chunk_size  size of regular chunk, round up to multiple of 2MB
+ *
+ * @return boolean
+ *
+ * @NOTE  this is Linux only, in other platform, equivalent to muggle_arena_init
+ */
+MUGGLE_C_EXPORT
+bool muggle_arena_init_thp(muggle_arena_t *arena, size_t chunk_size);
+
+/**
+ * @brief destroy arena, free all chunks
+ *
+ * @param arena  pointer to arena
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_destroy(muggle_arena_t *arena);
+
+/**
+ * @brief allocate memory aligned to MUGGLE_ARENA_DEFAULT_ALIGN
+ *
+ * @param arena    pointer to arena
+ * @param n_bytes  number of bytes
+ *
+ * @return on success return memory, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_arena_alloc(muggle_arena_t *arena, size_t n_bytes);
+
+/**
+ * @brief allocate aligned memory
+ *
+ * @param arena    pointer to arena
+ * @param n_bytes  number of bytes
+ * @param align    alignment, must be power of 2
+ *
+ * @return on success return memory, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_arena_alloc_aligned(
+	muggle_arena_t *arena, size_t n_bytes, size_t align);
+
+/**
+ * @brief copy string into arena
+ *
+ * @param arena  pointer to arena
+ * @param str    string
+ * @param n      max number of characters copied
+ *
+ * @return on success return null terminated copy, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+char* muggle_arena_strndup(muggle_arena_t *arena, const char *str, size_t n);
+
+/**
+ * @brief get save point of arena
+ *
+ * @param arena  pointer to arena
+ *
+ * @return save point
+ */
+MUGGLE_C_EXPORT
+muggle_arena_mark_t muggle_arena_save(muggle_arena_t *arena);
+
+/**
+ * @brief release all memory allocated after save point
+ *
+ * @param arena  pointer to arena
+ * @param mark   save point returned by muggle_arena_save
+ *
+ * @NOTE
+ *     save points taken after mark are invalid after rollback
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_rollback(muggle_arena_t *arena, muggle_arena_mark_t mark);
+
+/**
+ * @brief release all memory allocated from arena, chunks are kept for reuse
+ *
+ * @param arena  pointer to arena
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_reset(muggle_arena_t *arena);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_ARENA_H_
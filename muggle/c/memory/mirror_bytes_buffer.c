@@ -0,0 +1,316 @@
+#include "mirror_bytes_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "muggle/c/base/utils.h"
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#if MUGGLE_PLATFORM_LINUX
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+// retry times when other thread take the address space between unmap
+// and map on Windows
+#define MUGGLE_MIRROR_BYTES_BUFFER_MAP_RETRY 16
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+static size_t muggle_mirror_bytes_buffer_granularity(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwAllocationGranularity;
+}
+
+static char* muggle_mirror_bytes_buffer_map(size_t size)
+{
+	HANDLE h = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		(DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+	if (h == NULL)
+	{
+		return NULL;
+	}
+
+	char *base = NULL;
+	for (int i = 0; i < MUGGLE_MIRROR_BYTES_BUFFER_MAP_RETRY; i++)
+	{
+		// find a free address range of 2 * size, then map both views into it
+		void *p = VirtualAlloc(NULL, size * 2, MEM_RESERVE, PAGE_NOACCESS);
+		if (p == NULL)
+		{
+			break;
+		}
+		VirtualFree(p, 0, MEM_RELEASE);
+
+		void *v0 = MapViewOfFileEx(h, FILE_MAP_ALL_ACCESS, 0, 0, size, p);
+		if (v0 == NULL)
+		{
+			continue;
+		}
+
+		void *v1 = MapViewOfFileEx(h, FILE_MAP_ALL_ACCESS, 0, 0, size, (char*)p + size);
+		if (v1 == NULL)
+		{
+			UnmapViewOfFile(v0);
+			continue;
+		}
+
+		base = (char*)p;
+		break;
+	}
+
+	// views keep the mapping object alive
+	CloseHandle(h);
+
+	return base;
+}
+
+static void muggle_mirror_bytes_buffer_unmap(char *base, size_t size)
+{
+	UnmapViewOfFile(base);
+	UnmapViewOfFile(base + size);
+}
+
+#else
+
+static size_t muggle_mirror_bytes_buffer_granularity(void)
+{
+	return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static int muggle_mirror_bytes_buffer_create_fd(void)
+{
+	int fd = -1;
+
+#if MUGGLE_PLATFORM_LINUX && defined(SYS_memfd_create)
+	// 1 is MFD_CLOEXEC
+	fd = (int)syscall(SYS_memfd_create, "muggle_mirror_bytes_buffer", 1);
+	if (fd != -1)
+	{
+		return fd;
+	}
+#endif
+
+	// no memfd, use an unlinked temporary file instead
+	const char *templates[] = {
+		"/dev/shm/muggle_mirror_XXXXXX",
+		"/tmp/muggle_mirror_XXXXXX",
+	};
+	for (size_t i = 0; i < sizeof(templates) / sizeof(templates[0]); i++)
+	{
+		char path[64];
+		strncpy(path, templates[i], sizeof(path) - 1);
+		path[sizeof(path) - 1] = '\0';
+
+		fd = mkstemp(path);
+		if (fd != -1)
+		{
+			unlink(path);
+			return fd;
+		}
+	}
+
+	return -1;
+}
+
+static char* muggle_mirror_bytes_buffer_map(size_t size)
+{
+	int fd = muggle_mirror_bytes_buffer_create_fd();
+	if (fd == -1)
+	{
+		return NULL;
+	}
+
+	if (ftruncate(fd, (off_t)size) != 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	// reserve address space of 2 * size, then replace both halves by the
+	// shared mapping of fd
+	void *p = mmap(NULL, size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	char *base = (char*)p;
+	if (mmap(base, size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+		mmap(base + size, size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		munmap(base, size * 2);
+		close(fd);
+		return NULL;
+	}
+
+	// mappings keep the file alive
+	close(fd);
+
+	return base;
+}
+
+static void muggle_mirror_bytes_buffer_unmap(char *base, size_t size)
+{
+	munmap(base, size * 2);
+}
+
+#endif
+
+bool muggle_mirror_bytes_buffer_init(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int capacity)
+{
+	memset(bytes_buf, 0, sizeof(*bytes_buf));
+
+	if (capacity <= 0)
+	{
+		return false;
+	}
+
+	size_t granularity = muggle_mirror_bytes_buffer_granularity();
+	size_t size = MUGGLE_ROUND_UP_POW_OF_2_MUL((size_t)capacity, granularity);
+	if (size > (size_t)INT32_MAX)
+	{
+		return false;
+	}
+
+	char *base = muggle_mirror_bytes_buffer_map(size);
+	if (base == NULL)
+	{
+		return false;
+	}
+
+	bytes_buf->c = (int)size;
+	bytes_buf->buffer = base;
+
+	return true;
+}
+
+void muggle_mirror_bytes_buffer_destroy(muggle_mirror_bytes_buffer_t *bytes_buf)
+{
+	if (bytes_buf->buffer)
+	{
+		muggle_mirror_bytes_buffer_unmap(bytes_buf->buffer, (size_t)bytes_buf->c);
+	}
+	memset(bytes_buf, 0, sizeof(*bytes_buf));
+}
+
+int muggle_mirror_bytes_buffer_writable(muggle_mirror_bytes_buffer_t *bytes_buf)
+{
+	return bytes_buf->c - bytes_buf->n;
+}
+
+int muggle_mirror_bytes_buffer_readable(muggle_mirror_bytes_buffer_t *bytes_buf)
+{
+	return bytes_buf->n;
+}
+
+bool muggle_mirror_bytes_buffer_fetch(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, void *dst)
+{
+	if (num_bytes < 0 || num_bytes > bytes_buf->n)
+	{
+		return false;
+	}
+
+	memcpy(dst, bytes_buf->buffer + bytes_buf->r, num_bytes);
+
+	return true;
+}
+
+bool muggle_mirror_bytes_buffer_read(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, void *dst)
+{
+	if (!muggle_mirror_bytes_buffer_fetch(bytes_buf, num_bytes, dst))
+	{
+		return false;
+	}
+
+	return muggle_mirror_bytes_buffer_reader_move(bytes_buf, num_bytes);
+}
+
+bool muggle_mirror_bytes_buffer_write(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, const void *src)
+{
+	void *p = muggle_mirror_bytes_buffer_writer_fc(bytes_buf, num_bytes);
+	if (p == NULL)
+	{
+		return false;
+	}
+
+	memcpy(p, src, num_bytes);
+
+	return muggle_mirror_bytes_buffer_writer_move(bytes_buf, num_bytes);
+}
+
+void* muggle_mirror_bytes_buffer_writer_fc(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	if (num_bytes < 0 || num_bytes > bytes_buf->c - bytes_buf->n)
+	{
+		return NULL;
+	}
+
+	return bytes_buf->buffer + bytes_buf->w;
+}
+
+bool muggle_mirror_bytes_buffer_writer_move(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	if (num_bytes < 0 || num_bytes > bytes_buf->c - bytes_buf->n)
+	{
+		return false;
+	}
+
+	bytes_buf->w += num_bytes;
+	if (bytes_buf->w >= bytes_buf->c)
+	{
+		bytes_buf->w -= bytes_buf->c;
+	}
+	bytes_buf->n += num_bytes;
+
+	return true;
+}
+
+void* muggle_mirror_bytes_buffer_reader_fc(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	if (num_bytes < 0 || num_bytes > bytes_buf->n)
+	{
+		return NULL;
+	}
+
+	return bytes_buf->buffer + bytes_buf->r;
+}
+
+bool muggle_mirror_bytes_buffer_reader_move(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	if (num_bytes < 0 || num_bytes > bytes_buf->n)
+	{
+		return false;
+	}
+
+	bytes_buf->r += num_bytes;
+	if (bytes_buf->r >= bytes_buf->c)
+	{
+		bytes_buf->r -= bytes_buf->c;
+	}
+	bytes_buf->n -= num_bytes;
+
+	return true;
+}
+
+void muggle_mirror_bytes_buffer_clear(muggle_mirror_bytes_buffer_t *bytes_buf)
+{
+	bytes_buf->w = 0;
+	bytes_buf->r = 0;
+	bytes_buf->n = 0;
+}
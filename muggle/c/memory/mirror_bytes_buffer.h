@@ -0,0 +1,188 @@
+/******************************************************************************
+ *  @file         mirror_bytes_buffer.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec mirrored memory bytes buffer
+ *
+ *  mirrored bytes buffer map the same memory twice back to back, byte at
+ *  buffer[i] and buffer[i + c] are the same byte, so a region start inside
+ *  the first view and cross the wrap point is still contiguous in virtual
+ *  memory; writer_fc/reader_fc succeed for any size up to writable/readable
+ *  bytes, without the jump and tail waste of muggle_bytes_buffer_t
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_MIRROR_BYTES_BUFFER_H_
+#define MUGGLE_C_MIRROR_BYTES_BUFFER_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief mirrored memory bytes buffer
+ *
+ * use for write/read bytes of variable length, is not thread safe
+ */
+typedef struct muggle_mirror_bytes_buffer
+{
+	int c;        //!< capacity, multiple of page size
+	int w;        //!< write position, in [0, c)
+	int r;        //!< read position, in [0, c)
+	int n;        //!< number of readable bytes
+	char *buffer; //!< first view, followed by the mirror view
+}muggle_mirror_bytes_buffer_t;
+
+/**
+ * @brief initialize mirrored bytes buffer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param capacity   init capacity, round up to multiple of page size
+ *                   (allocation granularity on Windows)
+ *
+ * @return if success return true, otherwise return false
+ *
+ * @NOTE
+ *     - the whole capacity can be filled, bytes_buf->c is the real capacity
+ *     - map memory consume 2 * capacity of address space, but only capacity
+ *       of physical memory
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_init(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int capacity);
+
+/**
+ * @brief destroy mirrored bytes buffer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_mirror_bytes_buffer_destroy(muggle_mirror_bytes_buffer_t *bytes_buf);
+
+/**
+ * @brief get len of remain memory that used for write
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ *
+ * @return remain memory that used for write, it's always contiguous
+ */
+MUGGLE_C_EXPORT
+int muggle_mirror_bytes_buffer_writable(muggle_mirror_bytes_buffer_t *bytes_buf);
+
+/**
+ * @brief get len of bytes can be read
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ *
+ * @return readable len of bytes, it's always contiguous
+ */
+MUGGLE_C_EXPORT
+int muggle_mirror_bytes_buffer_readable(muggle_mirror_bytes_buffer_t *bytes_buf);
+
+/**
+ * @brief fetch bytes from mirrored bytes buffer, the readable bytes don't change
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ * @param dst        destination memory
+ *
+ * @return if readable bytes less than num_bytes, return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_fetch(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, void *dst);
+
+/**
+ * @brief read bytes from mirrored bytes buffer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ * @param dst        destination memory
+ *
+ * @return if readable bytes less than num_bytes, return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_read(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, void *dst);
+
+/**
+ * @brief write bytes into mirrored bytes buffer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ * @param src        source memory
+ *
+ * @return if writable bytes less than num_bytes, return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_write(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes, const void *src);
+
+/**
+ * @brief find contiguous memory for writer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ *
+ * @return if writable bytes less than num_bytes, return NULL, otherwise
+ *         return pointer to write position
+ *
+ * @NOTE
+ *     after write into the memory, use muggle_mirror_bytes_buffer_writer_move
+ *     to commit bytes
+ */
+MUGGLE_C_EXPORT
+void* muggle_mirror_bytes_buffer_writer_fc(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes);
+
+/**
+ * @brief move writer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ *
+ * @return if writable bytes less than num_bytes, return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_writer_move(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes);
+
+/**
+ * @brief find contiguous memory for reader
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ *
+ * @return if readable bytes less than num_bytes, return NULL, otherwise
+ *         return pointer to read position
+ */
+MUGGLE_C_EXPORT
+void* muggle_mirror_bytes_buffer_reader_fc(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes);
+
+/**
+ * @brief move reader
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ * @param num_bytes  number of bytes
+ *
+ * @return if readable bytes less than num_bytes, return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_mirror_bytes_buffer_reader_move(
+	muggle_mirror_bytes_buffer_t *bytes_buf, int num_bytes);
+
+/**
+ * @brief clear mirrored bytes buffer
+ *
+ * @param bytes_buf  pointer to mirrored bytes buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_mirror_bytes_buffer_clear(muggle_mirror_bytes_buffer_t *bytes_buf);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_MIRROR_BYTES_BUFFER_H_
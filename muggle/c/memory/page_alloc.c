@@ -0,0 +1,308 @@
+#include "page_alloc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "muggle/c/base/utils.h"
+#include "muggle/c/log/log.h"
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#if MUGGLE_PLATFORM_LINUX
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+#define MUGGLE_PAGE_ALLOC_MAGIC 0x50474D4Du
+
+#define MUGGLE_PAGE_ALLOC_HUGEPAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+// NUMA policy of mbind, see linux/mempolicy.h
+#define MUGGLE_PAGE_ALLOC_MPOL_PREFERRED 1
+#define MUGGLE_PAGE_ALLOC_MAX_NODE 1024
+
+/**
+ * @brief head of allocation, occupy a whole cache line before user memory
+ */
+typedef struct muggle_page_alloc_hdr
+{
+	union {
+		struct {
+			size_t   n_bytes; //!< bytes of allocation, include head
+			uint32_t backing; //!< options took effect
+			uint32_t magic;   //!< MUGGLE_PAGE_ALLOC_MAGIC
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+} muggle_page_alloc_hdr_t;
+
+static size_t muggle_page_alloc_page_size(void)
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwPageSize;
+#else
+	return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+static void muggle_page_alloc_touch(void *ptr, size_t n_bytes)
+{
+	size_t page_size = muggle_page_alloc_page_size();
+	volatile char *p = (volatile char*)ptr;
+	for (size_t i = 0; i < n_bytes; i += page_size)
+	{
+		p[i] = 0;
+	}
+}
+
+static void* muggle_page_alloc_heap(size_t n_bytes)
+{
+	void *p = NULL;
+	size_t total = sizeof(muggle_page_alloc_hdr_t) + n_bytes;
+#if MUGGLE_C_HAVE_ALIGNED_ALLOC
+	total = MUGGLE_ROUND_UP_POW_OF_2_MUL(total, (size_t)MUGGLE_CACHE_LINE_SIZE);
+	p = aligned_alloc(MUGGLE_CACHE_LINE_SIZE, total);
+#else
+	p = malloc(total);
+#endif
+	if (p == NULL)
+	{
+		return NULL;
+	}
+
+	muggle_page_alloc_hdr_t *hdr = (muggle_page_alloc_hdr_t*)p;
+	hdr->n_bytes = total;
+	hdr->backing = 0;
+	hdr->magic = MUGGLE_PAGE_ALLOC_MAGIC;
+	return hdr + 1;
+}
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+static void* muggle_page_alloc_map(
+	const muggle_page_alloc_attr_t *attr, size_t total, uint32_t *backing)
+{
+	void *p = NULL;
+	DWORD node = (DWORD)attr->numa_node;
+	bool use_node = attr->numa_node >= 0;
+
+	if (attr->flags & MUGGLE_PAGE_ALLOC_HUGETLB)
+	{
+		// large pages need SeLockMemoryPrivilege, fall back when refused
+		size_t large_page = GetLargePageMinimum();
+		if (large_page > 0)
+		{
+			size_t n = MUGGLE_ROUND_UP_POW_OF_2_MUL(total, large_page);
+			DWORD type = MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES;
+			p = use_node ?
+				VirtualAllocExNuma(GetCurrentProcess(), NULL, n, type, PAGE_READWRITE, node) :
+				VirtualAlloc(NULL, n, type, PAGE_READWRITE);
+			if (p)
+			{
+				total = n;
+				*backing |= MUGGLE_PAGE_ALLOC_HUGETLB;
+				if (use_node)
+				{
+					*backing |= MUGGLE_PAGE_ALLOC_NUMA;
+				}
+			}
+		}
+	}
+
+	if (p == NULL)
+	{
+		DWORD type = MEM_COMMIT | MEM_RESERVE;
+		if (use_node)
+		{
+			// node may be invalid or unavailable, fall back to any node
+			p = VirtualAllocExNuma(
+				GetCurrentProcess(), NULL, total, type, PAGE_READWRITE, node);
+			if (p)
+			{
+				*backing |= MUGGLE_PAGE_ALLOC_NUMA;
+			}
+		}
+		if (p == NULL)
+		{
+			p = VirtualAlloc(NULL, total, type, PAGE_READWRITE);
+		}
+		if (p == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	if ((attr->flags & MUGGLE_PAGE_ALLOC_LOCK) && VirtualLock(p, total))
+	{
+		*backing |= MUGGLE_PAGE_ALLOC_LOCK;
+	}
+
+	if (attr->flags & MUGGLE_PAGE_ALLOC_PREFAULT)
+	{
+		muggle_page_alloc_touch(p, total);
+		*backing |= MUGGLE_PAGE_ALLOC_PREFAULT;
+	}
+
+	muggle_page_alloc_hdr_t *hdr = (muggle_page_alloc_hdr_t*)p;
+	hdr->n_bytes = total;
+	return p;
+}
+
+static void muggle_page_alloc_unmap(void *p, size_t total)
+{
+	MUGGLE_UNUSED(total);
+	VirtualFree(p, 0, MEM_RELEASE);
+}
+
+#else
+
+static void* muggle_page_alloc_map(
+	const muggle_page_alloc_attr_t *attr, size_t total, uint32_t *backing)
+{
+	void *p = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+	if (attr->flags & MUGGLE_PAGE_ALLOC_HUGETLB)
+	{
+		// fail when hugepage pool is not reserved, fall back to THP
+		size_t n = MUGGLE_ROUND_UP_POW_OF_2_MUL(total, MUGGLE_PAGE_ALLOC_HUGEPAGE_SIZE);
+		p = mmap(NULL, n, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p != MAP_FAILED)
+		{
+			total = n;
+			*backing |= MUGGLE_PAGE_ALLOC_HUGETLB;
+		}
+	}
+#endif
+
+	if (p == MAP_FAILED)
+	{
+		p = mmap(NULL, total, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+		{
+			return NULL;
+		}
+
+#if MUGGLE_C_HAVE_MADV_HUGEPAGE
+		if ((attr->flags & (MUGGLE_PAGE_ALLOC_HUGETLB | MUGGLE_PAGE_ALLOC_THP)) &&
+			madvise(p, total, MADV_HUGEPAGE) == 0)
+		{
+			*backing |= MUGGLE_PAGE_ALLOC_THP;
+		}
+#endif
+	}
+
+	// bind before any page is touched
+#if MUGGLE_PLATFORM_LINUX && defined(SYS_mbind)
+	if (attr->numa_node >= 0 && attr->numa_node < MUGGLE_PAGE_ALLOC_MAX_NODE)
+	{
+		unsigned long mask[MUGGLE_PAGE_ALLOC_MAX_NODE / (8 * sizeof(unsigned long))];
+		memset(mask, 0, sizeof(mask));
+		mask[attr->numa_node / (8 * sizeof(unsigned long))] |=
+			1UL << (attr->numa_node % (8 * sizeof(unsigned long)));
+		if (syscall(SYS_mbind, p, total, MUGGLE_PAGE_ALLOC_MPOL_PREFERRED,
+				mask, (unsigned long)(sizeof(mask) * 8 + 1), 0) == 0)
+		{
+			*backing |= MUGGLE_PAGE_ALLOC_NUMA;
+		}
+	}
+#endif
+
+	if ((attr->flags & MUGGLE_PAGE_ALLOC_LOCK) && mlock(p, total) == 0)
+	{
+		// mlock also fault in all pages
+		*backing |= MUGGLE_PAGE_ALLOC_LOCK | MUGGLE_PAGE_ALLOC_PREFAULT;
+	}
+
+	if ((attr->flags & MUGGLE_PAGE_ALLOC_PREFAULT) &&
+		!(*backing & MUGGLE_PAGE_ALLOC_PREFAULT))
+	{
+#if MUGGLE_C_HAVE_MADV_POPULATE_WRITE
+		if (madvise(p, total, MADV_POPULATE_WRITE) != 0)
+		{
+			muggle_page_alloc_touch(p, total);
+		}
+#else
+		muggle_page_alloc_touch(p, total);
+#endif
+		*backing |= MUGGLE_PAGE_ALLOC_PREFAULT;
+	}
+
+	muggle_page_alloc_hdr_t *hdr = (muggle_page_alloc_hdr_t*)p;
+	hdr->n_bytes = total;
+	return p;
+}
+
+static void muggle_page_alloc_unmap(void *p, size_t total)
+{
+	munmap(p, total);
+}
+
+#endif
+
+void muggle_page_alloc_attr_init(muggle_page_alloc_attr_t *attr)
+{
+	attr->flags = 0;
+	attr->numa_node = MUGGLE_PAGE_ALLOC_NODE_ANY;
+}
+
+void* muggle_page_alloc(const muggle_page_alloc_attr_t *attr, size_t n_bytes)
+{
+	if (n_bytes > SIZE_MAX - MUGGLE_PAGE_ALLOC_HUGEPAGE_SIZE * 2)
+	{
+		return NULL;
+	}
+
+	if (attr == NULL || (attr->flags == 0 && attr->numa_node < 0))
+	{
+		return muggle_page_alloc_heap(n_bytes);
+	}
+
+	size_t page_size = muggle_page_alloc_page_size();
+	size_t total = MUGGLE_ROUND_UP_POW_OF_2_MUL(
+		sizeof(muggle_page_alloc_hdr_t) + n_bytes, page_size);
+
+	uint32_t backing = MUGGLE_PAGE_ALLOC_MAPPED;
+	muggle_page_alloc_hdr_t *hdr =
+		(muggle_page_alloc_hdr_t*)muggle_page_alloc_map(attr, total, &backing);
+	if (hdr == NULL)
+	{
+		return NULL;
+	}
+	hdr->backing = backing;
+	hdr->magic = MUGGLE_PAGE_ALLOC_MAGIC;
+
+	return hdr + 1;
+}
+
+void muggle_page_free(void *ptr)
+{
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	muggle_page_alloc_hdr_t *hdr = (muggle_page_alloc_hdr_t*)ptr - 1;
+	MUGGLE_ASSERT(hdr->magic == MUGGLE_PAGE_ALLOC_MAGIC);
+	hdr->magic = 0;
+
+	if (hdr->backing & MUGGLE_PAGE_ALLOC_MAPPED)
+	{
+		muggle_page_alloc_unmap(hdr, hdr->n_bytes);
+	}
+	else
+	{
+		free(hdr);
+	}
+}
+
+uint32_t muggle_page_alloc_backing(void *ptr)
+{
+	muggle_page_alloc_hdr_t *hdr = (muggle_page_alloc_hdr_t*)ptr - 1;
+	return hdr->backing;
+}
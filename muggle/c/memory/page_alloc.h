@@ -0,0 +1,93 @@
+/******************************************************************************
+ *  @file         page_alloc.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec page allocation backend
+ *
+ *  page allocation backend map large buffers of rings, channels and pools
+ *  directly from system, so they can be backed by hugepages, placed on a
+ *  chosen NUMA node, locked in memory and prefaulted before hot path touch
+ *  them; every option is best effort, when an option is not supported by
+ *  platform or refused by system, allocation fall back and still succeed,
+ *  use muggle_page_alloc_backing to see which options took effect
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_PAGE_ALLOC_H_
+#define MUGGLE_C_PAGE_ALLOC_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdint.h>
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+// page allocation flags
+#define MUGGLE_PAGE_ALLOC_HUGETLB   0x01 //!< explicit hugepages (MAP_HUGETLB), fall back to THP
+#define MUGGLE_PAGE_ALLOC_THP       0x02 //!< transparent hugepages (MADV_HUGEPAGE)
+#define MUGGLE_PAGE_ALLOC_LOCK      0x04 //!< lock pages in memory
+#define MUGGLE_PAGE_ALLOC_PREFAULT  0x08 //!< fault in all pages at allocation
+#define MUGGLE_PAGE_ALLOC_NUMA      0x10 //!< placed on numa_node (backing only)
+#define MUGGLE_PAGE_ALLOC_MAPPED    0x20 //!< mapped from system (backing only)
+
+#define MUGGLE_PAGE_ALLOC_NODE_ANY -1 //!< no NUMA node preference
+
+/**
+ * @brief page allocation attributes
+ */
+typedef struct muggle_page_alloc_attr
+{
+	uint32_t flags;     //!< MUGGLE_PAGE_ALLOC_* flags
+	int      numa_node; //!< preferred NUMA node, or MUGGLE_PAGE_ALLOC_NODE_ANY
+} muggle_page_alloc_attr_t;
+
+/**
+ * @brief initialize page allocation attributes with no options
+ *
+ * @param attr  pointer to attributes
+ */
+MUGGLE_C_EXPORT
+void muggle_page_alloc_attr_init(muggle_page_alloc_attr_t *attr);
+
+/**
+ * @brief allocate memory, aligned to cache line
+ *
+ * @param attr     allocation attributes, NULL or no options means allocate
+ *                 from heap
+ * @param n_bytes  number of bytes
+ *
+ * @return on success return memory, otherwise return NULL
+ *
+ * @NOTE
+ *     - when NUMA node is set, memory is bound to the node with preferred
+ *       policy (mbind on Linux, VirtualAllocExNuma on Windows); if binding
+ *       is not available, pages are placed on the node of the thread which
+ *       touch them first, so prefault in a thread running on that node
+ *     - content of memory is undefined
+ */
+MUGGLE_C_EXPORT
+void* muggle_page_alloc(const muggle_page_alloc_attr_t *attr, size_t n_bytes);
+
+/**
+ * @brief free memory allocated by muggle_page_alloc
+ *
+ * @param ptr  memory, do nothing if it's NULL
+ */
+MUGGLE_C_EXPORT
+void muggle_page_free(void *ptr);
+
+/**
+ * @brief get options which took effect for memory
+ *
+ * @param ptr  memory allocated by muggle_page_alloc
+ *
+ * @return MUGGLE_PAGE_ALLOC_* flags, 0 means memory is from heap
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_page_alloc_backing(void *ptr);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_PAGE_ALLOC_H_
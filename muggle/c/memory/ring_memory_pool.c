@@ -8,6 +8,14 @@
 int muggle_ring_memory_pool_init(muggle_ring_memory_pool_t *pool,
 								 muggle_sync_t capacity,
 								 muggle_sync_t data_size)
+{
+	return muggle_ring_memory_pool_init_attr(pool, capacity, data_size, NULL);
+}
+
+int muggle_ring_memory_pool_init_attr(muggle_ring_memory_pool_t *pool,
+									  muggle_sync_t capacity,
+									  muggle_sync_t data_size,
+									  const muggle_page_alloc_attr_t *attr)
 {
 	memset(pool, 0, sizeof(*pool));
 	if (capacity < 2) {
@@ -29,7 +37,7 @@ int muggle_ring_memory_pool_init(muggle_ring_memory_pool_t *pool,
 		muggle_next_pow_of_2(data_size + sizeof(muggle_ring_mpool_block_head_t));
 	pool->alloc_idx = 0;
 
-	pool->blocks = malloc(pool->block_size * pool->capacity);
+	pool->blocks = muggle_page_alloc(attr, pool->block_size * pool->capacity);
 	if (pool->blocks == NULL) {
 		return MUGGLE_ERR_MEM_ALLOC;
 	}
@@ -49,7 +57,7 @@ int muggle_ring_memory_pool_init(muggle_ring_memory_pool_t *pool,
 
 void muggle_ring_memory_pool_destroy(muggle_ring_memory_pool_t *pool)
 {
-	free(pool->blocks);
+	muggle_page_free(pool->blocks);
 }
 
 void *muggle_ring_memory_pool_alloc(muggle_ring_memory_pool_t *pool)
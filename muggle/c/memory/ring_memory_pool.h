@@ -13,6 +13,7 @@
 
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/memory/page_alloc.h"
 #include "muggle/c/sync/sync_obj.h"
 
 EXTERN_C_BEGIN
@@ -58,6 +59,24 @@ int muggle_ring_memory_pool_init(muggle_ring_memory_pool_t *pool,
 								 muggle_sync_t capacity,
 								 muggle_sync_t data_size);
 
+/**
+ * @brief initialize ring memory pool with page allocation attributes
+ *
+ * @param pool       ring memory pool
+ * @param capacity   init capacity
+ * @param data_size  memory data size
+ * @param attr       page allocation attributes of blocks, NULL means heap
+ *
+ * @return
+ *     - on success, return 0
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_memory_pool_init_attr(muggle_ring_memory_pool_t *pool,
+									  muggle_sync_t capacity,
+									  muggle_sync_t data_size,
+									  const muggle_page_alloc_attr_t *attr);
+
 /**
  * @brief destroy ring memory pool
  *
@@ -0,0 +1,528 @@
+#include "slab_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+// class index stored in the 4 bytes just before user memory
+#define MUGGLE_SLAB_CLASS_LARGE    0xFFFFFFFFu //!< mapped from system
+#define MUGGLE_SLAB_CLASS_FALLBACK 0xFFFFFFFEu //!< class pool exhausted
+
+// user memory alignment
+#define MUGGLE_SLAB_ALIGN 16
+
+// header of large and fallback allocation, 16 bytes, class index at the end
+typedef struct muggle_slab_large_hdr
+{
+	uint64_t n_bytes;   //!< mapped bytes
+	uint32_t reserved;
+	uint32_t class_idx; //!< MUGGLE_SLAB_CLASS_LARGE or FALLBACK
+} muggle_slab_large_hdr_t;
+
+// ts pool data follows muggle_ts_memory_pool_head_t, header fill the gap to
+// next 16 bytes boundary
+#define MUGGLE_TS_SLAB_HDR_SIZE \
+	(MUGGLE_SLAB_ALIGN - sizeof(muggle_ts_memory_pool_head_t) % MUGGLE_SLAB_ALIGN)
+
+enum
+{
+	MUGGLE_TS_SLAB_CLASS_UNINIT = 0,
+	MUGGLE_TS_SLAB_CLASS_INITIALIZING,
+	MUGGLE_TS_SLAB_CLASS_READY,
+	MUGGLE_TS_SLAB_CLASS_FAILED,
+};
+
+/***************** size classes *****************/
+
+static uint32_t muggle_slab_log2_floor(uint32_t x)
+{
+#if defined(_MSC_VER)
+	unsigned long idx = 0;
+	_BitScanReverse(&idx, x);
+	return (uint32_t)idx;
+#elif defined(__GNUC__) || defined(__clang__)
+	return 31 - (uint32_t)__builtin_clz(x);
+#else
+	uint32_t r = 0;
+	while (x >>= 1)
+	{
+		r++;
+	}
+	return r;
+#endif
+}
+
+static uint32_t muggle_slab_class_idx(size_t n_bytes)
+{
+	if (n_bytes <= 64)
+	{
+		// 16, 32, 48, 64
+		return n_bytes == 0 ? 0 : (uint32_t)((n_bytes - 1) >> 4);
+	}
+
+	// 4 classes in (2^lg, 2^(lg+1)], lg >= 6
+	uint32_t x = (uint32_t)n_bytes - 1;
+	uint32_t lg = muggle_slab_log2_floor(x);
+	return 4 + (lg - 6) * 4 + ((x >> (lg - 2)) - 4);
+}
+
+static int muggle_slab_classes_init(muggle_slab_classes_t *classes, uint32_t max_size)
+{
+	if (max_size == 0)
+	{
+		max_size = MUGGLE_SLAB_DEFAULT_MAX_SIZE;
+	}
+	if (max_size < MUGGLE_SLAB_MIN_SIZE || max_size > MUGGLE_SLAB_MAX_SIZE)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	classes->n_class = muggle_slab_class_idx(max_size) + 1;
+	for (uint32_t i = 0; i < classes->n_class; i++)
+	{
+		if (i < 4)
+		{
+			classes->sizes[i] = (i + 1) * 16;
+		}
+		else
+		{
+			uint32_t lg = 6 + (i - 4) / 4;
+			uint32_t k = (i - 4) % 4 + 1;
+			classes->sizes[i] = (1u << lg) + k * (1u << (lg - 2));
+		}
+	}
+
+	return 0;
+}
+
+/***************** large allocation *****************/
+
+static void* muggle_slab_large_alloc(size_t n_bytes)
+{
+	size_t total = sizeof(muggle_slab_large_hdr_t) + n_bytes;
+	if (total < n_bytes)
+	{
+		return NULL;
+	}
+
+#if MUGGLE_PLATFORM_WINDOWS
+	void *p = VirtualAlloc(NULL, total, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+	if (p == NULL)
+	{
+		return NULL;
+	}
+#else
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	total = (total + page_size - 1) / page_size * page_size;
+	void *p = mmap(NULL, total, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+	{
+		return NULL;
+	}
+#endif
+
+	muggle_slab_large_hdr_t *hdr = (muggle_slab_large_hdr_t*)p;
+	hdr->n_bytes = (uint64_t)total;
+	hdr->class_idx = MUGGLE_SLAB_CLASS_LARGE;
+	return hdr + 1;
+}
+
+static void muggle_slab_large_free(void *ptr)
+{
+	muggle_slab_large_hdr_t *hdr = (muggle_slab_large_hdr_t*)ptr - 1;
+#if MUGGLE_PLATFORM_WINDOWS
+	VirtualFree(hdr, 0, MEM_RELEASE);
+#else
+	munmap(hdr, (size_t)hdr->n_bytes);
+#endif
+}
+
+static void* muggle_slab_fallback_alloc(size_t n_bytes)
+{
+	muggle_slab_large_hdr_t *hdr = (muggle_slab_large_hdr_t*)malloc(
+		sizeof(muggle_slab_large_hdr_t) + n_bytes);
+	if (hdr == NULL)
+	{
+		return NULL;
+	}
+	hdr->n_bytes = (uint64_t)n_bytes;
+	hdr->class_idx = MUGGLE_SLAB_CLASS_FALLBACK;
+	return hdr + 1;
+}
+
+static void muggle_slab_fallback_free(void *ptr)
+{
+	free((muggle_slab_large_hdr_t*)ptr - 1);
+}
+
+static uint32_t muggle_slab_ptr_class(void *ptr)
+{
+	return ((uint32_t*)ptr)[-1];
+}
+
+/***************** single thread slab allocator *****************/
+
+int muggle_slab_allocator_init(
+	muggle_slab_allocator_t *slab, uint32_t max_size, uint32_t init_capacity)
+{
+	memset(slab, 0, sizeof(*slab));
+
+	int ret = muggle_slab_classes_init(&slab->classes, max_size);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	uint32_t n_class = slab->classes.n_class;
+	slab->pools = (muggle_memory_pool_t*)calloc(
+		n_class, sizeof(muggle_memory_pool_t));
+	slab->free_lists = (void**)calloc(n_class, sizeof(void*));
+	slab->stats = (muggle_slab_class_stats_t*)calloc(
+		n_class + 1, sizeof(muggle_slab_class_stats_t));
+	if (slab->pools == NULL || slab->free_lists == NULL || slab->stats == NULL)
+	{
+		muggle_slab_allocator_destroy(slab);
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	for (uint32_t i = 0; i < n_class; i++)
+	{
+		// header keeps user memory 16 bytes aligned
+		uint32_t block_size = MUGGLE_SLAB_ALIGN + slab->classes.sizes[i];
+		if (!muggle_memory_pool_init(&slab->pools[i], init_capacity, block_size))
+		{
+			muggle_slab_allocator_destroy(slab);
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		slab->stats[i].size = slab->classes.sizes[i];
+	}
+
+	return 0;
+}
+
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *slab)
+{
+	if (slab->pools)
+	{
+		for (uint32_t i = 0; i < slab->classes.n_class; i++)
+		{
+			if (slab->pools[i].block_size)
+			{
+				muggle_memory_pool_destroy(&slab->pools[i]);
+			}
+		}
+		free(slab->pools);
+		slab->pools = NULL;
+	}
+
+	if (slab->free_lists)
+	{
+		free(slab->free_lists);
+		slab->free_lists = NULL;
+	}
+
+	if (slab->stats)
+	{
+		free(slab->stats);
+		slab->stats = NULL;
+	}
+}
+
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *slab, size_t n_bytes)
+{
+	if (n_bytes > slab->classes.sizes[slab->classes.n_class - 1])
+	{
+		muggle_slab_class_stats_t *stats = &slab->stats[slab->classes.n_class];
+		void *ptr = muggle_slab_large_alloc(n_bytes);
+		if (ptr)
+		{
+			stats->n_alloc++;
+			if (stats->n_alloc - stats->n_free > stats->peak)
+			{
+				stats->peak = stats->n_alloc - stats->n_free;
+			}
+		}
+		return ptr;
+	}
+
+	uint32_t idx = muggle_slab_class_idx(n_bytes);
+	char *block = (char*)slab->free_lists[idx];
+	if (block)
+	{
+		slab->free_lists[idx] = *(void**)block;
+	}
+	else
+	{
+		block = (char*)muggle_memory_pool_alloc(&slab->pools[idx]);
+		if (block == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	muggle_slab_class_stats_t *stats = &slab->stats[idx];
+	stats->n_alloc++;
+	if (stats->n_alloc - stats->n_free > stats->peak)
+	{
+		stats->peak = stats->n_alloc - stats->n_free;
+	}
+
+	char *ptr = block + MUGGLE_SLAB_ALIGN;
+	((uint32_t*)ptr)[-1] = idx;
+	return ptr;
+}
+
+void muggle_slab_allocator_free(muggle_slab_allocator_t *slab, void *ptr)
+{
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	uint32_t idx = muggle_slab_ptr_class(ptr);
+	if (idx == MUGGLE_SLAB_CLASS_LARGE)
+	{
+		slab->stats[slab->classes.n_class].n_free++;
+		muggle_slab_large_free(ptr);
+		return;
+	}
+
+	slab->stats[idx].n_free++;
+
+	// blocks are returned to pool when destroy
+	void **block = (void**)((char*)ptr - MUGGLE_SLAB_ALIGN);
+	*block = slab->free_lists[idx];
+	slab->free_lists[idx] = block;
+}
+
+bool muggle_slab_allocator_get_stats(
+	muggle_slab_allocator_t *slab, uint32_t idx,
+	muggle_slab_class_stats_t *stats)
+{
+	if (idx > slab->classes.n_class)
+	{
+		return false;
+	}
+	*stats = slab->stats[idx];
+	return true;
+}
+
+/***************** thread safe slab allocator *****************/
+
+static muggle_ts_memory_pool_t* muggle_ts_slab_class_pool(
+	muggle_ts_slab_allocator_t *slab, uint32_t idx)
+{
+	muggle_ts_slab_class_t *c = &slab->slab_classes[idx];
+
+	muggle_atomic_int status =
+		muggle_atomic_load(&c->status, muggle_memory_order_acquire);
+	while (status != MUGGLE_TS_SLAB_CLASS_READY)
+	{
+		if (status == MUGGLE_TS_SLAB_CLASS_FAILED)
+		{
+			return NULL;
+		}
+
+		if (status == MUGGLE_TS_SLAB_CLASS_UNINIT &&
+			muggle_atomic_cmp_exch_strong(
+				&c->status, &status, MUGGLE_TS_SLAB_CLASS_INITIALIZING,
+				muggle_memory_order_acq_rel))
+		{
+			uint32_t size = slab->classes.sizes[idx];
+			uint32_t capacity = slab->bytes_per_class / size;
+			if (capacity < 8)
+			{
+				capacity = 8;
+			}
+
+			status = MUGGLE_TS_SLAB_CLASS_FAILED;
+			c->pool = (muggle_ts_memory_pool_t*)malloc(sizeof(muggle_ts_memory_pool_t));
+			if (c->pool)
+			{
+				if (muggle_ts_memory_pool_init(
+						c->pool, capacity,
+						(muggle_sync_t)(MUGGLE_TS_SLAB_HDR_SIZE + size)) == 0)
+				{
+					muggle_ts_memory_pool_set_magazine(c->pool, slab->magazine_size);
+					status = MUGGLE_TS_SLAB_CLASS_READY;
+				}
+				else
+				{
+					free(c->pool);
+					c->pool = NULL;
+				}
+			}
+			muggle_atomic_store(&c->status, status, muggle_memory_order_release);
+			continue;
+		}
+
+		// other thread is creating pool
+		muggle_thread_yield();
+		status = muggle_atomic_load(&c->status, muggle_memory_order_acquire);
+	}
+
+	return c->pool;
+}
+
+int muggle_ts_slab_allocator_init(
+	muggle_ts_slab_allocator_t *slab, uint32_t max_size,
+	uint32_t bytes_per_class, uint32_t magazine_size)
+{
+	memset(slab, 0, sizeof(*slab));
+
+	int ret = muggle_slab_classes_init(&slab->classes, max_size);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	slab->bytes_per_class = bytes_per_class;
+	slab->magazine_size = magazine_size;
+
+	size_t n = (size_t)slab->classes.n_class + 1;
+#if MUGGLE_C_HAVE_ALIGNED_ALLOC
+	slab->slab_classes = (muggle_ts_slab_class_t*)aligned_alloc(
+		MUGGLE_CACHE_LINE_SIZE, sizeof(muggle_ts_slab_class_t) * n);
+#else
+	slab->slab_classes = (muggle_ts_slab_class_t*)malloc(
+		sizeof(muggle_ts_slab_class_t) * n);
+#endif
+	if (slab->slab_classes == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	memset(slab->slab_classes, 0, sizeof(muggle_ts_slab_class_t) * n);
+
+	return 0;
+}
+
+void muggle_ts_slab_allocator_destroy(muggle_ts_slab_allocator_t *slab)
+{
+	if (slab->slab_classes == NULL)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < slab->classes.n_class; i++)
+	{
+		muggle_ts_slab_class_t *c = &slab->slab_classes[i];
+		if (c->pool)
+		{
+			muggle_ts_memory_pool_destroy(c->pool);
+			free(c->pool);
+			c->pool = NULL;
+		}
+	}
+
+	free(slab->slab_classes);
+	slab->slab_classes = NULL;
+}
+
+void* muggle_ts_slab_allocator_alloc(
+	muggle_ts_slab_allocator_t *slab, size_t n_bytes)
+{
+	if (n_bytes > slab->classes.sizes[slab->classes.n_class - 1])
+	{
+		void *ptr = muggle_slab_large_alloc(n_bytes);
+		if (ptr)
+		{
+			muggle_atomic_fetch_add64(
+				&slab->slab_classes[slab->classes.n_class].n_alloc, 1,
+				muggle_memory_order_relaxed);
+		}
+		return ptr;
+	}
+
+	uint32_t idx = muggle_slab_class_idx(n_bytes);
+	muggle_ts_slab_class_t *c = &slab->slab_classes[idx];
+
+	char *data = NULL;
+	muggle_ts_memory_pool_t *pool = muggle_ts_slab_class_pool(slab, idx);
+	if (pool)
+	{
+		data = (char*)muggle_ts_memory_pool_alloc(pool);
+	}
+
+	char *ptr = NULL;
+	if (data)
+	{
+		ptr = data + MUGGLE_TS_SLAB_HDR_SIZE;
+		((uint32_t*)ptr)[-1] = idx;
+	}
+	else
+	{
+		ptr = (char*)muggle_slab_fallback_alloc(slab->classes.sizes[idx]);
+		if (ptr == NULL)
+		{
+			return NULL;
+		}
+		muggle_atomic_fetch_add64(&c->n_fallback, 1, muggle_memory_order_relaxed);
+	}
+
+	muggle_atomic_fetch_add64(&c->n_alloc, 1, muggle_memory_order_relaxed);
+
+	return ptr;
+}
+
+void muggle_ts_slab_allocator_free(muggle_ts_slab_allocator_t *slab, void *ptr)
+{
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	uint32_t idx = muggle_slab_ptr_class(ptr);
+	if (idx == MUGGLE_SLAB_CLASS_LARGE)
+	{
+		muggle_atomic_fetch_add64(
+			&slab->slab_classes[slab->classes.n_class].n_free, 1,
+			muggle_memory_order_relaxed);
+		muggle_slab_large_free(ptr);
+		return;
+	}
+
+	if (idx == MUGGLE_SLAB_CLASS_FALLBACK)
+	{
+		// fallback block size tell which class it belongs to
+		muggle_slab_large_hdr_t *hdr = (muggle_slab_large_hdr_t*)ptr - 1;
+		idx = muggle_slab_class_idx((size_t)hdr->n_bytes);
+		muggle_slab_fallback_free(ptr);
+	}
+	else
+	{
+		muggle_ts_memory_pool_free((char*)ptr - MUGGLE_TS_SLAB_HDR_SIZE);
+	}
+
+	muggle_atomic_fetch_add64(
+		&slab->slab_classes[idx].n_free, 1, muggle_memory_order_relaxed);
+}
+
+bool muggle_ts_slab_allocator_get_stats(
+	muggle_ts_slab_allocator_t *slab, uint32_t idx,
+	muggle_slab_class_stats_t *stats)
+{
+	if (idx > slab->classes.n_class)
+	{
+		return false;
+	}
+
+	muggle_ts_slab_class_t *c = &slab->slab_classes[idx];
+	memset(stats, 0, sizeof(*stats));
+	stats->size = idx < slab->classes.n_class ? slab->classes.sizes[idx] : 0;
+	stats->n_alloc = (uint64_t)muggle_atomic_fetch_add64(
+		&c->n_alloc, 0, muggle_memory_order_relaxed);
+	stats->n_free = (uint64_t)muggle_atomic_fetch_add64(
+		&c->n_free, 0, muggle_memory_order_relaxed);
+	stats->n_fallback = (uint64_t)muggle_atomic_fetch_add64(
+		&c->n_fallback, 0, muggle_memory_order_relaxed);
+
+	return true;
+}
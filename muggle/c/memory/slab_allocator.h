@@ -0,0 +1,231 @@
+/******************************************************************************
+ *  @file         slab_allocator.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec multi size class slab allocator
+ *
+ *  slab allocator round request size up to a size class and serve it from
+ *  the fixed size pool of that class; classes are 16, 32, 48, 64, then 4
+ *  classes per power of two (e.g. 80, 96, 112, 128, 160, ...), so waste of
+ *  a block is at most 25%; requests larger than max size are mapped from
+ *  system directly
+ *
+ *  - muggle_slab_allocator_t: single thread, classes are muggle_memory_pool_t
+ *  - muggle_ts_slab_allocator_t: thread safe, classes are
+ *    muggle_ts_memory_pool_t
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SLAB_ALLOCATOR_H_
+#define MUGGLE_C_SLAB_ALLOCATOR_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/memory/memory_pool.h"
+#include "muggle/c/memory/threadsafe_memory_pool.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_SLAB_MIN_SIZE 16 //!< minimum size class
+#define MUGGLE_SLAB_DEFAULT_MAX_SIZE (64 * 1024) //!< default max size class
+#define MUGGLE_SLAB_MAX_SIZE (16 * 1024 * 1024) //!< upper limit of max size
+#define MUGGLE_SLAB_MAX_N_CLASS 80 //!< upper limit of number of classes
+
+/**
+ * @brief size classes
+ */
+typedef struct muggle_slab_classes
+{
+	uint32_t n_class;                        //!< number of classes
+	uint32_t sizes[MUGGLE_SLAB_MAX_N_CLASS]; //!< size of each class
+} muggle_slab_classes_t;
+
+/**
+ * @brief statistics of one size class
+ */
+typedef struct muggle_slab_class_stats
+{
+	uint32_t size;       //!< class size, 0 for large allocations
+	uint64_t n_alloc;    //!< number of allocations
+	uint64_t n_free;     //!< number of frees
+	uint64_t n_fallback; //!< allocations served by system allocator
+	uint64_t peak;       //!< max number of blocks in use (single thread only)
+} muggle_slab_class_stats_t;
+
+/**
+ * @brief single thread slab allocator
+ */
+typedef struct muggle_slab_allocator
+{
+	muggle_slab_classes_t      classes;    //!< size classes
+	muggle_memory_pool_t      *pools;      //!< pool of each class
+	void                     **free_lists; //!< LIFO freed blocks of each class
+	muggle_slab_class_stats_t *stats;      //!< stats of each class and large
+} muggle_slab_allocator_t;
+
+/**
+ * @brief class of thread safe slab allocator
+ */
+typedef struct muggle_ts_slab_class
+{
+	union {
+		struct {
+			muggle_atomic_int       status;   //!< pool initialize status
+			muggle_ts_memory_pool_t *pool;    //!< pool of class
+			muggle_atomic_int64     n_alloc;  //!< number of allocations
+			muggle_atomic_int64     n_free;   //!< number of frees
+			muggle_atomic_int64     n_fallback; //!< system allocations
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+} muggle_ts_slab_class_t;
+
+/**
+ * @brief thread safe slab allocator
+ */
+typedef struct muggle_ts_slab_allocator
+{
+	muggle_slab_classes_t   classes;         //!< size classes
+	uint32_t                bytes_per_class; //!< memory budget of each class
+	uint32_t                magazine_size;   //!< magazine size of class pool
+	muggle_ts_slab_class_t *slab_classes;    //!< classes and large
+} muggle_ts_slab_allocator_t;
+
+/**
+ * @brief initialize single thread slab allocator
+ *
+ * @param slab           pointer to slab allocator
+ * @param max_size       max size class, 0 means MUGGLE_SLAB_DEFAULT_MAX_SIZE
+ * @param init_capacity  initial capacity of every class pool, class pools
+ *                       grow automatically
+ *
+ * @NOTE
+ *     freed blocks are kept in a LIFO list of the class and reused first,
+ *     so recently touched memory is handed out again while it is still hot
+ *     in cache
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_init(
+	muggle_slab_allocator_t *slab, uint32_t max_size, uint32_t init_capacity);
+
+/**
+ * @brief destroy single thread slab allocator
+ *
+ * @param slab  pointer to slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *slab);
+
+/**
+ * @brief allocate memory, aligned to 16 bytes
+ *
+ * @param slab    pointer to slab allocator
+ * @param n_bytes number of bytes
+ *
+ * @return on success return memory, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *slab, size_t n_bytes);
+
+/**
+ * @brief free memory allocated by muggle_slab_allocator_alloc
+ *
+ * @param slab  pointer to slab allocator
+ * @param ptr   memory
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_free(muggle_slab_allocator_t *slab, void *ptr);
+
+/**
+ * @brief get statistics of class
+ *
+ * @param slab   pointer to slab allocator
+ * @param idx    class index, index n_class means large allocations
+ * @param stats  output statistics
+ *
+ * @return false if idx is out of range
+ */
+MUGGLE_C_EXPORT
+bool muggle_slab_allocator_get_stats(
+	muggle_slab_allocator_t *slab, uint32_t idx,
+	muggle_slab_class_stats_t *stats);
+
+/**
+ * @brief initialize thread safe slab allocator
+ *
+ * @param slab             pointer to slab allocator
+ * @param max_size         max size class, 0 means MUGGLE_SLAB_DEFAULT_MAX_SIZE
+ * @param bytes_per_class  memory budget of every class pool, the capacity
+ *                         of class pool is bytes_per_class / class size
+ *                         (at least 8); when class pool is exhausted,
+ *                         allocations fall back to system allocator
+ * @param magazine_size    magazine size of class pools, 0 means disable,
+ *                         see muggle_ts_memory_pool_set_magazine
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *     class pools are created on first use
+ */
+MUGGLE_C_EXPORT
+int muggle_ts_slab_allocator_init(
+	muggle_ts_slab_allocator_t *slab, uint32_t max_size,
+	uint32_t bytes_per_class, uint32_t magazine_size);
+
+/**
+ * @brief destroy thread safe slab allocator
+ *
+ * @param slab  pointer to slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_ts_slab_allocator_destroy(muggle_ts_slab_allocator_t *slab);
+
+/**
+ * @brief allocate memory, aligned to 16 bytes
+ *
+ * @param slab    pointer to slab allocator
+ * @param n_bytes number of bytes
+ *
+ * @return on success return memory, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_ts_slab_allocator_alloc(
+	muggle_ts_slab_allocator_t *slab, size_t n_bytes);
+
+/**
+ * @brief free memory allocated by muggle_ts_slab_allocator_alloc
+ *
+ * @param slab  pointer to slab allocator
+ * @param ptr   memory
+ */
+MUGGLE_C_EXPORT
+void muggle_ts_slab_allocator_free(muggle_ts_slab_allocator_t *slab, void *ptr);
+
+/**
+ * @brief get statistics of class
+ *
+ * @param slab   pointer to slab allocator
+ * @param idx    class index, index n_class means large allocations
+ * @param stats  output statistics
+ *
+ * @return false if idx is out of range
+ */
+MUGGLE_C_EXPORT
+bool muggle_ts_slab_allocator_get_stats(
+	muggle_ts_slab_allocator_t *slab, uint32_t idx,
+	muggle_slab_class_stats_t *stats);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SLAB_ALLOCATOR_H_
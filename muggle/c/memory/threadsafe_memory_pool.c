@@ -10,11 +10,23 @@
  
 #include "threadsafe_memory_pool.h"
 #include <stdlib.h>
+#include <string.h>
 #include "muggle/c/base/err.h"
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/atomic.h"
+#include "muggle/c/base/thread.h"
+
+// magazines of current thread, one for each pool used by the thread
+static muggle_thread_local muggle_ts_memory_pool_magazine_t *s_ts_memory_pool_magazines = NULL;
 
 int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_sync_t capacity, muggle_sync_t data_size)
+{
+	return muggle_ts_memory_pool_init_attr(pool, capacity, data_size, NULL);
+}
+
+int muggle_ts_memory_pool_init_attr(
+	muggle_ts_memory_pool_t *pool, muggle_sync_t capacity, muggle_sync_t data_size,
+	const muggle_page_alloc_attr_t *attr)
 {
 	if (capacity <= 0)
 	{
@@ -42,18 +54,14 @@ int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_sync_t capa
 
 	pool->capacity = capacity;
 	pool->block_size = block_size;
+	pool->magazine_size = 0;
 
 	size_t total_bytes = (size_t)capacity * (size_t)block_size;
-#if MUGGLE_C_HAVE_ALIGNED_ALLOC
-	pool->data = aligned_alloc(MUGGLE_CACHE_LINE_SIZE, total_bytes);
-	pool->ptrs = (muggle_ts_memory_pool_head_ptr_t*)aligned_alloc(
-			MUGGLE_CACHE_LINE_SIZE,
-			capacity * sizeof(muggle_ts_memory_pool_head_ptr_t));
-#else
-	pool->data = malloc(total_bytes);
-	pool->ptrs = (muggle_ts_memory_pool_head_ptr_t*)malloc(
-			capacity * sizeof(muggle_ts_memory_pool_head_ptr_t));
-#endif
+	pool->data = muggle_page_alloc(attr, total_bytes);
+	// index array is small, keep it in heap instead of hugepages or locked
+	// pages
+	pool->ptrs = (muggle_ts_memory_pool_head_ptr_t*)muggle_page_alloc(
+			NULL, capacity * sizeof(muggle_ts_memory_pool_head_ptr_t));
 	pool->alloc_idx = 0;
 	pool->cached_free_pos = 0;
 	pool->free_idx = 0;
@@ -62,15 +70,8 @@ int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_sync_t capa
 
 	if (pool->data == NULL || pool->ptrs == NULL)
 	{
-		if (pool->data)
-		{
-			free(pool->data);
-		}
-
-		if (pool->ptrs)
-		{
-			free(pool->ptrs);
-		}
+		muggle_page_free(pool->data);
+		muggle_page_free(pool->ptrs);
 
 		return MUGGLE_ERR_MEM_ALLOC;
 	}
@@ -86,40 +87,181 @@ int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_sync_t capa
 	return MUGGLE_OK;
 }
 
+/**
+ * @brief allocate at most n blocks from shared ring with one CAS
+ *
+ * @return number of blocks allocated
+ */
+static muggle_sync_t muggle_ts_memory_pool_alloc_n(muggle_ts_memory_pool_t *pool, void **datas, muggle_sync_t n)
+{
+	muggle_sync_t expected = pool->alloc_idx;
+	muggle_sync_t cnt = 0;
+	do {
+		// one slot is kept empty to tell full from empty
+		muggle_sync_t avail = MUGGLE_IDX_IN_POW_OF_2_RING(
+			pool->cached_free_pos - expected - 1, pool->capacity);
+		if (avail < n) {
+			pool->cached_free_pos =
+				muggle_atomic_load(&pool->free_idx, muggle_memory_order_acquire);
+			avail = MUGGLE_IDX_IN_POW_OF_2_RING(
+				pool->cached_free_pos - expected - 1, pool->capacity);
+			if (avail == 0) {
+				return 0;
+			}
+		}
+
+		cnt = avail < n ? avail : n;
+		for (muggle_sync_t i = 0; i < cnt; i++)
+		{
+			muggle_sync_t pos = MUGGLE_IDX_IN_POW_OF_2_RING(expected + i, pool->capacity);
+			datas[i] = (void*)(pool->ptrs[pos].ptr + 1);
+		}
+	} while (!muggle_atomic_cmp_exch_weak(
+			&pool->alloc_idx, &expected,
+			MUGGLE_IDX_IN_POW_OF_2_RING(expected + cnt, pool->capacity),
+			muggle_memory_order_relaxed));
+
+	return cnt;
+}
+
+/**
+ * @brief recycle n blocks into shared ring with one lock acquisition
+ */
+static void muggle_ts_memory_pool_free_n(muggle_ts_memory_pool_t *pool, void **datas, muggle_sync_t n)
+{
+	muggle_spinlock_lock(&pool->free_spinlock);
+
+	muggle_sync_t free_idx = pool->free_idx;
+	for (muggle_sync_t i = 0; i < n; i++)
+	{
+		muggle_ts_memory_pool_head_t *block =
+			(muggle_ts_memory_pool_head_t*)datas[i] - 1;
+		pool->ptrs[MUGGLE_IDX_IN_POW_OF_2_RING(free_idx + i, pool->capacity)].ptr = block;
+	}
+
+	muggle_sync_t free_pos =
+		MUGGLE_IDX_IN_POW_OF_2_RING(free_idx + n, pool->capacity);
+	muggle_atomic_store(&pool->free_idx, free_pos, muggle_memory_order_release);
+
+	muggle_spinlock_unlock(&pool->free_spinlock);
+}
+
+static muggle_ts_memory_pool_magazine_t* muggle_ts_memory_pool_magazine_get(muggle_ts_memory_pool_t *pool)
+{
+	muggle_ts_memory_pool_magazine_t *magazine = s_ts_memory_pool_magazines;
+	while (magazine)
+	{
+		if (magazine->pool == pool)
+		{
+			return magazine;
+		}
+		magazine = magazine->next;
+	}
+
+	magazine = (muggle_ts_memory_pool_magazine_t*)malloc(sizeof(muggle_ts_memory_pool_magazine_t));
+	if (magazine == NULL)
+	{
+		return NULL;
+	}
+	magazine->datas = (void**)malloc(sizeof(void*) * pool->magazine_size * 2);
+	if (magazine->datas == NULL)
+	{
+		free(magazine);
+		return NULL;
+	}
+	magazine->pool = pool;
+	magazine->cnt = 0;
+	magazine->next = s_ts_memory_pool_magazines;
+	s_ts_memory_pool_magazines = magazine;
+
+	return magazine;
+}
+
+static void muggle_ts_memory_pool_magazine_release(muggle_ts_memory_pool_t *pool)
+{
+	muggle_ts_memory_pool_magazine_t **pp = &s_ts_memory_pool_magazines;
+	while (*pp)
+	{
+		muggle_ts_memory_pool_magazine_t *magazine = *pp;
+		if (pool == NULL || magazine->pool == pool)
+		{
+			if (magazine->cnt > 0)
+			{
+				muggle_ts_memory_pool_free_n(magazine->pool, magazine->datas, magazine->cnt);
+			}
+			*pp = magazine->next;
+			free(magazine->datas);
+			free(magazine);
+		}
+		else
+		{
+			pp = &magazine->next;
+		}
+	}
+}
+
+int muggle_ts_memory_pool_set_magazine(muggle_ts_memory_pool_t *pool, muggle_sync_t magazine_size)
+{
+	if ((uint32_t)magazine_size >= (uint32_t)pool->capacity)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+	pool->magazine_size = magazine_size;
+
+	return MUGGLE_OK;
+}
+
+void muggle_ts_memory_pool_thread_cache_cleanup()
+{
+	muggle_ts_memory_pool_magazine_release(NULL);
+}
+
 void muggle_ts_memory_pool_destroy(muggle_ts_memory_pool_t *pool)
 {
+	if (pool->magazine_size > 0)
+	{
+		muggle_ts_memory_pool_magazine_release(pool);
+	}
+
 	if (pool->data)
 	{
-		free(pool->data);
+		muggle_page_free(pool->data);
 		pool->data = NULL;
 	}
 
 	if (pool->ptrs)
 	{
-		free(pool->ptrs);
+		muggle_page_free(pool->ptrs);
 		pool->ptrs = NULL;
 	}
 }
 
 void* muggle_ts_memory_pool_alloc(muggle_ts_memory_pool_t *pool)
 {
-	void *data = NULL;
-
-	muggle_sync_t expected = pool->alloc_idx;
-	muggle_sync_t alloc_pos = 0;
-	do {
-		alloc_pos = MUGGLE_IDX_IN_POW_OF_2_RING(expected + 1, pool->capacity);
-		if (alloc_pos == pool->cached_free_pos) {
-			pool->cached_free_pos =
-				muggle_atomic_load(&pool->free_idx, muggle_memory_order_acquire);
-			if (alloc_pos == pool->cached_free_pos) {
-				return NULL;
+	if (pool->magazine_size > 0)
+	{
+		muggle_ts_memory_pool_magazine_t *magazine =
+			muggle_ts_memory_pool_magazine_get(pool);
+		if (magazine)
+		{
+			if (magazine->cnt == 0)
+			{
+				magazine->cnt = muggle_ts_memory_pool_alloc_n(
+					pool, magazine->datas, pool->magazine_size);
+				if (magazine->cnt == 0)
+				{
+					return NULL;
+				}
 			}
+			return magazine->datas[--magazine->cnt];
 		}
+	}
 
-		data = (void*)(pool->ptrs[expected].ptr + 1);
-	} while (!muggle_atomic_cmp_exch_weak(&pool->alloc_idx, &expected, alloc_pos, muggle_memory_order_relaxed));
-
+	void *data = NULL;
+	if (muggle_ts_memory_pool_alloc_n(pool, &data, 1) == 0)
+	{
+		return NULL;
+	}
 	return data;
 }
 
@@ -129,13 +271,24 @@ void muggle_ts_memory_pool_free(void *data)
 		(muggle_ts_memory_pool_head_t*)data - 1;
 	muggle_ts_memory_pool_t *pool = block->pool;
 
-	muggle_spinlock_lock(&pool->free_spinlock);
-
-	pool->ptrs[pool->free_idx].ptr = block;
-
-	muggle_sync_t free_pos =
-		MUGGLE_IDX_IN_POW_OF_2_RING(pool->free_idx + 1, pool->capacity);
-	muggle_atomic_store(&pool->free_idx, free_pos, muggle_memory_order_release);
+	if (pool->magazine_size > 0)
+	{
+		muggle_ts_memory_pool_magazine_t *magazine =
+			muggle_ts_memory_pool_magazine_get(pool);
+		if (magazine)
+		{
+			if (magazine->cnt == pool->magazine_size * 2)
+			{
+				// keep the most recently freed half, they are hot in cache
+				muggle_ts_memory_pool_free_n(pool, magazine->datas, pool->magazine_size);
+				memmove(magazine->datas, magazine->datas + pool->magazine_size,
+					sizeof(void*) * pool->magazine_size);
+				magazine->cnt -= pool->magazine_size;
+			}
+			magazine->datas[magazine->cnt++] = data;
+			return;
+		}
+	}
 
-	muggle_spinlock_unlock(&pool->free_spinlock);
+	muggle_ts_memory_pool_free_n(pool, &data, 1);
 }
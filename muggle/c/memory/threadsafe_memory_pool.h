@@ -14,6 +14,7 @@
 #include "muggle/c/base/macro.h"
 #include "muggle/c/sync/sync_obj.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/memory/page_alloc.h"
 
 EXTERN_C_BEGIN
 
@@ -38,6 +39,17 @@ typedef struct muggle_ts_memory_pool_head_ptr
 	};
 }muggle_ts_memory_pool_head_ptr_t;
 
+/**
+ * @brief thread local magazine, cache blocks of one pool in current thread
+ */
+typedef struct muggle_ts_memory_pool_magazine
+{
+	struct muggle_ts_memory_pool           *pool;
+	struct muggle_ts_memory_pool_magazine *next;
+	muggle_sync_t                          cnt;
+	void                                   **datas;
+}muggle_ts_memory_pool_magazine_t;
+
 /**
  * @brief thread safe memory pool
  */
@@ -47,6 +59,7 @@ typedef struct muggle_ts_memory_pool
 		struct {
 			muggle_sync_t                    capacity;
 			muggle_sync_t                    block_size;
+			muggle_sync_t                    magazine_size;
 			void                             *data;
 			muggle_ts_memory_pool_head_ptr_t *ptrs;
 		};
@@ -87,10 +100,61 @@ typedef struct muggle_ts_memory_pool
 MUGGLE_C_EXPORT
 int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_sync_t capacity, muggle_sync_t data_size);
 
+/**
+ * @brief init muggle thread safe memory pool with page allocation attributes
+ *
+ * @param pool       pointer to ts_memory_pool
+ * @param capacity   expected capacity of pool
+ * @param data_size  user data size
+ * @param attr       page allocation attributes of blocks, NULL means heap
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ts_memory_pool_init_attr(
+	muggle_ts_memory_pool_t *pool, muggle_sync_t capacity, muggle_sync_t data_size,
+	const muggle_page_alloc_attr_t *attr);
+
+/**
+ * @brief enable thread local magazine cache of thread safe memory pool
+ *
+ * @param pool           pointer to ts_memory_pool
+ * @param magazine_size  number of blocks exchanged with shared pool in one
+ *                       batch, 0 means disable magazine
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *     - must be called before any alloc
+ *     - every thread cache at most 2 * magazine_size blocks, alloc and
+ *       free only touch thread local memory until the magazine is empty or
+ *       full, then magazine_size blocks are exchanged with shared pool
+ *     - a thread use magazine must call
+ *       muggle_ts_memory_pool_thread_cache_cleanup before exit, otherwise
+ *       cached blocks are not returned to pool
+ */
+MUGGLE_C_EXPORT
+int muggle_ts_memory_pool_set_magazine(muggle_ts_memory_pool_t *pool, muggle_sync_t magazine_size);
+
+/**
+ * @brief return blocks cached in current thread's magazines to their pools
+ * and release magazines
+ */
+MUGGLE_C_EXPORT
+void muggle_ts_memory_pool_thread_cache_cleanup();
+
 /**
  * @brief destroy thread safe memory pool
  *
  * @param pool  pointer to ts_memory_pool
+ *
+ * @NOTE
+ *     when magazine enabled, other threads must already cleanup thread
+ *     cache, magazine of current thread is released by destroy
  */
 MUGGLE_C_EXPORT
 void muggle_ts_memory_pool_destroy(muggle_ts_memory_pool_t *pool);
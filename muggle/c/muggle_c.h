@@ -39,8 +39,12 @@
 #include "muggle/c/memory/ring_memory_pool.h"
 #include "muggle/c/memory/memory_detect.h"
 #include "muggle/c/memory/bytes_buffer.h"
+#include "muggle/c/memory/mirror_bytes_buffer.h"
 #include "muggle/c/memory/threadsafe_memory_pool.h"
+#include "muggle/c/memory/page_alloc.h"
 #include "muggle/c/memory/pointer_slot.h"
+#include "muggle/c/memory/slab_allocator.h"
+#include "muggle/c/memory/arena.h"
 
 // time
 #include "muggle/c/time/win_gettimeofday.h"
@@ -66,16 +70,28 @@
 #include "muggle/c/sync/condition_variable.h"
 #include "muggle/c/sync/sync_obj.h"
 #include "muggle/c/sync/synclock.h"
+#include "muggle/c/sync/adaptivelock.h"
+#include "muggle/c/sync/semaphore.h"
+#include "muggle/c/sync/latch.h"
+#include "muggle/c/sync/barrier.h"
+#include "muggle/c/sync/eventcount.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/sync/ticketlock.h"
+#include "muggle/c/sync/mcslock.h"
+#include "muggle/c/sync/seqlock.h"
+#include "muggle/c/sync/ebr.h"
 #include "muggle/c/sync/ring_buffer.h"
 #include "muggle/c/sync/array_blocking_queue.h"
 #include "muggle/c/sync/double_buffer.h"
+#include "muggle/c/sync/triple_buffer.h"
 #include "muggle/c/sync/channel.h"
 #include "muggle/c/sync/ref_cnt.h"
 #include "muggle/c/sync/call_once.h"
 #include "muggle/c/sync/ma_ring.h"
 #include "muggle/c/sync/shm.h"
 #include "muggle/c/sync/shm_ring_buffer.h"
+#include "muggle/c/sync/shm_ringbuf_journal.h"
+#include "muggle/c/sync/thread_pool.h"
 
 // log
 #include "muggle/c/log/log_level.h"
@@ -0,0 +1,112 @@
+#include "adaptivelock.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+enum
+{
+	MUGGLE_ADAPTIVELOCK_STATUS_UNLOCK = 0,
+	MUGGLE_ADAPTIVELOCK_STATUS_LOCK,
+};
+
+// minimum and maximum number of spin before park
+#define MUGGLE_ADAPTIVELOCK_MIN_SPIN 16
+#define MUGGLE_ADAPTIVELOCK_MAX_SPIN 4096
+
+// spin limit move 1/8 toward recent wait time every lock
+#define MUGGLE_ADAPTIVELOCK_ADJUST_SHIFT 3
+
+static bool muggle_adaptivelock_try_acquire(muggle_adaptivelock_t *lock)
+{
+	muggle_sync_t expected = MUGGLE_ADAPTIVELOCK_STATUS_UNLOCK;
+	return muggle_atomic_cmp_exch_strong(
+		&lock->status, &expected, MUGGLE_ADAPTIVELOCK_STATUS_LOCK,
+		muggle_memory_order_acquire);
+}
+
+static void muggle_adaptivelock_adjust(
+	muggle_adaptivelock_t *lock, muggle_sync_t limit, muggle_sync_t cnt)
+{
+	// NOTE: racy update is benign, spin_limit is only a hint
+	int32_t diff = ((int32_t)cnt - (int32_t)limit) >>
+		MUGGLE_ADAPTIVELOCK_ADJUST_SHIFT;
+	muggle_atomic_store(
+		&lock->spin_limit, (muggle_sync_t)((int32_t)limit + diff),
+		muggle_memory_order_relaxed);
+}
+
+void muggle_adaptivelock_init(muggle_adaptivelock_t *lock)
+{
+	lock->n_waiters = 0;
+	lock->spin_limit = MUGGLE_ADAPTIVELOCK_MIN_SPIN;
+	muggle_atomic_store(
+		&lock->status, MUGGLE_ADAPTIVELOCK_STATUS_UNLOCK,
+		muggle_memory_order_release);
+}
+
+void muggle_adaptivelock_lock(muggle_adaptivelock_t *lock)
+{
+	if (muggle_adaptivelock_try_acquire(lock))
+	{
+		return;
+	}
+
+	// spin, holder may release lock soon
+	muggle_sync_t limit =
+		muggle_atomic_load(&lock->spin_limit, muggle_memory_order_relaxed);
+	muggle_sync_t max_spin = limit * 2 + MUGGLE_ADAPTIVELOCK_MIN_SPIN;
+	if (max_spin > MUGGLE_ADAPTIVELOCK_MAX_SPIN)
+	{
+		max_spin = MUGGLE_ADAPTIVELOCK_MAX_SPIN;
+	}
+
+	for (muggle_sync_t cnt = 0; cnt < max_spin; cnt++)
+	{
+		muggle_sync_cpu_relax();
+		if (muggle_atomic_load(&lock->status, muggle_memory_order_relaxed) ==
+				MUGGLE_ADAPTIVELOCK_STATUS_UNLOCK &&
+			muggle_adaptivelock_try_acquire(lock))
+		{
+			// short hold, spin limit toward this wait
+			muggle_adaptivelock_adjust(lock, limit, cnt);
+			return;
+		}
+	}
+
+	// long hold, spin limit decay, next lockers park earlier
+	muggle_adaptivelock_adjust(lock, limit, 0);
+
+	// park
+	//
+	// NOTE: waiter increase n_waiters before check status, unlocker store
+	// status before check n_waiters, so at least one of them observe the
+	// other (pair with the fence in muggle_adaptivelock_unlock)
+	muggle_atomic_fetch_add(&lock->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	while (!muggle_adaptivelock_try_acquire(lock))
+	{
+		muggle_sync_wait(&lock->status, MUGGLE_ADAPTIVELOCK_STATUS_LOCK, NULL);
+	}
+	muggle_atomic_fetch_sub(&lock->n_waiters, 1, muggle_memory_order_relaxed);
+}
+
+bool muggle_adaptivelock_trylock(muggle_adaptivelock_t *lock)
+{
+	return muggle_adaptivelock_try_acquire(lock);
+}
+
+void muggle_adaptivelock_unlock(muggle_adaptivelock_t *lock)
+{
+	muggle_atomic_store(
+		&lock->status, MUGGLE_ADAPTIVELOCK_STATUS_UNLOCK,
+		muggle_memory_order_release);
+
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&lock->n_waiters, muggle_memory_order_relaxed))
+	{
+		muggle_sync_wake_one(&lock->status);
+	}
+}
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *  @file         adaptivelock.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec adaptive lock
+ *
+ *  adaptive lock spin for a while before park on sync object, the spin
+ *  limit is self-tuned by how long lockers recently waited for the lock
+ *  holder: short critical sections are acquired by spinning without
+ *  futex wake latency, long critical sections make spin limit decay and
+ *  lockers park soon; unlock only wake when there are parked waiters
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_ADAPTIVELOCK_H_
+#define MUGGLE_C_ADAPTIVELOCK_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/sync_obj.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+typedef struct muggle_adaptivelock
+{
+	muggle_sync_t status;     //!< lock status
+	muggle_sync_t n_waiters;  //!< number of parked waiters
+	muggle_sync_t spin_limit; //!< self-tuned spin limit
+} muggle_adaptivelock_t;
+
+/**
+ * @brief initialize adaptive lock
+ *
+ * @param lock  adaptive lock
+ */
+MUGGLE_C_EXPORT
+void muggle_adaptivelock_init(muggle_adaptivelock_t *lock);
+
+/**
+ * @brief lock adaptive lock
+ *
+ * @param lock  adaptive lock
+ */
+MUGGLE_C_EXPORT
+void muggle_adaptivelock_lock(muggle_adaptivelock_t *lock);
+
+/**
+ * @brief try lock adaptive lock
+ *
+ * @param lock  adaptive lock
+ *
+ * @return true if lock success
+ */
+MUGGLE_C_EXPORT
+bool muggle_adaptivelock_trylock(muggle_adaptivelock_t *lock);
+
+/**
+ * @brief unlock adaptive lock
+ *
+ * @param lock  adaptive lock
+ */
+MUGGLE_C_EXPORT
+void muggle_adaptivelock_unlock(muggle_adaptivelock_t *lock);
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_ADAPTIVELOCK_H_
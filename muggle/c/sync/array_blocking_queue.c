@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "muggle/c/base/err.h"
+#include "muggle/c/sync/internal/sync_deadline.h"
 
 static void muggle_array_blocking_queue_enqueue(muggle_array_blocking_queue_t *queue, void *data)
 {
@@ -37,6 +38,55 @@ static void* muggle_array_blocking_queue_dequeue(muggle_array_blocking_queue_t *
 	return data;
 }
 
+static int muggle_array_blocking_queue_enqueue_n(muggle_array_blocking_queue_t *queue, void **datas, int n)
+{
+	int space = queue->capacity - queue->cnt;
+	if (n > space)
+	{
+		n = space;
+	}
+
+	// copy at most two contiguous segments
+	int first = queue->capacity - queue->put_idx;
+	if (first > n)
+	{
+		first = n;
+	}
+	memcpy(&queue->datas[queue->put_idx], datas, sizeof(void*) * first);
+	memcpy(&queue->datas[0], datas + first, sizeof(void*) * (n - first));
+
+	queue->put_idx += n;
+	if (queue->put_idx >= queue->capacity)
+	{
+		queue->put_idx -= queue->capacity;
+	}
+	queue->cnt += n;
+
+	return n;
+}
+
+static int muggle_array_blocking_queue_dequeue_n(muggle_array_blocking_queue_t *queue, void **datas, int max)
+{
+	int n = queue->cnt < max ? queue->cnt : max;
+
+	int first = queue->capacity - queue->take_idx;
+	if (first > n)
+	{
+		first = n;
+	}
+	memcpy(datas, &queue->datas[queue->take_idx], sizeof(void*) * first);
+	memcpy(datas + first, &queue->datas[0], sizeof(void*) * (n - first));
+
+	queue->take_idx += n;
+	if (queue->take_idx >= queue->capacity)
+	{
+		queue->take_idx -= queue->capacity;
+	}
+	queue->cnt -= n;
+
+	return n;
+}
+
 int muggle_array_blocking_queue_init(muggle_array_blocking_queue_t *queue, int capacity)
 {
 	memset(queue, 0, sizeof(muggle_array_blocking_queue_t));
@@ -126,3 +176,119 @@ void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue)
 
 	return data;
 }
+
+void* muggle_array_blocking_queue_timed_take(
+	muggle_array_blocking_queue_t *queue, const struct timespec *timeout)
+{
+	if (timeout == NULL)
+	{
+		return muggle_array_blocking_queue_take(queue);
+	}
+
+	muggle_sync_deadline_t deadline;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return NULL;
+	}
+
+	void *data = NULL;
+	struct timespec ts;
+	const struct timespec *p_wait = NULL;
+	while (queue->cnt == 0)
+	{
+		if (!muggle_sync_deadline_cv(&deadline, &ts, &p_wait))
+		{
+			break;
+		}
+		muggle_condition_variable_wait(&queue->cv_not_empty, &queue->mutex, p_wait);
+	}
+	if (queue->cnt > 0)
+	{
+		data = muggle_array_blocking_queue_dequeue(queue);
+	}
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return data;
+}
+
+int muggle_array_blocking_queue_put_n(muggle_array_blocking_queue_t *queue, void **datas, int n)
+{
+	if (n <= 0)
+	{
+		return MUGGLE_OK;
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	while (n > 0)
+	{
+		while (queue->cnt == queue->capacity)
+		{
+			muggle_condition_variable_wait(&queue->cv_not_full, &queue->mutex, NULL);
+		}
+
+		int cnt = muggle_array_blocking_queue_enqueue_n(queue, datas, n);
+		datas += cnt;
+		n -= cnt;
+
+		// signal once per batch, more than one consumer may proceed
+		if (cnt == 1)
+		{
+			muggle_condition_variable_notify_one(&queue->cv_not_empty);
+		}
+		else
+		{
+			muggle_condition_variable_notify_all(&queue->cv_not_empty);
+		}
+	}
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_array_blocking_queue_take_all(muggle_array_blocking_queue_t *queue, void **datas, int max)
+{
+	if (max <= 0)
+	{
+		return 0;
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return 0;
+	}
+
+	while (queue->cnt == 0)
+	{
+		muggle_condition_variable_wait(&queue->cv_not_empty, &queue->mutex, NULL);
+	}
+
+	int cnt = muggle_array_blocking_queue_dequeue_n(queue, datas, max);
+
+	// signal once per batch, more than one producer may proceed
+	if (cnt == 1)
+	{
+		muggle_condition_variable_notify_one(&queue->cv_not_full);
+	}
+	else
+	{
+		muggle_condition_variable_notify_all(&queue->cv_not_full);
+	}
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return cnt;
+}
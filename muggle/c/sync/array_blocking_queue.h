@@ -82,6 +82,58 @@ int muggle_array_blocking_queue_put(muggle_array_blocking_queue_t *queue, void *
 MUGGLE_C_EXPORT
 void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue);
 
+/**
+ * @brief take data from queue, wait at most timeout when queue is empty
+ *
+ * @param queue    array blocking queue pointer
+ * @param timeout  relative timeout, NULL means wait forever
+ *
+ * @return
+ *     - on success, return data
+ *     - return NULL on timeout or failed
+ */
+MUGGLE_C_EXPORT
+void* muggle_array_blocking_queue_timed_take(
+	muggle_array_blocking_queue_t *queue, const struct timespec *timeout);
+
+/**
+ * @brief put multiple datas into queue with one lock acquisition per
+ * available space
+ *
+ * @param queue   array blocking queue pointer
+ * @param datas   array of data pointers
+ * @param n       number of datas
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *     block until all datas are put; if n is larger than the free space,
+ *     put as many as possible, notify consumers once, and wait for more
+ *     free space
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_put_n(muggle_array_blocking_queue_t *queue, void **datas, int n);
+
+/**
+ * @brief take all datas in queue at once
+ *
+ * @param queue   array blocking queue pointer
+ * @param datas   array to store data pointers
+ * @param max     max number of datas to take
+ *
+ * @return 
+ *     - on success, return number of datas taken, greater than 0
+ *     - on failed, return 0
+ *
+ * @NOTE
+ *     block until queue is not empty, then take up to max datas and notify
+ *     producers once
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_take_all(muggle_array_blocking_queue_t *queue, void **datas, int max);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,64 @@
+#include "barrier.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+// number of spin before park
+#define MUGGLE_BARRIER_SPIN 128
+
+void muggle_barrier_init(muggle_barrier_t *barrier, muggle_sync_t n_threads)
+{
+	barrier->arrived = 0;
+	barrier->n_waiters = 0;
+	barrier->n_threads = n_threads;
+	muggle_atomic_store(&barrier->generation, 0, muggle_memory_order_release);
+}
+
+bool muggle_barrier_wait(muggle_barrier_t *barrier)
+{
+	// NOTE: generation can't change before this thread arrived
+	muggle_sync_t gen =
+		muggle_atomic_load(&barrier->generation, muggle_memory_order_acquire);
+
+	muggle_sync_t arrived = muggle_atomic_fetch_add(
+		&barrier->arrived, 1, muggle_memory_order_acq_rel) + 1;
+	if (arrived == barrier->n_threads)
+	{
+		// reset before release waiters, they may enter next phase at once
+		muggle_atomic_store(&barrier->arrived, 0, muggle_memory_order_relaxed);
+		muggle_atomic_fetch_add(
+			&barrier->generation, 1, muggle_memory_order_release);
+
+		// pair with the fence in waiter
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&barrier->n_waiters, muggle_memory_order_relaxed))
+		{
+			muggle_sync_wake_all(&barrier->generation);
+		}
+		return true;
+	}
+
+	for (int i = 0; i < MUGGLE_BARRIER_SPIN; i++)
+	{
+		if (muggle_atomic_load(&barrier->generation,
+							   muggle_memory_order_acquire) != gen)
+		{
+			return false;
+		}
+		muggle_sync_cpu_relax();
+	}
+
+	muggle_atomic_fetch_add(&barrier->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	while (muggle_atomic_load(&barrier->generation,
+							  muggle_memory_order_acquire) == gen)
+	{
+		muggle_sync_wait(&barrier->generation, gen, NULL);
+	}
+	muggle_atomic_fetch_sub(&barrier->n_waiters, 1, muggle_memory_order_relaxed);
+
+	return false;
+}
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
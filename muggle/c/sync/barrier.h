@@ -0,0 +1,58 @@
+/******************************************************************************
+ *  @file         barrier.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec cyclic barrier
+ *
+ *  reusable barrier built on sync object, threads block until all
+ *  participants arrived, then the barrier resets for the next phase
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_BARRIER_H_
+#define MUGGLE_C_BARRIER_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/sync_obj.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+typedef struct muggle_barrier
+{
+	muggle_sync_t arrived;    //!< number of arrived threads in phase
+	muggle_sync_t generation; //!< phase generation
+	muggle_sync_t n_waiters;  //!< number of parked waiters
+	muggle_sync_t n_threads;  //!< number of participants
+} muggle_barrier_t;
+
+/**
+ * @brief initialize barrier
+ *
+ * @param barrier    barrier
+ * @param n_threads  number of participants, must be greater than 0
+ */
+MUGGLE_C_EXPORT
+void muggle_barrier_init(muggle_barrier_t *barrier, muggle_sync_t n_threads);
+
+/**
+ * @brief arrive at barrier and block until all participants arrived
+ *
+ * @param barrier  barrier
+ *
+ * @return
+ *     true for the last arrived thread of the phase, false for others, so
+ *     exactly one thread could do serial work between phases
+ */
+MUGGLE_C_EXPORT
+bool muggle_barrier_wait(muggle_barrier_t *barrier);
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_BARRIER_H_
@@ -15,6 +15,9 @@
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/sync/internal/sync_deadline.h"
+#include "muggle/c/event/event_signal.h"
+#include "muggle/c/event/event_loop.h"
 
 /***************** write lock *****************/
 
@@ -58,6 +61,33 @@ static void muggle_channel_write_spinlock_unlock(muggle_channel_t *chan)
 	muggle_spinlock_unlock(&chan->write_spinlock);
 }
 
+////////////////// MUGGLE_CHANNEL_FLAG_WRITE_TICKET ////////////////// 
+
+static void muggle_channel_write_ticketlock_lock(muggle_channel_t *chan)
+{
+	muggle_ticketlock_lock(&chan->write_ticketlock);
+}
+
+static void muggle_channel_write_ticketlock_unlock(muggle_channel_t *chan)
+{
+	muggle_ticketlock_unlock(&chan->write_ticketlock);
+}
+
+////////////////// MUGGLE_CHANNEL_FLAG_WRITE_MCS ////////////////// 
+
+// write lock is never nested, one node per thread is enough for all channels
+static muggle_thread_local muggle_mcslock_node_t s_channel_mcs_node;
+
+static void muggle_channel_write_mcslock_lock(muggle_channel_t *chan)
+{
+	muggle_mcslock_lock(&chan->write_mcslock, &s_channel_mcs_node);
+}
+
+static void muggle_channel_write_mcslock_unlock(muggle_channel_t *chan)
+{
+	muggle_mcslock_unlock(&chan->write_mcslock, &s_channel_mcs_node);
+}
+
 ////////////////// MUGGLE_CHANNEL_FLAG_WRITE_SINGLE ////////////////// 
 
 static void muggle_channel_write_single_lock(muggle_channel_t *chan)
@@ -168,6 +198,80 @@ static void* muggle_channel_read_sync(muggle_channel_t *chan)
 	return NULL;
 }
 
+static uint32_t muggle_channel_write_n_sync(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	// slot of read_cursor can't be written, so number of writable slots is
+	// distance between write and read cursor minus one
+	muggle_sync_t rpos =
+		muggle_atomic_load(&chan->read_cursor, muggle_memory_order_acquire);
+	uint32_t remain = (uint32_t)MUGGLE_IDX_IN_POW_OF_2_RING(
+		rpos - chan->write_cursor, chan->capacity) - 1;
+	if (n > remain)
+	{
+		n = remain;
+	}
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	muggle_sync_t wpos = chan->write_cursor;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		chan->blocks[wpos].data = datas[i];
+		wpos = MUGGLE_IDX_IN_POW_OF_2_RING(wpos + 1, chan->capacity);
+	}
+
+	// publish all slots with a single release store, see comment in
+	// muggle_channel_write_sync
+	muggle_atomic_store(
+		&chan->write_cursor, wpos, muggle_memory_order_release);
+
+	return n;
+}
+
+static uint32_t muggle_channel_read_n_sync(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	muggle_sync_t rpos =
+		MUGGLE_IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_sync_t wpos;
+	while (1)
+	{
+		wpos = muggle_atomic_load(
+			&chan->write_cursor, muggle_memory_order_acquire);
+		if (wpos != rpos)
+		{
+			uint32_t cnt = 0;
+			muggle_sync_t last_pos = rpos;
+			while (rpos != wpos && cnt < max_n)
+			{
+				datas[cnt++] = chan->blocks[rpos].data;
+				last_pos = rpos;
+				rpos = MUGGLE_IDX_IN_POW_OF_2_RING(rpos + 1, chan->capacity);
+			}
+			muggle_atomic_store(
+				&chan->read_cursor, last_pos, muggle_memory_order_release);
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			return 0;
+		}
+		muggle_sync_wait(&chan->write_cursor, wpos, p_wait);
+	}
+
+	return 0;
+}
+
 #endif
 
 ////////////////// MUGGLE_CHANNEL_FLAG_READ_MUTEX ////////////////// 
@@ -219,6 +323,69 @@ static void* muggle_channel_read_mutex(muggle_channel_t *chan)
 	}
 }
 
+static uint32_t muggle_channel_write_n_mutex(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	muggle_mutex_lock(chan->read_mutex);
+
+	uint32_t remain = (uint32_t)MUGGLE_IDX_IN_POW_OF_2_RING(
+		chan->read_cursor - chan->write_cursor, chan->capacity) - 1;
+	if (n > remain)
+	{
+		n = remain;
+	}
+
+	muggle_sync_t wpos = chan->write_cursor;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		chan->blocks[wpos].data = datas[i];
+		wpos = MUGGLE_IDX_IN_POW_OF_2_RING(wpos + 1, chan->capacity);
+	}
+	chan->write_cursor = wpos;
+
+	muggle_mutex_unlock(chan->read_mutex);
+
+	return n;
+}
+
+static uint32_t muggle_channel_read_n_mutex(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec ts;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	muggle_mutex_lock(chan->read_mutex);
+
+	while (1)
+	{
+		muggle_sync_t rpos =
+			MUGGLE_IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+		if (rpos != chan->write_cursor)
+		{
+			uint32_t cnt = 0;
+			while (rpos != chan->write_cursor && cnt < max_n)
+			{
+				datas[cnt++] = chan->blocks[rpos].data;
+				chan->read_cursor = rpos;
+				rpos = MUGGLE_IDX_IN_POW_OF_2_RING(rpos + 1, chan->capacity);
+			}
+			muggle_mutex_unlock(chan->read_mutex);
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_cv(&deadline, &ts, &p_wait))
+		{
+			muggle_mutex_unlock(chan->read_mutex);
+			return 0;
+		}
+		muggle_condition_variable_wait(
+			chan->read_cv, chan->read_mutex, p_wait);
+	}
+}
+
 ////////////////// MUGGLE_CHANNEL_FLAG_READ_BUSY ////////////////// 
 
 static int muggle_channel_write_busy(muggle_channel_t *chan, void *data)
@@ -274,6 +441,414 @@ static void* muggle_channel_read_busy(muggle_channel_t *chan)
 	return NULL;
 }
 
+static uint32_t muggle_channel_write_n_busy(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	uint32_t remain = (uint32_t)MUGGLE_IDX_IN_POW_OF_2_RING(
+		chan->cached_r_cur - chan->write_cursor, chan->capacity) - 1;
+	if (remain < n)
+	{
+		chan->cached_r_cur =
+			muggle_atomic_load(&chan->read_cursor, muggle_memory_order_acquire);
+		remain = (uint32_t)MUGGLE_IDX_IN_POW_OF_2_RING(
+			chan->cached_r_cur - chan->write_cursor, chan->capacity) - 1;
+		if (n > remain)
+		{
+			n = remain;
+		}
+		if (n == 0)
+		{
+			return 0;
+		}
+	}
+
+	muggle_sync_t wpos = chan->write_cursor;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		chan->blocks[wpos].data = datas[i];
+		wpos = MUGGLE_IDX_IN_POW_OF_2_RING(wpos + 1, chan->capacity);
+	}
+	muggle_atomic_store(
+		&chan->write_cursor, wpos, muggle_memory_order_release);
+
+	return n;
+}
+
+static uint32_t muggle_channel_read_n_busy(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	muggle_sync_t rpos =
+		MUGGLE_IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_sync_t wpos;
+	while (1)
+	{
+		wpos = muggle_atomic_load(
+			&chan->write_cursor, muggle_memory_order_acquire);
+		if (wpos != rpos)
+		{
+			uint32_t cnt = 0;
+			muggle_sync_t last_pos = rpos;
+			while (rpos != wpos && cnt < max_n)
+			{
+				datas[cnt++] = chan->blocks[rpos].data;
+				last_pos = rpos;
+				rpos = MUGGLE_IDX_IN_POW_OF_2_RING(rpos + 1, chan->capacity);
+			}
+			muggle_atomic_store(
+				&chan->read_cursor, last_pos, muggle_memory_order_release);
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			return 0;
+		}
+		// muggle_thread_yield();
+	}
+
+	return 0;
+}
+
+////////////////// MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE ////////////////// 
+
+// NOTE:
+//   In lock-free mode, write_cursor and read_cursor increase monotonically,
+//   slot index is cursor & (capacity - 1), and every slot carry a sequence
+//   number
+//     * seq == pos:     slot is free for the writer that claim pos
+//     * seq == pos + 1: slot is published for the reader that claim pos
+//   after reader consume the slot, set seq = pos + capacity for next lap.
+//   Sequence and cursor are compared by signed distance of uint32_t, so
+//   wrap around of cursor is safe
+#define MUGGLE_CHANNEL_SEQ_DIFF(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+static uint32_t muggle_channel_lockfree_push_n(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_sync_t seq = 0;
+	int32_t diff = 0;
+	uint32_t cnt = 0;
+
+	muggle_sync_t pos =
+		muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		// count contiguous free slots from pos
+		cnt = 0;
+		while (cnt < n)
+		{
+			block = &chan->blocks[
+				MUGGLE_IDX_IN_POW_OF_2_RING(pos + cnt, chan->capacity)];
+			seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+			diff = MUGGLE_CHANNEL_SEQ_DIFF(seq, pos + cnt);
+			if (diff != 0)
+			{
+				break;
+			}
+			++cnt;
+		}
+
+		if (cnt == 0)
+		{
+			if (diff < 0)
+			{
+				// slot still hold last lap data, channel full
+				return 0;
+			}
+
+			// other writer already claimed pos
+			pos = muggle_atomic_load(
+				&chan->write_cursor, muggle_memory_order_relaxed);
+			continue;
+		}
+
+		// claim [pos, pos + cnt) with a single CAS, when failed, pos will be
+		// updated to current write cursor
+		if (muggle_atomic_cmp_exch_weak(
+				&chan->write_cursor, &pos, pos + cnt,
+				muggle_memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	for (uint32_t i = 0; i < cnt; i++)
+	{
+		block = &chan->blocks[
+			MUGGLE_IDX_IN_POW_OF_2_RING(pos + i, chan->capacity)];
+		block->data = datas[i];
+		muggle_atomic_store(&block->seq, pos + i + 1, muggle_memory_order_release);
+	}
+
+	return cnt;
+}
+
+static uint32_t muggle_channel_lockfree_pop_n(
+	muggle_channel_t *chan, void **datas, uint32_t max_n)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_sync_t seq = 0;
+	int32_t diff = 0;
+	uint32_t cnt = 0;
+
+	muggle_sync_t pos =
+		muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		// count contiguous published slots from pos
+		cnt = 0;
+		while (cnt < max_n)
+		{
+			block = &chan->blocks[
+				MUGGLE_IDX_IN_POW_OF_2_RING(pos + cnt, chan->capacity)];
+			seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+			diff = MUGGLE_CHANNEL_SEQ_DIFF(seq, pos + cnt + 1);
+			if (diff != 0)
+			{
+				break;
+			}
+			++cnt;
+		}
+
+		if (cnt == 0)
+		{
+			if (diff < 0)
+			{
+				// slot not published yet
+				return 0;
+			}
+
+			// other reader already claimed pos
+			pos = muggle_atomic_load(
+				&chan->read_cursor, muggle_memory_order_relaxed);
+			continue;
+		}
+
+		if (muggle_atomic_cmp_exch_weak(
+				&chan->read_cursor, &pos, pos + cnt,
+				muggle_memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	for (uint32_t i = 0; i < cnt; i++)
+	{
+		block = &chan->blocks[
+			MUGGLE_IDX_IN_POW_OF_2_RING(pos + i, chan->capacity)];
+		datas[i] = block->data;
+		muggle_atomic_store(
+			&block->seq, pos + i + chan->capacity, muggle_memory_order_release);
+	}
+
+	return cnt;
+}
+
+/**
+ * @brief check whether has slot that claimed by writer but not pop yet
+ *
+ * @param chan  pointer to muggle_channel_t
+ * @param wpos  write cursor that loaded before pop
+ *
+ * @return boolean
+ *
+ * NOTE: Reader only allow to sleep when there has no pending slot, cause
+ * writer publish slot after move write cursor, so a sleep reader that wait on
+ * write cursor can't miss wake up.
+ */
+static int muggle_channel_lockfree_has_pending(
+	muggle_channel_t *chan, muggle_sync_t wpos)
+{
+	muggle_sync_t rpos =
+		muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+	return wpos != rpos;
+}
+
+static int muggle_channel_write_lockfree(muggle_channel_t *chan, void *data)
+{
+	if (muggle_channel_lockfree_push_n(chan, &data, 1) == 0)
+	{
+		return MUGGLE_ERR_FULL;
+	}
+	return MUGGLE_OK;
+}
+
+static uint32_t muggle_channel_write_n_lockfree(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	return muggle_channel_lockfree_push_n(chan, datas, n);
+}
+
+static void muggle_channel_wake_lockfree_mutex(muggle_channel_t *chan)
+{
+	// writer not hold read_mutex in lock-free mode, lock and unlock here to
+	// ensure reader already in waiting or will see published slot
+	muggle_mutex_lock(chan->read_mutex);
+	muggle_mutex_unlock(chan->read_mutex);
+	muggle_condition_variable_notify_one(chan->read_cv);
+}
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+static uint32_t muggle_channel_read_n_lockfree_sync(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	while (1)
+	{
+		muggle_sync_t wpos = muggle_atomic_load(
+			&chan->write_cursor, muggle_memory_order_acquire);
+
+		uint32_t cnt = muggle_channel_lockfree_pop_n(chan, datas, max_n);
+		if (cnt > 0)
+		{
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			return 0;
+		}
+
+		if (muggle_channel_lockfree_has_pending(chan, wpos))
+		{
+			// writer claimed slot but not publish yet
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_sync_wait(&chan->write_cursor, wpos, p_wait);
+	}
+
+	return 0;
+}
+
+static void* muggle_channel_read_lockfree_sync(muggle_channel_t *chan)
+{
+	void *data = NULL;
+	muggle_channel_read_n_lockfree_sync(chan, &data, 1, NULL);
+	return data;
+}
+
+#endif
+
+static uint32_t muggle_channel_read_n_lockfree_mutex(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec ts;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	while (1)
+	{
+		muggle_sync_t wpos = muggle_atomic_load(
+			&chan->write_cursor, muggle_memory_order_acquire);
+
+		uint32_t cnt = muggle_channel_lockfree_pop_n(chan, datas, max_n);
+		if (cnt > 0)
+		{
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_cv(&deadline, &ts, &p_wait))
+		{
+			return 0;
+		}
+
+		if (muggle_channel_lockfree_has_pending(chan, wpos))
+		{
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_mutex_lock(chan->read_mutex);
+		if (muggle_atomic_load(
+				&chan->write_cursor, muggle_memory_order_acquire) == wpos)
+		{
+			muggle_condition_variable_wait(
+				chan->read_cv, chan->read_mutex, p_wait);
+		}
+		muggle_mutex_unlock(chan->read_mutex);
+	}
+
+	return 0;
+}
+
+static void* muggle_channel_read_lockfree_mutex(muggle_channel_t *chan)
+{
+	void *data = NULL;
+	muggle_channel_read_n_lockfree_mutex(chan, &data, 1, NULL);
+	return data;
+}
+
+static uint32_t muggle_channel_read_n_lockfree_busy(
+	muggle_channel_t *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout)
+{
+	muggle_sync_deadline_t deadline;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	while (1)
+	{
+		uint32_t cnt = muggle_channel_lockfree_pop_n(chan, datas, max_n);
+		if (cnt > 0)
+		{
+			return cnt;
+		}
+
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			return 0;
+		}
+	}
+
+	return 0;
+}
+
+static void* muggle_channel_read_lockfree_busy(muggle_channel_t *chan)
+{
+	void *data = NULL;
+	muggle_channel_read_n_lockfree_busy(chan, &data, 1, NULL);
+	return data;
+}
+
+////////////////// MUGGLE_CHANNEL_FLAG_READ_EVENT ////////////////// 
+
+static void muggle_channel_wake_event(muggle_channel_t *chan)
+{
+	// order cursor publish before load ev_notified, pair with the fence
+	// in muggle_channel_ev_clearup
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	// only the first writer after reader clearup signal event fd
+	if (muggle_atomic_load(&chan->ev_notified, muggle_memory_order_relaxed))
+	{
+		return;
+	}
+
+	if (muggle_atomic_exchange(
+			&chan->ev_notified, 1, muggle_memory_order_acq_rel) == 0)
+	{
+		muggle_ev_signal_wakeup(chan->ev_signal);
+	}
+}
+
 /***************** channel functions *****************/
 
 enum
@@ -281,10 +856,18 @@ enum
 	CHANNEL_INIT_WRITE_MUTEX = 1 << 0,
 	CHANNEL_INIT_READ_MUTEX  = 1 << 1,
 	CHANNEL_INIT_READ_CV     = 1 << 2,
+	CHANNEL_INIT_EV_SIGNAL   = 1 << 3,
 };
 
 int muggle_channel_init(
 	muggle_channel_t *chan, muggle_sync_t capacity, int flags)
+{
+	return muggle_channel_init_attr(chan, capacity, flags, NULL);
+}
+
+int muggle_channel_init_attr(
+	muggle_channel_t *chan, muggle_sync_t capacity, int flags,
+	const muggle_page_alloc_attr_t *attr)
 {
 	memset(chan, 0, sizeof(*chan));
 
@@ -337,8 +920,22 @@ int muggle_channel_init(
 			chan->fn_lock = muggle_channel_write_spinlock_lock;
 			chan->fn_unlock = muggle_channel_write_spinlock_unlock;
 		}break;
+	case MUGGLE_CHANNEL_FLAG_WRITE_TICKET:
+		{
+			muggle_ticketlock_init(&chan->write_ticketlock);
+			chan->fn_lock = muggle_channel_write_ticketlock_lock;
+			chan->fn_unlock = muggle_channel_write_ticketlock_unlock;
+		}break;
+	case MUGGLE_CHANNEL_FLAG_WRITE_MCS:
+		{
+			muggle_mcslock_init(&chan->write_mcslock);
+			chan->fn_lock = muggle_channel_write_mcslock_lock;
+			chan->fn_unlock = muggle_channel_write_mcslock_unlock;
+		}break;
 	case MUGGLE_CHANNEL_FLAG_WRITE_SINGLE:
+	case MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE:
 		{
+			// lock-free writers only CAS write cursor, no write lock needed
 			chan->fn_lock = muggle_channel_write_single_lock;
 			chan->fn_unlock = muggle_channel_write_single_unlock;
 		}break;
@@ -380,6 +977,8 @@ int muggle_channel_init(
 			chan->fn_write = muggle_channel_write_sync;
 			chan->fn_wake = muggle_channel_wake_sync;
 			chan->fn_read = muggle_channel_read_sync;
+			chan->fn_write_n = muggle_channel_write_n_sync;
+			chan->fn_read_n = muggle_channel_read_n_sync;
 		}break;
 #endif
 	case MUGGLE_CHANNEL_FLAG_READ_BUSY:
@@ -387,6 +986,37 @@ int muggle_channel_init(
 			chan->fn_write = muggle_channel_write_busy;
 			chan->fn_wake = muggle_channel_wake_busy;
 			chan->fn_read = muggle_channel_read_busy;
+			chan->fn_write_n = muggle_channel_write_n_busy;
+			chan->fn_read_n = muggle_channel_read_n_busy;
+		}break;
+	case MUGGLE_CHANNEL_FLAG_READ_EVENT:
+		{
+			chan->ev_signal = (struct muggle_event_signal*)malloc(
+				sizeof(muggle_event_signal_t));
+			if (chan->ev_signal == NULL)
+			{
+				ret = MUGGLE_ERR_MEM_ALLOC;
+				goto channel_init_except;
+			}
+
+			if (muggle_ev_signal_init(chan->ev_signal) != 0)
+			{
+				free(chan->ev_signal);
+				chan->ev_signal = NULL;
+
+				ret = MUGGLE_ERR_SYS_CALL;
+				goto channel_init_except;
+			}
+			chan->init_flags |= CHANNEL_INIT_EV_SIGNAL;
+			chan->ev_notified = 0;
+
+			// blocking read in event mode is busy loop, user should wait
+			// event fd in event loop
+			chan->fn_write = muggle_channel_write_busy;
+			chan->fn_wake = muggle_channel_wake_event;
+			chan->fn_read = muggle_channel_read_busy;
+			chan->fn_write_n = muggle_channel_write_n_busy;
+			chan->fn_read_n = muggle_channel_read_n_busy;
 		}break;
 	case MUGGLE_CHANNEL_FLAG_READ_MUTEX:
 	default:
@@ -431,20 +1061,52 @@ int muggle_channel_init(
 			chan->fn_write = muggle_channel_write_mutex;
 			chan->fn_wake = muggle_channel_wake_mutex;
 			chan->fn_read = muggle_channel_read_mutex;
+			chan->fn_write_n = muggle_channel_write_n_mutex;
+			chan->fn_read_n = muggle_channel_read_n_mutex;
 		}break;
 	}
 
-	chan->write_cursor = 0;
-	chan->cached_r_cur = capacity - 1;
-	chan->read_cursor = capacity - 1;
-
-#if MUGGLE_C_HAVE_ALIGNED_ALLOC
-	chan->blocks = (muggle_channel_block_t*)aligned_alloc(
-		MUGGLE_CACHE_LINE_SIZE, sizeof(muggle_channel_block_t) * capacity);
-#else
-	chan->blocks =(muggle_channel_block_t*)malloc(
-		sizeof(muggle_channel_block_t) * capacity);
+	if (w_flags == MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE)
+	{
+		switch (r_flags)
+		{
+#if MUGGLE_C_HAVE_SYNC_OBJ
+		case MUGGLE_CHANNEL_FLAG_READ_SYNC:
+			{
+				chan->fn_read = muggle_channel_read_lockfree_sync;
+				chan->fn_read_n = muggle_channel_read_n_lockfree_sync;
+			}break;
 #endif
+		case MUGGLE_CHANNEL_FLAG_READ_BUSY:
+		case MUGGLE_CHANNEL_FLAG_READ_EVENT:
+			{
+				chan->fn_read = muggle_channel_read_lockfree_busy;
+				chan->fn_read_n = muggle_channel_read_n_lockfree_busy;
+			}break;
+		case MUGGLE_CHANNEL_FLAG_READ_MUTEX:
+		default:
+			{
+				chan->fn_wake = muggle_channel_wake_lockfree_mutex;
+				chan->fn_read = muggle_channel_read_lockfree_mutex;
+				chan->fn_read_n = muggle_channel_read_n_lockfree_mutex;
+			}break;
+		}
+		chan->fn_write = muggle_channel_write_lockfree;
+		chan->fn_write_n = muggle_channel_write_n_lockfree;
+
+		chan->write_cursor = 0;
+		chan->cached_r_cur = 0;
+		chan->read_cursor = 0;
+	}
+	else
+	{
+		chan->write_cursor = 0;
+		chan->cached_r_cur = capacity - 1;
+		chan->read_cursor = capacity - 1;
+	}
+
+	chan->blocks = (muggle_channel_block_t*)muggle_page_alloc(
+		attr, sizeof(muggle_channel_block_t) * capacity);
 	if (chan->blocks == NULL)
 	{
 		ret = MUGGLE_ERR_MEM_ALLOC;
@@ -454,6 +1116,7 @@ int muggle_channel_init(
 	for (muggle_sync_t i = 0; i < capacity; i++)
 	{
 		memset(&chan->blocks[i], 0, sizeof(muggle_channel_block_t));
+		chan->blocks[i].seq = i;
 	}
 
 	return MUGGLE_OK;
@@ -466,9 +1129,16 @@ channel_init_except:
 
 void muggle_channel_destroy(muggle_channel_t *chan)
 {
+	if (chan->ev_signal)
+	{
+		muggle_ev_signal_destroy(chan->ev_signal);
+		free(chan->ev_signal);
+		chan->ev_signal = NULL;
+	}
+
 	if (chan->blocks)
 	{
-		free(chan->blocks);
+		muggle_page_free(chan->blocks);
 		chan->blocks = NULL;
 	}
 
@@ -484,7 +1154,9 @@ void muggle_channel_destroy(muggle_channel_t *chan)
 		free(chan->read_mutex);
 		chan->read_mutex = NULL;
 	}
-	if (chan->write_mutex)
+	// NOTE: write_mutex shares memory with other write locks, check init
+	// flags instead of pointer
+	if ((chan->init_flags & CHANNEL_INIT_WRITE_MUTEX) && chan->write_mutex)
 	{
 		muggle_mutex_destroy(chan->write_mutex);
 		free(chan->write_mutex);
@@ -512,3 +1184,104 @@ void* muggle_channel_read(muggle_channel_t *chan)
 {
 	return chan->fn_read(chan);
 }
+
+uint32_t muggle_channel_write_n(
+	muggle_channel_t *chan, void **datas, uint32_t n)
+{
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	chan->fn_lock(chan);
+	uint32_t cnt = chan->fn_write_n(chan, datas, n);
+	chan->fn_unlock(chan);
+
+	if (cnt > 0)
+	{
+		chan->fn_wake(chan);
+	}
+
+	return cnt;
+}
+
+uint32_t muggle_channel_read_n(
+	muggle_channel_t *chan, void **datas, uint32_t max_n)
+{
+	if (max_n == 0)
+	{
+		return 0;
+	}
+
+	return chan->fn_read_n(chan, datas, max_n, NULL);
+}
+
+void* muggle_channel_try_read(muggle_channel_t *chan)
+{
+	static const struct timespec zero_timeout = { 0, 0 };
+	void *data = NULL;
+	chan->fn_read_n(chan, &data, 1, &zero_timeout);
+	return data;
+}
+
+uint32_t muggle_channel_try_read_n(
+	muggle_channel_t *chan, void **datas, uint32_t max_n)
+{
+	static const struct timespec zero_timeout = { 0, 0 };
+	if (max_n == 0)
+	{
+		return 0;
+	}
+
+	return chan->fn_read_n(chan, datas, max_n, &zero_timeout);
+}
+
+void* muggle_channel_read_timeout(
+	muggle_channel_t *chan, const struct timespec *timeout)
+{
+	void *data = NULL;
+	chan->fn_read_n(chan, &data, 1, timeout);
+	return data;
+}
+
+struct muggle_event_signal* muggle_channel_ev_signal(muggle_channel_t *chan)
+{
+	return chan->ev_signal;
+}
+
+int muggle_channel_ev_clearup(muggle_channel_t *chan)
+{
+	if (chan->ev_signal == NULL)
+	{
+		return MUGGLE_EVENT_ERROR;
+	}
+
+	// NOTE: must clearup event fd before rearm, otherwise signal from writer
+	// between rearm and clearup will be swallowed
+	int ret = muggle_ev_signal_clearup(chan->ev_signal);
+
+	muggle_atomic_store(&chan->ev_notified, 0, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	return ret;
+}
+
+int muggle_channel_ev_add_to_evloop(
+	muggle_channel_t *chan,
+	struct muggle_event_loop *evloop,
+	struct muggle_event_context *ctx)
+{
+	if (chan->ev_signal == NULL)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+	muggle_event_fd fd = muggle_ev_signal_rfd(chan->ev_signal);
+
+	int ret = muggle_ev_ctx_init(ctx, fd, chan);
+	if (ret != 0)
+	{
+		return ret;
+	}
+
+	return muggle_evloop_add_ctx(evloop, ctx);
+}
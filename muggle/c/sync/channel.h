@@ -8,7 +8,8 @@
  *  @brief        mugglec channel
  *
  * Passing data between threads, user must gurantee only one reader use channel
- * at the same time
+ * at the same time (except MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE, which allow
+ * multiple readers)
  *   - When channel full, write will failed and return enum MUGGLE_ERR_*
  *   - When channel empty, read will block until data write into channel
  *
@@ -27,8 +28,11 @@
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/sync/ticketlock.h"
+#include "muggle/c/sync/mcslock.h"
 #include "muggle/c/sync/sync_obj.h"
 #include "muggle/c/sync/synclock.h"
+#include "muggle/c/memory/page_alloc.h"
 
 EXTERN_C_BEGIN
 
@@ -42,6 +46,16 @@ enum
 	MUGGLE_CHANNEL_FLAG_WRITE_SPIN   = 2, //!< write lock use spinlock
 	MUGGLE_CHANNEL_FLAG_WRITE_SINGLE = 3, //!< user guarantee only one writer
 										  //   use this channel
+	MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE = 4, //!< lock-free bounded MPMC, every
+											//   slot has sequence number,
+											//   writers and readers only CAS
+											//   their own cursor, allow
+											//   multiple readers
+	MUGGLE_CHANNEL_FLAG_WRITE_TICKET = 5, //!< write lock use ticket lock,
+										  //   writers get lock in FIFO order
+	MUGGLE_CHANNEL_FLAG_WRITE_MCS    = 6, //!< write lock use MCS queue lock,
+										  //   writers spin on their own
+										  //   thread local node
 
 	MUGGLE_CHANNEL_FLAG_SINGLE_WRITER = MUGGLE_CHANNEL_FLAG_WRITE_SINGLE,
 };
@@ -55,6 +69,9 @@ enum
 	MUGGLE_CHANNEL_FLAG_READ_MUTEX = 1 << 4, //!< reader with mutex with
 	MUGGLE_CHANNEL_FLAG_READ_BUSY  = 2 << 4, //!< reader busy loop until read
 											 //   message from channel
+	MUGGLE_CHANNEL_FLAG_READ_EVENT = 3 << 4, //!< reader wait on event fd in
+											 //   event loop, see
+											 //   muggle_channel_ev_*
 
 	MUGGLE_CHANNEL_FLAG_READ_WAIT      = MUGGLE_CHANNEL_FLAG_READ_SYNC,
 	MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP = MUGGLE_CHANNEL_FLAG_READ_BUSY,
@@ -70,12 +87,20 @@ enum
 };
 
 struct muggle_channel;
+struct muggle_event_signal;
+struct muggle_event_loop;
+struct muggle_event_context;
 
 typedef void (*fn_muggle_channel_lock)(struct muggle_channel *chan);
 typedef int (*fn_muggle_channel_write)(struct muggle_channel *chan, void *data);
 typedef void (*fn_muggle_channel_unlock)(struct muggle_channel *chan);
 typedef void (*fn_muggle_channel_wake)(struct muggle_channel *chan);
 typedef void* (*fn_muggle_channel_read)(struct muggle_channel *chan);
+typedef uint32_t (*fn_muggle_channel_write_n)(
+	struct muggle_channel *chan, void **datas, uint32_t n);
+typedef uint32_t (*fn_muggle_channel_read_n)(
+	struct muggle_channel *chan, void **datas, uint32_t max_n,
+	const struct timespec *timeout);
 
 /**
  * @brief channel node block
@@ -83,7 +108,11 @@ typedef void* (*fn_muggle_channel_read)(struct muggle_channel *chan);
 typedef struct muggle_channel_block
 {
 	union {
-		void *data;
+		struct {
+			void          *data; //!< data pointer
+			muggle_sync_t seq;   //!< sequence number, only used in
+								 //   MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE
+		};
 		MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(0);
 	};
 }muggle_channel_block_t;
@@ -132,6 +161,8 @@ typedef struct muggle_channel
 		muggle_sync_t     write_synclock;  //!< wirte lock with synclock
 		muggle_spinlock_t write_spinlock;  //!< write lock with spinlock
 		muggle_mutex_t    *write_mutex;    //!< write lock with mutex
+		muggle_ticketlock_t write_ticketlock; //!< write lock with ticket lock
+		muggle_mcslock_t  write_mcslock;   //!< write lock with MCS lock
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
 	};
 	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(3);
@@ -141,6 +172,18 @@ typedef struct muggle_channel
 	muggle_condition_variable_t *read_cv;
 
 	muggle_channel_block_t *blocks;
+
+	// batch write & read
+	fn_muggle_channel_write_n fn_write_n; //!< batch write function
+	fn_muggle_channel_read_n  fn_read_n;  //!< batch read function
+
+	// event notify, only used in MUGGLE_CHANNEL_FLAG_READ_EVENT
+	struct muggle_event_signal *ev_signal; //!< event signal
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(4);
+	union {
+		muggle_atomic_int ev_notified; //!< event fd already be signaled
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+	};
 }muggle_channel_t;
 
 /**
@@ -158,6 +201,23 @@ MUGGLE_C_EXPORT
 int muggle_channel_init(
 	muggle_channel_t *chan, muggle_sync_t capacity, int flags);
 
+/**
+ * @brief init muggle_channel_t with page allocation attributes of blocks
+ *
+ * @param chan      pointer to muggle_channel_t
+ * @param capacity  capacity of channel
+ * @param flags     bitwise or MUGGLE_CHANNEL_FLAG_WRITE_* and MUGGLE_CHANNEL_FLAG_READ_*
+ * @param attr      page allocation attributes, NULL means heap
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_init_attr(
+	muggle_channel_t *chan, muggle_sync_t capacity, int flags,
+	const muggle_page_alloc_attr_t *attr);
+
 /**
  * @brief destroy muggle_channel_t
  *
@@ -189,6 +249,145 @@ int muggle_channel_write(muggle_channel_t *chan, void *data);
 MUGGLE_C_EXPORT
 void* muggle_channel_read(muggle_channel_t *chan);
 
+/**
+ * @brief write a batch of data into channel
+ *
+ * @param chan   pointer to muggle_channel_t
+ * @param datas  array of data pointer
+ * @param n      number of data in datas
+ *
+ * @return number of data written, from the head of datas
+ *
+ * @NOTE
+ *   Writer hold the write lock once, publish all written slots with a single
+ *   move of write cursor and wake reader once. When channel don't have
+ *   enough space, only part of datas will be written, user need to check
+ *   return value and retry the remaining
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_channel_write_n(
+	muggle_channel_t *chan, void **datas, uint32_t n);
+
+/**
+ * @brief read a batch of data from channel
+ *
+ * @param chan   pointer to muggle_channel_t
+ * @param datas  array for store data pointer
+ * @param max_n  max number of data to read
+ *
+ * @return number of data read
+ *
+ * @NOTE
+ *   When channel empty, block the same way as muggle_channel_read; once
+ *   there has data, read up to max_n data and move read cursor once
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_channel_read_n(
+	muggle_channel_t *chan, void **datas, uint32_t max_n);
+
+/**
+ * @brief try read data from channel, return immediately when channel empty
+ *
+ * @param chan  pointer to muggle_channel_t
+ *
+ * @return
+ *     - data pointer
+ *     - NULL when channel is empty
+ *
+ * @NOTE
+ *   NULL also can't be distinguished from the written NULL data, so don't
+ *   write NULL into channel if use try_read or read_timeout
+ */
+MUGGLE_C_EXPORT
+void* muggle_channel_try_read(muggle_channel_t *chan);
+
+/**
+ * @brief try read a batch of data from channel, never block
+ *
+ * @param chan   pointer to muggle_channel_t
+ * @param datas  array for store data pointer
+ * @param max_n  max number of data to read
+ *
+ * @return number of data read, 0 when channel is empty
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_channel_try_read_n(
+	muggle_channel_t *chan, void **datas, uint32_t max_n);
+
+/**
+ * @brief read data from channel, wait at most timeout
+ *
+ * @param chan     pointer to muggle_channel_t
+ * @param timeout  relative timeout, if NULL, wait until read data
+ *
+ * @return
+ *     - data pointer
+ *     - NULL when timeout
+ */
+MUGGLE_C_EXPORT
+void* muggle_channel_read_timeout(
+	muggle_channel_t *chan, const struct timespec *timeout);
+
+/**
+ * @brief get event signal of channel
+ *
+ * @param chan  pointer to muggle_channel_t
+ *
+ * @return
+ *     - event signal, use muggle_ev_signal_rfd to get the event fd that
+ *       readable when channel has data
+ *     - NULL if channel not MUGGLE_CHANNEL_FLAG_READ_EVENT
+ *
+ * @NOTE
+ *   In MUGGLE_CHANNEL_FLAG_READ_EVENT, writers only signal event fd when
+ *   the reader has cleared up the previous signal, so a burst of messages
+ *   cost one syscall. When event fd readable, reader must invoke
+ *   muggle_channel_ev_clearup first, then drain channel with
+ *   muggle_channel_try_read_n until it return 0, otherwise messages may be
+ *   left in channel without next signal.
+ *
+ *   The event signal belongs to the channel, don't destroy it or close its
+ *   fd.
+ */
+MUGGLE_C_EXPORT
+struct muggle_event_signal* muggle_channel_ev_signal(muggle_channel_t *chan);
+
+/**
+ * @brief clearup event fd of channel and rearm writers notification
+ *
+ * @param chan  pointer to muggle_channel_t
+ *
+ * @return
+ *     - number of times be wakeup
+ *     - on failed, return MUGGLE_EVENT_ERROR
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_ev_clearup(muggle_channel_t *chan);
+
+/**
+ * @brief add channel event fd into event loop
+ *
+ * @param chan    pointer to muggle_channel_t
+ * @param evloop  event loop
+ * @param ctx     event context, initialized with channel's event fd and
+ *                use channel as context data
+ *
+ * @return
+ *     - 0 on success
+ *     - otherwise failed
+ *
+ * @NOTE
+ *   The same as muggle_evloop_add_ctx, invoke it before event loop run or
+ *   in event loop thread. In evloop read callback, get channel via
+ *   muggle_ev_ctx_data(ctx). Don't close ctx in evloop callbacks, the event
+ *   fd is released in muggle_channel_destroy.
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_ev_add_to_evloop(
+	muggle_channel_t *chan,
+	struct muggle_event_loop *evloop,
+	struct muggle_event_context *ctx);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,255 @@
+#include "ebr.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+// epoch wrap around in 30 bits, local epoch = (epoch << 1) | active still
+// fit in muggle_atomic_int
+#define MUGGLE_EBR_EPOCH_MASK 0x3FFFFFFFu
+
+#define MUGGLE_EBR_LOCAL_ACTIVE 1
+
+#define MUGGLE_EBR_EPOCH_DIFF(a, b) \
+	(((uint32_t)(a) - (uint32_t)(b)) & MUGGLE_EBR_EPOCH_MASK)
+
+static void muggle_ebr_retire_list_free(
+	muggle_ebr_t *ebr, muggle_ebr_retire_list_t *list)
+{
+	for (uint32_t i = 0; i < list->cnt; i++)
+	{
+		ebr->free_fn(list->ptrs[i]);
+	}
+	list->cnt = 0;
+}
+
+/**
+ * @brief try advance global epoch
+ *
+ * @param ebr  pointer to ebr
+ *
+ * @return current global epoch
+ */
+static uint32_t muggle_ebr_try_advance(muggle_ebr_t *ebr)
+{
+	muggle_atomic_int epoch =
+		muggle_atomic_load(&ebr->global_epoch, muggle_memory_order_seq_cst);
+
+	for (uint32_t i = 0; i < ebr->n_thread; i++)
+	{
+		muggle_ebr_thread_t *thr = &ebr->threads[i];
+		if (!muggle_atomic_load(&thr->in_use, muggle_memory_order_acquire))
+		{
+			continue;
+		}
+
+		muggle_atomic_int local =
+			muggle_atomic_load(&thr->local_epoch, muggle_memory_order_acquire);
+		if ((local & MUGGLE_EBR_LOCAL_ACTIVE) &&
+			(uint32_t)(local >> 1) != (uint32_t)epoch)
+		{
+			// active reader has not observed current epoch yet
+			return (uint32_t)epoch;
+		}
+	}
+
+	muggle_atomic_int next =
+		(muggle_atomic_int)(((uint32_t)epoch + 1) & MUGGLE_EBR_EPOCH_MASK);
+	if (!muggle_atomic_cmp_exch_strong(
+			&ebr->global_epoch, &epoch, next, muggle_memory_order_seq_cst))
+	{
+		// other thread already advanced, epoch is updated by CAS
+		return (uint32_t)epoch;
+	}
+
+	return (uint32_t)next;
+}
+
+/**
+ * @brief free retire lists which no reader could hold
+ *
+ * @param thr    thread record
+ * @param epoch  current global epoch
+ *
+ * @return number of objects freed
+ */
+static uint32_t muggle_ebr_collect(muggle_ebr_thread_t *thr, uint32_t epoch)
+{
+	uint32_t n = 0;
+	for (int i = 0; i < MUGGLE_EBR_N_EPOCH; i++)
+	{
+		muggle_ebr_retire_list_t *list = &thr->lists[i];
+		if (list->cnt > 0 && MUGGLE_EBR_EPOCH_DIFF(epoch, list->epoch) >= 2)
+		{
+			n += list->cnt;
+			muggle_ebr_retire_list_free(thr->ebr, list);
+		}
+	}
+	return n;
+}
+
+int muggle_ebr_init(
+	muggle_ebr_t *ebr, uint32_t n_thread, uint32_t batch,
+	muggle_ebr_free_fn free_fn)
+{
+	memset(ebr, 0, sizeof(*ebr));
+
+	if (n_thread == 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	ebr->threads = (muggle_ebr_thread_t*)calloc(
+		n_thread, sizeof(muggle_ebr_thread_t));
+	if (ebr->threads == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	ebr->n_thread = n_thread;
+	ebr->batch = batch ? batch : MUGGLE_EBR_DEFAULT_BATCH;
+	ebr->free_fn = free_fn ? free_fn : free;
+
+	for (uint32_t i = 0; i < n_thread; i++)
+	{
+		ebr->threads[i].ebr = ebr;
+	}
+
+	muggle_atomic_store(&ebr->global_epoch, 0, muggle_memory_order_release);
+
+	return 0;
+}
+
+void muggle_ebr_destroy(muggle_ebr_t *ebr)
+{
+	if (ebr->threads == NULL)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < ebr->n_thread; i++)
+	{
+		muggle_ebr_thread_t *thr = &ebr->threads[i];
+		for (int j = 0; j < MUGGLE_EBR_N_EPOCH; j++)
+		{
+			muggle_ebr_retire_list_t *list = &thr->lists[j];
+			muggle_ebr_retire_list_free(ebr, list);
+			if (list->ptrs)
+			{
+				free(list->ptrs);
+			}
+		}
+	}
+
+	free(ebr->threads);
+	ebr->threads = NULL;
+}
+
+muggle_ebr_thread_t* muggle_ebr_register(muggle_ebr_t *ebr)
+{
+	for (uint32_t i = 0; i < ebr->n_thread; i++)
+	{
+		muggle_ebr_thread_t *thr = &ebr->threads[i];
+		muggle_atomic_int expected = 0;
+		if (muggle_atomic_load(&thr->in_use, muggle_memory_order_relaxed) == 0 &&
+			muggle_atomic_cmp_exch_strong(
+				&thr->in_use, &expected, 1, muggle_memory_order_acquire))
+		{
+			thr->nesting = 0;
+			thr->n_retire = 0;
+			muggle_atomic_store(&thr->local_epoch, 0, muggle_memory_order_relaxed);
+			return thr;
+		}
+	}
+
+	return NULL;
+}
+
+void muggle_ebr_unregister(muggle_ebr_thread_t *thr)
+{
+	thr->nesting = 0;
+	muggle_atomic_store(&thr->local_epoch, 0, muggle_memory_order_release);
+	muggle_atomic_store(&thr->in_use, 0, muggle_memory_order_release);
+}
+
+void muggle_ebr_enter(muggle_ebr_thread_t *thr)
+{
+	if (thr->nesting++ > 0)
+	{
+		return;
+	}
+
+	muggle_atomic_int epoch = muggle_atomic_load(
+		&thr->ebr->global_epoch, muggle_memory_order_relaxed);
+	muggle_atomic_store(
+		&thr->local_epoch, (epoch << 1) | MUGGLE_EBR_LOCAL_ACTIVE,
+		muggle_memory_order_relaxed);
+
+	// make local epoch visible before load any shared pointer
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+}
+
+void muggle_ebr_exit(muggle_ebr_thread_t *thr)
+{
+	if (--thr->nesting > 0)
+	{
+		return;
+	}
+
+	muggle_atomic_int local =
+		muggle_atomic_load(&thr->local_epoch, muggle_memory_order_relaxed);
+	muggle_atomic_store(
+		&thr->local_epoch, local & ~MUGGLE_EBR_LOCAL_ACTIVE,
+		muggle_memory_order_release);
+}
+
+int muggle_ebr_retire(muggle_ebr_thread_t *thr, void *ptr)
+{
+	uint32_t epoch = (uint32_t)muggle_atomic_load(
+		&thr->ebr->global_epoch, muggle_memory_order_seq_cst);
+
+	muggle_ebr_collect(thr, epoch);
+
+	// only lists of epoch and epoch - 1 may be kept after collect, so there
+	// is always a list for current epoch
+	muggle_ebr_retire_list_t *list = NULL;
+	for (int i = 0; i < MUGGLE_EBR_N_EPOCH; i++)
+	{
+		muggle_ebr_retire_list_t *cur = &thr->lists[i];
+		if (cur->cnt > 0 && cur->epoch == epoch)
+		{
+			list = cur;
+			break;
+		}
+		if (cur->cnt == 0 && list == NULL)
+		{
+			list = cur;
+		}
+	}
+	list->epoch = epoch;
+
+	if (list->cnt == list->capacity)
+	{
+		uint32_t capacity = list->capacity ? list->capacity * 2 : thr->ebr->batch;
+		void **ptrs = (void**)realloc(list->ptrs, sizeof(void*) * capacity);
+		if (ptrs == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		list->ptrs = ptrs;
+		list->capacity = capacity;
+	}
+	list->ptrs[list->cnt++] = ptr;
+
+	if (++thr->n_retire >= thr->ebr->batch)
+	{
+		muggle_ebr_reclaim(thr);
+	}
+
+	return 0;
+}
+
+uint32_t muggle_ebr_reclaim(muggle_ebr_thread_t *thr)
+{
+	thr->n_retire = 0;
+	return muggle_ebr_collect(thr, muggle_ebr_try_advance(thr->ebr));
+}
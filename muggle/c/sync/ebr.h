@@ -0,0 +1,197 @@
+/******************************************************************************
+ *  @file         ebr.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec epoch-based memory reclamation
+ *
+ *  readers enter critical section before dereference shared pointers and
+ *  exit after all references dropped, writers unlink objects and retire
+ *  them instead of free immediately; the global epoch advances only when
+ *  every active reader has observed it, objects retired in epoch e are
+ *  freed in batch after the global epoch reaches e + 2, at that time no
+ *  reader could still hold them
+ *
+ *  readers never take locks and writers never wait for readers, the cost
+ *  is retired objects may be kept for a while when reader stay in critical
+ *  section for a long time
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_EBR_H_
+#define MUGGLE_C_EBR_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+// number of epoch buckets of retire list
+#define MUGGLE_EBR_N_EPOCH 3
+
+// default number of retired objects before try to reclaim
+#define MUGGLE_EBR_DEFAULT_BATCH 64
+
+/**
+ * @brief function used to free retired object, e.g. free or
+ * muggle_ts_memory_pool_free
+ *
+ * @param ptr  retired object
+ */
+typedef void (*muggle_ebr_free_fn)(void *ptr);
+
+/**
+ * @brief retired objects of one epoch
+ */
+typedef struct muggle_ebr_retire_list
+{
+	uint32_t          epoch;    //!< epoch of objects retired
+	void            **ptrs;     //!< retired objects
+	uint32_t          cnt;      //!< number of retired objects
+	uint32_t          capacity; //!< capacity of ptrs
+} muggle_ebr_retire_list_t;
+
+struct muggle_ebr;
+
+/**
+ * @brief thread record of epoch-based reclamation
+ */
+typedef struct muggle_ebr_thread
+{
+	union {
+		muggle_atomic_int local_epoch; //!< (epoch << 1) | active
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	muggle_atomic_int in_use;   //!< record registered by thread
+	uint32_t          nesting;  //!< nesting level of critical section
+	uint32_t          n_retire; //!< retired count since last reclaim
+	struct muggle_ebr *ebr;     //!< owner
+	muggle_ebr_retire_list_t lists[MUGGLE_EBR_N_EPOCH]; //!< retire lists
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+} muggle_ebr_thread_t;
+
+/**
+ * @brief epoch-based reclamation domain
+ */
+typedef struct muggle_ebr
+{
+	union {
+		muggle_atomic_int global_epoch; //!< global epoch
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	muggle_ebr_thread_t *threads;   //!< thread records
+	uint32_t             n_thread;  //!< max number of threads
+	uint32_t             batch;     //!< retired count to try reclaim
+	muggle_ebr_free_fn   free_fn;   //!< free function of retired objects
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+} muggle_ebr_t;
+
+/**
+ * @brief initialize epoch-based reclamation domain
+ *
+ * @param ebr        pointer to ebr
+ * @param n_thread   max number of threads register at the same time
+ * @param batch      number of retired objects before try reclaim, 0 means
+ *                   MUGGLE_EBR_DEFAULT_BATCH
+ * @param free_fn    free function of retired objects, NULL means free
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_init(
+	muggle_ebr_t *ebr, uint32_t n_thread, uint32_t batch,
+	muggle_ebr_free_fn free_fn);
+
+/**
+ * @brief destroy epoch-based reclamation domain, all retired objects are
+ * freed
+ *
+ * @param ebr  pointer to ebr
+ *
+ * @NOTE
+ *     all threads must already leave critical section
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_destroy(muggle_ebr_t *ebr);
+
+/**
+ * @brief register current thread
+ *
+ * @param ebr  pointer to ebr
+ *
+ * @return
+ *     - on success, return thread record, only used in the caller thread
+ *     - return NULL when all records are in use
+ *
+ * @NOTE
+ *     record released by muggle_ebr_unregister is reused, objects retired
+ *     by previous owner are still reclaimed by the new owner
+ */
+MUGGLE_C_EXPORT
+muggle_ebr_thread_t* muggle_ebr_register(muggle_ebr_t *ebr);
+
+/**
+ * @brief unregister thread record
+ *
+ * @param thr  thread record
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_unregister(muggle_ebr_thread_t *thr);
+
+/**
+ * @brief enter critical section, shared pointers loaded in critical section
+ * are valid until exit
+ *
+ * @param thr  thread record
+ *
+ * @NOTE
+ *     critical section could be nested
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_enter(muggle_ebr_thread_t *thr);
+
+/**
+ * @brief exit critical section
+ *
+ * @param thr  thread record
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_exit(muggle_ebr_thread_t *thr);
+
+/**
+ * @brief retire object which already unlinked from shared structure
+ *
+ * @param thr  thread record
+ * @param ptr  object
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_MEM_ALLOC when failed grow retire list, object is
+ *       not retired
+ *
+ * @NOTE
+ *     every batch retired objects, try advance global epoch and free
+ *     objects which no reader could hold
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_retire(muggle_ebr_thread_t *thr, void *ptr);
+
+/**
+ * @brief try advance global epoch and free objects which no reader could
+ * hold
+ *
+ * @param thr  thread record
+ *
+ * @return number of objects freed
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_ebr_reclaim(muggle_ebr_thread_t *thr);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_EBR_H_
@@ -0,0 +1,80 @@
+#include "eventcount.h"
+#include <stdbool.h>
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+// number of spin before park
+#define MUGGLE_EVENTCOUNT_SPIN 128
+
+void muggle_eventcount_init(muggle_eventcount_t *ec)
+{
+	ec->n_waiters = 0;
+	muggle_atomic_store(&ec->epoch, 0, muggle_memory_order_release);
+}
+
+muggle_sync_t muggle_eventcount_prepare_wait(muggle_eventcount_t *ec)
+{
+	// NOTE: waiter increase n_waiters before check condition, notifier
+	// make condition true before check n_waiters (pair with the fence in
+	// muggle_eventcount_notify)
+	muggle_atomic_fetch_add(&ec->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	return muggle_atomic_load(&ec->epoch, muggle_memory_order_acquire);
+}
+
+void muggle_eventcount_cancel_wait(muggle_eventcount_t *ec)
+{
+	muggle_atomic_fetch_sub(&ec->n_waiters, 1, muggle_memory_order_relaxed);
+}
+
+void muggle_eventcount_commit_wait(muggle_eventcount_t *ec, muggle_sync_t key)
+{
+	for (int i = 0; i < MUGGLE_EVENTCOUNT_SPIN; i++)
+	{
+		if (muggle_atomic_load(&ec->epoch, muggle_memory_order_acquire) != key)
+		{
+			muggle_eventcount_cancel_wait(ec);
+			return;
+		}
+		muggle_sync_cpu_relax();
+	}
+
+	while (muggle_atomic_load(&ec->epoch, muggle_memory_order_acquire) == key)
+	{
+		muggle_sync_wait(&ec->epoch, key, NULL);
+	}
+	muggle_eventcount_cancel_wait(ec);
+}
+
+static void muggle_eventcount_notify(muggle_eventcount_t *ec, bool all)
+{
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&ec->n_waiters, muggle_memory_order_relaxed) == 0)
+	{
+		return;
+	}
+
+	muggle_atomic_fetch_add(&ec->epoch, 1, muggle_memory_order_release);
+	if (all)
+	{
+		muggle_sync_wake_all(&ec->epoch);
+	}
+	else
+	{
+		muggle_sync_wake_one(&ec->epoch);
+	}
+}
+
+void muggle_eventcount_notify_one(muggle_eventcount_t *ec)
+{
+	muggle_eventcount_notify(ec, false);
+}
+
+void muggle_eventcount_notify_all(muggle_eventcount_t *ec)
+{
+	muggle_eventcount_notify(ec, true);
+}
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
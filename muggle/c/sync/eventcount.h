@@ -0,0 +1,100 @@
+/******************************************************************************
+ *  @file         eventcount.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec event count
+ *
+ *  event count add blocking to any lock-free condition without lost
+ *  wakeup, waiter use two-phase wait:
+ *
+ *  while (!condition()) {
+ *      key = muggle_eventcount_prepare_wait(ec);
+ *      if (condition()) {
+ *          muggle_eventcount_cancel_wait(ec);
+ *          break;
+ *      }
+ *      muggle_eventcount_commit_wait(ec, key);
+ *  }
+ *
+ *  notifier make condition true, then call muggle_eventcount_notify_*,
+ *  notify is only an atomic load when there is no waiter
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_EVENTCOUNT_H_
+#define MUGGLE_C_EVENTCOUNT_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/sync_obj.h"
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+typedef struct muggle_eventcount
+{
+	muggle_sync_t epoch;     //!< increased by every notify with waiters
+	muggle_sync_t n_waiters; //!< number of prepared waiters
+} muggle_eventcount_t;
+
+/**
+ * @brief initialize event count
+ *
+ * @param ec  event count
+ */
+MUGGLE_C_EXPORT
+void muggle_eventcount_init(muggle_eventcount_t *ec);
+
+/**
+ * @brief prepare wait, must followed by cancel_wait or commit_wait
+ *
+ * @param ec  event count
+ *
+ * @return wait key
+ */
+MUGGLE_C_EXPORT
+muggle_sync_t muggle_eventcount_prepare_wait(muggle_eventcount_t *ec);
+
+/**
+ * @brief cancel prepared wait, the condition already satisfied
+ *
+ * @param ec  event count
+ */
+MUGGLE_C_EXPORT
+void muggle_eventcount_cancel_wait(muggle_eventcount_t *ec);
+
+/**
+ * @brief block until notified after the key prepared
+ *
+ * @param ec   event count
+ * @param key  key returned by muggle_eventcount_prepare_wait
+ *
+ * @NOTE
+ *     return doesn't mean condition is satisfied, waiter must check it again
+ */
+MUGGLE_C_EXPORT
+void muggle_eventcount_commit_wait(muggle_eventcount_t *ec, muggle_sync_t key);
+
+/**
+ * @brief wake at least one waiter
+ *
+ * @param ec  event count
+ */
+MUGGLE_C_EXPORT
+void muggle_eventcount_notify_one(muggle_eventcount_t *ec);
+
+/**
+ * @brief wake all waiters
+ *
+ * @param ec  event count
+ */
+MUGGLE_C_EXPORT
+void muggle_eventcount_notify_all(muggle_eventcount_t *ec);
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_EVENTCOUNT_H_
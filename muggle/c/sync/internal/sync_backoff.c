@@ -0,0 +1,35 @@
+#include "sync_backoff.h"
+#include "muggle/c/base/thread.h"
+
+void muggle_sync_backoff_init(muggle_sync_backoff_t *b)
+{
+	b->n_relax = 1;
+}
+
+void muggle_sync_backoff(muggle_sync_backoff_t *b)
+{
+	if (b->n_relax > MUGGLE_SYNC_BACKOFF_MAX_RELAX)
+	{
+		// already spin long enough, owner may be preempted
+		muggle_thread_yield();
+		return;
+	}
+
+	for (uint32_t i = 0; i < b->n_relax; i++)
+	{
+		muggle_sync_cpu_relax();
+	}
+	b->n_relax <<= 1;
+}
+
+void muggle_sync_backoff_n(uint32_t n)
+{
+	if (n > MUGGLE_SYNC_BACKOFF_MAX_RELAX)
+	{
+		n = MUGGLE_SYNC_BACKOFF_MAX_RELAX;
+	}
+	for (uint32_t i = 0; i < n; i++)
+	{
+		muggle_sync_cpu_relax();
+	}
+}
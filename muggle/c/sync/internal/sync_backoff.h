@@ -0,0 +1,67 @@
+/******************************************************************************
+ *  @file         sync_backoff.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec spin backoff, cpu relax hint with bounded
+ *                exponential backoff for busy wait loops
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SYNC_BACKOFF_H_
+#define MUGGLE_C_SYNC_BACKOFF_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+
+#if MUGGLE_PLATFORM_WINDOWS
+	#define muggle_sync_cpu_relax() YieldProcessor()
+#elif defined(__x86_64__) || defined(__i386__)
+	#define muggle_sync_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define muggle_sync_cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+	#define muggle_sync_cpu_relax() \
+		muggle_atomic_signal_fence(muggle_memory_order_seq_cst)
+#endif
+
+// max number of cpu relax in one backoff
+#define MUGGLE_SYNC_BACKOFF_MAX_RELAX 1024
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief spin backoff
+ */
+typedef struct muggle_sync_backoff
+{
+	uint32_t n_relax; //!< number of cpu relax in next backoff
+} muggle_sync_backoff_t;
+
+/**
+ * @brief initialize backoff
+ *
+ * @param b  backoff
+ */
+void muggle_sync_backoff_init(muggle_sync_backoff_t *b);
+
+/**
+ * @brief spin with cpu relax hint, double the spin count every time until
+ * reach MUGGLE_SYNC_BACKOFF_MAX_RELAX, then yield thread
+ *
+ * @param b  backoff
+ */
+void muggle_sync_backoff(muggle_sync_backoff_t *b);
+
+/**
+ * @brief spin with cpu relax hint n times
+ *
+ * @param n  number of cpu relax, bounded by MUGGLE_SYNC_BACKOFF_MAX_RELAX
+ */
+void muggle_sync_backoff_n(uint32_t n);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SYNC_BACKOFF_H_
@@ -0,0 +1,99 @@
+#include "sync_deadline.h"
+#include "muggle/c/time/realtime_get.h"
+
+#define MUGGLE_SYNC_DEADLINE_NS_PER_SEC 1000000000L
+
+void muggle_sync_deadline_init(
+	muggle_sync_deadline_t *d, const struct timespec *timeout)
+{
+	d->timeout = timeout;
+	d->abs_ts.tv_sec = 0;
+	d->abs_ts.tv_nsec = 0;
+	d->started = false;
+}
+
+bool muggle_sync_deadline_is_zero(muggle_sync_deadline_t *d)
+{
+	return d->timeout &&
+		d->timeout->tv_sec <= 0 && d->timeout->tv_nsec <= 0;
+}
+
+static void muggle_sync_deadline_start(muggle_sync_deadline_t *d)
+{
+	if (d->started)
+	{
+		return;
+	}
+
+	struct timespec ts;
+	muggle_realtime_get(ts);
+	ts.tv_sec += d->timeout->tv_sec;
+	ts.tv_nsec += d->timeout->tv_nsec;
+	while (ts.tv_nsec >= MUGGLE_SYNC_DEADLINE_NS_PER_SEC)
+	{
+		ts.tv_sec += 1;
+		ts.tv_nsec -= MUGGLE_SYNC_DEADLINE_NS_PER_SEC;
+	}
+	d->abs_ts = ts;
+	d->started = true;
+}
+
+bool muggle_sync_deadline_remain(
+	muggle_sync_deadline_t *d,
+	struct timespec *remain,
+	const struct timespec **p_wait)
+{
+	if (d->timeout == NULL)
+	{
+		*p_wait = NULL;
+		return true;
+	}
+
+	if (muggle_sync_deadline_is_zero(d))
+	{
+		return false;
+	}
+
+	muggle_sync_deadline_start(d);
+
+	struct timespec now;
+	muggle_realtime_get(now);
+
+	remain->tv_sec = d->abs_ts.tv_sec - now.tv_sec;
+	remain->tv_nsec = d->abs_ts.tv_nsec - now.tv_nsec;
+	if (remain->tv_nsec < 0)
+	{
+		remain->tv_sec -= 1;
+		remain->tv_nsec += MUGGLE_SYNC_DEADLINE_NS_PER_SEC;
+	}
+	if (remain->tv_sec < 0 || (remain->tv_sec == 0 && remain->tv_nsec == 0))
+	{
+		return false;
+	}
+
+	*p_wait = remain;
+	return true;
+}
+
+bool muggle_sync_deadline_cv(
+	muggle_sync_deadline_t *d,
+	struct timespec *ts,
+	const struct timespec **p_wait)
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	// SleepConditionVariableCS use relative milliseconds
+	return muggle_sync_deadline_remain(d, ts, p_wait);
+#else
+	// pthread_cond_timedwait use absolute time
+	if (!muggle_sync_deadline_remain(d, ts, p_wait))
+	{
+		return false;
+	}
+	if (*p_wait)
+	{
+		*ts = d->abs_ts;
+		*p_wait = ts;
+	}
+	return true;
+#endif
+}
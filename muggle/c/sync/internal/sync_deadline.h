@@ -0,0 +1,82 @@
+/******************************************************************************
+ *  @file         sync_deadline.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec sync deadline, convert relative timeout for waits
+ *
+ *  muggle_sync_wait accept relative timeout, but in *nix
+ *  muggle_condition_variable_wait accept absolute time, this helper keep the
+ *  deadline of a wait loop and return the timeout argument each wait need
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SYNC_DEADLINE_H_
+#define MUGGLE_C_SYNC_DEADLINE_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdbool.h>
+#include <time.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief deadline of wait loop
+ */
+typedef struct muggle_sync_deadline
+{
+	const struct timespec *timeout; //!< relative timeout, NULL means infinite
+	struct timespec        abs_ts;  //!< absolute deadline in realtime
+	bool                   started; //!< abs_ts already calculated
+} muggle_sync_deadline_t;
+
+/**
+ * @brief initialize deadline
+ *
+ * @param d        deadline
+ * @param timeout  relative timeout, NULL means wait infinite
+ */
+void muggle_sync_deadline_init(
+	muggle_sync_deadline_t *d, const struct timespec *timeout);
+
+/**
+ * @brief check timeout is zero, caller can return immediately without wait
+ *
+ * @param d  deadline
+ *
+ * @return boolean
+ */
+bool muggle_sync_deadline_is_zero(muggle_sync_deadline_t *d);
+
+/**
+ * @brief get relative timeout for muggle_sync_wait
+ *
+ * @param d       deadline
+ * @param remain  output remain time
+ * @param p_wait  output timeout argument of wait, NULL means infinite
+ *
+ * @return false if deadline already expired
+ */
+bool muggle_sync_deadline_remain(
+	muggle_sync_deadline_t *d,
+	struct timespec *remain,
+	const struct timespec **p_wait);
+
+/**
+ * @brief get timeout for muggle_condition_variable_wait
+ *
+ * @param d       deadline
+ * @param ts      output timespec
+ * @param p_wait  output timeout argument of wait, NULL means infinite
+ *
+ * @return false if deadline already expired
+ */
+bool muggle_sync_deadline_cv(
+	muggle_sync_deadline_t *d,
+	struct timespec *ts,
+	const struct timespec **p_wait);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SYNC_DEADLINE_H_
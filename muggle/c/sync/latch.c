@@ -0,0 +1,70 @@
+#include "latch.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+// number of spin before park
+#define MUGGLE_LATCH_SPIN 128
+
+void muggle_latch_init(muggle_latch_t *latch, muggle_sync_t count)
+{
+	latch->n_waiters = 0;
+	muggle_atomic_store(&latch->count, count, muggle_memory_order_release);
+}
+
+void muggle_latch_count_down(muggle_latch_t *latch, muggle_sync_t n)
+{
+	muggle_sync_t v =
+		muggle_atomic_fetch_sub(&latch->count, n, muggle_memory_order_acq_rel);
+	if (v != n)
+	{
+		return;
+	}
+
+	// pair with the fence in muggle_latch_wait
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&latch->n_waiters, muggle_memory_order_relaxed))
+	{
+		muggle_sync_wake_all(&latch->count);
+	}
+}
+
+bool muggle_latch_try_wait(muggle_latch_t *latch)
+{
+	return muggle_atomic_load(&latch->count, muggle_memory_order_acquire) == 0;
+}
+
+void muggle_latch_wait(muggle_latch_t *latch)
+{
+	for (int i = 0; i < MUGGLE_LATCH_SPIN; i++)
+	{
+		if (muggle_latch_try_wait(latch))
+		{
+			return;
+		}
+		muggle_sync_cpu_relax();
+	}
+
+	muggle_atomic_fetch_add(&latch->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	while (1)
+	{
+		muggle_sync_t c =
+			muggle_atomic_load(&latch->count, muggle_memory_order_acquire);
+		if (c == 0)
+		{
+			break;
+		}
+		muggle_sync_wait(&latch->count, c, NULL);
+	}
+	muggle_atomic_fetch_sub(&latch->n_waiters, 1, muggle_memory_order_relaxed);
+}
+
+void muggle_latch_arrive_and_wait(muggle_latch_t *latch)
+{
+	muggle_latch_count_down(latch, 1);
+	muggle_latch_wait(latch);
+}
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *  @file         latch.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec countdown latch
+ *
+ *  single use countdown latch built on sync object, waiters block until the
+ *  counter reaches zero, e.g. start gate of threads
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LATCH_H_
+#define MUGGLE_C_LATCH_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/sync_obj.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+typedef struct muggle_latch
+{
+	muggle_sync_t count;     //!< remaining count
+	muggle_sync_t n_waiters; //!< number of parked waiters
+} muggle_latch_t;
+
+/**
+ * @brief initialize latch
+ *
+ * @param latch  latch
+ * @param count  initial count
+ */
+MUGGLE_C_EXPORT
+void muggle_latch_init(muggle_latch_t *latch, muggle_sync_t count);
+
+/**
+ * @brief decrease latch count, wake all waiters when count reaches zero
+ *
+ * @param latch  latch
+ * @param n      number to decrease, must not larger than remaining count
+ */
+MUGGLE_C_EXPORT
+void muggle_latch_count_down(muggle_latch_t *latch, muggle_sync_t n);
+
+/**
+ * @brief check whether latch count reaches zero without block
+ *
+ * @param latch  latch
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_latch_try_wait(muggle_latch_t *latch);
+
+/**
+ * @brief block until latch count reaches zero
+ *
+ * @param latch  latch
+ */
+MUGGLE_C_EXPORT
+void muggle_latch_wait(muggle_latch_t *latch);
+
+/**
+ * @brief count down 1 and wait latch count reaches zero
+ *
+ * @param latch  latch
+ */
+MUGGLE_C_EXPORT
+void muggle_latch_arrive_and_wait(muggle_latch_t *latch);
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_LATCH_H_
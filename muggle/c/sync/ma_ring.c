@@ -4,6 +4,10 @@
 #include "muggle/c/base/utils.h"
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#endif
 
 #define MUGGLE_MA_RING_CACHE_LINE 64
 #define MUGGLE_MA_RING_CACHE_INTERVAL (2 * MUGGLE_MA_RING_CACHE_LINE)
@@ -12,6 +16,10 @@
 #define MUGGLE_MA_RING_DEFAULT_BLOCK_SIZE 1024
 #define MUGGLE_MA_RING_DEFAULT_DATA_SIZE \
 	(MUGGLE_MA_RING_DEFAULT_BLOCK_SIZE - MUGGLE_MA_RING_CACHE_INTERVAL)
+#define MUGGLE_MA_RING_DEFAULT_MAX_REORDER 1000000 // 1ms
+#define MUGGLE_MA_RING_SPIN_CNT 1024
+
+#define MUGGLE_MA_RING_BLOCK_HDR_SIZE sizeof(muggle_ma_ring_block_hdr_t)
 
 static void s_default_ma_ring_cb(muggle_ma_ring_t *ring, void *data)
 {
@@ -19,27 +27,75 @@ static void s_default_ma_ring_cb(muggle_ma_ring_t *ring, void *data)
 	MUGGLE_UNUSED(data);
 }
 
-static void muggle_ma_ring_handle_new(muggle_ma_ring_context_t *ctx)
+static uint64_t s_default_ma_ring_stamp()
 {
-	muggle_spinlock_lock(&ctx->spinlock);
+#if MUGGLE_PLATFORM_WINDOWS
+	static LARGE_INTEGER freq = { 0 };
+	LARGE_INTEGER cnt;
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&cnt);
+	return (uint64_t)((double)cnt.QuadPart * 1000000000.0 / freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static void muggle_ma_ring_update_block_size(muggle_ma_ring_context_t *ctx)
+{
+	if (ctx->varlen) {
+		ctx->block_size = MUGGLE_CACHE_LINE_SIZE;
+		return;
+	}
+
+	muggle_sync_t hdr_size =
+		ctx->ordered ? (muggle_sync_t)MUGGLE_MA_RING_BLOCK_HDR_SIZE : 0;
+	ctx->block_size = MUGGLE_ALIGN_TRUE_SHARING(hdr_size + ctx->data_size);
+}
+
+static void muggle_ma_ring_wake_backend(muggle_ma_ring_backend_t *backend)
+{
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	// pair with the fence in muggle_ma_ring_backend_park
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&backend->parked, muggle_memory_order_relaxed) &&
+		muggle_atomic_exchange(&backend->parked, 0,
+							   muggle_memory_order_acq_rel)) {
+		muggle_sync_wake_one(&backend->parked);
+	}
+#else
+	MUGGLE_UNUSED(backend);
+#endif
+}
 
-	while (ctx->add_list.next) {
+static void muggle_ma_ring_handle_new_nolock(muggle_ma_ring_backend_t *backend)
+{
+	while (backend->add_list.next) {
 		// remove from add list
-		muggle_ma_ring_list_node_t *node = ctx->add_list.next;
-		ctx->add_list.next = node->next;
+		muggle_ma_ring_list_node_t *node = backend->add_list.next;
+		backend->add_list.next = node->next;
 		node->next = NULL;
 
 		// add into ring list
-		node->next = ctx->ring_list.next;
-		ctx->ring_list.next = node;
+		node->next = backend->ring_list.next;
+		backend->ring_list.next = node;
 	}
+}
 
+static void muggle_ma_ring_handle_new(muggle_ma_ring_context_t *ctx,
+									  muggle_ma_ring_backend_t *backend)
+{
+	muggle_spinlock_lock(&ctx->spinlock);
+	muggle_ma_ring_handle_new_nolock(backend);
 	muggle_spinlock_unlock(&ctx->spinlock);
 }
 
-static void muggle_ma_ring_handle_remove(muggle_ma_ring_context_t *ctx)
+static void muggle_ma_ring_handle_remove(muggle_ma_ring_backend_t *backend)
 {
-	muggle_ma_ring_list_node_t *prev = &ctx->ring_list;
+	muggle_ma_ring_list_node_t *prev = &backend->ring_list;
 	muggle_ma_ring_list_node_t *node = prev->next;
 	while (node) {
 		muggle_sync_t status = muggle_atomic_load(&node->ring->status,
@@ -60,12 +116,55 @@ static void muggle_ma_ring_handle_remove(muggle_ma_ring_context_t *ctx)
 	}
 }
 
+// get header of ring's next record, return NULL if ring is empty
+static muggle_ma_ring_block_hdr_t *
+muggle_ma_ring_head(muggle_ma_ring_context_t *ctx, muggle_ma_ring_t *ring)
+{
+	muggle_sync_t w =
+		muggle_atomic_load(&ring->wpos, muggle_memory_order_acquire);
+	if (ring->rpos == w) {
+		return NULL;
+	}
+
+	muggle_ma_ring_block_hdr_t *hdr =
+		(muggle_ma_ring_block_hdr_t *)((char *)ring->buffer +
+									   ctx->block_size * ring->rpos);
+	if (ctx->varlen && hdr->n_cachelines == 0) {
+		// writer wrapped, record at the start of ring already published
+		muggle_atomic_store(&ring->rpos, 0, muggle_memory_order_release);
+		hdr = (muggle_ma_ring_block_hdr_t *)ring->buffer;
+	}
+	return hdr;
+}
+
+// move ring reader over the record returned by muggle_ma_ring_head
+static void muggle_ma_ring_advance(muggle_ma_ring_context_t *ctx,
+								   muggle_ma_ring_t *ring,
+								   muggle_ma_ring_block_hdr_t *hdr)
+{
+	muggle_sync_t r = ring->rpos + (ctx->varlen ? hdr->n_cachelines : 1);
+	if (r >= ctx->capacity) {
+		r = 0;
+	}
+	muggle_atomic_store(&ring->rpos, r, muggle_memory_order_release);
+}
+
 static int muggle_ma_ring_consume(muggle_ma_ring_context_t *ctx,
 								  muggle_ma_ring_t *ring)
 {
 	int num_consume = 0;
 	char *block = (char *)ring->buffer;
 
+	if (ctx->varlen) {
+		muggle_ma_ring_block_hdr_t *hdr = NULL;
+		while ((hdr = muggle_ma_ring_head(ctx, ring)) != NULL) {
+			ctx->cb(ring, hdr + 1);
+			muggle_ma_ring_advance(ctx, ring, hdr);
+			++num_consume;
+		}
+		return num_consume;
+	}
+
 	muggle_sync_t w =
 		muggle_atomic_load(&ring->wpos, muggle_memory_order_acquire);
 	muggle_sync_t r = ring->rpos;
@@ -88,48 +187,312 @@ static int muggle_ma_ring_consume(muggle_ma_ring_context_t *ctx,
 	return num_consume;
 }
 
+/**
+ * @brief head of ring in k-way merge
+ */
+typedef struct {
+	uint64_t stamp; //!< stamp of ring head
+	muggle_ma_ring_t *ring; //!< ring
+	muggle_ma_ring_block_hdr_t *hdr; //!< header of ring head
+} muggle_ma_ring_merge_head_t;
+
+typedef struct {
+	muggle_ma_ring_merge_head_t *heads; //!< min-heap of ring heads
+	uint32_t size; //!< number of heads in heap
+	uint32_t capacity; //!< capacity of heads
+} muggle_ma_ring_merge_heap_t;
+
+static void muggle_ma_ring_heap_sift_down(muggle_ma_ring_merge_heap_t *heap,
+										  uint32_t idx)
+{
+	muggle_ma_ring_merge_head_t *heads = heap->heads;
+	while (1) {
+		uint32_t l = 2 * idx + 1;
+		uint32_t r = l + 1;
+		uint32_t min_idx = idx;
+		if (l < heap->size && heads[l].stamp < heads[min_idx].stamp) {
+			min_idx = l;
+		}
+		if (r < heap->size && heads[r].stamp < heads[min_idx].stamp) {
+			min_idx = r;
+		}
+		if (min_idx == idx) {
+			break;
+		}
+
+		muggle_ma_ring_merge_head_t tmp = heads[idx];
+		heads[idx] = heads[min_idx];
+		heads[min_idx] = tmp;
+		idx = min_idx;
+	}
+}
+
+static int muggle_ma_ring_consume_ordered(muggle_ma_ring_context_t *ctx,
+										  muggle_ma_ring_backend_t *backend,
+										  muggle_ma_ring_merge_heap_t *heap,
+										  bool flush)
+{
+	int num_consume = 0;
+	uint32_t num_empty = 0;
+
+	// build heap with ring heads
+	heap->size = 0;
+	muggle_ma_ring_list_node_t *node = backend->ring_list.next;
+	while (node) {
+		muggle_ma_ring_block_hdr_t *hdr = muggle_ma_ring_head(ctx, node->ring);
+		if (hdr == NULL) {
+			++num_empty;
+		} else {
+			if (heap->size == heap->capacity) {
+				uint32_t capacity = heap->capacity ? heap->capacity * 2 : 16;
+				muggle_ma_ring_merge_head_t *heads =
+					(muggle_ma_ring_merge_head_t *)realloc(
+						heap->heads,
+						sizeof(muggle_ma_ring_merge_head_t) * capacity);
+				if (heads == NULL) {
+					return 0;
+				}
+				heap->heads = heads;
+				heap->capacity = capacity;
+			}
+			heap->heads[heap->size].stamp = hdr->stamp;
+			heap->heads[heap->size].ring = node->ring;
+			heap->heads[heap->size].hdr = hdr;
+			++heap->size;
+		}
+		node = node->next;
+	}
+
+	for (uint32_t i = heap->size / 2; i > 0; --i) {
+		muggle_ma_ring_heap_sift_down(heap, i - 1);
+	}
+
+	// k-way merge
+	uint64_t now = 0;
+	while (heap->size > 0) {
+		muggle_ma_ring_merge_head_t *top = &heap->heads[0];
+
+		// some ring is empty, producer of it may stamped an older record
+		// but not yet published, hold records in reordering window
+		if (num_empty > 0 && !flush) {
+			if (now < top->stamp + ctx->max_reorder) {
+				now = ctx->stamp_cb();
+				if (now < top->stamp + ctx->max_reorder) {
+					break;
+				}
+			}
+		}
+
+		muggle_ma_ring_t *ring = top->ring;
+		ctx->cb(ring, top->hdr + 1);
+		++num_consume;
+
+		muggle_ma_ring_advance(ctx, ring, top->hdr);
+
+		muggle_ma_ring_block_hdr_t *hdr = muggle_ma_ring_head(ctx, ring);
+		if (hdr) {
+			top->stamp = hdr->stamp;
+			top->hdr = hdr;
+		} else {
+			heap->heads[0] = heap->heads[heap->size - 1];
+			--heap->size;
+			++num_empty;
+		}
+		muggle_ma_ring_heap_sift_down(heap, 0);
+	}
+
+	return num_consume;
+}
+
+// check is there any thing for backend to do
+static bool muggle_ma_ring_backend_has_work(muggle_ma_ring_context_t *ctx,
+											muggle_ma_ring_backend_t *backend)
+{
+	if (muggle_atomic_load(&ctx->stop, muggle_memory_order_acquire)) {
+		return true;
+	}
+
+	muggle_ma_ring_list_node_t *node = backend->ring_list.next;
+	while (node) {
+		muggle_ma_ring_t *ring = node->ring;
+		if (muggle_atomic_load(&ring->wpos, muggle_memory_order_acquire) !=
+			ring->rpos) {
+			return true;
+		}
+		if (muggle_atomic_load(&ring->status, muggle_memory_order_relaxed) ==
+			MUGGLE_MA_RING_STATUS_WAIT_REMOVE) {
+			return true;
+		}
+		node = node->next;
+	}
+
+	return false;
+}
+
+static void muggle_ma_ring_backend_park(muggle_ma_ring_context_t *ctx,
+										muggle_ma_ring_backend_t *backend)
+{
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	muggle_atomic_store(&backend->parked, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	// recheck after announce parked, new ring may already has records
+	muggle_ma_ring_handle_new(ctx, backend);
+	if (muggle_ma_ring_backend_has_work(ctx, backend)) {
+		muggle_atomic_store(&backend->parked, 0, muggle_memory_order_relaxed);
+		return;
+	}
+
+	while (muggle_atomic_load(&backend->parked, muggle_memory_order_acquire)) {
+		muggle_sync_wait(&backend->parked, 1, NULL);
+	}
+#else
+	MUGGLE_UNUSED(ctx);
+	MUGGLE_UNUSED(backend);
+	muggle_thread_yield();
+#endif
+}
+
+static void muggle_ma_ring_backend_wait(muggle_ma_ring_context_t *ctx,
+										muggle_ma_ring_backend_t *backend,
+										uint32_t *idle_cnt, bool has_pending)
+{
+	switch (ctx->wait_strategy) {
+	case MUGGLE_MA_RING_WAIT_BUSY: {
+		// do nothing
+	} break;
+	case MUGGLE_MA_RING_WAIT_SPIN_YIELD: {
+		if (++(*idle_cnt) > MUGGLE_MA_RING_SPIN_CNT) {
+			muggle_thread_yield();
+		}
+	} break;
+	case MUGGLE_MA_RING_WAIT_FUTEX: {
+		if (++(*idle_cnt) <= MUGGLE_MA_RING_SPIN_CNT) {
+			break;
+		}
+
+		if (has_pending) {
+			// records held in reordering window, can't park
+			muggle_thread_yield();
+		} else {
+			muggle_ma_ring_backend_park(ctx, backend);
+			*idle_cnt = 0;
+		}
+	} break;
+	case MUGGLE_MA_RING_WAIT_SLEEP:
+	default: {
+		muggle_nsleep(100);
+	} break;
+	}
+}
+
 #if MUGGLE_PLATFORM_WINDOWS
 static muggle_thread_ret_t __stdcall s_muggle_ma_ring_backend_func(void *args)
 #else
 static muggle_thread_ret_t s_muggle_ma_ring_backend_func(void *args)
 #endif
 {
-	MUGGLE_UNUSED(args);
-
+	muggle_ma_ring_backend_t *backend = (muggle_ma_ring_backend_t *)args;
 	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
 
 	if (ctx->before_run_cb) {
 		ctx->before_run_cb();
 	}
 
+	muggle_ma_ring_merge_heap_t heap;
+	memset(&heap, 0, sizeof(heap));
+
+	uint32_t idle_cnt = 0;
 	while (1) {
 		int num_consume = 0;
+		int stop = muggle_atomic_load(&ctx->stop, muggle_memory_order_acquire);
 
-		muggle_ma_ring_handle_new(ctx);
+		muggle_ma_ring_handle_new(ctx, backend);
 
-		muggle_ma_ring_list_node_t *node = ctx->ring_list.next;
-		while (node) {
-			num_consume += muggle_ma_ring_consume(ctx, node->ring);
-			node = node->next;
+		if (ctx->ordered) {
+			num_consume =
+				muggle_ma_ring_consume_ordered(ctx, backend, &heap, stop);
+		} else {
+			muggle_ma_ring_list_node_t *node = backend->ring_list.next;
+			while (node) {
+				num_consume += muggle_ma_ring_consume(ctx, node->ring);
+				node = node->next;
+			}
 		}
 
-		muggle_ma_ring_handle_remove(ctx);
+		muggle_ma_ring_handle_remove(backend);
 
-		// if no message readed, sleep this thread for a while
+		if (stop) {
+			// exit after all rings drained
+			if (num_consume == 0) {
+				break;
+			}
+			continue;
+		}
+
+		// if no message readed, wait with wait strategy
 		if (num_consume == 0) {
-			// muggle_ma_ring_thread_yield();
-			muggle_nsleep(100);
+			muggle_ma_ring_backend_wait(ctx, backend, &idle_cnt, heap.size > 0);
+		} else {
+			idle_cnt = 0;
 		}
 	}
 
+	free(heap.heads);
+
 	return 0;
 }
 
 void muggle_ma_ring_backend_run()
 {
-	muggle_thread_t th_backend;
-	muggle_thread_create(&th_backend, s_muggle_ma_ring_backend_func, NULL);
-	muggle_thread_detach(&th_backend);
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+
+#if !MUGGLE_C_HAVE_SYNC_OBJ
+	if (ctx->wait_strategy == MUGGLE_MA_RING_WAIT_FUTEX) {
+		ctx->wait_strategy = MUGGLE_MA_RING_WAIT_SPIN_YIELD;
+	}
+#endif
+
+	muggle_atomic_store(&ctx->stop, 0, muggle_memory_order_relaxed);
+	muggle_atomic_store(&ctx->backend_running, 1, muggle_memory_order_release);
+	for (uint32_t i = 0; i < ctx->num_backend; i++) {
+		muggle_ma_ring_backend_t *backend = &ctx->backends[i];
+		backend->idx = i;
+		muggle_atomic_store(&backend->parked, 0, muggle_memory_order_relaxed);
+		if (muggle_thread_create(&backend->thread,
+								 s_muggle_ma_ring_backend_func,
+								 backend) != 0) {
+			// stop backends already run
+			muggle_atomic_store(&ctx->stop, 1, muggle_memory_order_release);
+			for (uint32_t j = 0; j < i; j++) {
+				muggle_ma_ring_wake_backend(&ctx->backends[j]);
+				muggle_thread_join(&ctx->backends[j].thread);
+			}
+			muggle_atomic_store(&ctx->backend_running, 0,
+								muggle_memory_order_release);
+			return;
+		}
+	}
+}
+
+void muggle_ma_ring_backend_stop()
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	if (!muggle_atomic_load(&ctx->backend_running,
+							muggle_memory_order_acquire)) {
+		return;
+	}
+
+	muggle_atomic_store(&ctx->stop, 1, muggle_memory_order_release);
+	for (uint32_t i = 0; i < ctx->num_backend; i++) {
+		muggle_ma_ring_wake_backend(&ctx->backends[i]);
+	}
+
+	for (uint32_t i = 0; i < ctx->num_backend; i++) {
+		muggle_thread_join(&ctx->backends[i].thread);
+	}
+
+	muggle_atomic_store(&ctx->backend_running, 0, muggle_memory_order_release);
 }
 
 muggle_ma_ring_context_t *muggle_ma_ring_ctx_get()
@@ -138,10 +501,22 @@ muggle_ma_ring_context_t *muggle_ma_ring_ctx_get()
 		.spinlock = 0,
 		.capacity = MUGGLE_MA_RING_DEFAULT_CAPACITY,
 		.block_size = MUGGLE_MA_RING_DEFAULT_BLOCK_SIZE,
-		.add_list = { .next = NULL, .ring = NULL },
-		.ring_list = { .next = NULL, .ring = NULL },
 		.cb = s_default_ma_ring_cb,
 		.before_run_cb = NULL,
+		.data_size = MUGGLE_MA_RING_DEFAULT_BLOCK_SIZE,
+		.ordered = false,
+		.max_reorder = MUGGLE_MA_RING_DEFAULT_MAX_REORDER,
+		.stamp_cb = s_default_ma_ring_stamp,
+		.wait_strategy = MUGGLE_MA_RING_WAIT_SLEEP,
+		.backend_running = 0,
+		.stop = 0,
+		.varlen = false,
+		.num_backend = 1,
+		.next_backend = 0,
+		.page_attr = {
+			.flags = 0,
+			.numa_node = MUGGLE_PAGE_ALLOC_NODE_ANY,
+		},
 	};
 	return &s_ctx;
 }
@@ -152,11 +527,21 @@ void muggle_ma_ring_ctx_set_capacity(muggle_sync_t capacity)
 	ctx->capacity = capacity;
 }
 
-void muggle_ma_ring_ctx_set_data_size(muggle_sync_t data_size)
+void muggle_ma_ring_ctx_set_page_attr(const muggle_page_alloc_attr_t *attr)
 {
 	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	if (attr) {
+		ctx->page_attr = *attr;
+	} else {
+		muggle_page_alloc_attr_init(&ctx->page_attr);
+	}
+}
 
-	ctx->block_size = MUGGLE_ALIGN_TRUE_SHARING(data_size);
+void muggle_ma_ring_ctx_set_data_size(muggle_sync_t data_size)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->data_size = data_size;
+	muggle_ma_ring_update_block_size(ctx);
 }
 
 void muggle_ma_ring_ctx_set_callback(muggle_ma_ring_callback fn)
@@ -172,6 +557,60 @@ void muggle_ma_ring_ctx_set_before_run_callback(
 	ctx->before_run_cb = fn;
 }
 
+void muggle_ma_ring_ctx_set_wait_strategy(int wait_strategy)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->wait_strategy = wait_strategy;
+}
+
+int muggle_ma_ring_ctx_set_backend_num(uint32_t num_backend)
+{
+	if (num_backend == 0 || num_backend > MUGGLE_MA_RING_MAX_BACKEND) {
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->num_backend = num_backend;
+	return 0;
+}
+
+void muggle_ma_ring_ctx_set_varlen(bool varlen)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->varlen = varlen;
+	muggle_ma_ring_update_block_size(ctx);
+}
+
+void muggle_ma_ring_ctx_set_ordered(bool ordered, uint64_t max_reorder)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->ordered = ordered;
+	ctx->max_reorder = max_reorder;
+	muggle_ma_ring_update_block_size(ctx);
+}
+
+void muggle_ma_ring_ctx_set_stamp_callback(muggle_ma_ring_stamp_callback fn)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	ctx->stamp_cb = fn ? fn : s_default_ma_ring_stamp;
+}
+
+uint64_t muggle_ma_ring_get_stamp(void *data)
+{
+	muggle_ma_ring_block_hdr_t *hdr =
+		(muggle_ma_ring_block_hdr_t *)((char *)data -
+									   MUGGLE_MA_RING_BLOCK_HDR_SIZE);
+	return hdr->stamp;
+}
+
+uint32_t muggle_ma_ring_get_bytes(void *data)
+{
+	muggle_ma_ring_block_hdr_t *hdr =
+		(muggle_ma_ring_block_hdr_t *)((char *)data -
+									   MUGGLE_MA_RING_BLOCK_HDR_SIZE);
+	return hdr->n_bytes;
+}
+
 static muggle_thread_local muggle_ma_ring_t *s_muggle_ma_ring_thread_ctx = NULL;
 muggle_ma_ring_t *muggle_ma_ring_thread_ctx_get()
 {
@@ -193,8 +632,12 @@ static int muggle_ma_ring_insert_thread_ctx(muggle_ma_ring_t *ring)
 	node->ring = ring;
 
 	muggle_spinlock_lock(&ctx->spinlock);
-	node->next = ctx->add_list.next;
-	ctx->add_list.next = node;
+	muggle_ma_ring_backend_t *backend =
+		&ctx->backends[ctx->next_backend % ctx->num_backend];
+	++ctx->next_backend;
+	node->next = backend->add_list.next;
+	backend->add_list.next = node;
+	ring->backend = backend;
 	muggle_spinlock_unlock(&ctx->spinlock);
 
 	return 0;
@@ -202,8 +645,16 @@ static int muggle_ma_ring_insert_thread_ctx(muggle_ma_ring_t *ring)
 
 static void muggle_ma_ring_remove_thread_ctx(muggle_ma_ring_t *ring)
 {
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	muggle_ma_ring_backend_t *backend = ring->backend;
+	if (backend == NULL) {
+		// never inserted into backend
+		return;
+	}
+
 	muggle_atomic_store(&ring->status, MUGGLE_MA_RING_STATUS_WAIT_REMOVE,
 						muggle_memory_order_relaxed);
+	muggle_ma_ring_wake_backend(backend);
 
 	do {
 		muggle_atomic_int status =
@@ -211,18 +662,37 @@ static void muggle_ma_ring_remove_thread_ctx(muggle_ma_ring_t *ring)
 		if (status == MUGGLE_MA_RING_STATUS_DONE) {
 			break;
 		}
+
+		if (!muggle_atomic_load(&ctx->backend_running,
+								muggle_memory_order_acquire)) {
+			// backend not run or already stopped, remove by self
+			muggle_spinlock_lock(&ctx->spinlock);
+			muggle_ma_ring_handle_new_nolock(backend);
+			muggle_ma_ring_handle_remove(backend);
+			muggle_spinlock_unlock(&ctx->spinlock);
+			continue;
+		}
+
 		muggle_msleep(1);
 	} while (1);
 }
 
 static void muggle_ma_ring_join(muggle_ma_ring_t *ring)
 {
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
 	do {
 		muggle_sync_t r =
 			muggle_atomic_load(&ring->rpos, muggle_memory_order_relaxed);
 		if (r == ring->wpos) {
 			break;
 		}
+
+		if (!muggle_atomic_load(&ctx->backend_running,
+								muggle_memory_order_acquire)) {
+			// no backend consume remain records
+			break;
+		}
+
 		muggle_msleep(1);
 	} while (1);
 }
@@ -242,13 +712,8 @@ muggle_ma_ring_t *muggle_ma_ring_thread_ctx_init()
 		   sizeof(*s_muggle_ma_ring_thread_ctx));
 
 	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
-#if MUGGLE_C_HAVE_ALIGNED_ALLOC
-	s_muggle_ma_ring_thread_ctx->buffer =
-		aligned_alloc(MUGGLE_CACHE_LINE_SIZE, ctx->capacity * ctx->block_size);
-#else
-	s_muggle_ma_ring_thread_ctx->buffer =
-		malloc(ctx->capacity * ctx->block_size);
-#endif
+	s_muggle_ma_ring_thread_ctx->buffer = muggle_page_alloc(
+		&ctx->page_attr, (size_t)ctx->capacity * ctx->block_size);
 	if (s_muggle_ma_ring_thread_ctx->buffer == NULL) {
 		muggle_ma_ring_thread_ctx_cleanup();
 		return NULL;
@@ -273,6 +738,8 @@ void muggle_ma_ring_thread_ctx_cleanup()
 
 		muggle_ma_ring_remove_thread_ctx(s_muggle_ma_ring_thread_ctx);
 
+		// backend no longer reference the ring after removed
+		muggle_page_free(s_muggle_ma_ring_thread_ctx->buffer);
 		free(s_muggle_ma_ring_thread_ctx);
 		s_muggle_ma_ring_thread_ctx = NULL;
 	}
@@ -281,13 +748,95 @@ void muggle_ma_ring_thread_ctx_cleanup()
 void *muggle_ma_ring_alloc(muggle_ma_ring_t *ring)
 {
 	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
-	return (char *)ring->buffer + ctx->block_size * ring->wpos;
+	if (ctx->varlen) {
+		return muggle_ma_ring_alloc_bytes(ring, ctx->data_size);
+	}
+
+	char *block = (char *)ring->buffer + ctx->block_size * ring->wpos;
+	if (ctx->ordered) {
+		block += MUGGLE_MA_RING_BLOCK_HDR_SIZE;
+	}
+	return block;
+}
+
+void *muggle_ma_ring_alloc_bytes(muggle_ma_ring_t *ring, uint32_t n_bytes)
+{
+	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	if (!ctx->varlen) {
+		return NULL;
+	}
+
+	uint64_t n = ((uint64_t)MUGGLE_MA_RING_BLOCK_HDR_SIZE + n_bytes +
+				  MUGGLE_CACHE_LINE_SIZE - 1) /
+				 MUGGLE_CACHE_LINE_SIZE;
+	// a record wrap to the start of ring must fit in [0, rpos - 1) even when
+	// backend consumed everything (rpos == wpos), that hold for any wpos only
+	// if record take at most half of ring; larger record may wait forever
+	if (n > ctx->capacity / 2) {
+		return NULL;
+	}
+	muggle_sync_t n_cachelines = (muggle_sync_t)n;
+
+	// if record can't fit in the tail of ring, skip the tail and write
+	// record at the start of ring
+	muggle_sync_t w = ring->wpos;
+	muggle_sync_t skip = 0;
+	if (w + n_cachelines > ctx->capacity) {
+		skip = ctx->capacity - w;
+	}
+
+	// always keep one cacheline empty, so wpos == rpos means empty
+	while (1) {
+		muggle_sync_t r =
+			muggle_atomic_load(&ring->rpos, muggle_memory_order_acquire);
+		muggle_sync_t remain =
+			(r > w) ? (r - w - 1) : (ctx->capacity - w + r - 1);
+		if (remain >= skip + n_cachelines) {
+			break;
+		}
+		muggle_thread_yield();
+	}
+
+	muggle_ma_ring_block_hdr_t *hdr =
+		(muggle_ma_ring_block_hdr_t *)((char *)ring->buffer +
+									   MUGGLE_CACHE_LINE_SIZE * w);
+	if (skip > 0) {
+		hdr->n_bytes = 0;
+		hdr->n_cachelines = 0;
+		hdr = (muggle_ma_ring_block_hdr_t *)ring->buffer;
+	}
+	hdr->n_bytes = n_bytes;
+	hdr->n_cachelines = n_cachelines;
+
+	ring->w_pending = skip + n_cachelines;
+	ring->w_hdr = hdr;
+
+	return hdr + 1;
 }
 
 void muggle_ma_ring_move(muggle_ma_ring_t *ring)
 {
 	static muggle_thread_local muggle_sync_t r = 0;
 	muggle_ma_ring_context_t *ctx = muggle_ma_ring_ctx_get();
+	if (ctx->varlen) {
+		muggle_ma_ring_block_hdr_t *hdr =
+			(muggle_ma_ring_block_hdr_t *)ring->w_hdr;
+		if (ctx->ordered) {
+			hdr->stamp = ctx->stamp_cb();
+		}
+
+		muggle_sync_t next_w = ring->wpos + ring->w_pending;
+		if (next_w >= ctx->capacity) {
+			next_w -= ctx->capacity;
+		}
+		muggle_atomic_store(&ring->wpos, next_w, muggle_memory_order_release);
+
+		if (ctx->wait_strategy == MUGGLE_MA_RING_WAIT_FUTEX) {
+			muggle_ma_ring_wake_backend(ring->backend);
+		}
+		return;
+	}
+
 	muggle_sync_t next_w = ring->wpos + 1;
 	if (next_w >= ctx->capacity) {
 		next_w = 0;
@@ -298,5 +847,16 @@ void muggle_ma_ring_move(muggle_ma_ring_t *ring)
 		r = muggle_atomic_load(&ring->rpos, muggle_memory_order_relaxed);
 	}
 
+	if (ctx->ordered) {
+		muggle_ma_ring_block_hdr_t *hdr =
+			(muggle_ma_ring_block_hdr_t *)((char *)ring->buffer +
+										   ctx->block_size * ring->wpos);
+		hdr->stamp = ctx->stamp_cb();
+	}
+
 	muggle_atomic_store(&ring->wpos, next_w, muggle_memory_order_release);
+
+	if (ctx->wait_strategy == MUGGLE_MA_RING_WAIT_FUTEX) {
+		muggle_ma_ring_wake_backend(ring->backend);
+	}
 }
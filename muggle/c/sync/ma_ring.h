@@ -15,7 +15,10 @@
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/memory/page_alloc.h"
 #include "muggle/c/sync/sync_obj.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 EXTERN_C_BEGIN
 
@@ -25,13 +28,32 @@ enum {
 	MUGGLE_MA_RING_STATUS_DONE,
 };
 
+/**
+ * @brief wait strategy of ma_ring backend when no record be consumed
+ */
+enum {
+	MUGGLE_MA_RING_WAIT_SLEEP = 0, //!< default, sleep a while
+	MUGGLE_MA_RING_WAIT_BUSY, //!< busy spin, lowest latency, burn a core
+	MUGGLE_MA_RING_WAIT_SPIN_YIELD, //!< spin for a while then yield
+	MUGGLE_MA_RING_WAIT_FUTEX, //!< spin for a while then park on sync
+							   //   object, producers wake backend
+};
+
+#define MUGGLE_MA_RING_MAX_BACKEND 16
+
+struct muggle_ma_ring_backend;
+
 /**
  * @brief multiple-async ring
  */
 typedef struct muggle_ma_ring {
 	void *buffer; //!< ring buffer datas
 	union {
-		muggle_sync_t wpos; //!< writer position
+		struct {
+			muggle_sync_t wpos; //!< writer position
+			muggle_sync_t w_pending; //!< blocks of allocated record
+			void *w_hdr; //!< header of allocated record
+		};
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
 	};
 	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(0);
@@ -41,8 +63,20 @@ typedef struct muggle_ma_ring {
 	};
 	muggle_thread_readable_id tid; //!< thread id
 	muggle_sync_t status; //!< status of ring
+	struct muggle_ma_ring_backend *backend; //!< backend consume this ring
 } muggle_ma_ring_t;
 
+/**
+ * @brief ma_ring block header, exists in ordered or variable-length mode
+ */
+typedef struct muggle_ma_ring_block_hdr {
+	uint64_t stamp; //!< stamp of record, set in muggle_ma_ring_move
+	uint32_t n_bytes; //!< bytes of record, only in variable-length mode
+	uint32_t n_cachelines; //!< cachelines of record include header, only
+						   //   in variable-length mode, 0 means wrap to
+						   //   the start of ring
+} muggle_ma_ring_block_hdr_t;
+
 /**
  * @brief ma_ring list
  */
@@ -51,6 +85,20 @@ typedef struct muggle_ma_ring_list_node {
 	muggle_ma_ring_t *ring; //!< am_ring pointer
 } muggle_ma_ring_list_node_t;
 
+/**
+ * @brief ma_ring backend consumer
+ */
+typedef struct muggle_ma_ring_backend {
+	muggle_ma_ring_list_node_t add_list; //!< add list
+	muggle_ma_ring_list_node_t ring_list; //!< ring list
+	muggle_thread_t thread; //!< backend thread
+	uint32_t idx; //!< index of backend
+	union {
+		muggle_sync_t parked; //!< backend parked on sync object
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+} muggle_ma_ring_backend_t;
+
 /**
  * @brief ma_ring callback function
  *
@@ -63,6 +111,11 @@ typedef void (*muggle_ma_ring_callback)(muggle_ma_ring_t *ring, void *data);
  */
 typedef void (*muggle_ma_ring_before_run_callback)();
 
+/**
+ * @brief ma_ring stamp callback, return value must be monotonic increasing
+ */
+typedef uint64_t (*muggle_ma_ring_stamp_callback)();
+
 /**
  * @brief ma_ring context
  */
@@ -70,18 +123,41 @@ typedef struct muggle_ma_ring_context {
 	muggle_spinlock_t spinlock; //!< context spinlock
 	muggle_sync_t capacity; //!< capacity of ring elements
 	muggle_sync_t block_size; //!< size of ring block
-	muggle_ma_ring_list_node_t add_list; //!< add list
-	muggle_ma_ring_list_node_t ring_list; //!< ring list
 	muggle_ma_ring_callback cb; //!< message callback
 	muggle_ma_ring_before_run_callback before_run_cb; //!< before run callback
+	muggle_sync_t data_size; //!< size of user data in ring block
+	bool ordered; //!< backend deliver records in stamp order
+	uint64_t max_reorder; //!< max reordering latency, in stamp unit
+	muggle_ma_ring_stamp_callback stamp_cb; //!< stamp callback
+	int wait_strategy; //!< backend wait strategy, MUGGLE_MA_RING_WAIT_*
+	muggle_sync_t backend_running; //!< backend thread is running
+	muggle_sync_t stop; //!< backend stop flag
+	bool varlen; //!< variable-length records mode
+	uint32_t num_backend; //!< number of backend threads
+	uint32_t next_backend; //!< backend of next inserted ring
+	muggle_ma_ring_backend_t backends[MUGGLE_MA_RING_MAX_BACKEND]; //!< backends
+	muggle_page_alloc_attr_t page_attr; //!< page allocation attributes of ring buffers
 } muggle_ma_ring_context_t;
 
 /**
- * @brief run ma_ring backend thread
+ * @brief run ma_ring backend threads
  */
 MUGGLE_C_EXPORT
 void muggle_ma_ring_backend_run();
 
+/**
+ * @brief stop ma_ring backend threads
+ *
+ * backend drain all rings (ignore reordering window in ordered mode), then
+ * exit, this function return after all backend threads joined
+ *
+ * @NOTE
+ *   user should guarantee producers stop write before invoke this function,
+ *   records written after backend exit will not be consumed
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_backend_stop();
+
 /**
  * @brief get ma_ring context
  *
@@ -98,6 +174,19 @@ muggle_ma_ring_context_t *muggle_ma_ring_ctx_get();
 MUGGLE_C_EXPORT
 void muggle_ma_ring_ctx_set_capacity(muggle_sync_t capacity);
 
+/**
+ * @brief set page allocation attributes of ring buffers
+ *
+ * @param attr  page allocation attributes, NULL means heap
+ *
+ * @NOTE
+ *     ring buffer is allocated and prefaulted (if required) in
+ *     muggle_ma_ring_thread_ctx_init, so without explicit NUMA node, pages
+ *     land on the node of the writer thread
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_ctx_set_page_attr(const muggle_page_alloc_attr_t *attr);
+
 /**
  * @brief set ma_ring data size
  *
@@ -123,6 +212,100 @@ MUGGLE_C_EXPORT
 void muggle_ma_ring_ctx_set_before_run_callback(
 	muggle_ma_ring_before_run_callback fn);
 
+/**
+ * @brief set wait strategy of ma_ring backend
+ *
+ * @param wait_strategy  MUGGLE_MA_RING_WAIT_*
+ *
+ * @NOTE
+ *   must be set before backend run. When sync object is not supported in
+ *   the platform, MUGGLE_MA_RING_WAIT_FUTEX fallback to spin then yield
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_ctx_set_wait_strategy(int wait_strategy);
+
+/**
+ * @brief set number of ma_ring backend threads
+ *
+ * @param num_backend  number of backend threads, range in
+ *                     [1, MUGGLE_MA_RING_MAX_BACKEND]
+ *
+ * @return
+ *   - 0 on success
+ *   - MUGGLE_ERR_INVALID_PARAM if num_backend out of range
+ *
+ * @NOTE
+ *   - must be set before backend run and any thread context initialized
+ *   - rings are assigned to backends in round-robin, every ring is consumed
+ *     by only one backend, so records of the same ring keep in order, but
+ *     callback may be invoked in multiple backend threads concurrently
+ *   - in ordered mode, each backend only merge rings it owns
+ */
+MUGGLE_C_EXPORT
+int muggle_ma_ring_ctx_set_backend_num(uint32_t num_backend);
+
+/**
+ * @brief set variable-length records mode of ma_ring
+ *
+ * @param varlen  if true, ring is split into cachelines, every record
+ *                occupy a muggle_ma_ring_block_hdr_t and n_bytes data,
+ *                rounded up to cachelines
+ *
+ * @NOTE
+ *   - must be set before backend run and any thread context initialized
+ *   - in variable-length mode, capacity is number of cachelines of each
+ *     ring, and data_size only used by muggle_ma_ring_alloc
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_ctx_set_varlen(bool varlen);
+
+/**
+ * @brief set ordered mode of ma_ring
+ *
+ * @param ordered      if true, backend merge records of all rings in stamp
+ *                     order
+ * @param max_reorder  max reordering latency in stamp unit. When some ring
+ *                     is empty, backend hold the oldest record until it is
+ *                     older than max_reorder, in case a producer already
+ *                     stamped an older record but not yet published
+ *
+ * @NOTE
+ *   - must be set before backend run and any thread context initialized
+ *   - in ordered mode, every block has a muggle_ma_ring_block_hdr_t before
+ *     user data, the stamp is taken in muggle_ma_ring_move
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_ctx_set_ordered(bool ordered, uint64_t max_reorder);
+
+/**
+ * @brief set stamp callback of ordered mode
+ *
+ * @param fn  stamp callback function, default is monotonic clock in ns, user
+ *            can replace it with TSC or a global sequence
+ */
+MUGGLE_C_EXPORT
+void muggle_ma_ring_ctx_set_stamp_callback(muggle_ma_ring_stamp_callback fn);
+
+/**
+ * @brief get stamp of record in ordered mode
+ *
+ * @param data  data pointer that passed in ma_ring callback
+ *
+ * @return stamp of record
+ */
+MUGGLE_C_EXPORT
+uint64_t muggle_ma_ring_get_stamp(void *data);
+
+/**
+ * @brief get bytes of record in variable-length mode
+ *
+ * @param data  data pointer that passed in ma_ring callback
+ *
+ * @return number of bytes that requested in muggle_ma_ring_alloc_bytes
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_ma_ring_get_bytes(void *data);
+
 /**
  * @brief get thread-local ma_ring
  *
@@ -151,10 +334,33 @@ void muggle_ma_ring_thread_ctx_cleanup();
  * @param ring  am_ring pointer
  *
  * @return block pointer
+ *
+ * @NOTE
+ *   in variable-length mode, it's the same as allocate data_size bytes
  */
 MUGGLE_C_EXPORT
 void *muggle_ma_ring_alloc(muggle_ma_ring_t *ring);
 
+/**
+ * @brief allocate variable-length record
+ *
+ * @param ring     am_ring pointer
+ * @param n_bytes  number of bytes required
+ *
+ * @return
+ *   - on success, return pointer to record data
+ *   - return NULL if not in variable-length mode or record exceeds half of
+ *     the ring's capacity
+ *
+ * @NOTE
+ *   - if there is no enough space, wait until backend consume records
+ *   - a record take (n_bytes + header) rounded up to cachelines, it must not
+ *     exceed capacity / 2 cachelines, so it can always be placed after
+ *     backend drain the ring, no matter where the write position is
+ */
+MUGGLE_C_EXPORT
+void *muggle_ma_ring_alloc_bytes(muggle_ma_ring_t *ring, uint32_t n_bytes);
+
 /**
  * @brief move ring writer forward
  *
@@ -0,0 +1,122 @@
+#include "mcslock.h"
+#include <stddef.h>
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+// muggle_atomic_* only support integer in windows, use pointer version of
+// interlocked functions directly
+#if MUGGLE_PLATFORM_WINDOWS
+
+static muggle_mcslock_node_t *muggle_mcslock_xchg(
+	muggle_mcslock_node_t **ptr, muggle_mcslock_node_t *val)
+{
+	return (muggle_mcslock_node_t*)InterlockedExchangePointer(
+		(PVOID volatile*)ptr, val);
+}
+
+static bool muggle_mcslock_cas(
+	muggle_mcslock_node_t **ptr,
+	muggle_mcslock_node_t *expected,
+	muggle_mcslock_node_t *desired)
+{
+	return InterlockedCompareExchangePointer(
+		(PVOID volatile*)ptr, desired, expected) == expected;
+}
+
+static muggle_mcslock_node_t *muggle_mcslock_load(muggle_mcslock_node_t **ptr)
+{
+	return (muggle_mcslock_node_t*)InterlockedCompareExchangePointer(
+		(PVOID volatile*)ptr, NULL, NULL);
+}
+
+static void muggle_mcslock_store(
+	muggle_mcslock_node_t **ptr, muggle_mcslock_node_t *val)
+{
+	InterlockedExchangePointer((PVOID volatile*)ptr, val);
+}
+
+#else
+
+static muggle_mcslock_node_t *muggle_mcslock_xchg(
+	muggle_mcslock_node_t **ptr, muggle_mcslock_node_t *val)
+{
+	return __atomic_exchange_n(ptr, val, __ATOMIC_ACQ_REL);
+}
+
+static bool muggle_mcslock_cas(
+	muggle_mcslock_node_t **ptr,
+	muggle_mcslock_node_t *expected,
+	muggle_mcslock_node_t *desired)
+{
+	return __atomic_compare_exchange_n(
+		ptr, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+static muggle_mcslock_node_t *muggle_mcslock_load(muggle_mcslock_node_t **ptr)
+{
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static void muggle_mcslock_store(
+	muggle_mcslock_node_t **ptr, muggle_mcslock_node_t *val)
+{
+	__atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+}
+
+#endif
+
+void muggle_mcslock_init(muggle_mcslock_t *lock)
+{
+	muggle_mcslock_store(&lock->tail, NULL);
+}
+
+void muggle_mcslock_lock(muggle_mcslock_t *lock, muggle_mcslock_node_t *node)
+{
+	node->next = NULL;
+	muggle_atomic_store(&node->locked, 1, muggle_memory_order_relaxed);
+
+	muggle_mcslock_node_t *prev = muggle_mcslock_xchg(&lock->tail, node);
+	if (prev == NULL)
+	{
+		return;
+	}
+
+	muggle_mcslock_store(&prev->next, node);
+
+	// spin on local node
+	muggle_sync_backoff_t backoff;
+	muggle_sync_backoff_init(&backoff);
+	while (muggle_atomic_load(&node->locked, muggle_memory_order_acquire))
+	{
+		muggle_sync_backoff(&backoff);
+	}
+}
+
+bool muggle_mcslock_trylock(muggle_mcslock_t *lock,
+							muggle_mcslock_node_t *node)
+{
+	node->next = NULL;
+	muggle_atomic_store(&node->locked, 0, muggle_memory_order_relaxed);
+	return muggle_mcslock_cas(&lock->tail, NULL, node);
+}
+
+void muggle_mcslock_unlock(muggle_mcslock_t *lock,
+						   muggle_mcslock_node_t *node)
+{
+	muggle_mcslock_node_t *next = muggle_mcslock_load(&node->next);
+	if (next == NULL)
+	{
+		// no waiter, release lock
+		if (muggle_mcslock_cas(&lock->tail, node, NULL))
+		{
+			return;
+		}
+
+		// a waiter already swap tail, wait it link to node
+		while ((next = muggle_mcslock_load(&node->next)) == NULL)
+		{
+			muggle_sync_cpu_relax();
+		}
+	}
+
+	muggle_atomic_store(&next->locked, 0, muggle_memory_order_release);
+}
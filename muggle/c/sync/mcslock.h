@@ -0,0 +1,87 @@
+/******************************************************************************
+ *  @file         mcslock.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec MCS queue lock
+ *
+ *  fair FIFO queue lock, every locker enqueue its own node and spin on the
+ *  node's local flag, so waiters don't bounce the lock's cache line; the
+ *  lock owner hand over the lock to the next node directly
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_MCSLOCK_H_
+#define MUGGLE_C_MCSLOCK_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief MCS lock queue node, every locker need its own node
+ */
+typedef struct muggle_mcslock_node
+{
+	union {
+		struct {
+			struct muggle_mcslock_node *next; //!< next waiter
+			muggle_atomic_int locked; //!< 1 - waiting, 0 - lock handed over
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+} muggle_mcslock_node_t;
+
+typedef struct muggle_mcslock
+{
+	muggle_mcslock_node_t *tail; //!< tail of waiting queue
+} muggle_mcslock_t;
+
+/**
+ * @brief initialize MCS lock
+ *
+ * @param lock  MCS lock
+ */
+MUGGLE_C_EXPORT
+void muggle_mcslock_init(muggle_mcslock_t *lock);
+
+/**
+ * @brief lock MCS lock
+ *
+ * @param lock  MCS lock
+ * @param node  locker's node, must be valid until unlock
+ *
+ * @NOTE
+ *   the same node can't be used by two locks at the same time
+ */
+MUGGLE_C_EXPORT
+void muggle_mcslock_lock(muggle_mcslock_t *lock, muggle_mcslock_node_t *node);
+
+/**
+ * @brief try lock MCS lock
+ *
+ * @param lock  MCS lock
+ * @param node  locker's node, must be valid until unlock
+ *
+ * @return true if lock success
+ */
+MUGGLE_C_EXPORT
+bool muggle_mcslock_trylock(muggle_mcslock_t *lock,
+							muggle_mcslock_node_t *node);
+
+/**
+ * @brief unlock MCS lock
+ *
+ * @param lock  MCS lock
+ * @param node  node passed in lock
+ */
+MUGGLE_C_EXPORT
+void muggle_mcslock_unlock(muggle_mcslock_t *lock,
+						   muggle_mcslock_node_t *node);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_MCSLOCK_H_
@@ -12,6 +12,7 @@
 #include "muggle/c/base/err.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/base/utils.h"
+#include "muggle/c/sync/internal/sync_deadline.h"
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,7 +41,8 @@ typedef void (*fn_muggle_ring_buffer_write)(
 	muggle_ring_buffer_t *r, void *data);
 typedef void (*fn_muggle_ring_buffer_wake)(muggle_ring_buffer_t *r);
 typedef void *(*fn_muggle_ring_buffer_read)(
-	muggle_ring_buffer_t *r, muggle_sync_t idx);
+	muggle_ring_buffer_t *r, muggle_sync_t idx,
+	const struct timespec *timeout);
 
 // convert flag to mode
 static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
@@ -90,6 +92,45 @@ static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
 	return MUGGLE_OK;
 }
 
+/***************** gating *****************/
+
+#define MUGGLE_RING_BUFFER_SEQ_DIFF(a, b) \
+	((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+// wait until all gating stages release the slot of r->write_seq
+static void muggle_ring_buffer_wait_gating(muggle_ring_buffer_t *r)
+{
+	// NOTE: keep one slot empty, so stages can distinguish full from empty
+	// via the wrapped cursor
+	int32_t limit = (int32_t)r->capacity - 1;
+	if (MUGGLE_RING_BUFFER_SEQ_DIFF(r->write_seq, r->cached_gate) < limit)
+	{
+		return;
+	}
+
+	while (1)
+	{
+		muggle_sync_t min_seq = r->write_seq;
+		for (uint32_t i = 0; i < r->num_gating; i++)
+		{
+			muggle_sync_t seq = muggle_atomic_load(
+				&r->gating[i]->cursor, muggle_memory_order_acquire);
+			if (MUGGLE_RING_BUFFER_SEQ_DIFF(seq, min_seq) < 0)
+			{
+				min_seq = seq;
+			}
+		}
+		r->cached_gate = min_seq;
+
+		if (MUGGLE_RING_BUFFER_SEQ_DIFF(r->write_seq, min_seq) < limit)
+		{
+			return;
+		}
+
+		muggle_thread_yield();
+	}
+}
+
 /***************** lock & write *****************/
 
 // muggle ring_buffer write functions
@@ -97,6 +138,12 @@ inline static void muggle_ring_buffer_write_lock(muggle_ring_buffer_t *r, void *
 {
 	muggle_spinlock_lock(&r->write_spin);
 
+	if (r->num_gating > 0)
+	{
+		muggle_ring_buffer_wait_gating(r);
+	}
+	r->write_seq++;
+
 	// assignment
 	r->blocks[r->cursor].data = data;
 
@@ -109,6 +156,12 @@ inline static void muggle_ring_buffer_write_lock(muggle_ring_buffer_t *r, void *
 
 inline static void muggle_ring_buffer_write_single(muggle_ring_buffer_t *r, void *data)
 {
+	if (r->num_gating > 0)
+	{
+		muggle_ring_buffer_wait_gating(r);
+	}
+	r->write_seq++;
+
 	// assignment
 	r->blocks[r->cursor].data = data;
 
@@ -162,8 +215,14 @@ inline static void muggle_ring_buffer_wake_lock(muggle_ring_buffer_t *r)
 /***************** read *****************/
 // muggle ring_buffer read functions
 inline static void* muggle_ring_buffer_read_wait(
-	muggle_ring_buffer_t *r, muggle_sync_t idx)
+	muggle_ring_buffer_t *r, muggle_sync_t idx,
+	const struct timespec *timeout)
 {
+	muggle_sync_deadline_t deadline;
+	struct timespec ts;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
 #if MUGGLE_RING_BUFFER_USE_SYNC
 	muggle_atomic_int rpos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
 	muggle_atomic_int wpos;
@@ -175,7 +234,11 @@ inline static void* muggle_ring_buffer_read_wait(
 			return r->blocks[rpos].data;
 		}
 
-		muggle_sync_wait(&r->cursor, wpos, NULL);
+		if (!muggle_sync_deadline_remain(&deadline, &ts, &p_wait))
+		{
+			return NULL;
+		}
+		muggle_sync_wait(&r->cursor, wpos, p_wait);
 	} while (1);
 #else
 	muggle_atomic_int rpos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
@@ -191,7 +254,12 @@ inline static void* muggle_ring_buffer_read_wait(
 			return data;
 		}
 
-		muggle_condition_variable_wait(&r->read_cv, &r->read_mutex, NULL);
+		if (!muggle_sync_deadline_cv(&deadline, &ts, &p_wait))
+		{
+			muggle_mutex_unlock(&r->read_mutex);
+			return NULL;
+		}
+		muggle_condition_variable_wait(&r->read_cv, &r->read_mutex, p_wait);
 	} while (1);
 #endif
 
@@ -199,8 +267,14 @@ inline static void* muggle_ring_buffer_read_wait(
 }
 
 inline static void *muggle_ring_buffer_read_busy_loop(
-	muggle_ring_buffer_t *r, muggle_sync_t idx)
+	muggle_ring_buffer_t *r, muggle_sync_t idx,
+	const struct timespec *timeout)
 {
+	muggle_sync_deadline_t deadline;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
 	muggle_atomic_int rpos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
 	muggle_atomic_int wpos;
 
@@ -212,6 +286,10 @@ inline static void *muggle_ring_buffer_read_busy_loop(
 			return r->blocks[rpos].data;
 		}
 
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			return NULL;
+		}
 		// muggle_thread_yield();
 	} while (1);
 
@@ -219,10 +297,16 @@ inline static void *muggle_ring_buffer_read_busy_loop(
 }
 
 inline static void *muggle_ring_buffer_read_once(
-	muggle_ring_buffer_t *r, muggle_sync_t idx)
+	muggle_ring_buffer_t *r, muggle_sync_t idx,
+	const struct timespec *timeout)
 {
 	MUGGLE_UNUSED(idx);
 
+	muggle_sync_deadline_t deadline;
+	struct timespec ts;
+	const struct timespec *p_wait = NULL;
+	muggle_sync_deadline_init(&deadline, timeout);
+
 	void *ret = NULL;
 	muggle_mutex_lock(&r->read_mutex);
 	do
@@ -238,9 +322,17 @@ inline static void *muggle_ring_buffer_read_once(
 		}
 
 #if MUGGLE_RING_BUFFER_USE_SYNC
-		muggle_sync_wait(&r->cursor, wpos, NULL);
+		if (!muggle_sync_deadline_remain(&deadline, &ts, &p_wait))
+		{
+			break;
+		}
+		muggle_sync_wait(&r->cursor, wpos, p_wait);
 #else
-		muggle_condition_variable_wait(&r->read_cv, &r->read_mutex, NULL);
+		if (!muggle_sync_deadline_cv(&deadline, &ts, &p_wait))
+		{
+			break;
+		}
+		muggle_condition_variable_wait(&r->read_cv, &r->read_mutex, p_wait);
 #endif
 	} while (1);
 	muggle_mutex_unlock(&r->read_mutex);
@@ -270,6 +362,13 @@ static fn_muggle_ring_buffer_read muggle_ring_buffer_read_functions[MUGGLE_RING_
 
 int muggle_ring_buffer_init(
 	muggle_ring_buffer_t *r, muggle_sync_t capacity, int flag)
+{
+	return muggle_ring_buffer_init_attr(r, capacity, flag, NULL);
+}
+
+int muggle_ring_buffer_init_attr(
+	muggle_ring_buffer_t *r, muggle_sync_t capacity, int flag,
+	const muggle_page_alloc_attr_t *attr)
 {
 	memset(r, 0, sizeof(muggle_ring_buffer_t));
 	if (capacity <= 0)
@@ -308,14 +407,8 @@ int muggle_ring_buffer_init(
 		return ret;
 	}
 
-#if MUGGLE_C_HAVE_ALIGNED_ALLOC
-	r->blocks = (muggle_ring_buffer_block_t*)aligned_alloc(
-			MUGGLE_CACHE_LINE_SIZE,
-			sizeof(muggle_ring_buffer_block_t) * r->capacity);
-#else
-	r->blocks = (muggle_ring_buffer_block_t*)malloc(
-			sizeof(muggle_ring_buffer_block_t) * r->capacity);
-#endif
+	r->blocks = (muggle_ring_buffer_block_t*)muggle_page_alloc(
+			attr, sizeof(muggle_ring_buffer_block_t) * r->capacity);
 	if (r->blocks == NULL)
 	{
 		muggle_mutex_destroy(&r->read_mutex);
@@ -328,7 +421,7 @@ int muggle_ring_buffer_init(
 
 int muggle_ring_buffer_destroy(muggle_ring_buffer_t *r)
 {
-	free(r->blocks);
+	muggle_page_free(r->blocks);
 	muggle_mutex_destroy(&r->read_mutex);
 	muggle_condition_variable_destroy(&r->read_cv);
 	return MUGGLE_OK;
@@ -348,5 +441,154 @@ int muggle_ring_buffer_write(muggle_ring_buffer_t *r, void *data)
 void *muggle_ring_buffer_read(muggle_ring_buffer_t *r, uint32_t idx)
 {
 	muggle_sync_t pos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
-	return (*muggle_ring_buffer_read_functions[r->read_mode])(r, pos);
+	return (*muggle_ring_buffer_read_functions[r->read_mode])(r, pos, NULL);
+}
+
+void *muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, uint32_t idx)
+{
+	static const struct timespec zero_timeout = { 0, 0 };
+	muggle_sync_t pos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	return (*muggle_ring_buffer_read_functions[r->read_mode])(
+		r, pos, &zero_timeout);
+}
+
+void *muggle_ring_buffer_read_timeout(
+	muggle_ring_buffer_t *r, uint32_t idx, const struct timespec *timeout)
+{
+	muggle_sync_t pos = MUGGLE_IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	return (*muggle_ring_buffer_read_functions[r->read_mode])(
+		r, pos, timeout);
+}
+
+/***************** stage *****************/
+
+int muggle_ring_buffer_stage_init(
+	muggle_ring_buffer_stage_t *stage,
+	muggle_ring_buffer_t *r,
+	const char *name,
+	muggle_ring_buffer_stage_t **deps,
+	uint32_t num_deps)
+{
+	memset(stage, 0, sizeof(*stage));
+
+	if (num_deps > MUGGLE_RING_BUFFER_STAGE_MAX_DEPS)
+	{
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+
+	if (r->read_mode == MUGGLE_RING_BUFFER_READ_MODE_ONCE)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	for (uint32_t i = 0; i < num_deps; i++)
+	{
+		if (deps[i] == NULL || deps[i]->ring != r)
+		{
+			return MUGGLE_ERR_INVALID_PARAM;
+		}
+		stage->deps[i] = deps[i];
+	}
+
+	stage->cursor = r->write_seq;
+	stage->ring = r;
+	stage->name = name;
+	stage->num_deps = num_deps;
+
+	return MUGGLE_OK;
+}
+
+int muggle_ring_buffer_add_gating(
+	muggle_ring_buffer_t *r, muggle_ring_buffer_stage_t *stage)
+{
+	if (stage->ring != r)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (r->num_gating >= MUGGLE_RING_BUFFER_MAX_GATING)
+	{
+		return MUGGLE_ERR_FULL;
+	}
+
+	r->gating[r->num_gating++] = stage;
+	r->cached_gate = r->write_seq;
+
+	return MUGGLE_OK;
+}
+
+static uint32_t muggle_ring_buffer_stage_available(
+	muggle_ring_buffer_stage_t *stage)
+{
+	muggle_ring_buffer_t *r = stage->ring;
+	muggle_sync_t cursor = stage->cursor;
+
+	if (stage->num_deps == 0)
+	{
+		muggle_sync_t wpos =
+			muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		return (uint32_t)MUGGLE_IDX_IN_POW_OF_2_RING(
+			(uint32_t)wpos - (uint32_t)cursor, (uint32_t)r->capacity);
+	}
+
+	uint32_t avail = UINT32_MAX;
+	for (uint32_t i = 0; i < stage->num_deps; i++)
+	{
+		muggle_sync_t seq = muggle_atomic_load(
+			&stage->deps[i]->cursor, muggle_memory_order_acquire);
+		uint32_t n = (uint32_t)seq - (uint32_t)cursor;
+		if (n < avail)
+		{
+			avail = n;
+		}
+	}
+
+	return avail;
+}
+
+uint32_t muggle_ring_buffer_stage_wait(muggle_ring_buffer_stage_t *stage)
+{
+	muggle_ring_buffer_t *r = stage->ring;
+	while (1)
+	{
+		uint32_t n = muggle_ring_buffer_stage_available(stage);
+		if (n > 0)
+		{
+			return n;
+		}
+
+		if (stage->num_deps == 0)
+		{
+			// wait writer with ring buffer read mode
+			muggle_sync_t pos =
+				MUGGLE_IDX_IN_POW_OF_2_RING(stage->cursor, r->capacity);
+			(*muggle_ring_buffer_read_functions[r->read_mode])(r, pos, NULL);
+		}
+		else if (r->read_mode != MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP)
+		{
+			muggle_thread_yield();
+		}
+	}
+}
+
+void* muggle_ring_buffer_stage_get(
+	muggle_ring_buffer_stage_t *stage, uint32_t offset)
+{
+	muggle_ring_buffer_t *r = stage->ring;
+	muggle_sync_t pos =
+		MUGGLE_IDX_IN_POW_OF_2_RING(stage->cursor + offset, r->capacity);
+	return r->blocks[pos].data;
+}
+
+void* muggle_ring_buffer_stage_read(muggle_ring_buffer_stage_t *stage)
+{
+	muggle_ring_buffer_stage_wait(stage);
+	return muggle_ring_buffer_stage_get(stage, 0);
+}
+
+void muggle_ring_buffer_stage_commit(
+	muggle_ring_buffer_stage_t *stage, uint32_t n)
+{
+	muggle_atomic_store(
+		&stage->cursor, stage->cursor + n, muggle_memory_order_release);
 }
@@ -15,6 +15,7 @@
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/spinlock.h"
+#include "muggle/c/memory/page_alloc.h"
 #include "muggle/c/sync/sync_obj.h"
 #include "muggle/c/sync/condition_variable.h"
 
@@ -34,6 +35,11 @@ enum
 	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE   = 0x10, //!< every message will only be read once
 };
 
+#define MUGGLE_RING_BUFFER_MAX_GATING     8 //!< max number of stages gate writer
+#define MUGGLE_RING_BUFFER_STAGE_MAX_DEPS 8 //!< max number of upstream stages
+
+struct muggle_ring_buffer_stage;
+
 typedef struct muggle_ring_buffer_block
 {
 	union {
@@ -58,6 +64,8 @@ typedef struct muggle_ring_buffer
 	union {
 		struct {
 			muggle_spinlock_t write_spin;
+			muggle_sync_t     write_seq;    //!< sequence of next write
+			muggle_sync_t     cached_gate;  //!< cached slowest gating cursor
 		};
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 	};
@@ -80,8 +88,35 @@ typedef struct muggle_ring_buffer
 	muggle_mutex_t read_mutex;
 	muggle_condition_variable_t read_cv;
 	muggle_ring_buffer_block_t *blocks;
+
+	// stages that writer gated on, see muggle_ring_buffer_add_gating
+	struct muggle_ring_buffer_stage *gating[MUGGLE_RING_BUFFER_MAX_GATING];
+	uint32_t num_gating;
 }muggle_ring_buffer_t;
 
+/**
+ * @brief consumer stage of ring buffer
+ *
+ * A stage consume every message in ring buffer in order, and publish its
+ * progress via cursor. A stage can depend on upstream stages, then it only
+ * see messages that all upstream stages already committed. So one ring
+ * buffer with pre-allocated entries can serve a whole pipeline, e.g.
+ * decode -> risk check -> journal, without copy messages between rings.
+ */
+typedef struct muggle_ring_buffer_stage
+{
+	union {
+		muggle_sync_t cursor; //!< sequence of next message to consume
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(0);
+
+	muggle_ring_buffer_t *ring;  //!< ring buffer
+	const char           *name;  //!< stage name
+	struct muggle_ring_buffer_stage *deps[MUGGLE_RING_BUFFER_STAGE_MAX_DEPS];
+	uint32_t             num_deps; //!< number of upstream stages
+}muggle_ring_buffer_stage_t;
+
 /**
  * @brief initialize ring buffer
  *
@@ -97,6 +132,23 @@ MUGGLE_C_EXPORT
 int muggle_ring_buffer_init(
 	muggle_ring_buffer_t *r, muggle_sync_t capacity, int flag);
 
+/**
+ * @brief initialize ring buffer with page allocation attributes of blocks
+ *
+ * @param r         ring buffer pointer
+ * @param capacity  initialize capacity for ring buffer
+ * @param flag      bit OR operationg of MUGGLE_RING_BUFFER_FLAG_*
+ * @param attr      page allocation attributes, NULL means heap
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_init_attr(
+	muggle_ring_buffer_t *r, muggle_sync_t capacity, int flag,
+	const muggle_page_alloc_attr_t *attr);
+
 /**
  * @brief destroy ring buffer
  *
@@ -138,6 +190,126 @@ int muggle_ring_buffer_write(muggle_ring_buffer_t *r, void *data);
 MUGGLE_C_EXPORT
 void* muggle_ring_buffer_read(muggle_ring_buffer_t *r, uint32_t idx);
 
+/**
+ * @brief try read data from ring buffer, return immediately if no data
+ *
+ * @param r     ring buffer pointer
+ * @param idx   index of data
+ *
+ * @return
+ *     - data pointer
+ *     - NULL if message of idx is not ready yet
+ *
+ * @NOTE
+ *   when return NULL, user should retry the same idx later
+ */
+MUGGLE_C_EXPORT
+void* muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, uint32_t idx);
+
+/**
+ * @brief read data from ring buffer, wait at most timeout
+ *
+ * @param r        ring buffer pointer
+ * @param idx      index of data
+ * @param timeout  relative timeout, if NULL, wait until read data
+ *
+ * @return
+ *     - data pointer
+ *     - NULL when timeout
+ */
+MUGGLE_C_EXPORT
+void* muggle_ring_buffer_read_timeout(
+	muggle_ring_buffer_t *r, uint32_t idx, const struct timespec *timeout);
+
+/**
+ * @brief initialize consumer stage of ring buffer
+ *
+ * @param stage     stage pointer
+ * @param r         ring buffer pointer
+ * @param name      stage name, the string must outlive stage
+ * @param deps      upstream stages, NULL means consume directly from writer
+ * @param num_deps  number of upstream stages
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *   - stages must be initialized before writer write any message
+ *   - ring buffer with MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE can't use stage
+ *   - every stage must be consumed by only one thread
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_stage_init(
+	muggle_ring_buffer_stage_t *stage,
+	muggle_ring_buffer_t *r,
+	const char *name,
+	muggle_ring_buffer_stage_t **deps,
+	uint32_t num_deps);
+
+/**
+ * @brief let writer gated on stage
+ *
+ * @param r      ring buffer pointer
+ * @param stage  stage, usually the terminal stage of pipeline
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *   When ring buffer has gating stages, writer never overwrite message that
+ *   gating stages not yet committed, and it wait(yield) when ring is full,
+ *   and at most capacity - 1 messages in flight.
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_add_gating(
+	muggle_ring_buffer_t *r, muggle_ring_buffer_stage_t *stage);
+
+/**
+ * @brief wait until stage has messages to consume
+ *
+ * @param stage  stage pointer
+ *
+ * @return number of messages available from stage cursor, at least 1
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_ring_buffer_stage_wait(muggle_ring_buffer_stage_t *stage);
+
+/**
+ * @brief get message in stage
+ *
+ * @param stage   stage pointer
+ * @param offset  offset from stage cursor, must less than the number
+ *                returned by muggle_ring_buffer_stage_wait
+ *
+ * @return data pointer
+ */
+MUGGLE_C_EXPORT
+void* muggle_ring_buffer_stage_get(
+	muggle_ring_buffer_stage_t *stage, uint32_t offset);
+
+/**
+ * @brief wait and get next message of stage, the same as
+ * muggle_ring_buffer_stage_wait + muggle_ring_buffer_stage_get(stage, 0)
+ *
+ * @param stage  stage pointer
+ *
+ * @return data pointer
+ */
+MUGGLE_C_EXPORT
+void* muggle_ring_buffer_stage_read(muggle_ring_buffer_stage_t *stage);
+
+/**
+ * @brief commit messages, make them visible to downstream stages and writer
+ *
+ * @param stage  stage pointer
+ * @param n      number of messages be consumed
+ */
+MUGGLE_C_EXPORT
+void muggle_ring_buffer_stage_commit(
+	muggle_ring_buffer_stage_t *stage, uint32_t n);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,123 @@
+#include "semaphore.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+#include "muggle/c/sync/internal/sync_deadline.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+// number of spin before park
+#define MUGGLE_SEMAPHORE_SPIN 128
+
+void muggle_semaphore_init(muggle_semaphore_t *sem, muggle_sync_t count)
+{
+	sem->n_waiters = 0;
+	muggle_atomic_store(&sem->count, count, muggle_memory_order_release);
+}
+
+bool muggle_semaphore_trywait(muggle_semaphore_t *sem)
+{
+	muggle_sync_t c =
+		muggle_atomic_load(&sem->count, muggle_memory_order_relaxed);
+	while (c > 0)
+	{
+		if (muggle_atomic_cmp_exch_weak(
+				&sem->count, &c, c - 1, muggle_memory_order_acquire))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool muggle_semaphore_spin(muggle_semaphore_t *sem)
+{
+	for (int i = 0; i < MUGGLE_SEMAPHORE_SPIN; i++)
+	{
+		if (muggle_semaphore_trywait(sem))
+		{
+			return true;
+		}
+		muggle_sync_cpu_relax();
+	}
+	return false;
+}
+
+void muggle_semaphore_wait(muggle_semaphore_t *sem)
+{
+	if (muggle_semaphore_spin(sem))
+	{
+		return;
+	}
+
+	// NOTE: waiter increase n_waiters before check count, poster increase
+	// count before check n_waiters (pair with the fence in post)
+	muggle_atomic_fetch_add(&sem->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	while (!muggle_semaphore_trywait(sem))
+	{
+		muggle_sync_wait(&sem->count, 0, NULL);
+	}
+	muggle_atomic_fetch_sub(&sem->n_waiters, 1, muggle_memory_order_relaxed);
+}
+
+bool muggle_semaphore_timedwait(
+	muggle_semaphore_t *sem, const struct timespec *timeout)
+{
+	if (timeout == NULL)
+	{
+		muggle_semaphore_wait(sem);
+		return true;
+	}
+
+	if (muggle_semaphore_spin(sem))
+	{
+		return true;
+	}
+
+	muggle_sync_deadline_t deadline;
+	muggle_sync_deadline_init(&deadline, timeout);
+
+	bool ret = false;
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	muggle_atomic_fetch_add(&sem->n_waiters, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	while (1)
+	{
+		if (muggle_semaphore_trywait(sem))
+		{
+			ret = true;
+			break;
+		}
+
+		if (!muggle_sync_deadline_remain(&deadline, &remain, &p_wait))
+		{
+			break;
+		}
+
+		muggle_sync_wait(&sem->count, 0, p_wait);
+	}
+	muggle_atomic_fetch_sub(&sem->n_waiters, 1, muggle_memory_order_relaxed);
+
+	return ret;
+}
+
+void muggle_semaphore_post(muggle_semaphore_t *sem, muggle_sync_t n)
+{
+	muggle_atomic_fetch_add(&sem->count, n, muggle_memory_order_release);
+
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&sem->n_waiters, muggle_memory_order_relaxed))
+	{
+		if (n == 1)
+		{
+			muggle_sync_wake_one(&sem->count);
+		}
+		else
+		{
+			muggle_sync_wake_all(&sem->count);
+		}
+	}
+}
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
@@ -0,0 +1,83 @@
+/******************************************************************************
+ *  @file         semaphore.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec counting semaphore
+ *
+ *  semaphore built on sync object, waiter spin for a while before park,
+ *  post only wake when there are parked waiters
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SEMAPHORE_H_
+#define MUGGLE_C_SEMAPHORE_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/sync_obj.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+typedef struct muggle_semaphore
+{
+	muggle_sync_t count;     //!< available count
+	muggle_sync_t n_waiters; //!< number of parked waiters
+} muggle_semaphore_t;
+
+/**
+ * @brief initialize semaphore
+ *
+ * @param sem    semaphore
+ * @param count  initial count
+ */
+MUGGLE_C_EXPORT
+void muggle_semaphore_init(muggle_semaphore_t *sem, muggle_sync_t count);
+
+/**
+ * @brief decrease semaphore count, block until count is greater than 0
+ *
+ * @param sem  semaphore
+ */
+MUGGLE_C_EXPORT
+void muggle_semaphore_wait(muggle_semaphore_t *sem);
+
+/**
+ * @brief try decrease semaphore count without block
+ *
+ * @param sem  semaphore
+ *
+ * @return true if count decreased
+ */
+MUGGLE_C_EXPORT
+bool muggle_semaphore_trywait(muggle_semaphore_t *sem);
+
+/**
+ * @brief decrease semaphore count, block at most timeout
+ *
+ * @param sem      semaphore
+ * @param timeout  relative timeout, NULL means wait infinite
+ *
+ * @return true if count decreased, false on timeout
+ */
+MUGGLE_C_EXPORT
+bool muggle_semaphore_timedwait(
+	muggle_semaphore_t *sem, const struct timespec *timeout);
+
+/**
+ * @brief increase semaphore count
+ *
+ * @param sem  semaphore
+ * @param n    number to increase
+ */
+MUGGLE_C_EXPORT
+void muggle_semaphore_post(muggle_semaphore_t *sem, muggle_sync_t n);
+
+#endif // MUGGLE_C_HAVE_SYNC_OBJ
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SEMAPHORE_H_
@@ -0,0 +1,102 @@
+#include "seqlock.h"
+#include "muggle/c/base/thread.h"
+#include <string.h>
+
+// number of spin before yield when writer in progress
+#define MUGGLE_SEQLOCK_SPIN_CNT 64
+
+void muggle_seqlock_init(muggle_seqlock_t *seqlock)
+{
+	muggle_atomic_store(&seqlock->seq, 0, muggle_memory_order_release);
+}
+
+void muggle_seqlock_write_begin(muggle_seqlock_t *seqlock)
+{
+	muggle_atomic_int seq =
+		muggle_atomic_load(&seqlock->seq, muggle_memory_order_relaxed);
+	muggle_atomic_store(&seqlock->seq, seq + 1, muggle_memory_order_relaxed);
+
+	// make sure odd sequence visible before data modified
+	muggle_atomic_thread_fence(muggle_memory_order_release);
+}
+
+void muggle_seqlock_write_end(muggle_seqlock_t *seqlock)
+{
+	muggle_atomic_int seq =
+		muggle_atomic_load(&seqlock->seq, muggle_memory_order_relaxed);
+	muggle_atomic_store(&seqlock->seq, seq + 1, muggle_memory_order_release);
+}
+
+void muggle_seqlock_write_lock(muggle_seqlock_t *seqlock)
+{
+	uint32_t spin = 0;
+	while (1) {
+		muggle_atomic_int seq =
+			muggle_atomic_load(&seqlock->seq, muggle_memory_order_relaxed);
+		if (!(seq & 1) &&
+			muggle_atomic_cmp_exch_weak(&seqlock->seq, &seq, seq + 1,
+										muggle_memory_order_acquire)) {
+			break;
+		}
+
+		if (++spin >= MUGGLE_SEQLOCK_SPIN_CNT) {
+			spin = 0;
+			muggle_thread_yield();
+		}
+	}
+
+	muggle_atomic_thread_fence(muggle_memory_order_release);
+}
+
+void muggle_seqlock_write_unlock(muggle_seqlock_t *seqlock)
+{
+	muggle_seqlock_write_end(seqlock);
+}
+
+muggle_atomic_int muggle_seqlock_read_begin(muggle_seqlock_t *seqlock)
+{
+	uint32_t spin = 0;
+	muggle_atomic_int seq =
+		muggle_atomic_load(&seqlock->seq, muggle_memory_order_acquire);
+	while (seq & 1) {
+		if (++spin >= MUGGLE_SEQLOCK_SPIN_CNT) {
+			spin = 0;
+			muggle_thread_yield();
+		}
+		seq = muggle_atomic_load(&seqlock->seq, muggle_memory_order_acquire);
+	}
+	return seq;
+}
+
+bool muggle_seqlock_read_retry(muggle_seqlock_t *seqlock,
+							   muggle_atomic_int seq)
+{
+	// make sure data loads complete before sequence reload
+	muggle_atomic_thread_fence(muggle_memory_order_acquire);
+	return muggle_atomic_load(&seqlock->seq, muggle_memory_order_relaxed) !=
+		   seq;
+}
+
+void muggle_seqlock_write_copy(muggle_seqlock_t *seqlock, void *dst,
+							   const void *src, size_t size)
+{
+	muggle_seqlock_write_begin(seqlock);
+	memcpy(dst, src, size);
+	muggle_seqlock_write_end(seqlock);
+}
+
+uint32_t muggle_seqlock_read_copy(muggle_seqlock_t *seqlock, void *dst,
+								  const void *src, size_t size)
+{
+	uint32_t n_retry = 0;
+	muggle_atomic_int seq;
+	while (1) {
+		seq = muggle_seqlock_read_begin(seqlock);
+		memcpy(dst, src, size);
+		if (!muggle_seqlock_read_retry(seqlock, seq)) {
+			break;
+		}
+		++n_retry;
+	}
+	return n_retry;
+}
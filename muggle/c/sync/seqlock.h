@@ -0,0 +1,143 @@
+/******************************************************************************
+ *  @file         seqlock.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec sequence lock
+ *
+ *  seqlock let one writer publish snapshots to many readers, readers never
+ *  block writer and each other, reader copy data out and retry if writer
+ *  modified it in the meantime
+ *
+ *  muggle_seqlock_t only contains an atomic counter without any pointer or
+ *  handle, so it can be placed in memory shared between processes (e.g.
+ *  muggle_shm_t region) directly
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SEQLOCK_H_
+#define MUGGLE_C_SEQLOCK_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+typedef struct {
+	muggle_atomic_int seq; //!< sequence, odd means writer in progress
+} muggle_seqlock_t;
+
+/**
+ * @brief initialize seqlock
+ *
+ * @param seqlock  pointer to seqlock
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_init(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief single writer begin modify data
+ *
+ * @param seqlock  pointer to seqlock
+ *
+ * @NOTE
+ *   only one writer is allowed, if there are multiple writers, use
+ *   muggle_seqlock_write_lock instead
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_write_begin(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief single writer end modify data
+ *
+ * @param seqlock  pointer to seqlock
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_write_end(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief writers lock seqlock, serialize multiple writers
+ *
+ * @param seqlock  pointer to seqlock
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_write_lock(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief writers unlock seqlock
+ *
+ * @param seqlock  pointer to seqlock
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_write_unlock(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief reader begin read data
+ *
+ * @param seqlock  pointer to seqlock
+ *
+ * @return sequence, pass it to muggle_seqlock_read_retry
+ *
+ * @NOTE
+ *   wait until there has no writer in progress
+ */
+MUGGLE_C_EXPORT
+muggle_atomic_int muggle_seqlock_read_begin(muggle_seqlock_t *seqlock);
+
+/**
+ * @brief reader check data need to read again
+ *
+ * @param seqlock  pointer to seqlock
+ * @param seq      sequence return by muggle_seqlock_read_begin
+ *
+ * @return if true, data read since read_begin is inconsistent, retry
+ *
+ * @NOTE
+ *   data read between begin and retry may be torn, don't use it (e.g.
+ *   dereference pointer in it) before retry return false
+ *
+ * @code
+ * muggle_atomic_int seq;
+ * do {
+ *     seq = muggle_seqlock_read_begin(&seqlock);
+ *     snapshot = data;
+ * } while (muggle_seqlock_read_retry(&seqlock, seq));
+ * @endcode
+ */
+MUGGLE_C_EXPORT
+bool muggle_seqlock_read_retry(muggle_seqlock_t *seqlock,
+							   muggle_atomic_int seq);
+
+/**
+ * @brief single writer copy data into protected memory
+ *
+ * @param seqlock  pointer to seqlock
+ * @param dst      protected memory
+ * @param src      source data
+ * @param size     number of bytes
+ */
+MUGGLE_C_EXPORT
+void muggle_seqlock_write_copy(muggle_seqlock_t *seqlock, void *dst,
+							   const void *src, size_t size);
+
+/**
+ * @brief reader copy consistent snapshot of protected memory
+ *
+ * @param seqlock  pointer to seqlock
+ * @param dst      snapshot output
+ * @param src      protected memory
+ * @param size     number of bytes
+ *
+ * @return number of retry times
+ */
+MUGGLE_C_EXPORT
+uint32_t muggle_seqlock_read_copy(muggle_seqlock_t *seqlock, void *dst,
+								  const void *src, size_t size);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SEQLOCK_H_
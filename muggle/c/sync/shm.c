@@ -29,6 +29,54 @@ void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
 	return shm->ptr;
 }
 
+void *muggle_shm_open_file(muggle_shm_t *shm, const char *filepath, int flag,
+						   uint32_t nbytes)
+{
+	memset(shm, 0, sizeof(*shm));
+
+	DWORD creation = OPEN_EXISTING;
+	if (flag & MUGGLE_SHM_FLAG_CREAT) {
+		creation = CREATE_NEW;
+	}
+	shm->hFile = CreateFileA(filepath, GENERIC_READ | GENERIC_WRITE,
+							 FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+							 creation, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (shm->hFile == INVALID_HANDLE_VALUE) {
+		shm->hFile = NULL;
+		return NULL;
+	}
+
+	if (nbytes == 0) {
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(shm->hFile, &file_size) ||
+			file_size.QuadPart == 0 || file_size.QuadPart > UINT32_MAX) {
+			goto open_file_failed;
+		}
+		nbytes = (uint32_t)file_size.QuadPart;
+	}
+
+	shm->hMapFile = CreateFileMappingA(shm->hFile, NULL, PAGE_READWRITE, 0,
+									   nbytes, NULL);
+	if (shm->hMapFile == NULL) {
+		goto open_file_failed;
+	}
+
+	shm->ptr = MapViewOfFile(shm->hMapFile, FILE_MAP_ALL_ACCESS, 0, 0, nbytes);
+	if (shm->ptr == NULL) {
+		CloseHandle(shm->hMapFile);
+		goto open_file_failed;
+	}
+
+	shm->nbytes = nbytes;
+
+	return shm->ptr;
+
+open_file_failed:
+	CloseHandle(shm->hFile);
+	shm->hFile = NULL;
+	return NULL;
+}
+
 int muggle_shm_detach(muggle_shm_t *shm)
 {
 	if (shm->ptr == NULL) {
@@ -42,6 +90,33 @@ int muggle_shm_detach(muggle_shm_t *shm)
 
 	CloseHandle(shm->hMapFile);
 
+	if (shm->hFile) {
+		CloseHandle(shm->hFile);
+		shm->hFile = NULL;
+	}
+
+	return 0;
+}
+
+int muggle_shm_sync(muggle_shm_t *shm)
+{
+	if (shm->ptr == NULL) {
+		return -1;
+	}
+
+	if (shm->hFile == NULL) {
+		return 0;
+	}
+
+	// FlushViewOfFile only start writing dirty pages, FlushFileBuffers wait
+	// for them reach the device
+	if (!FlushViewOfFile(shm->ptr, 0)) {
+		return -1;
+	}
+	if (!FlushFileBuffers(shm->hFile)) {
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -65,6 +140,15 @@ void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
 	return NULL;
 }
 
+void *muggle_shm_open_file(muggle_shm_t *shm, const char *filepath, int flag,
+						   uint32_t nbytes)
+{
+	MUGGLE_UNUSED(shm);
+	MUGGLE_UNUSED(filepath);
+	MUGGLE_UNUSED(flag);
+	MUGGLE_UNUSED(nbytes);
+	return NULL;
+}
 
 int muggle_shm_detach(muggle_shm_t *shm)
 {
@@ -72,6 +156,12 @@ int muggle_shm_detach(muggle_shm_t *shm)
 	return -1;
 }
 
+int muggle_shm_sync(muggle_shm_t *shm)
+{
+	MUGGLE_UNUSED(shm);
+	return -1;
+}
+
 int muggle_shm_rm(muggle_shm_t *shm)
 {
 	MUGGLE_UNUSED(shm);
@@ -81,6 +171,9 @@ int muggle_shm_rm(muggle_shm_t *shm)
 #else
 	#include <sys/ipc.h>
 	#include <sys/shm.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
 	#include <unistd.h>
 
 void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
@@ -121,6 +214,63 @@ void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
 
 	shm->ptr = ptr;
 	shm->shm_id = shm_id;
+	shm->fd = -1;
+	shm->nbytes = nbytes;
+
+	return shm->ptr;
+}
+
+void *muggle_shm_open_file(muggle_shm_t *shm, const char *filepath, int flag,
+						   uint32_t nbytes)
+{
+	memset(shm, 0, sizeof(*shm));
+	shm->shm_id = -1;
+	shm->fd = -1;
+
+	int flag_open = O_RDWR;
+	mode_t mode = S_IRUSR | S_IWUSR;
+	if (flag & MUGGLE_SHM_FLAG_CREAT) {
+		flag_open |= O_CREAT | O_EXCL;
+	}
+	if (flag & MUGGLE_SHM_FLAG_PRIVILEGE_GROUP) {
+		mode |= S_IRGRP | S_IWGRP;
+	}
+	if (flag & MUGGLE_SHM_FLAG_PRIVILEGE_OTHER) {
+		mode |= S_IROTH | S_IWOTH;
+	}
+
+	int fd = open(filepath, flag_open, mode);
+	if (fd == -1) {
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return NULL;
+	}
+
+	if (nbytes == 0) {
+		if (st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) {
+			close(fd);
+			return NULL;
+		}
+		nbytes = (uint32_t)st.st_size;
+	} else if ((uint64_t)st.st_size < nbytes) {
+		if (ftruncate(fd, (off_t)nbytes) != 0) {
+			close(fd);
+			return NULL;
+		}
+	}
+
+	void *ptr = mmap(NULL, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (ptr == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+
+	shm->ptr = ptr;
+	shm->fd = fd;
 	shm->nbytes = nbytes;
 
 	return shm->ptr;
@@ -132,6 +282,16 @@ int muggle_shm_detach(muggle_shm_t *shm)
 		return -1;
 	}
 
+	if (shm->fd != -1) {
+		if (munmap(shm->ptr, shm->nbytes) != 0) {
+			return -1;
+		}
+		close(shm->fd);
+		shm->fd = -1;
+		shm->ptr = NULL;
+		return 0;
+	}
+
 	if (shmdt(shm->ptr) != 0) {
 		return -1;
 	}
@@ -141,8 +301,30 @@ int muggle_shm_detach(muggle_shm_t *shm)
 	return 0;
 }
 
+int muggle_shm_sync(muggle_shm_t *shm)
+{
+	if (shm->ptr == NULL) {
+		return -1;
+	}
+
+	if (shm->fd == -1) {
+		return 0;
+	}
+
+	if (msync(shm->ptr, shm->nbytes, MS_SYNC) != 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
 int muggle_shm_rm(muggle_shm_t *shm)
 {
+	if (shm->shm_id == -1) {
+		// file backed, content persist in file
+		return 0;
+	}
+
 	if (shmctl(shm->shm_id, IPC_RMID, NULL) == -1) {
 		return -1;
 	}
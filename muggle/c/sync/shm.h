@@ -35,8 +35,10 @@ typedef struct {
 	void *ptr; //!< pointer to shared memory
 #if MUGGLE_PLATFORM_WINDOWS
 	HANDLE hMapFile;
+	HANDLE hFile; //!< file handle if file backed, otherwise NULL
 #else
-	int shm_id; //!< shared memory id
+	int shm_id; //!< shared memory id, -1 if file backed
+	int fd; //!< file descriptor if file backed, otherwise -1
 #endif
 	uint32_t nbytes; //!< number of bytes (user input, possible 0)
 } muggle_shm_t;
@@ -66,6 +68,30 @@ MUGGLE_C_EXPORT
 void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
 					  int flag, uint32_t nbytes);
 
+/**
+ * @brief open shared memory backed by a memory-mapped file
+ *
+ * @param shm       pointer to muggle_shm_t
+ * @param filepath  file path
+ * @param flag      bit or of MUGGLE_SHM_FLAG_*
+ * @param nbytes    expected size of memory
+ *
+ * @return
+ *   - on success, return pointer to memory
+ *   - on failed, return NULL
+ *
+ * @NOTE
+ *   - with MUGGLE_SHM_FLAG_CREAT, create a new file with nbytes, if it's
+ *     already exists, return NULL
+ *   - with MUGGLE_SHM_FLAG_OPEN and nbytes is 0, mapping entire file
+ *   - content persist in file after detach, muggle_shm_rm do nothing for
+ *     file backed shared memory, remove the file if it's not needed
+ *   - shm->nbytes is the actual size of mapping
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_open_file(muggle_shm_t *shm, const char *filepath, int flag,
+						   uint32_t nbytes);
+
 /**
  * @brief detach shared memory
  *
@@ -78,6 +104,23 @@ void *muggle_shm_open(muggle_shm_t *shm, const char *k_name, int k_num,
 MUGGLE_C_EXPORT
 int muggle_shm_detach(muggle_shm_t *shm);
 
+/**
+ * @brief flush file backed shared memory into its file
+ *
+ * @param shm  pointer to muggle_shm_t
+ *
+ * @return
+ *   - on success, return 0
+ *   - otherwise failed
+ *
+ * @NOTE
+ *   block until dirty pages of mapping are written to storage device, so
+ *   content survive OS crash or power loss; do nothing for shared memory
+ *   not backed by file
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_sync(muggle_shm_t *shm);
+
 /**
  * @brief remove shared memory
  *
@@ -1,5 +1,8 @@
 #include "shm_ring_buffer.h"
 #include "muggle/c/base/utils.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/sleep.h"
+#include "muggle/c/sync/internal/sync_deadline.h"
 #include <string.h>
 #include <assert.h>
 
@@ -8,6 +11,13 @@
 // 'M', 'S', 'H', 'M'
 #define MUGGLE_SHM_RINGBUF_MAGIC 0x4D53484D
 
+// poll interval of waiting reader when there is no shared sync object
+#define MUGGLE_SHM_RINGBUF_POLL_MS 1
+
+// max time of a single park of waiting reader, writer check parked readers
+// without fence, so a wakeup may be missed and reader recheck after it
+#define MUGGLE_SHM_RINGBUF_PARK_SLICE_MS 1
+
 typedef struct {
 	char placeholder[MUGGLE_CACHE_LINE_SIZE];
 } muggle_shm_ringbuf_block_t;
@@ -17,23 +27,66 @@ muggle_shm_ringbuf_t *muggle_shm_ringbuf_open(muggle_shm_t *shm,
 											  const char *k_name, int k_num,
 											  int flag, uint32_t nbytes)
 {
-	uint32_t data_bytes = 0;
-	uint32_t n_cacheline = 0;
-	uint32_t total_bytes = 0;
+	return muggle_shm_ringbuf_open_ex(shm, k_name, k_num, flag, nbytes, 0);
+}
 
+static uint32_t muggle_shm_ringbuf_cal_total_bytes(uint32_t nbytes,
+												  uint32_t *data_bytes,
+												  uint32_t *n_cacheline)
+{
 	if (nbytes == 0) {
-		total_bytes = 0;
-	} else {
-		data_bytes =
-			MUGGLE_ROUND_UP_POW_OF_2_MUL(nbytes, MUGGLE_CACHE_LINE_SIZE);
-		n_cacheline = data_bytes / MUGGLE_CACHE_LINE_SIZE;
-		n_cacheline = (uint32_t)muggle_next_pow_of_2(n_cacheline);
-		data_bytes = n_cacheline * MUGGLE_CACHE_LINE_SIZE;
-
-		total_bytes = sizeof(muggle_shm_ringbuf_t) + data_bytes;
-		total_bytes = MUGGLE_SHM_ALIGN_4K_PAGE(total_bytes);
+		*data_bytes = 0;
+		*n_cacheline = 0;
+		return 0;
 	}
 
+	uint32_t n_bytes =
+		MUGGLE_ROUND_UP_POW_OF_2_MUL(nbytes, MUGGLE_CACHE_LINE_SIZE);
+	uint32_t n = n_bytes / MUGGLE_CACHE_LINE_SIZE;
+	n = (uint32_t)muggle_next_pow_of_2(n);
+	n_bytes = n * MUGGLE_CACHE_LINE_SIZE;
+
+	*data_bytes = n_bytes;
+	*n_cacheline = n;
+
+	uint32_t total_bytes = sizeof(muggle_shm_ringbuf_t) + n_bytes;
+	return MUGGLE_SHM_ALIGN_4K_PAGE(total_bytes);
+}
+
+static void muggle_shm_ringbuf_init(muggle_shm_ringbuf_t *ptr,
+									uint32_t data_bytes, uint32_t n_cacheline,
+									uint32_t total_bytes, uint32_t rb_flags)
+{
+	memset(ptr, 0, sizeof(*ptr));
+
+	ptr->n_bytes = data_bytes;
+	ptr->total_bytes = total_bytes;
+	ptr->n_cacheline = n_cacheline;
+	ptr->flags = rb_flags;
+
+	ptr->write_cursor = 0;
+	ptr->staged_cursor = 0;
+	ptr->cached_remain = ptr->n_cacheline - 1;
+
+	ptr->read_cursor = 0;
+
+	muggle_spinlock_init(&ptr->write_lock);
+	muggle_spinlock_init(&ptr->read_lock);
+
+	ptr->magic = MUGGLE_SHM_RINGBUF_MAGIC;
+	muggle_atomic_store(&ptr->ready, 1, muggle_memory_order_release);
+}
+
+muggle_shm_ringbuf_t *muggle_shm_ringbuf_open_ex(muggle_shm_t *shm,
+												 const char *k_name, int k_num,
+												 int flag, uint32_t nbytes,
+												 uint32_t rb_flags)
+{
+	uint32_t data_bytes = 0;
+	uint32_t n_cacheline = 0;
+	uint32_t total_bytes =
+		muggle_shm_ringbuf_cal_total_bytes(nbytes, &data_bytes, &n_cacheline);
+
 	muggle_shm_ringbuf_t *ptr = (muggle_shm_ringbuf_t *)muggle_shm_open(
 		shm, k_name, k_num, flag, total_bytes);
 	if (ptr == NULL) {
@@ -42,22 +95,41 @@ muggle_shm_ringbuf_t *muggle_shm_ringbuf_open(muggle_shm_t *shm,
 
 	// if create new shm, do init
 	if (flag & MUGGLE_SHM_FLAG_CREAT) {
-		memset(ptr, 0, sizeof(*ptr));
-
-		ptr->n_bytes = data_bytes;
-		ptr->total_bytes = total_bytes;
-		ptr->n_cacheline = n_cacheline;
+		muggle_shm_ringbuf_init(ptr, data_bytes, n_cacheline, total_bytes,
+								rb_flags);
+	}
 
-		ptr->write_cursor = 0;
-		ptr->cached_remain = ptr->n_cacheline - 1;
+	return ptr;
+}
 
-		ptr->read_cursor = 0;
+muggle_shm_ringbuf_t *muggle_shm_ringbuf_open_file(muggle_shm_t *shm,
+												   const char *filepath,
+												   int flag, uint32_t nbytes,
+												   uint32_t rb_flags)
+{
+	uint32_t data_bytes = 0;
+	uint32_t n_cacheline = 0;
+	uint32_t total_bytes = 0;
+	if (flag & MUGGLE_SHM_FLAG_CREAT) {
+		if (nbytes == 0) {
+			return NULL;
+		}
+		total_bytes = muggle_shm_ringbuf_cal_total_bytes(nbytes, &data_bytes,
+														 &n_cacheline);
+	}
 
-		muggle_spinlock_init(&ptr->write_lock);
-		muggle_spinlock_init(&ptr->read_lock);
+	muggle_shm_ringbuf_t *ptr = (muggle_shm_ringbuf_t *)muggle_shm_open_file(
+		shm, filepath, flag, total_bytes);
+	if (ptr == NULL) {
+		return NULL;
+	}
 
-		ptr->magic = MUGGLE_SHM_RINGBUF_MAGIC;
-		muggle_atomic_store(&ptr->ready, 1, muggle_memory_order_release);
+	if (flag & MUGGLE_SHM_FLAG_CREAT) {
+		muggle_shm_ringbuf_init(ptr, data_bytes, n_cacheline, total_bytes,
+								rb_flags);
+	} else if (shm->nbytes < sizeof(muggle_shm_ringbuf_t)) {
+		muggle_shm_detach(shm);
+		return NULL;
 	}
 
 	return ptr;
@@ -100,12 +172,12 @@ void muggle_shm_ringbuf_update_cached_remain(muggle_shm_ringbuf_t *shm_rbuf,
 {
 	muggle_sync_t r_pos =
 		muggle_atomic_load(&shm_rbuf->read_cursor, muggle_memory_order_relaxed);
-	if (r_pos > shm_rbuf->write_cursor) {
+	if (r_pos > shm_rbuf->staged_cursor) {
 		//         w         r
 		// ================================
 		//
 		// contiguous writable is: r - w - 1
-		shm_rbuf->cached_remain = r_pos - shm_rbuf->write_cursor - 1;
+		shm_rbuf->cached_remain = r_pos - shm_rbuf->staged_cursor - 1;
 	} else {
 		//             r        w          end
 		// ================================
@@ -119,18 +191,23 @@ void muggle_shm_ringbuf_update_cached_remain(muggle_shm_ringbuf_t *shm_rbuf,
 		//   right_remain use (end - w - 1) instead of (end - w), it's can 
 		//   reduce branch judgment in codes
 		uint32_t right_remain =
-			shm_rbuf->n_cacheline - shm_rbuf->write_cursor - 1;
+			shm_rbuf->n_cacheline - shm_rbuf->staged_cursor - 1;
 		int32_t left_remain = (int32_t)r_pos - 1;
 		if (right_remain >= required_cacheline) {
 			shm_rbuf->cached_remain = right_remain;
 		} else if (left_remain >= (int32_t)required_cacheline) {
 			// fillup current hdr 0 and move w to 0
+			//
+			// NOTE:
+			//   staged messages before current hdr are published together,
+			//   they are already written completely
 			muggle_shm_ringbuf_data_hdr_t *hdr =
 				muggle_shm_ringbuf_get_data(shm_rbuf,
-						shm_rbuf->write_cursor);
+						shm_rbuf->staged_cursor);
 			hdr->n_bytes = 0;
 			hdr->n_cachelines = 0;
 
+			shm_rbuf->staged_cursor = 0;
 			muggle_atomic_store(&shm_rbuf->write_cursor, 0,
 					muggle_memory_order_release);
 
@@ -161,7 +238,7 @@ void *muggle_shm_ringbuf_w_alloc_cachelines(muggle_shm_ringbuf_t *shm_rbuf,
 	}
 
 	muggle_shm_ringbuf_data_hdr_t *hdr =
-		muggle_shm_ringbuf_get_data(shm_rbuf, shm_rbuf->write_cursor);
+		muggle_shm_ringbuf_get_data(shm_rbuf, shm_rbuf->staged_cursor);
 	hdr->n_bytes = n_bytes;
 	hdr->n_cachelines = n_cacheline;
 
@@ -170,12 +247,43 @@ void *muggle_shm_ringbuf_w_alloc_cachelines(muggle_shm_ringbuf_t *shm_rbuf,
 	return (void *)(hdr + 1);
 }
 
+static void muggle_shm_ringbuf_wake_readers(muggle_shm_ringbuf_t *shm_rbuf)
+{
+#if MUGGLE_C_HAVE_SHARED_SYNC_OBJ
+	// no fence here, publish must stay cheap when nobody is parked; a
+	// reader announced just before this load may be missed, it is bounded
+	// by MUGGLE_SHM_RINGBUF_PARK_SLICE_MS in muggle_shm_ringbuf_fetch_wait
+	if (muggle_atomic_load(&shm_rbuf->n_waiters, muggle_memory_order_relaxed)) {
+		muggle_atomic_fetch_add(&shm_rbuf->futex_seq, 1,
+								muggle_memory_order_release);
+		muggle_sync_wake_all_shared(&shm_rbuf->futex_seq);
+	}
+#else
+	MUGGLE_UNUSED(shm_rbuf);
+#endif
+}
+
 void muggle_shm_ringbuf_w_move(muggle_shm_ringbuf_t *shm_rbuf)
+{
+	muggle_shm_ringbuf_w_stage(shm_rbuf);
+	muggle_shm_ringbuf_w_publish(shm_rbuf);
+}
+
+void muggle_shm_ringbuf_w_stage(muggle_shm_ringbuf_t *shm_rbuf)
 {
 	uint32_t n = shm_rbuf->cached_w_hdr->n_cachelines;
 	shm_rbuf->cached_remain -= n;
-	muggle_atomic_store(&shm_rbuf->write_cursor, shm_rbuf->write_cursor + n,
+	shm_rbuf->staged_cursor += n;
+}
+
+void muggle_shm_ringbuf_w_publish(muggle_shm_ringbuf_t *shm_rbuf)
+{
+	muggle_atomic_store(&shm_rbuf->write_cursor, shm_rbuf->staged_cursor,
 						muggle_memory_order_release);
+
+	if (shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_BLOCKING) {
+		muggle_shm_ringbuf_wake_readers(shm_rbuf);
+	}
 }
 
 void *muggle_shm_ringbuf_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
@@ -219,6 +327,137 @@ void *muggle_shm_ringbuf_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
 	return NULL;
 }
 
+bool muggle_shm_ringbuf_r_batch_begin(muggle_shm_ringbuf_t *shm_rbuf,
+									  muggle_shm_ringbuf_r_batch_t *batch)
+{
+	batch->shm_rbuf = shm_rbuf;
+	batch->w_pos = muggle_atomic_load(&shm_rbuf->write_cursor,
+									  muggle_memory_order_acquire);
+	batch->r_pos = shm_rbuf->read_cursor;
+	batch->n_msg = 0;
+
+	return batch->w_pos != batch->r_pos;
+}
+
+void *muggle_shm_ringbuf_r_batch_next(muggle_shm_ringbuf_r_batch_t *batch,
+									  uint32_t *n_bytes)
+{
+	while (batch->r_pos != batch->w_pos) {
+		muggle_shm_ringbuf_data_hdr_t *hdr =
+			muggle_shm_ringbuf_get_data(batch->shm_rbuf, batch->r_pos);
+		if (hdr->n_bytes != 0) {
+			batch->r_pos += hdr->n_cachelines;
+			++batch->n_msg;
+			if (n_bytes) {
+				*n_bytes = hdr->n_bytes;
+			}
+			return hdr + 1;
+		}
+
+		// wrap hdr, but write cursor moved to start and data not write yet
+		if (batch->w_pos == 0) {
+			break;
+		}
+		batch->r_pos = 0;
+	}
+
+	return NULL;
+}
+
+void muggle_shm_ringbuf_r_batch_commit(muggle_shm_ringbuf_r_batch_t *batch)
+{
+	if (batch->r_pos == batch->shm_rbuf->read_cursor) {
+		return;
+	}
+	muggle_atomic_store(&batch->shm_rbuf->read_cursor, batch->r_pos,
+						muggle_memory_order_release);
+}
+
+typedef void *(*fn_muggle_shm_ringbuf_fetch)(muggle_shm_ringbuf_t *shm_rbuf,
+											 int reader_id, uint32_t *n_bytes);
+
+static void *muggle_shm_ringbuf_fetch_wait(muggle_shm_ringbuf_t *shm_rbuf,
+										   fn_muggle_shm_ringbuf_fetch fn,
+										   int reader_id, uint32_t *n_bytes,
+										   uint32_t spin_cnt,
+										   const struct timespec *timeout)
+{
+	void *data = fn(shm_rbuf, reader_id, n_bytes);
+	for (uint32_t i = 0; data == NULL && i < spin_cnt; ++i) {
+		data = fn(shm_rbuf, reader_id, n_bytes);
+	}
+	if (data) {
+		return data;
+	}
+
+	muggle_sync_deadline_t deadline;
+	muggle_sync_deadline_init(&deadline, timeout);
+	if (muggle_sync_deadline_is_zero(&deadline)) {
+		return NULL;
+	}
+
+	struct timespec remain;
+	const struct timespec *p_wait = NULL;
+	while (muggle_sync_deadline_remain(&deadline, &remain, &p_wait)) {
+#if MUGGLE_C_HAVE_SHARED_SYNC_OBJ
+		if (shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_BLOCKING) {
+			// announce parked, then recheck before wait
+			muggle_atomic_fetch_add(&shm_rbuf->n_waiters, 1,
+									muggle_memory_order_relaxed);
+			muggle_sync_t seq = muggle_atomic_load(&shm_rbuf->futex_seq,
+												   muggle_memory_order_acquire);
+			muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+			data = fn(shm_rbuf, reader_id, n_bytes);
+			if (data == NULL) {
+				const struct timespec slice = {
+					0, MUGGLE_SHM_RINGBUF_PARK_SLICE_MS * 1000000L
+				};
+				const struct timespec *p_park = &slice;
+				if (p_wait && (p_wait->tv_sec < slice.tv_sec ||
+							   (p_wait->tv_sec == slice.tv_sec &&
+								p_wait->tv_nsec < slice.tv_nsec))) {
+					p_park = p_wait;
+				}
+				muggle_sync_wait_shared(&shm_rbuf->futex_seq, seq, p_park);
+				data = fn(shm_rbuf, reader_id, n_bytes);
+			}
+
+			muggle_atomic_fetch_sub(&shm_rbuf->n_waiters, 1,
+									muggle_memory_order_relaxed);
+			if (data) {
+				return data;
+			}
+			continue;
+		}
+#endif
+
+		muggle_msleep(MUGGLE_SHM_RINGBUF_POLL_MS);
+		data = fn(shm_rbuf, reader_id, n_bytes);
+		if (data) {
+			return data;
+		}
+	}
+
+	return NULL;
+}
+
+static void *muggle_shm_ringbuf_fetch_adapter(muggle_shm_ringbuf_t *shm_rbuf,
+											  int reader_id, uint32_t *n_bytes)
+{
+	MUGGLE_UNUSED(reader_id);
+	return muggle_shm_ringbuf_r_fetch(shm_rbuf, n_bytes);
+}
+
+void *muggle_shm_ringbuf_r_fetch_wait(muggle_shm_ringbuf_t *shm_rbuf,
+									  uint32_t *n_bytes, uint32_t spin_cnt,
+									  const struct timespec *timeout)
+{
+	return muggle_shm_ringbuf_fetch_wait(shm_rbuf,
+										 muggle_shm_ringbuf_fetch_adapter, 0,
+										 n_bytes, spin_cnt, timeout);
+}
+
 void muggle_shm_ringbuf_r_move(muggle_shm_ringbuf_t *shm_rbuf)
 {
 	uint32_t n = shm_rbuf->cached_r_hdr->n_cachelines;
@@ -231,3 +470,299 @@ void muggle_shm_ringbuf_r_move(muggle_shm_ringbuf_t *shm_rbuf)
 	muggle_atomic_store(&shm_rbuf->read_cursor, r_pos,
 						muggle_memory_order_release);
 }
+
+#define MUGGLE_SHM_RINGBUF_POS_BEFORE(a, b) ((int32_t)((a) - (b)) < 0)
+
+static void muggle_shm_ringbuf_bcast_refresh_gate(
+	muggle_shm_ringbuf_t *shm_rbuf)
+{
+	// pair with the fence in muggle_shm_ringbuf_bcast_reader_register
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	muggle_sync_t gate = shm_rbuf->write_cursor;
+	for (int i = 0; i < MUGGLE_SHM_RINGBUF_MAX_READER; ++i) {
+		muggle_shm_ringbuf_reader_t *reader = &shm_rbuf->readers[i];
+		muggle_sync_t status =
+			muggle_atomic_load(&reader->status, muggle_memory_order_relaxed);
+		if (status != MUGGLE_SHM_RINGBUF_READER_ACTIVE) {
+			continue;
+		}
+
+		muggle_sync_t cursor =
+			muggle_atomic_load(&reader->cursor, muggle_memory_order_acquire);
+		if (MUGGLE_SHM_RINGBUF_POS_BEFORE(cursor, gate)) {
+			gate = cursor;
+		}
+	}
+	shm_rbuf->cached_gate = gate;
+}
+
+static void muggle_shm_ringbuf_bcast_reclaim(muggle_shm_ringbuf_t *shm_rbuf,
+											 muggle_sync_t target)
+{
+	muggle_sync_t tail = shm_rbuf->w_tail;
+	while (MUGGLE_SHM_RINGBUF_POS_BEFORE(tail, target)) {
+		uint32_t idx = tail & (shm_rbuf->n_cacheline - 1);
+		muggle_shm_ringbuf_data_hdr_t *hdr =
+			muggle_shm_ringbuf_get_data(shm_rbuf, idx);
+		if (hdr->n_cachelines == 0) {
+			tail += shm_rbuf->n_cacheline - idx;
+		} else {
+			tail += hdr->n_cachelines;
+		}
+	}
+
+	// readers must see new tail before messages be overwritten
+	muggle_atomic_store(&shm_rbuf->w_tail, tail, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_release);
+
+	shm_rbuf->cached_gate = tail;
+}
+
+// ensure [cached_gate, end) not larger than ring
+static bool muggle_shm_ringbuf_bcast_reserve(muggle_shm_ringbuf_t *shm_rbuf,
+											 muggle_sync_t end)
+{
+	if ((muggle_sync_t)(end - shm_rbuf->cached_gate) <= shm_rbuf->n_cacheline) {
+		return true;
+	}
+
+	if (shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_OVERWRITE) {
+		muggle_shm_ringbuf_bcast_reclaim(shm_rbuf,
+										 end - shm_rbuf->n_cacheline);
+		return true;
+	}
+
+	muggle_shm_ringbuf_bcast_refresh_gate(shm_rbuf);
+	return (muggle_sync_t)(end - shm_rbuf->cached_gate) <=
+		   shm_rbuf->n_cacheline;
+}
+
+int muggle_shm_ringbuf_bcast_reader_register(muggle_shm_ringbuf_t *shm_rbuf,
+											 int *reader_id)
+{
+	if (!(shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_BROADCAST)) {
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	for (int i = 0; i < MUGGLE_SHM_RINGBUF_MAX_READER; ++i) {
+		muggle_shm_ringbuf_reader_t *reader = &shm_rbuf->readers[i];
+		muggle_sync_t expected = MUGGLE_SHM_RINGBUF_READER_FREE;
+		if (!muggle_atomic_cmp_exch_strong(&reader->status, &expected,
+										   MUGGLE_SHM_RINGBUF_READER_CLAIMED,
+										   muggle_memory_order_acq_rel)) {
+			continue;
+		}
+
+		muggle_atomic_store(&reader->cursor,
+							muggle_atomic_load(&shm_rbuf->write_cursor,
+											   muggle_memory_order_acquire),
+							muggle_memory_order_relaxed);
+		reader->n_overrun = 0;
+		reader->r_pending = 0;
+		muggle_atomic_store(&reader->status, MUGGLE_SHM_RINGBUF_READER_ACTIVE,
+							muggle_memory_order_release);
+
+		// writer may refreshed gate without this reader before it be active,
+		// reload write cursor after the fence, so reader never start before
+		// the gate writer used
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		muggle_atomic_store(&reader->cursor,
+							muggle_atomic_load(&shm_rbuf->write_cursor,
+											   muggle_memory_order_acquire),
+							muggle_memory_order_release);
+
+		*reader_id = i;
+		return 0;
+	}
+
+	return MUGGLE_ERR_FULL;
+}
+
+void muggle_shm_ringbuf_bcast_reader_unregister(muggle_shm_ringbuf_t *shm_rbuf,
+												int reader_id)
+{
+	muggle_atomic_store(&shm_rbuf->readers[reader_id].status,
+						MUGGLE_SHM_RINGBUF_READER_FREE,
+						muggle_memory_order_release);
+}
+
+void muggle_shm_ringbuf_bcast_reader_evict(muggle_shm_ringbuf_t *shm_rbuf,
+										   int reader_id)
+{
+	muggle_sync_t expected = MUGGLE_SHM_RINGBUF_READER_ACTIVE;
+	muggle_atomic_cmp_exch_strong(&shm_rbuf->readers[reader_id].status,
+								  &expected, MUGGLE_SHM_RINGBUF_READER_EVICTED,
+								  muggle_memory_order_acq_rel);
+}
+
+int muggle_shm_ringbuf_bcast_slowest_reader(muggle_shm_ringbuf_t *shm_rbuf,
+											muggle_sync_t *lag)
+{
+	int slowest = -1;
+	muggle_sync_t max_lag = 0;
+	muggle_sync_t w = muggle_atomic_load(&shm_rbuf->write_cursor,
+										 muggle_memory_order_acquire);
+	for (int i = 0; i < MUGGLE_SHM_RINGBUF_MAX_READER; ++i) {
+		muggle_shm_ringbuf_reader_t *reader = &shm_rbuf->readers[i];
+		if (muggle_atomic_load(&reader->status, muggle_memory_order_acquire) !=
+			MUGGLE_SHM_RINGBUF_READER_ACTIVE) {
+			continue;
+		}
+
+		muggle_sync_t cursor =
+			muggle_atomic_load(&reader->cursor, muggle_memory_order_relaxed);
+		muggle_sync_t reader_lag = w - cursor;
+		if (slowest == -1 || reader_lag > max_lag) {
+			slowest = i;
+			max_lag = reader_lag;
+		}
+	}
+
+	if (lag) {
+		*lag = max_lag;
+	}
+	return slowest;
+}
+
+void *muggle_shm_ringbuf_bcast_w_alloc_bytes(muggle_shm_ringbuf_t *shm_rbuf,
+											 uint32_t n_bytes)
+{
+	uint32_t n_cacheline = MUGGLE_SHM_RINGBUF_CAL_BYTES_CACHELINE(n_bytes);
+	if (n_cacheline > shm_rbuf->n_cacheline) {
+		return NULL;
+	}
+
+	muggle_sync_t w = shm_rbuf->write_cursor;
+	uint32_t idx = w & (shm_rbuf->n_cacheline - 1);
+	if (idx + n_cacheline > shm_rbuf->n_cacheline) {
+		// fillup wrap hdr and publish it alone, so message always start at
+		// the start of ring and never overlap the wrap hdr
+		uint32_t skip = shm_rbuf->n_cacheline - idx;
+		if (!muggle_shm_ringbuf_bcast_reserve(shm_rbuf, w + skip)) {
+			return NULL;
+		}
+
+		muggle_shm_ringbuf_data_hdr_t *hdr =
+			muggle_shm_ringbuf_get_data(shm_rbuf, idx);
+		hdr->n_bytes = 0;
+		hdr->n_cachelines = 0;
+
+		w += skip;
+		idx = 0;
+		muggle_atomic_store(&shm_rbuf->write_cursor, w,
+							muggle_memory_order_release);
+	}
+
+	if (!muggle_shm_ringbuf_bcast_reserve(shm_rbuf, w + n_cacheline)) {
+		return NULL;
+	}
+
+	muggle_shm_ringbuf_data_hdr_t *hdr =
+		muggle_shm_ringbuf_get_data(shm_rbuf, idx);
+	hdr->n_bytes = n_bytes;
+	hdr->n_cachelines = n_cacheline;
+
+	shm_rbuf->cached_w_hdr = hdr;
+
+	return (void *)(hdr + 1);
+}
+
+void muggle_shm_ringbuf_bcast_w_move(muggle_shm_ringbuf_t *shm_rbuf)
+{
+	muggle_atomic_store(&shm_rbuf->write_cursor,
+						shm_rbuf->write_cursor +
+							shm_rbuf->cached_w_hdr->n_cachelines,
+						muggle_memory_order_release);
+
+	if (shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_BLOCKING) {
+		muggle_shm_ringbuf_wake_readers(shm_rbuf);
+	}
+}
+
+// in overwrite mode, check reader position still valid after read
+static bool muggle_shm_ringbuf_bcast_check_overrun(
+	muggle_shm_ringbuf_t *shm_rbuf, muggle_shm_ringbuf_reader_t *reader)
+{
+	if (!(shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_OVERWRITE)) {
+		return false;
+	}
+
+	// pair with the fence in muggle_shm_ringbuf_bcast_reclaim
+	muggle_atomic_thread_fence(muggle_memory_order_acquire);
+	muggle_sync_t tail =
+		muggle_atomic_load(&shm_rbuf->w_tail, muggle_memory_order_relaxed);
+	if (!MUGGLE_SHM_RINGBUF_POS_BEFORE(reader->cursor, tail)) {
+		return false;
+	}
+
+	++reader->n_overrun;
+	muggle_atomic_store(&reader->cursor, tail, muggle_memory_order_release);
+	return true;
+}
+
+void *muggle_shm_ringbuf_bcast_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
+									   int reader_id, uint32_t *n_bytes)
+{
+	muggle_shm_ringbuf_reader_t *reader = &shm_rbuf->readers[reader_id];
+	if (muggle_atomic_load(&reader->status, muggle_memory_order_relaxed) !=
+		MUGGLE_SHM_RINGBUF_READER_ACTIVE) {
+		return NULL;
+	}
+
+	while (true) {
+		muggle_sync_t w_pos = muggle_atomic_load(&shm_rbuf->write_cursor,
+												 muggle_memory_order_acquire);
+		muggle_sync_t r_pos = reader->cursor;
+		if (w_pos == r_pos) {
+			return NULL;
+		}
+
+		uint32_t idx = r_pos & (shm_rbuf->n_cacheline - 1);
+		muggle_shm_ringbuf_data_hdr_t *hdr =
+			muggle_shm_ringbuf_get_data(shm_rbuf, idx);
+		uint32_t hdr_n_bytes = hdr->n_bytes;
+		uint32_t hdr_n_cachelines = hdr->n_cachelines;
+
+		if (muggle_shm_ringbuf_bcast_check_overrun(shm_rbuf, reader)) {
+			continue;
+		}
+
+		if (hdr_n_cachelines == 0) {
+			// wrap hdr, jump to the start of ring
+			muggle_atomic_store(&reader->cursor,
+								r_pos + shm_rbuf->n_cacheline - idx,
+								muggle_memory_order_release);
+			continue;
+		}
+
+		reader->r_pending = hdr_n_cachelines;
+		if (n_bytes) {
+			*n_bytes = hdr_n_bytes;
+		}
+		return hdr + 1;
+	}
+}
+
+bool muggle_shm_ringbuf_bcast_r_move(muggle_shm_ringbuf_t *shm_rbuf,
+									 int reader_id)
+{
+	muggle_shm_ringbuf_reader_t *reader = &shm_rbuf->readers[reader_id];
+	if (muggle_shm_ringbuf_bcast_check_overrun(shm_rbuf, reader)) {
+		return false;
+	}
+
+	muggle_atomic_store(&reader->cursor, reader->cursor + reader->r_pending,
+						muggle_memory_order_release);
+	return true;
+}
+
+void *muggle_shm_ringbuf_bcast_r_fetch_wait(muggle_shm_ringbuf_t *shm_rbuf,
+											int reader_id, uint32_t *n_bytes,
+											uint32_t spin_cnt,
+											const struct timespec *timeout)
+{
+	return muggle_shm_ringbuf_fetch_wait(shm_rbuf,
+										 muggle_shm_ringbuf_bcast_r_fetch,
+										 reader_id, n_bytes, spin_cnt, timeout);
+}
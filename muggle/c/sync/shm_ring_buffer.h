@@ -20,20 +20,65 @@
 
 EXTERN_C_BEGIN
 
+#define MUGGLE_SHM_RINGBUF_MAX_READER 16
+
+/**
+ * @brief shared memory ring buffer mode flags
+ */
+enum {
+	MUGGLE_SHM_RINGBUF_FLAG_BROADCAST = 0x01, //!< every reader see every message
+	MUGGLE_SHM_RINGBUF_FLAG_OVERWRITE = 0x02, //!< broadcast writer overwrite
+											  //   oldest messages instead of
+											  //   wait slow readers
+	MUGGLE_SHM_RINGBUF_FLAG_BLOCKING = 0x04, //!< writer wake parked readers,
+											 //   needed by *_r_fetch_wait
+	MUGGLE_SHM_RINGBUF_FLAG_JOURNAL = 0x08, //!< ring is a journal segment,
+											//   never wrap, see
+											//   shm_ringbuf_journal.h
+};
+
+/**
+ * @brief status of broadcast reader slot
+ */
+enum {
+	MUGGLE_SHM_RINGBUF_READER_FREE = 0, //!< slot is free
+	MUGGLE_SHM_RINGBUF_READER_CLAIMED, //!< slot is registering
+	MUGGLE_SHM_RINGBUF_READER_ACTIVE, //!< reader is active
+	MUGGLE_SHM_RINGBUF_READER_EVICTED, //!< reader evicted, not gate writer
+};
+
 typedef struct {
 	uint32_t n_bytes; //!< number of bytes
 	uint32_t n_cachelines; //!< number of cachelines
 } muggle_shm_ringbuf_data_hdr_t;
 
+/**
+ * @brief broadcast reader slot in shared header
+ */
+typedef struct {
+	union {
+		struct {
+			muggle_sync_t status; //!< MUGGLE_SHM_RINGBUF_READER_*
+			muggle_sync_t cursor; //!< reader position
+			muggle_sync_t n_overrun; //!< times of overrun by writer
+			muggle_sync_t r_pending; //!< cachelines of fetched message
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+} muggle_shm_ringbuf_reader_t;
+
 typedef struct {
 	union {
 		struct {
 			uint32_t magic; //!< magic word
 			uint32_t n_bytes; //!< number of data bytes
 			uint32_t total_bytes; //!< total bytes
-			uint32_t reserved1; //!< reserved bytes
+			uint32_t flags; //!< bit or of MUGGLE_SHM_RINGBUF_FLAG_*
 			muggle_sync_t n_cacheline; //!< number of data cachelines
 			muggle_sync_t ready; //!< is ready
+			uint32_t segment_seq; //!< sequence number of journal segment
+			muggle_sync_t sealed; //!< journal segment is sealed, writer
+								  //   rolled to next segment
 		};
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
 	};
@@ -44,6 +89,10 @@ typedef struct {
 			muggle_sync_t write_cursor; //!< write cursor
 			muggle_sync_t cached_remain; //!< contiguous len of cachelines
 			muggle_shm_ringbuf_data_hdr_t *cached_w_hdr; //!< current write hdr
+			muggle_sync_t w_tail; //!< oldest valid position, overwrite mode
+			muggle_sync_t cached_gate; //!< cached slowest reader position
+			muggle_sync_t staged_cursor; //!< writer position include staged
+										 //   but not published messages
 		};
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 	};
@@ -73,8 +122,29 @@ typedef struct {
 		MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
 	};
 	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(4);
+	muggle_shm_ringbuf_reader_t
+		readers[MUGGLE_SHM_RINGBUF_MAX_READER]; //!< broadcast reader table
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(5);
+	union {
+		struct {
+			muggle_sync_t futex_seq; //!< process-shared futex word
+			muggle_sync_t n_waiters; //!< number of parked readers
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
+	};
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(6);
 } muggle_shm_ringbuf_t;
 
+/**
+ * @brief batch read iterator
+ */
+typedef struct {
+	muggle_shm_ringbuf_t *shm_rbuf; //!< pointer to muggle_shm_ringbuf_t
+	muggle_sync_t w_pos; //!< snapshot of write cursor
+	muggle_sync_t r_pos; //!< position of next message
+	uint32_t n_msg; //!< number of messages iterated
+} muggle_shm_ringbuf_r_batch_t;
+
 // calculate required number of cacheline
 #define MUGGLE_SHM_RINGBUF_CAL_BYTES_CACHELINE(n_bytes)        \
 	((MUGGLE_ROUND_UP_POW_OF_2_MUL(                            \
@@ -103,6 +173,58 @@ muggle_shm_ringbuf_t *muggle_shm_ringbuf_open(muggle_shm_t *shm,
 											  const char *k_name, int k_num,
 											  int flag, uint32_t nbytes);
 
+/**
+ * @brief open shared memory ring buffer with mode flags
+ *
+ * @param shm       pointer to muggle_shm_t
+ * @param k_name    key's name of shm, in *nix, gurantee it's an exists filepath
+ * @param k_num     key's number, range in [1, 255]
+ * @param flag      bit or of MUGGLE_SHM_FLAG_*
+ * @param nbytes    expected size of data's memory
+ * @param rb_flags  bit or of MUGGLE_SHM_RINGBUF_FLAG_*, only used when
+ *                  create shm, otherwise mode is read from shared header
+ *
+ * @return
+ *   - on success, return pointer to memory
+ *   - on failed, return NULL
+ *
+ * @NOTE
+ *   in broadcast mode, write_cursor and reader cursors are positions keep
+ *   increasing (wrap around in 32 bits), the index in ring is
+ *   cursor & (n_cacheline - 1), use muggle_shm_ringbuf_bcast_* functions
+ *   to read and write
+ */
+MUGGLE_C_EXPORT
+muggle_shm_ringbuf_t *muggle_shm_ringbuf_open_ex(muggle_shm_t *shm,
+												 const char *k_name, int k_num,
+												 int flag, uint32_t nbytes,
+												 uint32_t rb_flags);
+
+/**
+ * @brief open ring buffer backed by a memory-mapped file
+ *
+ * @param shm       pointer to muggle_shm_t
+ * @param filepath  file path
+ * @param flag      bit or of MUGGLE_SHM_FLAG_*
+ * @param nbytes    expected size of data's memory, only used when create
+ * @param rb_flags  bit or of MUGGLE_SHM_RINGBUF_FLAG_*, only used when create
+ *
+ * @return
+ *   - on success, return pointer to memory
+ *   - on failed, return NULL
+ *
+ * @NOTE
+ *   the record format is the same as muggle_shm_ringbuf_open_ex, content
+ *   persist in file after process exit, so it can be opened and replayed
+ *   again; when open exists file, check muggle_shm_ringbuf_is_ready before
+ *   use it
+ */
+MUGGLE_C_EXPORT
+muggle_shm_ringbuf_t *muggle_shm_ringbuf_open_file(muggle_shm_t *shm,
+												   const char *filepath,
+												   int flag, uint32_t nbytes,
+												   uint32_t rb_flags);
+
 /**
  * @brief check shared memory buffer is ready
  *
@@ -192,6 +314,32 @@ void *muggle_shm_ringbuf_w_alloc_cachelines(muggle_shm_ringbuf_t *shm_rbuf,
 MUGGLE_C_EXPORT
 void muggle_shm_ringbuf_w_move(muggle_shm_ringbuf_t *shm_rbuf);
 
+/**
+ * @brief write move without publish
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ *
+ * @NOTE
+ *   staged messages are invisible to readers until
+ *   muggle_shm_ringbuf_w_publish, writer can stage a batch of messages and
+ *   publish them with one store to write cursor. When writer wrap to the
+ *   start of ring, staged messages are published together
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_w_stage(muggle_shm_ringbuf_t *shm_rbuf);
+
+/**
+ * @brief publish all staged messages
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ *
+ * @NOTE
+ *   when allocate failed, writer should publish staged messages before
+ *   wait readers, otherwise readers never release space
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_w_publish(muggle_shm_ringbuf_t *shm_rbuf);
+
 /**
  * @brief fetch next data for read
  *
@@ -206,6 +354,35 @@ MUGGLE_C_EXPORT
 void *muggle_shm_ringbuf_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
 								 uint32_t *n_bytes);
 
+/**
+ * @brief fetch next data for read, wait if no data
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ * @param n_bytes   number of bytes read
+ * @param spin_cnt  times of fetch retry before park
+ * @param timeout   relative timeout, NULL means wait infinite
+ *
+ * @return
+ *   - when has data wait for read, return pointer to data
+ *   - when timeout, return NULL
+ *
+ * @NOTE
+ *   - reader spin for spin_cnt times first, latency critical readers can
+ *     pass a large spin_cnt to avoid syscalls
+ *   - if ring created with MUGGLE_SHM_RINGBUF_FLAG_BLOCKING and platform
+ *     supports process-shared futex, reader park on futex_seq and writer
+ *     wake it only when there are parked readers; otherwise reader poll
+ *     with sleep
+ *   - writer check parked readers without a full fence, a wakeup raced
+ *     with reader parking may be missed, each park is at most 1ms, so the
+ *     reader see the message no later than that
+ *   - if there are multiple readers, must hold read lock
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_r_fetch_wait(muggle_shm_ringbuf_t *shm_rbuf,
+									  uint32_t *n_bytes, uint32_t spin_cnt,
+									  const struct timespec *timeout);
+
 /**
  * @brief read move
  *
@@ -214,6 +391,180 @@ void *muggle_shm_ringbuf_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
 MUGGLE_C_EXPORT
 void muggle_shm_ringbuf_r_move(muggle_shm_ringbuf_t *shm_rbuf);
 
+/**
+ * @brief begin batch read, take a snapshot of all published messages
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ * @param batch     batch iterator
+ *
+ * @return whether there are messages wait for read
+ */
+MUGGLE_C_EXPORT
+bool muggle_shm_ringbuf_r_batch_begin(muggle_shm_ringbuf_t *shm_rbuf,
+									  muggle_shm_ringbuf_r_batch_t *batch);
+
+/**
+ * @brief get next message in batch
+ *
+ * @param batch    batch iterator
+ * @param n_bytes  number of bytes read
+ *
+ * @return
+ *   - pointer to message data, it's valid until the batch be committed
+ *   - NULL if no more message in snapshot
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_r_batch_next(muggle_shm_ringbuf_r_batch_t *batch,
+									  uint32_t *n_bytes);
+
+/**
+ * @brief commit batch, move read cursor over all iterated messages once
+ *
+ * @param batch  batch iterator
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_r_batch_commit(muggle_shm_ringbuf_r_batch_t *batch);
+
+/**
+ * @brief register broadcast reader
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  output id of reader
+ *
+ * @return
+ *   - 0 on success
+ *   - MUGGLE_ERR_INVALID_PARAM if shm_rbuf is not in broadcast mode
+ *   - MUGGLE_ERR_FULL if there is no free reader slot
+ *
+ * @NOTE
+ *   reader start at current write position, messages published before
+ *   register are invisible to it
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_ringbuf_bcast_reader_register(muggle_shm_ringbuf_t *shm_rbuf,
+											 int *reader_id);
+
+/**
+ * @brief unregister broadcast reader
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  id of reader
+ *
+ * @NOTE
+ *   a monitor process can invoke it on behalf of a dead reader process
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_bcast_reader_unregister(muggle_shm_ringbuf_t *shm_rbuf,
+												int reader_id);
+
+/**
+ * @brief evict broadcast reader, the writer will no longer wait for it
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  id of reader
+ *
+ * @NOTE
+ *   evicted reader fetch nothing, it should unregister and register again
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_bcast_reader_evict(muggle_shm_ringbuf_t *shm_rbuf,
+										   int reader_id);
+
+/**
+ * @brief find the slowest active broadcast reader
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ * @param lag       output number of cachelines reader fall behind writer,
+ *                  could be NULL
+ *
+ * @return id of the slowest reader, -1 if there is no active reader
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_ringbuf_bcast_slowest_reader(muggle_shm_ringbuf_t *shm_rbuf,
+											muggle_sync_t *lag);
+
+/**
+ * @brief allocate bytes for broadcast write
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ * @param n_bytes   number of bytes required
+ *
+ * @return
+ *   - on success, return pointer to memory addr
+ *   - on failed, return NULL, it happens when slowest reader is not far
+ *     enough, or n_bytes is larger than the ring
+ *
+ * @NOTE
+ *   in overwrite mode, allocate always success unless n_bytes is too large
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_bcast_w_alloc_bytes(muggle_shm_ringbuf_t *shm_rbuf,
+											 uint32_t n_bytes);
+
+/**
+ * @brief broadcast write move
+ *
+ * @param shm_rbuf  pointer to muggle_shm_ringbuf_t
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_bcast_w_move(muggle_shm_ringbuf_t *shm_rbuf);
+
+/**
+ * @brief fetch next data for broadcast reader
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  id of reader
+ * @param n_bytes    number of bytes read
+ *
+ * @return
+ *   - when has data wait for read, return pointer to data
+ *   - when no data wait for read or reader is not active, return NULL
+ *
+ * @NOTE
+ *   in overwrite mode, if reader already be overrun by writer, it jump to
+ *   the oldest valid message and increase n_overrun of reader slot
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_bcast_r_fetch(muggle_shm_ringbuf_t *shm_rbuf,
+									   int reader_id, uint32_t *n_bytes);
+
+/**
+ * @brief fetch next data for broadcast reader, wait if no data
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  id of reader
+ * @param n_bytes    number of bytes read
+ * @param spin_cnt   times of fetch retry before park
+ * @param timeout    relative timeout, NULL means wait infinite
+ *
+ * @return
+ *   - when has data wait for read, return pointer to data
+ *   - when timeout, return NULL
+ *
+ * @NOTE
+ *   wait policy is the same as muggle_shm_ringbuf_r_fetch_wait
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_bcast_r_fetch_wait(muggle_shm_ringbuf_t *shm_rbuf,
+											int reader_id, uint32_t *n_bytes,
+											uint32_t spin_cnt,
+											const struct timespec *timeout);
+
+/**
+ * @brief broadcast read move
+ *
+ * @param shm_rbuf   pointer to muggle_shm_ringbuf_t
+ * @param reader_id  id of reader
+ *
+ * @return
+ *   - true, fetched data is valid
+ *   - false, only in overwrite mode, fetched data was overwritten by writer
+ *     while reading, the data must be discarded
+ */
+MUGGLE_C_EXPORT
+bool muggle_shm_ringbuf_bcast_r_move(muggle_shm_ringbuf_t *shm_rbuf,
+									 int reader_id);
+
 EXTERN_C_END
 
 #endif // !MUGGLE_C_SHM_RING_BUFFER_H_
@@ -0,0 +1,293 @@
+#include "shm_ringbuf_journal.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/os/path.h"
+#include "muggle/c/os/os.h"
+#include <stdio.h>
+#include <string.h>
+
+static int muggle_shm_ringbuf_journal_path(char *buf, size_t bufsize,
+										   const char *prefix, uint32_t seq)
+{
+	int ret = snprintf(buf, bufsize, "%s.%08u", prefix, (unsigned int)seq);
+	if (ret < 0 || (size_t)ret >= bufsize) {
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+	return 0;
+}
+
+static muggle_shm_ringbuf_t *
+muggle_shm_ringbuf_journal_open_segment(muggle_shm_t *shm, const char *prefix,
+										uint32_t seq)
+{
+	char filepath[MUGGLE_MAX_PATH];
+	if (muggle_shm_ringbuf_journal_path(filepath, sizeof(filepath), prefix,
+										seq) != 0) {
+		return NULL;
+	}
+
+	muggle_shm_ringbuf_t *shm_rbuf = muggle_shm_ringbuf_open_file(
+		shm, filepath, MUGGLE_SHM_FLAG_OPEN, 0, 0);
+	if (shm_rbuf == NULL) {
+		return NULL;
+	}
+
+	if (!muggle_shm_ringbuf_is_ready(shm_rbuf) ||
+		!(shm_rbuf->flags & MUGGLE_SHM_RINGBUF_FLAG_JOURNAL)) {
+		muggle_shm_detach(shm);
+		return NULL;
+	}
+
+	return shm_rbuf;
+}
+
+static int
+muggle_shm_ringbuf_journal_create_segment(muggle_shm_ringbuf_journal_t *journal,
+										  uint32_t seq)
+{
+	char filepath[MUGGLE_MAX_PATH];
+	int ret = muggle_shm_ringbuf_journal_path(filepath, sizeof(filepath),
+											  journal->prefix, seq);
+	if (ret != 0) {
+		return ret;
+	}
+
+	muggle_shm_ringbuf_t *shm_rbuf = muggle_shm_ringbuf_open_file(
+		&journal->shm, filepath, MUGGLE_SHM_FLAG_CREAT, journal->nbytes,
+		MUGGLE_SHM_RINGBUF_FLAG_JOURNAL);
+	if (shm_rbuf == NULL) {
+		return MUGGLE_ERR_SYS_CALL;
+	}
+	shm_rbuf->segment_seq = seq;
+
+	journal->seq = seq;
+	journal->shm_rbuf = shm_rbuf;
+
+	return 0;
+}
+
+int muggle_shm_ringbuf_journal_open(muggle_shm_ringbuf_journal_t *journal,
+									const char *prefix, uint32_t nbytes)
+{
+	memset(journal, 0, sizeof(*journal));
+
+	if (nbytes == 0) {
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	size_t len = strlen(prefix);
+	if (len >= sizeof(journal->prefix)) {
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+	memcpy(journal->prefix, prefix, len + 1);
+	journal->nbytes = nbytes;
+
+	// find the last segment
+	char filepath[MUGGLE_MAX_PATH];
+	uint32_t seq = 0;
+	bool found = false;
+	while (1) {
+		int ret = muggle_shm_ringbuf_journal_path(filepath, sizeof(filepath),
+												  prefix, seq);
+		if (ret != 0) {
+			return ret;
+		}
+		if (!muggle_path_exists(filepath)) {
+			break;
+		}
+		found = true;
+		++seq;
+	}
+
+	if (!found) {
+		return muggle_shm_ringbuf_journal_create_segment(journal, 0);
+	}
+	--seq;
+
+	muggle_shm_ringbuf_t *shm_rbuf =
+		muggle_shm_ringbuf_journal_open_segment(&journal->shm, prefix, seq);
+	if (shm_rbuf == NULL) {
+		// last segment was created but not initialized before writer
+		// exit, there has no message in it
+		muggle_shm_ringbuf_journal_path(filepath, sizeof(filepath), prefix,
+										seq);
+		if (muggle_os_remove(filepath) != 0) {
+			return MUGGLE_ERR_SYS_CALL;
+		}
+		return muggle_shm_ringbuf_journal_create_segment(journal, seq);
+	}
+
+	if (muggle_atomic_load(&shm_rbuf->sealed, muggle_memory_order_acquire)) {
+		muggle_shm_detach(&journal->shm);
+		return muggle_shm_ringbuf_journal_create_segment(journal, seq + 1);
+	}
+
+	// resume at the end of published messages
+	shm_rbuf->staged_cursor = shm_rbuf->write_cursor;
+	shm_rbuf->cached_remain = 0;
+
+	journal->seq = seq;
+	journal->shm_rbuf = shm_rbuf;
+
+	return 0;
+}
+
+void muggle_shm_ringbuf_journal_close(muggle_shm_ringbuf_journal_t *journal)
+{
+	if (journal->shm_rbuf) {
+		muggle_shm_sync(&journal->shm);
+		muggle_shm_detach(&journal->shm);
+		journal->shm_rbuf = NULL;
+	}
+}
+
+int muggle_shm_ringbuf_journal_sync(muggle_shm_ringbuf_journal_t *journal)
+{
+	if (journal->shm_rbuf == NULL) {
+		return MUGGLE_ERR_NULL_PARAM;
+	}
+
+	if (muggle_shm_sync(&journal->shm) != 0) {
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	return 0;
+}
+
+void *muggle_shm_ringbuf_journal_w_alloc_bytes(
+	muggle_shm_ringbuf_journal_t *journal, uint32_t n_bytes)
+{
+	muggle_shm_ringbuf_t *shm_rbuf = journal->shm_rbuf;
+	if (shm_rbuf == NULL) {
+		return NULL;
+	}
+
+	// journal segment never wrap, read_cursor keep 0, so alloc return NULL
+	// when the segment is full
+	void *data = muggle_shm_ringbuf_w_alloc_bytes(shm_rbuf, n_bytes);
+	if (data) {
+		return data;
+	}
+
+	uint32_t n_cacheline = MUGGLE_SHM_RINGBUF_CAL_BYTES_CACHELINE(n_bytes);
+	if (n_cacheline >= shm_rbuf->n_cacheline) {
+		return NULL;
+	}
+
+	// seal current segment and roll to the next one
+	//
+	// NOTE: all messages already published in w_move, readers see sealed
+	// with acquire and then see final write_cursor; sealed segment is never
+	// written again, flush it before detach
+	muggle_atomic_store(&shm_rbuf->sealed, 1, muggle_memory_order_release);
+	muggle_shm_sync(&journal->shm);
+	muggle_shm_detach(&journal->shm);
+	journal->shm_rbuf = NULL;
+
+	if (muggle_shm_ringbuf_journal_create_segment(journal, journal->seq + 1) !=
+		0) {
+		return NULL;
+	}
+
+	return muggle_shm_ringbuf_w_alloc_bytes(journal->shm_rbuf, n_bytes);
+}
+
+void muggle_shm_ringbuf_journal_w_move(muggle_shm_ringbuf_journal_t *journal)
+{
+	muggle_shm_ringbuf_w_move(journal->shm_rbuf);
+}
+
+int muggle_shm_ringbuf_journal_reader_open(
+	muggle_shm_ringbuf_journal_reader_t *reader, const char *prefix,
+	uint32_t seq, uint32_t pos)
+{
+	memset(reader, 0, sizeof(*reader));
+
+	size_t len = strlen(prefix);
+	if (len >= sizeof(reader->prefix)) {
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+	memcpy(reader->prefix, prefix, len + 1);
+
+	reader->shm_rbuf =
+		muggle_shm_ringbuf_journal_open_segment(&reader->shm, prefix, seq);
+	if (reader->shm_rbuf == NULL) {
+		return MUGGLE_ERR_SYS_CALL;
+	}
+
+	if (pos >= reader->shm_rbuf->n_cacheline) {
+		muggle_shm_ringbuf_journal_reader_close(reader);
+		return MUGGLE_ERR_BEYOND_RANGE;
+	}
+
+	reader->seq = seq;
+	reader->r_pos = pos;
+
+	return 0;
+}
+
+void muggle_shm_ringbuf_journal_reader_close(
+	muggle_shm_ringbuf_journal_reader_t *reader)
+{
+	if (reader->shm_rbuf) {
+		muggle_shm_detach(&reader->shm);
+		reader->shm_rbuf = NULL;
+	}
+}
+
+void *muggle_shm_ringbuf_journal_r_fetch(
+	muggle_shm_ringbuf_journal_reader_t *reader, uint32_t *n_bytes)
+{
+	while (1) {
+		muggle_shm_ringbuf_t *shm_rbuf = reader->shm_rbuf;
+		muggle_sync_t w_pos = muggle_atomic_load(&shm_rbuf->write_cursor,
+												 muggle_memory_order_acquire);
+		if (w_pos == reader->r_pos) {
+			if (!muggle_atomic_load(&shm_rbuf->sealed,
+									muggle_memory_order_acquire)) {
+				return NULL;
+			}
+
+			// writer may publish messages before seal
+			w_pos = muggle_atomic_load(&shm_rbuf->write_cursor,
+									   muggle_memory_order_acquire);
+			if (w_pos == reader->r_pos) {
+				muggle_shm_t shm;
+				muggle_shm_ringbuf_t *next =
+					muggle_shm_ringbuf_journal_open_segment(
+						&shm, reader->prefix, reader->seq + 1);
+				if (next == NULL) {
+					// next segment not ready yet
+					return NULL;
+				}
+
+				muggle_shm_detach(&reader->shm);
+				reader->shm = shm;
+				reader->shm_rbuf = next;
+				reader->seq++;
+				reader->r_pos = 0;
+				continue;
+			}
+		}
+
+		reader->cached_r_hdr =
+			muggle_shm_ringbuf_get_data(shm_rbuf, reader->r_pos);
+		if (n_bytes) {
+			*n_bytes = reader->cached_r_hdr->n_bytes;
+		}
+		return reader->cached_r_hdr + 1;
+	}
+}
+
+void muggle_shm_ringbuf_journal_r_move(
+	muggle_shm_ringbuf_journal_reader_t *reader)
+{
+	reader->r_pos += reader->cached_r_hdr->n_cachelines;
+}
+
+void muggle_shm_ringbuf_journal_reader_tell(
+	muggle_shm_ringbuf_journal_reader_t *reader, uint32_t *seq, uint32_t *pos)
+{
+	*seq = reader->seq;
+	*pos = reader->r_pos;
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+ *  @file         shm_ringbuf_journal.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec file-backed journal of shared memory ring buffer
+ *
+ *  journal is a sequence of segment files named <prefix>.<seq>, every
+ *  segment is a file-backed muggle_shm_ringbuf_t with the same record
+ *  format; instead of wrap around, writer seal current segment and roll
+ *  to the next one, so all records persist and can be replayed from any
+ *  position
+ *
+ *  durability: published records survive crash of writer process as soon
+ *  as muggle_shm_ringbuf_journal_w_move return, they are in page cache of
+ *  OS; records survive OS crash or power loss only after segment is flushed
+ *  to storage device, writer flush a segment when it is sealed and when
+ *  journal is closed, call muggle_shm_ringbuf_journal_sync to flush current
+ *  segment at any other checkpoint
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SHM_RINGBUF_JOURNAL_H_
+#define MUGGLE_C_SHM_RINGBUF_JOURNAL_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/sync/shm_ring_buffer.h"
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief journal writer
+ */
+typedef struct {
+	char prefix[MUGGLE_MAX_PATH]; //!< path prefix of segment files
+	uint32_t seq; //!< sequence number of current segment
+	uint32_t nbytes; //!< data bytes of each segment
+	muggle_shm_t shm; //!< current segment mapping
+	muggle_shm_ringbuf_t *shm_rbuf; //!< current segment
+} muggle_shm_ringbuf_journal_t;
+
+/**
+ * @brief journal reader
+ */
+typedef struct {
+	char prefix[MUGGLE_MAX_PATH]; //!< path prefix of segment files
+	uint32_t seq; //!< sequence number of current segment
+	uint32_t r_pos; //!< read position in current segment, in cachelines
+	muggle_shm_t shm; //!< current segment mapping
+	muggle_shm_ringbuf_t *shm_rbuf; //!< current segment
+	muggle_shm_ringbuf_data_hdr_t *cached_r_hdr; //!< current read hdr
+} muggle_shm_ringbuf_journal_reader_t;
+
+/**
+ * @brief open journal writer
+ *
+ * @param journal  pointer to journal writer
+ * @param prefix   path prefix of segment files
+ * @param nbytes   expected data bytes of each segment
+ *
+ * @return
+ *   - on success, return 0
+ *   - otherwise return MUGGLE_ERR_*
+ *
+ * @NOTE
+ *   segments must be contiguous from 0, if segments already exists, writer
+ *   resume at the end of the last segment, messages allocated but not
+ *   moved before process exit are discarded
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_ringbuf_journal_open(muggle_shm_ringbuf_journal_t *journal,
+									const char *prefix, uint32_t nbytes);
+
+/**
+ * @brief close journal writer, flush current segment, segment files are kept
+ *
+ * @param journal  pointer to journal writer
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_journal_close(muggle_shm_ringbuf_journal_t *journal);
+
+/**
+ * @brief flush current segment to storage device
+ *
+ * @param journal  pointer to journal writer
+ *
+ * @return
+ *   - on success, return 0
+ *   - otherwise return MUGGLE_ERR_*
+ *
+ * @NOTE
+ *   block until all published records of current segment are durable,
+ *   sealed segments are already flushed; this is a slow system call, don't
+ *   call it on every message
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_ringbuf_journal_sync(muggle_shm_ringbuf_journal_t *journal);
+
+/**
+ * @brief journal writer allocate bytes
+ *
+ * @param journal  pointer to journal writer
+ * @param n_bytes  number of bytes
+ *
+ * @return
+ *   - on success, return pointer to data
+ *   - on failed, return NULL, message is larger than segment or failed
+ *     create next segment
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_journal_w_alloc_bytes(
+	muggle_shm_ringbuf_journal_t *journal, uint32_t n_bytes);
+
+/**
+ * @brief journal writer move
+ *
+ * @param journal  pointer to journal writer
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_journal_w_move(muggle_shm_ringbuf_journal_t *journal);
+
+/**
+ * @brief open journal reader
+ *
+ * @param reader  pointer to journal reader
+ * @param prefix  path prefix of segment files
+ * @param seq     sequence number of segment
+ * @param pos     start position in segment, in cachelines, 0 or position
+ *                return from muggle_shm_ringbuf_journal_reader_tell
+ *
+ * @return
+ *   - on success, return 0
+ *   - otherwise return MUGGLE_ERR_*
+ */
+MUGGLE_C_EXPORT
+int muggle_shm_ringbuf_journal_reader_open(
+	muggle_shm_ringbuf_journal_reader_t *reader, const char *prefix,
+	uint32_t seq, uint32_t pos);
+
+/**
+ * @brief close journal reader
+ *
+ * @param reader  pointer to journal reader
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_journal_reader_close(
+	muggle_shm_ringbuf_journal_reader_t *reader);
+
+/**
+ * @brief journal reader fetch data
+ *
+ * @param reader   pointer to journal reader
+ * @param n_bytes  return number of bytes of data, could be NULL
+ *
+ * @return
+ *   - on success, return data
+ *   - there has no more data, return NULL
+ *
+ * @NOTE
+ *   reader step into the next segment automatically when current segment
+ *   is sealed; reader position is private, it never block journal writer
+ */
+MUGGLE_C_EXPORT
+void *muggle_shm_ringbuf_journal_r_fetch(
+	muggle_shm_ringbuf_journal_reader_t *reader, uint32_t *n_bytes);
+
+/**
+ * @brief journal reader move
+ *
+ * @param reader  pointer to journal reader
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_journal_r_move(
+	muggle_shm_ringbuf_journal_reader_t *reader);
+
+/**
+ * @brief get journal reader position, used as checkpoint
+ *
+ * @param reader  pointer to journal reader
+ * @param seq     return sequence number of segment
+ * @param pos     return position in segment
+ */
+MUGGLE_C_EXPORT
+void muggle_shm_ringbuf_journal_reader_tell(
+	muggle_shm_ringbuf_journal_reader_t *reader, uint32_t *seq,
+	uint32_t *pos);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_SHM_RINGBUF_JOURNAL_H_
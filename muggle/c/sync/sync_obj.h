@@ -41,6 +41,9 @@ EXTERN_C_BEGIN
 	//     use atomic rel-acq for futex
 	typedef uint32_t muggle_sync_t;
 
+	// futex without FUTEX_PRIVATE_FLAG can be used across processes
+	#define MUGGLE_C_HAVE_SHARED_SYNC_OBJ 1
+
 #elif MUGGLE_PLATFORM_WINDOWS
 
 	#include <windows.h>
@@ -68,8 +71,12 @@ EXTERN_C_BEGIN
 	//       intrinsics with _nf suffix)
 	typedef LONG muggle_sync_t;
 
+	// WaitOnAddress only works for threads in the same process
+	#define MUGGLE_C_HAVE_SHARED_SYNC_OBJ 0
+
 #else
 	#define MUGGLE_C_HAVE_SYNC_OBJ 0
+	#define MUGGLE_C_HAVE_SHARED_SYNC_OBJ 0
 	typedef uint32_t muggle_sync_t;
 #endif
 
@@ -118,6 +125,53 @@ int muggle_sync_wake_all(muggle_sync_t *addr);
 
 #endif
 
+#if MUGGLE_C_HAVE_SHARED_SYNC_OBJ
+
+/**
+ * @brief Waits for *addr != val, addr could be placed in shared memory
+ *
+ * @param addr     address on whitch to wait
+ * @param val      compare value
+ * @param timeout
+ *     wait before the operation times out
+ *     if NULL, the thread waits indefinitely until *addr changed
+ *
+ * @return 
+ *     -1: failed
+ *     otherwise: ok
+ */
+MUGGLE_C_EXPORT
+int muggle_sync_wait_shared(
+	muggle_sync_t *addr, muggle_sync_t val, const struct timespec *timeout);
+
+/**
+ * @brief wake one thread or process that is waiting for the shared
+ *        muggle_sync_t address to change
+ *
+ * @param addr  address on whitch to wait
+ *
+ * @return 
+ *     -1: failed
+ *     otherwise: ok
+ */
+MUGGLE_C_EXPORT
+int muggle_sync_wake_one_shared(muggle_sync_t *addr);
+
+/**
+ * @brief wake all threads and processes that is waiting for the shared
+ *        muggle_sync_t address to change
+ *
+ * @param addr  address on whitch to wait
+ *
+ * @return 
+ *     -1: failed
+ *     otherwise: ok
+ */
+MUGGLE_C_EXPORT
+int muggle_sync_wake_all_shared(muggle_sync_t *addr);
+
+#endif
+
 EXTERN_C_END
 
 #endif // !MUGGLE_SYNC_OBJ_H_
@@ -41,4 +41,19 @@ int muggle_sync_wake_all(muggle_sync_t *addr)
 		addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, NULL, NULL, 0);
 }
 
+int muggle_sync_wait_shared(muggle_sync_t *addr, muggle_sync_t val, const struct timespec *timeout)
+{
+	return muggle_futex(addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+int muggle_sync_wake_one_shared(muggle_sync_t *addr)
+{
+	return muggle_futex(addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+int muggle_sync_wake_all_shared(muggle_sync_t *addr)
+{
+	return muggle_futex(addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
 #endif
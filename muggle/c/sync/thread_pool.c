@@ -0,0 +1,636 @@
+#include "thread_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/sleep.h"
+#include "muggle/c/os/cpu.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+// task group pending high bit, there are waiters parked on group
+#define MUGGLE_THREAD_POOL_GROUP_WAITER 0x80000000u
+
+// number of failed rounds before idle worker park
+#define MUGGLE_THREAD_POOL_IDLE_SPIN 64
+
+// group waiter park interval, new tasks of the group may be put into
+// injection queue while all workers are waiting
+#define MUGGLE_THREAD_POOL_GROUP_WAIT_MS 1
+
+#define MUGGLE_THREAD_POOL_POS_DIFF(a, b) ((int32_t)((a) - (b)))
+
+static muggle_thread_local muggle_thread_pool_worker_t *s_thread_pool_worker = NULL;
+static muggle_thread_local uint32_t s_thread_pool_rand = 0;
+
+/***************** task group *****************/
+
+static void muggle_thread_pool_group_add(muggle_thread_pool_group_t *group)
+{
+	if (group)
+	{
+		muggle_atomic_fetch_add(&group->pending, 1, muggle_memory_order_relaxed);
+	}
+}
+
+static void muggle_thread_pool_group_done(muggle_thread_pool_group_t *group)
+{
+	if (group == NULL)
+	{
+		return;
+	}
+
+	muggle_sync_t v = muggle_atomic_fetch_sub(
+		&group->pending, 1, muggle_memory_order_acq_rel);
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	// NOTE: don't touch group except wake address after the last task
+	// completed, waiter may already return and release group
+	if (v == (MUGGLE_THREAD_POOL_GROUP_WAITER | 1))
+	{
+		muggle_sync_wake_all(&group->pending);
+	}
+#else
+	MUGGLE_UNUSED(v);
+#endif
+}
+
+/***************** Chase-Lev deque *****************/
+
+static int muggle_thread_pool_deque_init(
+	muggle_thread_pool_deque_t *deque, muggle_sync_t capacity)
+{
+	deque->tasks = (muggle_thread_pool_task_t*)malloc(
+		sizeof(muggle_thread_pool_task_t) * capacity);
+	if (deque->tasks == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	deque->mask = capacity - 1;
+	deque->top = 0;
+	deque->bottom = 0;
+
+	return 0;
+}
+
+static bool muggle_thread_pool_deque_push(
+	muggle_thread_pool_deque_t *deque, const muggle_thread_pool_task_t *task)
+{
+	muggle_sync_t b =
+		muggle_atomic_load(&deque->bottom, muggle_memory_order_relaxed);
+	muggle_sync_t t =
+		muggle_atomic_load(&deque->top, muggle_memory_order_acquire);
+	if (MUGGLE_THREAD_POOL_POS_DIFF(b, t) > (int32_t)deque->mask)
+	{
+		return false;
+	}
+
+	deque->tasks[b & deque->mask] = *task;
+	muggle_atomic_store(&deque->bottom, b + 1, muggle_memory_order_release);
+
+	return true;
+}
+
+static bool muggle_thread_pool_deque_pop(
+	muggle_thread_pool_deque_t *deque, muggle_thread_pool_task_t *task)
+{
+	muggle_sync_t b =
+		muggle_atomic_load(&deque->bottom, muggle_memory_order_relaxed) - 1;
+	muggle_atomic_store(&deque->bottom, b, muggle_memory_order_relaxed);
+
+	// make bottom visible to thieves before read top
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	muggle_sync_t t =
+		muggle_atomic_load(&deque->top, muggle_memory_order_relaxed);
+	if (MUGGLE_THREAD_POOL_POS_DIFF(b, t) < 0)
+	{
+		// empty
+		muggle_atomic_store(&deque->bottom, b + 1, muggle_memory_order_relaxed);
+		return false;
+	}
+
+	*task = deque->tasks[b & deque->mask];
+	if (b != t)
+	{
+		return true;
+	}
+
+	// the last task, race with thieves
+	bool ret = muggle_atomic_cmp_exch_strong(
+		&deque->top, &t, t + 1, muggle_memory_order_seq_cst);
+	muggle_atomic_store(&deque->bottom, b + 1, muggle_memory_order_relaxed);
+
+	return ret;
+}
+
+static bool muggle_thread_pool_deque_steal(
+	muggle_thread_pool_deque_t *deque, muggle_thread_pool_task_t *task)
+{
+	muggle_sync_t t =
+		muggle_atomic_load(&deque->top, muggle_memory_order_acquire);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	muggle_sync_t b =
+		muggle_atomic_load(&deque->bottom, muggle_memory_order_acquire);
+	if (MUGGLE_THREAD_POOL_POS_DIFF(b, t) <= 0)
+	{
+		return false;
+	}
+
+	// NOTE: slot t can't be overwritten by owner before top moved, if copy
+	// is torn, CAS failed and the copy is discarded
+	*task = deque->tasks[t & deque->mask];
+	return muggle_atomic_cmp_exch_strong(
+		&deque->top, &t, t + 1, muggle_memory_order_seq_cst);
+}
+
+static bool muggle_thread_pool_deque_empty(muggle_thread_pool_deque_t *deque)
+{
+	muggle_sync_t t =
+		muggle_atomic_load(&deque->top, muggle_memory_order_relaxed);
+	muggle_sync_t b =
+		muggle_atomic_load(&deque->bottom, muggle_memory_order_relaxed);
+	return MUGGLE_THREAD_POOL_POS_DIFF(b, t) <= 0;
+}
+
+/***************** injection queue *****************/
+
+static bool muggle_thread_pool_inj_put(
+	muggle_thread_pool_t *pool, const muggle_thread_pool_task_t *task)
+{
+	bool ret = false;
+
+	muggle_spinlock_lock(&pool->inj_lock);
+	if (pool->inj_tail - pool->inj_head <= pool->inj_mask)
+	{
+		pool->inj_tasks[pool->inj_tail & pool->inj_mask] = *task;
+		muggle_atomic_store(
+			&pool->inj_tail, pool->inj_tail + 1, muggle_memory_order_relaxed);
+		ret = true;
+	}
+	muggle_spinlock_unlock(&pool->inj_lock);
+
+	return ret;
+}
+
+static bool muggle_thread_pool_inj_empty(muggle_thread_pool_t *pool)
+{
+	return muggle_atomic_load(&pool->inj_head, muggle_memory_order_relaxed) ==
+		muggle_atomic_load(&pool->inj_tail, muggle_memory_order_relaxed);
+}
+
+static bool muggle_thread_pool_inj_take(
+	muggle_thread_pool_t *pool, muggle_thread_pool_task_t *task)
+{
+	if (muggle_thread_pool_inj_empty(pool))
+	{
+		return false;
+	}
+
+	bool ret = false;
+
+	muggle_spinlock_lock(&pool->inj_lock);
+	if (pool->inj_head != pool->inj_tail)
+	{
+		*task = pool->inj_tasks[pool->inj_head & pool->inj_mask];
+		muggle_atomic_store(
+			&pool->inj_head, pool->inj_head + 1, muggle_memory_order_relaxed);
+		ret = true;
+	}
+	muggle_spinlock_unlock(&pool->inj_lock);
+
+	return ret;
+}
+
+/***************** schedule *****************/
+
+static muggle_thread_pool_worker_t* muggle_thread_pool_current_worker(
+	muggle_thread_pool_t *pool)
+{
+	muggle_thread_pool_worker_t *worker = s_thread_pool_worker;
+	if (worker && worker->pool == pool)
+	{
+		return worker;
+	}
+	return NULL;
+}
+
+static uint32_t muggle_thread_pool_rand(uint32_t *state)
+{
+	// xorshift32
+	uint32_t x = *state;
+	if (x == 0)
+	{
+		x = 0x9E3779B9u;
+	}
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+static bool muggle_thread_pool_has_work(muggle_thread_pool_t *pool)
+{
+	if (!muggle_thread_pool_inj_empty(pool))
+	{
+		return true;
+	}
+	for (uint32_t i = 0; i < pool->n_worker; i++)
+	{
+		if (!muggle_thread_pool_deque_empty(&pool->workers[i].deque))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void muggle_thread_pool_notify(muggle_thread_pool_t *pool)
+{
+	// pair with the fence in muggle_thread_pool_park
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&pool->n_sleepers, muggle_memory_order_relaxed))
+	{
+		muggle_atomic_fetch_add(&pool->futex_seq, 1, muggle_memory_order_release);
+#if MUGGLE_C_HAVE_SYNC_OBJ
+		muggle_sync_wake_one(&pool->futex_seq);
+#endif
+	}
+}
+
+static bool muggle_thread_pool_push(
+	muggle_thread_pool_t *pool, const muggle_thread_pool_task_t *task)
+{
+	muggle_thread_pool_worker_t *worker =
+		muggle_thread_pool_current_worker(pool);
+
+	bool ret = false;
+	if (worker)
+	{
+		ret = muggle_thread_pool_deque_push(&worker->deque, task);
+	}
+	else
+	{
+		ret = muggle_thread_pool_inj_put(pool, task);
+	}
+
+	if (ret)
+	{
+		muggle_thread_pool_notify(pool);
+	}
+
+	return ret;
+}
+
+static void muggle_thread_pool_run_task(
+	muggle_thread_pool_t *pool, muggle_thread_pool_task_t *task)
+{
+	if (task->range_fn)
+	{
+		// lazy binary splitting, push right half and keep left half
+		uint64_t begin = task->begin;
+		uint64_t end = task->end;
+		while (end - begin > task->grain)
+		{
+			uint64_t mid = begin + (end - begin) / 2;
+
+			muggle_thread_pool_task_t sub = *task;
+			sub.begin = mid;
+			sub.end = end;
+
+			muggle_thread_pool_group_add(task->group);
+			if (!muggle_thread_pool_push(pool, &sub))
+			{
+				// queue is full, run the rest in current thread
+				muggle_thread_pool_group_done(task->group);
+				break;
+			}
+			end = mid;
+		}
+
+		task->range_fn(task->args, begin, end);
+	}
+	else
+	{
+		task->fn(task->args);
+	}
+
+	muggle_thread_pool_group_done(task->group);
+}
+
+static bool muggle_thread_pool_run_one(
+	muggle_thread_pool_t *pool, muggle_thread_pool_worker_t *worker)
+{
+	muggle_thread_pool_task_t task;
+
+	if (worker && muggle_thread_pool_deque_pop(&worker->deque, &task))
+	{
+		muggle_thread_pool_run_task(pool, &task);
+		return true;
+	}
+
+	if (muggle_thread_pool_inj_take(pool, &task))
+	{
+		muggle_thread_pool_run_task(pool, &task);
+		return true;
+	}
+
+	// randomized stealing
+	uint32_t *rand_state = worker ? &worker->rand : &s_thread_pool_rand;
+	uint32_t start = muggle_thread_pool_rand(rand_state) % pool->n_worker;
+	for (uint32_t i = 0; i < pool->n_worker; i++)
+	{
+		muggle_thread_pool_worker_t *victim =
+			&pool->workers[(start + i) % pool->n_worker];
+		if (victim == worker)
+		{
+			continue;
+		}
+
+		if (muggle_thread_pool_deque_steal(&victim->deque, &task))
+		{
+			muggle_thread_pool_run_task(pool, &task);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void muggle_thread_pool_park(muggle_thread_pool_t *pool)
+{
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	muggle_sync_t seq =
+		muggle_atomic_load(&pool->futex_seq, muggle_memory_order_acquire);
+
+	// NOTE: sleeper increase n_sleepers before check queues, submitter push
+	// task before check n_sleepers, so at least one of them observe the
+	// other (pair with the fence in muggle_thread_pool_notify)
+	muggle_atomic_fetch_add(&pool->n_sleepers, 1, muggle_memory_order_relaxed);
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	if (!muggle_thread_pool_has_work(pool) &&
+		!muggle_atomic_load(&pool->stop, muggle_memory_order_acquire))
+	{
+		muggle_sync_wait(&pool->futex_seq, seq, NULL);
+	}
+
+	muggle_atomic_fetch_sub(&pool->n_sleepers, 1, muggle_memory_order_relaxed);
+#else
+	muggle_msleep(1);
+#endif
+}
+
+static muggle_thread_ret_t muggle_thread_pool_worker_routine(void *p_args)
+{
+	muggle_thread_pool_worker_t *worker = (muggle_thread_pool_worker_t*)p_args;
+	muggle_thread_pool_t *pool = worker->pool;
+
+	s_thread_pool_worker = worker;
+
+	if (pool->flags & MUGGLE_THREAD_POOL_FLAG_AFFINITY)
+	{
+		int hc = muggle_thread_hardware_concurrency();
+		if (hc > 0)
+		{
+			muggle_cpu_mask_t mask;
+			muggle_cpu_mask_zero(&mask);
+			muggle_cpu_mask_set(&mask, (int)(worker->idx % (uint32_t)hc));
+			muggle_cpu_set_thread_affinity(muggle_get_current_tid_handle(), &mask);
+		}
+	}
+
+	uint32_t idle = 0;
+	while (!muggle_atomic_load(&pool->stop, muggle_memory_order_acquire))
+	{
+		if (muggle_thread_pool_run_one(pool, worker))
+		{
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < MUGGLE_THREAD_POOL_IDLE_SPIN)
+		{
+			muggle_sync_cpu_relax();
+			continue;
+		}
+
+		idle = 0;
+		muggle_thread_pool_park(pool);
+	}
+
+	s_thread_pool_worker = NULL;
+
+	return 0;
+}
+
+/***************** thread pool functions *****************/
+
+static void muggle_thread_pool_stop(muggle_thread_pool_t *pool, uint32_t n_started)
+{
+	muggle_atomic_store(&pool->stop, 1, muggle_memory_order_release);
+	muggle_atomic_fetch_add(&pool->futex_seq, 1, muggle_memory_order_release);
+#if MUGGLE_C_HAVE_SYNC_OBJ
+	muggle_sync_wake_all(&pool->futex_seq);
+#endif
+
+	for (uint32_t i = 0; i < n_started; i++)
+	{
+		muggle_thread_join(&pool->workers[i].thread);
+	}
+}
+
+static void muggle_thread_pool_free(muggle_thread_pool_t *pool)
+{
+	if (pool->workers)
+	{
+		for (uint32_t i = 0; i < pool->n_worker; i++)
+		{
+			if (pool->workers[i].deque.tasks)
+			{
+				free(pool->workers[i].deque.tasks);
+			}
+		}
+		free(pool->workers);
+		pool->workers = NULL;
+	}
+
+	if (pool->inj_tasks)
+	{
+		free(pool->inj_tasks);
+		pool->inj_tasks = NULL;
+	}
+}
+
+int muggle_thread_pool_init(
+	muggle_thread_pool_t *pool, uint32_t n_worker, uint32_t capacity,
+	int flags)
+{
+	memset(pool, 0, sizeof(*pool));
+
+	if (n_worker == 0)
+	{
+		int hc = muggle_thread_hardware_concurrency();
+		n_worker = hc > 0 ? (uint32_t)hc : 1;
+	}
+
+	if (capacity < 2)
+	{
+		capacity = 2;
+	}
+	capacity = (uint32_t)muggle_next_pow_of_2(capacity);
+	if (capacity == 0 || capacity > 0x40000000u)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	pool->n_worker = n_worker;
+	pool->flags = flags;
+
+	muggle_spinlock_init(&pool->inj_lock);
+	pool->inj_tasks = (muggle_thread_pool_task_t*)malloc(
+		sizeof(muggle_thread_pool_task_t) * capacity);
+	if (pool->inj_tasks == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	pool->inj_mask = capacity - 1;
+
+	pool->workers = (muggle_thread_pool_worker_t*)calloc(
+		n_worker, sizeof(muggle_thread_pool_worker_t));
+	if (pool->workers == NULL)
+	{
+		muggle_thread_pool_free(pool);
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	for (uint32_t i = 0; i < n_worker; i++)
+	{
+		muggle_thread_pool_worker_t *worker = &pool->workers[i];
+		if (muggle_thread_pool_deque_init(&worker->deque, capacity) != 0)
+		{
+			muggle_thread_pool_free(pool);
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		worker->pool = pool;
+		worker->idx = i;
+		worker->rand = i + 1;
+	}
+
+	for (uint32_t i = 0; i < n_worker; i++)
+	{
+		muggle_thread_pool_worker_t *worker = &pool->workers[i];
+		if (muggle_thread_create(
+				&worker->thread, muggle_thread_pool_worker_routine, worker) != 0)
+		{
+			muggle_thread_pool_stop(pool, i);
+			muggle_thread_pool_free(pool);
+			return MUGGLE_ERR_SYS_CALL;
+		}
+	}
+
+	return 0;
+}
+
+void muggle_thread_pool_destroy(muggle_thread_pool_t *pool)
+{
+	if (pool->workers == NULL)
+	{
+		return;
+	}
+
+	muggle_thread_pool_stop(pool, pool->n_worker);
+	muggle_thread_pool_free(pool);
+}
+
+void muggle_thread_pool_group_init(muggle_thread_pool_group_t *group)
+{
+	muggle_atomic_store(&group->pending, 0, muggle_memory_order_release);
+}
+
+void muggle_thread_pool_submit(
+	muggle_thread_pool_t *pool, muggle_thread_pool_group_t *group,
+	muggle_thread_pool_fn fn, void *args)
+{
+	muggle_thread_pool_task_t task;
+	memset(&task, 0, sizeof(task));
+	task.fn = fn;
+	task.args = args;
+	task.group = group;
+
+	muggle_thread_pool_group_add(group);
+	if (!muggle_thread_pool_push(pool, &task))
+	{
+		muggle_thread_pool_run_task(pool, &task);
+	}
+}
+
+void muggle_thread_pool_group_wait(
+	muggle_thread_pool_t *pool, muggle_thread_pool_group_t *group)
+{
+	muggle_thread_pool_worker_t *worker =
+		muggle_thread_pool_current_worker(pool);
+
+	while (1)
+	{
+		muggle_sync_t v =
+			muggle_atomic_load(&group->pending, muggle_memory_order_acquire);
+		if ((v & ~MUGGLE_THREAD_POOL_GROUP_WAITER) == 0)
+		{
+			break;
+		}
+
+		// help run tasks
+		if (muggle_thread_pool_run_one(pool, worker))
+		{
+			continue;
+		}
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+		if (!(v & MUGGLE_THREAD_POOL_GROUP_WAITER))
+		{
+			if (!muggle_atomic_cmp_exch_strong(
+					&group->pending, &v, v | MUGGLE_THREAD_POOL_GROUP_WAITER,
+					muggle_memory_order_acq_rel))
+			{
+				continue;
+			}
+			v |= MUGGLE_THREAD_POOL_GROUP_WAITER;
+		}
+
+		struct timespec timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_nsec = MUGGLE_THREAD_POOL_GROUP_WAIT_MS * 1000000;
+		muggle_sync_wait(&group->pending, v, &timeout);
+#else
+		muggle_thread_yield();
+#endif
+	}
+}
+
+void muggle_thread_pool_parallel_for(
+	muggle_thread_pool_t *pool, uint64_t begin, uint64_t end, uint64_t grain,
+	muggle_thread_pool_range_fn fn, void *args)
+{
+	if (end <= begin)
+	{
+		return;
+	}
+
+	muggle_thread_pool_group_t group;
+	muggle_thread_pool_group_init(&group);
+
+	muggle_thread_pool_task_t task;
+	memset(&task, 0, sizeof(task));
+	task.range_fn = fn;
+	task.args = args;
+	task.group = &group;
+	task.begin = begin;
+	task.end = end;
+	task.grain = grain ? grain : 1;
+
+	// caller run the left most range, the rest are split into queues
+	muggle_thread_pool_group_add(&group);
+	muggle_thread_pool_run_task(pool, &task);
+
+	muggle_thread_pool_group_wait(pool, &group);
+}
@@ -0,0 +1,234 @@
+/******************************************************************************
+ *  @file         thread_pool.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec work-stealing thread pool
+ *
+ *  every worker owns a Chase-Lev deque, worker push and pop tasks at the
+ *  bottom of its own deque, idle workers steal from the top of random
+ *  victims' deques; tasks submitted from outside of pool are put into a
+ *  shared injection queue; idle workers park on sync object
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_THREAD_POOL_H_
+#define MUGGLE_C_THREAD_POOL_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/sync_obj.h"
+#include "muggle/c/sync/spinlock.h"
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief thread pool flags
+ */
+enum
+{
+	MUGGLE_THREAD_POOL_FLAG_AFFINITY = 0x01, //!< pin worker i to cpu
+											 //   (i % hardware concurrency)
+};
+
+/**
+ * @brief task function
+ *
+ * @param args  user arguments
+ */
+typedef void (*muggle_thread_pool_fn)(void *args);
+
+/**
+ * @brief range task function of parallel for
+ *
+ * @param args   user arguments
+ * @param begin  begin of range
+ * @param end    end of range (not included)
+ */
+typedef void (*muggle_thread_pool_range_fn)(
+	void *args, uint64_t begin, uint64_t end);
+
+/**
+ * @brief task group, wait a set of tasks completed
+ */
+typedef struct muggle_thread_pool_group
+{
+	muggle_sync_t pending; //!< number of pending tasks and waiter bit
+} muggle_thread_pool_group_t;
+
+/**
+ * @brief thread pool task
+ */
+typedef struct muggle_thread_pool_task
+{
+	muggle_thread_pool_fn       fn;       //!< task function
+	muggle_thread_pool_range_fn range_fn; //!< range task function
+	void                       *args;     //!< user arguments
+	muggle_thread_pool_group_t *group;    //!< task group, could be NULL
+	uint64_t                    begin;    //!< begin of range
+	uint64_t                    end;      //!< end of range
+	uint64_t                    grain;    //!< grain size of range
+} muggle_thread_pool_task_t;
+
+/**
+ * @brief Chase-Lev work-stealing deque
+ */
+typedef struct muggle_thread_pool_deque
+{
+	union {
+		muggle_sync_t top; //!< steal side
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	union {
+		muggle_sync_t bottom; //!< owner side
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	};
+	muggle_thread_pool_task_t *tasks; //!< task array
+	muggle_sync_t              mask;  //!< capacity - 1
+} muggle_thread_pool_deque_t;
+
+struct muggle_thread_pool;
+
+/**
+ * @brief thread pool worker
+ */
+typedef struct muggle_thread_pool_worker
+{
+	muggle_thread_pool_deque_t deque;   //!< worker's deque
+	struct muggle_thread_pool *pool;    //!< pool
+	muggle_thread_t            thread;  //!< worker thread
+	uint32_t                   idx;     //!< worker index
+	uint32_t                   rand;    //!< random state of victim select
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(0);
+} muggle_thread_pool_worker_t;
+
+/**
+ * @brief thread pool
+ */
+typedef struct muggle_thread_pool
+{
+	muggle_thread_pool_worker_t *workers;  //!< workers
+	uint32_t                     n_worker; //!< number of workers
+	int                          flags;    //!< MUGGLE_THREAD_POOL_FLAG_*
+
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(0);
+
+	// injection queue, tasks submitted outside of pool
+	union {
+		struct {
+			muggle_spinlock_t          inj_lock;  //!< injection queue lock
+			muggle_thread_pool_task_t *inj_tasks; //!< injection tasks
+			muggle_sync_t              inj_mask;  //!< capacity - 1
+			muggle_sync_t              inj_head;  //!< take position
+			muggle_sync_t              inj_tail;  //!< put position
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(1);
+
+	// idle workers park
+	union {
+		struct {
+			muggle_sync_t futex_seq;  //!< park sequence
+			muggle_sync_t n_sleepers; //!< number of parked workers
+			muggle_sync_t stop;       //!< stop flag
+		};
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	};
+	MUGGLE_STRUCT_CACHE_LINE_X2_PADDING(2);
+} muggle_thread_pool_t;
+
+/**
+ * @brief initialize thread pool and start workers
+ *
+ * @param pool      pointer to thread pool
+ * @param n_worker  number of workers, 0 means hardware concurrency
+ * @param capacity  capacity of every worker's deque and injection queue
+ * @param flags     bit or of MUGGLE_THREAD_POOL_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_thread_pool_init(
+	muggle_thread_pool_t *pool, uint32_t n_worker, uint32_t capacity,
+	int flags);
+
+/**
+ * @brief stop workers and destroy thread pool
+ *
+ * @param pool  pointer to thread pool
+ *
+ * @NOTE
+ *     tasks not started yet are discarded, wait task groups before destroy
+ */
+MUGGLE_C_EXPORT
+void muggle_thread_pool_destroy(muggle_thread_pool_t *pool);
+
+/**
+ * @brief initialize task group
+ *
+ * @param group  pointer to task group
+ */
+MUGGLE_C_EXPORT
+void muggle_thread_pool_group_init(muggle_thread_pool_group_t *group);
+
+/**
+ * @brief submit task
+ *
+ * @param pool   pointer to thread pool
+ * @param group  task group, could be NULL
+ * @param fn     task function
+ * @param args   user arguments
+ *
+ * @NOTE
+ *     - when called in worker, task is pushed into worker's own deque,
+ *       otherwise pushed into injection queue
+ *     - if the queue is full, task run in caller thread immediately
+ */
+MUGGLE_C_EXPORT
+void muggle_thread_pool_submit(
+	muggle_thread_pool_t *pool, muggle_thread_pool_group_t *group,
+	muggle_thread_pool_fn fn, void *args);
+
+/**
+ * @brief wait all tasks in group completed
+ *
+ * @param pool   pointer to thread pool
+ * @param group  task group
+ *
+ * @NOTE
+ *     caller help run pending tasks while waiting, so it's allowed to wait
+ *     group in worker's task
+ */
+MUGGLE_C_EXPORT
+void muggle_thread_pool_group_wait(
+	muggle_thread_pool_t *pool, muggle_thread_pool_group_t *group);
+
+/**
+ * @brief parallel for, split [begin, end) and run fn in workers, return
+ * after all range completed
+ *
+ * @param pool   pointer to thread pool
+ * @param begin  begin of range
+ * @param end    end of range (not included)
+ * @param grain  max size of range in one fn call, 0 means 1
+ * @param fn     range function
+ * @param args   user arguments
+ *
+ * @NOTE
+ *     range is split lazily, every task push its right half back to the
+ *     deque until it's not larger than grain, so idle workers steal large
+ *     chunks
+ */
+MUGGLE_C_EXPORT
+void muggle_thread_pool_parallel_for(
+	muggle_thread_pool_t *pool, uint64_t begin, uint64_t end, uint64_t grain,
+	muggle_thread_pool_range_fn fn, void *args);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_THREAD_POOL_H_
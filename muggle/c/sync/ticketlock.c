@@ -0,0 +1,59 @@
+#include "ticketlock.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/internal/sync_backoff.h"
+
+// number of cpu relax per waiter ahead
+#define MUGGLE_TICKETLOCK_RELAX_PER_WAITER 32
+
+// after spin rounds, yield thread, lock owner may be preempted
+#define MUGGLE_TICKETLOCK_SPIN_ROUND 1024
+
+void muggle_ticketlock_init(muggle_ticketlock_t *lock)
+{
+	lock->next = 0;
+	muggle_atomic_store(&lock->owner, 0, muggle_memory_order_release);
+}
+
+void muggle_ticketlock_lock(muggle_ticketlock_t *lock)
+{
+	muggle_atomic_int ticket =
+		muggle_atomic_fetch_add(&lock->next, 1, muggle_memory_order_relaxed);
+
+	uint32_t round = 0;
+	while (1)
+	{
+		muggle_atomic_int owner =
+			muggle_atomic_load(&lock->owner, muggle_memory_order_acquire);
+		if (owner == ticket)
+		{
+			break;
+		}
+
+		// proportional backoff, waiters ahead need time to release lock
+		uint32_t n_ahead = (uint32_t)(ticket - owner);
+		muggle_sync_backoff_n(n_ahead * MUGGLE_TICKETLOCK_RELAX_PER_WAITER);
+
+		if (++round >= MUGGLE_TICKETLOCK_SPIN_ROUND)
+		{
+			round = 0;
+			muggle_thread_yield();
+		}
+	}
+}
+
+bool muggle_ticketlock_trylock(muggle_ticketlock_t *lock)
+{
+	muggle_atomic_int owner =
+		muggle_atomic_load(&lock->owner, muggle_memory_order_relaxed);
+	muggle_atomic_int ticket = owner;
+	return muggle_atomic_cmp_exch_strong(
+		&lock->next, &ticket, owner + 1, muggle_memory_order_acquire);
+}
+
+void muggle_ticketlock_unlock(muggle_ticketlock_t *lock)
+{
+	// only lock owner modify owner field
+	muggle_atomic_int owner =
+		muggle_atomic_load(&lock->owner, muggle_memory_order_relaxed);
+	muggle_atomic_store(&lock->owner, owner + 1, muggle_memory_order_release);
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+ *  @file         ticketlock.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec ticket lock
+ *
+ *  fair FIFO spin lock, every locker take a ticket and spin until the
+ *  owner reach its ticket, waiting time proportional backoff with cpu relax
+ *  hint
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_TICKETLOCK_H_
+#define MUGGLE_C_TICKETLOCK_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdbool.h>
+
+EXTERN_C_BEGIN
+
+typedef struct muggle_ticketlock
+{
+	muggle_atomic_int next;  //!< next ticket
+	muggle_atomic_int owner; //!< ticket of lock owner
+} muggle_ticketlock_t;
+
+/**
+ * @brief initialize ticket lock
+ *
+ * @param lock  ticket lock
+ */
+MUGGLE_C_EXPORT
+void muggle_ticketlock_init(muggle_ticketlock_t *lock);
+
+/**
+ * @brief lock ticket lock
+ *
+ * @param lock  ticket lock
+ */
+MUGGLE_C_EXPORT
+void muggle_ticketlock_lock(muggle_ticketlock_t *lock);
+
+/**
+ * @brief try lock ticket lock
+ *
+ * @param lock  ticket lock
+ *
+ * @return true if lock success
+ */
+MUGGLE_C_EXPORT
+bool muggle_ticketlock_trylock(muggle_ticketlock_t *lock);
+
+/**
+ * @brief unlock ticket lock
+ *
+ * @param lock  ticket lock
+ */
+MUGGLE_C_EXPORT
+void muggle_ticketlock_unlock(muggle_ticketlock_t *lock);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_TICKETLOCK_H_
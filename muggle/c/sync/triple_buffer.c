@@ -0,0 +1,104 @@
+#include "triple_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+
+// middle = index | MUGGLE_TRIPLE_BUFFER_NEW
+#define MUGGLE_TRIPLE_BUFFER_IDX_MASK 0x03
+#define MUGGLE_TRIPLE_BUFFER_NEW 0x04
+
+int muggle_triple_buffer_init(muggle_triple_buffer_t *tbuf, size_t block_size)
+{
+	memset(tbuf, 0, sizeof(*tbuf));
+
+	if (block_size == 0) {
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	// every buffer in it's own cache lines
+	size_t stride =
+		MUGGLE_ROUND_UP_POW_OF_2_MUL(block_size, MUGGLE_CACHE_LINE_SIZE);
+#if MUGGLE_C_HAVE_ALIGNED_ALLOC
+	tbuf->blocks = aligned_alloc(MUGGLE_CACHE_LINE_SIZE, stride * 3);
+#else
+	tbuf->blocks = malloc(stride * 3);
+#endif
+	if (tbuf->blocks == NULL) {
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	memset(tbuf->blocks, 0, stride * 3);
+
+	for (int i = 0; i < 3; i++) {
+		tbuf->bufs[i] = (char *)tbuf->blocks + stride * i;
+	}
+	tbuf->block_size = block_size;
+
+	tbuf->back = 0;
+	tbuf->front = 2;
+	muggle_atomic_store(&tbuf->middle, 1, muggle_memory_order_release);
+
+	return 0;
+}
+
+void muggle_triple_buffer_destroy(muggle_triple_buffer_t *tbuf)
+{
+	if (tbuf->blocks) {
+		free(tbuf->blocks);
+		tbuf->blocks = NULL;
+	}
+}
+
+void *muggle_triple_buffer_w_buf(muggle_triple_buffer_t *tbuf)
+{
+	return tbuf->bufs[tbuf->back];
+}
+
+void muggle_triple_buffer_w_publish(muggle_triple_buffer_t *tbuf)
+{
+	// release back buffer content, the old middle is free for writer
+	muggle_atomic_int old = muggle_atomic_exchange(
+		&tbuf->middle, tbuf->back | MUGGLE_TRIPLE_BUFFER_NEW,
+		muggle_memory_order_acq_rel);
+	tbuf->back = old & MUGGLE_TRIPLE_BUFFER_IDX_MASK;
+}
+
+void muggle_triple_buffer_write(muggle_triple_buffer_t *tbuf, const void *src,
+								size_t n)
+{
+	memcpy(tbuf->bufs[tbuf->back], src, n);
+	muggle_triple_buffer_w_publish(tbuf);
+}
+
+bool muggle_triple_buffer_r_has_new(muggle_triple_buffer_t *tbuf)
+{
+	return (muggle_atomic_load(&tbuf->middle, muggle_memory_order_relaxed) &
+			MUGGLE_TRIPLE_BUFFER_NEW) != 0;
+}
+
+void *muggle_triple_buffer_r_fetch(muggle_triple_buffer_t *tbuf, bool *updated)
+{
+	bool is_new = false;
+	if (muggle_triple_buffer_r_has_new(tbuf)) {
+		// only writer set new flag, so it's still set when exchange
+		muggle_atomic_int old = muggle_atomic_exchange(
+			&tbuf->middle, tbuf->front, muggle_memory_order_acq_rel);
+		tbuf->front = old & MUGGLE_TRIPLE_BUFFER_IDX_MASK;
+		is_new = true;
+	}
+
+	if (updated) {
+		*updated = is_new;
+	}
+
+	return tbuf->bufs[tbuf->front];
+}
+
+bool muggle_triple_buffer_read(muggle_triple_buffer_t *tbuf, void *dst,
+							   size_t n)
+{
+	bool updated = false;
+	void *src = muggle_triple_buffer_r_fetch(tbuf, &updated);
+	memcpy(dst, src, n);
+	return updated;
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ *  @file         triple_buffer.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec wait-free triple buffer
+ *
+ *  triple buffer is for one writer and one reader that only care about the
+ *  latest state; writer owns the back buffer, reader owns the front buffer
+ *  and the middle buffer is exchanged by a single atomic operation, so
+ *  writer always has a free buffer to write and reader always get the most
+ *  recent complete one, neither of them waits for the other
+ *
+ *  unlike muggle_double_buffer_t, stale states are overwritten instead of
+ *  queued
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_TRIPLE_BUFFER_H_
+#define MUGGLE_C_TRIPLE_BUFFER_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+typedef struct {
+	union {
+		muggle_atomic_int middle; //!< middle buffer index and new flag
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	};
+	union {
+		int back; //!< back buffer index, only accessed by writer
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	};
+	union {
+		int front; //!< front buffer index, only accessed by reader
+		MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	};
+	void *bufs[3]; //!< buffers
+	size_t block_size; //!< size of each buffer
+	void *blocks; //!< memory of buffers
+} muggle_triple_buffer_t;
+
+/**
+ * @brief initialize triple buffer
+ *
+ * @param tbuf        pointer to triple buffer
+ * @param block_size  size of each buffer
+ *
+ * @return
+ *   - return 0 on success
+ *   - otherwise return error code in muggle/c/base/err.h
+ *
+ * @NOTE
+ *   all buffers are zero filled
+ */
+MUGGLE_C_EXPORT
+int muggle_triple_buffer_init(muggle_triple_buffer_t *tbuf, size_t block_size);
+
+/**
+ * @brief destroy triple buffer
+ *
+ * @param tbuf  pointer to triple buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_triple_buffer_destroy(muggle_triple_buffer_t *tbuf);
+
+/**
+ * @brief writer get back buffer
+ *
+ * @param tbuf  pointer to triple buffer
+ *
+ * @return back buffer, it's content is the state published 2 times before
+ */
+MUGGLE_C_EXPORT
+void *muggle_triple_buffer_w_buf(muggle_triple_buffer_t *tbuf);
+
+/**
+ * @brief writer publish back buffer, and swap a free buffer to back
+ *
+ * @param tbuf  pointer to triple buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_triple_buffer_w_publish(muggle_triple_buffer_t *tbuf);
+
+/**
+ * @brief writer copy data into back buffer and publish it
+ *
+ * @param tbuf  pointer to triple buffer
+ * @param src   source data
+ * @param n     number of bytes, not larger than block size
+ */
+MUGGLE_C_EXPORT
+void muggle_triple_buffer_write(muggle_triple_buffer_t *tbuf, const void *src,
+								size_t n);
+
+/**
+ * @brief check whether writer published new buffer since last fetch
+ *
+ * @param tbuf  pointer to triple buffer
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_triple_buffer_r_has_new(muggle_triple_buffer_t *tbuf);
+
+/**
+ * @brief reader get the latest published buffer
+ *
+ * @param tbuf     pointer to triple buffer
+ * @param updated  return whether it's a new buffer since last fetch, could
+ *                 be NULL
+ *
+ * @return front buffer, valid until next fetch of reader
+ */
+MUGGLE_C_EXPORT
+void *muggle_triple_buffer_r_fetch(muggle_triple_buffer_t *tbuf, bool *updated);
+
+/**
+ * @brief reader copy the latest published data
+ *
+ * @param tbuf  pointer to triple buffer
+ * @param dst   destination
+ * @param n     number of bytes, not larger than block size
+ *
+ * @return whether the data is new since last read
+ */
+MUGGLE_C_EXPORT
+bool muggle_triple_buffer_read(muggle_triple_buffer_t *tbuf, void *dst,
+							   size_t n);
+
+EXTERN_C_END
+
+#endif // !MUGGLE_C_TRIPLE_BUFFER_H_
@@ -76,6 +76,7 @@ static muggle_thread_ret_t muggle_benchmark_thread_trans_producer(void *p_args)
 
 	uint64_t count = config->rounds * config->record_per_round;
 	uint64_t offset = args->producer_id * count;
+	uint64_t failed_count = 0;
 	for (uint64_t round = 0; round < config->rounds; round++)
 	{
 		for (uint64_t i = 0; i < config->record_per_round; i++)
@@ -87,7 +88,10 @@ static muggle_thread_ret_t muggle_benchmark_thread_trans_producer(void *p_args)
 			muggle_benchmark_record_t *record_write_end = records_write_end + idx;
 
 			fn_record(record_write_beg);
-			fn_write(user_args, data);
+			if (fn_write(user_args, data) != 0)
+			{
+				++failed_count;
+			}
 			fn_record(record_write_end);
 		}
 
@@ -97,8 +101,12 @@ static muggle_thread_ret_t muggle_benchmark_thread_trans_producer(void *p_args)
 		}
 	}
 
-	MUGGLE_LOG_INFO("producer[%d] completed, total write record: %llu",
-		args->producer_id, (unsigned long long)count);
+	// NOTE: message write failed (e.g. channel full) will never be read, so
+	// report it, otherwise the read latency of different queues can't be
+	// compared directly
+	MUGGLE_LOG_INFO("producer[%d] completed, total write record: %llu, failed: %llu",
+		args->producer_id, (unsigned long long)count,
+		(unsigned long long)failed_count);
 
 	return 0;
 }
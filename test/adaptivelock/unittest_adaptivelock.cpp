@@ -0,0 +1,88 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+TEST(adaptivelock, incr)
+{
+	int x = 0;
+
+	muggle_adaptivelock_t lock;
+	muggle_adaptivelock_init(&lock);
+
+	int cnt_thread = 8;
+	int incr_per_thread = 1024;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			for (int i = 0; i < incr_per_thread; i++)
+			{
+				muggle_adaptivelock_lock(&lock);
+				x++;
+				muggle_adaptivelock_unlock(&lock);
+			}
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(x, cnt_thread * incr_per_thread);
+	EXPECT_EQ(lock.n_waiters, 0);
+}
+
+TEST(adaptivelock, long_hold)
+{
+	int x = 0;
+
+	muggle_adaptivelock_t lock;
+	muggle_adaptivelock_init(&lock);
+
+	// sleep in critical section, lockers spin failed and park
+	int cnt_thread = 4;
+	int incr_per_thread = 32;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			for (int i = 0; i < incr_per_thread; i++)
+			{
+				muggle_adaptivelock_lock(&lock);
+				x++;
+				if (i % 4 == 0)
+				{
+					muggle_msleep(1);
+				}
+				muggle_adaptivelock_unlock(&lock);
+			}
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(x, cnt_thread * incr_per_thread);
+	EXPECT_EQ(lock.n_waiters, 0);
+}
+
+TEST(adaptivelock, trylock)
+{
+	muggle_adaptivelock_t lock;
+	muggle_adaptivelock_init(&lock);
+
+	ASSERT_TRUE(muggle_adaptivelock_trylock(&lock));
+	ASSERT_FALSE(muggle_adaptivelock_trylock(&lock));
+	muggle_adaptivelock_unlock(&lock);
+
+	ASSERT_TRUE(muggle_adaptivelock_trylock(&lock));
+	muggle_adaptivelock_unlock(&lock);
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#define CHUNK_SIZE 1024
+
+class TestArenaFixture : public ::testing::Test {
+public:
+	void SetUp()
+	{
+		bool ret = muggle_arena_init(&arena_, CHUNK_SIZE);
+		ASSERT_TRUE(ret);
+	}
+
+	void TearDown()
+	{
+		muggle_arena_destroy(&arena_);
+	}
+
+protected:
+	muggle_arena_t arena_;
+};
+
+static int CountChunks(muggle_arena_chunk_t *chunk)
+{
+	int cnt = 0;
+	for (; chunk; chunk = chunk->prev)
+	{
+		cnt++;
+	}
+	return cnt;
+}
+
+TEST_F(TestArenaFixture, alloc)
+{
+	char *prev = NULL;
+	for (int i = 0; i < 16; i++)
+	{
+		char *p = (char*)muggle_arena_alloc(&arena_, 10);
+		ASSERT_TRUE(p != NULL);
+		ASSERT_EQ((uintptr_t)p % MUGGLE_ARENA_DEFAULT_ALIGN, 0u);
+		memset(p, i, 10);
+		if (prev)
+		{
+			// bump pointer in the same chunk
+			ASSERT_EQ(p - prev, MUGGLE_ARENA_DEFAULT_ALIGN);
+		}
+		prev = p;
+	}
+	ASSERT_EQ(CountChunks(arena_.chunk), 1);
+}
+
+TEST_F(TestArenaFixture, alloc_aligned)
+{
+	muggle_arena_alloc_aligned(&arena_, 1, 1);
+	for (size_t align = 1; align <= 256; align *= 2)
+	{
+		void *p = muggle_arena_alloc_aligned(&arena_, 3, align);
+		ASSERT_TRUE(p != NULL);
+		ASSERT_EQ((uintptr_t)p % align, 0u);
+	}
+	ASSERT_TRUE(muggle_arena_alloc_aligned(&arena_, 8, 3) == NULL);
+	ASSERT_TRUE(muggle_arena_alloc_aligned(&arena_, 8, 0) == NULL);
+}
+
+TEST_F(TestArenaFixture, grow)
+{
+	for (int i = 0; i < 100; i++)
+	{
+		char *p = (char*)muggle_arena_alloc(&arena_, 100);
+		ASSERT_TRUE(p != NULL);
+		memset(p, i, 100);
+	}
+	ASSERT_GT(CountChunks(arena_.chunk), 1);
+
+	// oversize allocation get its own chunk
+	char *big = (char*)muggle_arena_alloc(&arena_, CHUNK_SIZE * 4);
+	ASSERT_TRUE(big != NULL);
+	memset(big, 0, CHUNK_SIZE * 4);
+	ASSERT_GT(arena_.chunk->size, (size_t)CHUNK_SIZE);
+
+	// oversize chunk is freed by reset, regular chunks are kept
+	int n_chunk = CountChunks(arena_.chunk);
+	muggle_arena_reset(&arena_);
+	ASSERT_EQ(CountChunks(arena_.chunk), 1);
+	ASSERT_EQ(CountChunks(arena_.spare), n_chunk - 2);
+
+	// reuse spare chunks
+	for (int i = 0; i < 100; i++)
+	{
+		ASSERT_TRUE(muggle_arena_alloc(&arena_, 100) != NULL);
+	}
+	ASSERT_EQ(CountChunks(arena_.chunk) + CountChunks(arena_.spare), n_chunk - 1);
+}
+
+TEST_F(TestArenaFixture, rollback)
+{
+	char *a = muggle_arena_strndup(&arena_, "hello world", 5);
+	ASSERT_STREQ(a, "hello");
+
+	muggle_arena_mark_t mark = muggle_arena_save(&arena_);
+	for (int i = 0; i < 100; i++)
+	{
+		ASSERT_TRUE(muggle_arena_alloc(&arena_, 100) != NULL);
+	}
+
+	muggle_arena_mark_t inner = muggle_arena_save(&arena_);
+	void *p1 = muggle_arena_alloc(&arena_, 32);
+	muggle_arena_rollback(&arena_, inner);
+	void *p2 = muggle_arena_alloc(&arena_, 32);
+	ASSERT_EQ(p1, p2);
+
+	muggle_arena_rollback(&arena_, mark);
+	ASSERT_EQ(CountChunks(arena_.chunk), 1);
+	ASSERT_STREQ(a, "hello");
+
+	char *b = muggle_arena_strndup(&arena_, "abc", 16);
+	ASSERT_STREQ(b, "abc");
+	ASSERT_EQ(b, a + 6);
+}
+
+TEST(arena, thp)
+{
+	muggle_arena_t arena;
+	bool ret = muggle_arena_init_thp(&arena, 0);
+	if (!ret)
+	{
+		// THP not available
+		return;
+	}
+
+	char *p = (char*)muggle_arena_alloc(&arena, 4096);
+	ASSERT_TRUE(p != NULL);
+	memset(p, 0, 4096);
+
+	muggle_arena_destroy(&arena);
+}
+
+TEST(arena, avl_tree_scoped)
+{
+	muggle_arena_t arena;
+	ASSERT_TRUE(muggle_arena_init(&arena, 0));
+
+	for (int r = 0; r < 4; r++)
+	{
+		muggle_avl_tree_t tree;
+		ASSERT_TRUE(muggle_avl_tree_init_arena(&tree, [](const void *d1, const void *d2) {
+			intptr_t a = (intptr_t)d1, b = (intptr_t)d2;
+			return a < b ? -1 : (a > b ? 1 : 0);
+		}, &arena));
+
+		for (intptr_t i = 1; i <= 1000; i++)
+		{
+			ASSERT_TRUE(muggle_avl_tree_insert(&tree, (void*)i, NULL) != NULL);
+		}
+		for (intptr_t i = 1; i <= 1000; i += 2)
+		{
+			muggle_avl_tree_node_t *node = muggle_avl_tree_find(&tree, (void*)i);
+			ASSERT_TRUE(node != NULL);
+			muggle_avl_tree_remove(&tree, node, NULL, NULL, NULL, NULL);
+		}
+		ASSERT_TRUE(muggle_avl_tree_find(&tree, (void*)2) != NULL);
+		ASSERT_TRUE(muggle_avl_tree_find(&tree, (void*)3) == NULL);
+
+		// drop whole tree in O(1)
+		muggle_arena_reset(&arena);
+	}
+
+	muggle_arena_destroy(&arena);
+}
@@ -191,3 +191,118 @@ TEST(array_blocking_queue, mul_producer_mul_consumer)
 
 	producer_consumer(hc, hc, g_cnt_interval, g_interval_ms);
 }
+
+TEST(array_blocking_queue, put_n_take_all_single_thread)
+{
+	muggle_array_blocking_queue_t queue;
+	int capacity = 16;
+	int arr[64];
+	void *datas[64];
+	void *out[64];
+	for (int i = 0; i < 64; ++i)
+	{
+		arr[i] = i;
+		datas[i] = &arr[i];
+	}
+
+	muggle_array_blocking_queue_init(&queue, capacity);
+
+	// move take/put index, so batch wrap around
+	for (int round = 0; round < 5; ++round)
+	{
+		EXPECT_EQ(muggle_array_blocking_queue_put_n(&queue, datas, 10), MUGGLE_OK);
+		EXPECT_EQ(queue.cnt, 10);
+
+		int n = muggle_array_blocking_queue_take_all(&queue, out, 4);
+		EXPECT_EQ(n, 4);
+		for (int i = 0; i < n; ++i)
+		{
+			EXPECT_EQ(*(int*)out[i], i);
+		}
+
+		n = muggle_array_blocking_queue_take_all(&queue, out, 64);
+		EXPECT_EQ(n, 6);
+		for (int i = 0; i < n; ++i)
+		{
+			EXPECT_EQ(*(int*)out[i], i + 4);
+		}
+		EXPECT_EQ(queue.cnt, 0);
+	}
+
+	muggle_array_blocking_queue_destroy(&queue);
+}
+
+TEST(array_blocking_queue, put_n_larger_than_capacity)
+{
+	muggle_array_blocking_queue_t queue;
+	int capacity = 8;
+	int total = 1000;
+	int *arr = (int*)malloc(sizeof(int) * total);
+	void **datas = (void**)malloc(sizeof(void*) * total);
+	for (int i = 0; i < total; ++i)
+	{
+		arr[i] = i;
+		datas[i] = &arr[i];
+	}
+
+	muggle_array_blocking_queue_init(&queue, capacity);
+
+	std::thread consumer([&]{
+		void *out[5];
+		int expect = 0;
+		while (expect < total)
+		{
+			int n = muggle_array_blocking_queue_take_all(&queue, out, 5);
+			ASSERT_GT(n, 0);
+			for (int i = 0; i < n; ++i)
+			{
+				ASSERT_EQ(*(int*)out[i], expect++);
+			}
+		}
+	});
+
+	EXPECT_EQ(muggle_array_blocking_queue_put_n(&queue, datas, total), MUGGLE_OK);
+
+	consumer.join();
+
+	muggle_array_blocking_queue_destroy(&queue);
+	free(datas);
+	free(arr);
+}
+
+TEST(array_blocking_queue, timed_take)
+{
+	muggle_array_blocking_queue_t queue;
+	int data = 5;
+
+	muggle_array_blocking_queue_init(&queue, 4);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 20 * 1000000;
+
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(muggle_array_blocking_queue_timed_take(&queue, &timeout) == NULL);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	EXPECT_GE(elapsed, 15);
+
+	muggle_array_blocking_queue_put(&queue, &data);
+	void *p = muggle_array_blocking_queue_timed_take(&queue, &timeout);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*(int*)p, 5);
+
+	// wake up by producer before timeout
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	std::thread producer([&]{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		muggle_array_blocking_queue_put(&queue, &data);
+	});
+	p = muggle_array_blocking_queue_timed_take(&queue, &timeout);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*(int*)p, 5);
+	producer.join();
+
+	muggle_array_blocking_queue_destroy(&queue);
+}
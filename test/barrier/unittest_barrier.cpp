@@ -0,0 +1,52 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+TEST(barrier, phases)
+{
+	const int cnt_thread = 6;
+	const int cnt_phase = 1000;
+
+	muggle_barrier_t barrier;
+	muggle_barrier_init(&barrier, cnt_thread);
+
+	muggle_atomic_int arrived[cnt_phase];
+	memset(arrived, 0, sizeof(arrived));
+	muggle_atomic_int n_serial = 0;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			for (int phase = 0; phase < cnt_phase; phase++)
+			{
+				muggle_atomic_fetch_add(
+					&arrived[phase], 1, muggle_memory_order_relaxed);
+				if (muggle_barrier_wait(&barrier))
+				{
+					muggle_atomic_fetch_add(
+						&n_serial, 1, muggle_memory_order_relaxed);
+				}
+
+				// all threads arrived this phase before any leave
+				ASSERT_EQ(muggle_atomic_load(
+					&arrived[phase], muggle_memory_order_relaxed), cnt_thread);
+			}
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(n_serial, cnt_phase);
+	EXPECT_EQ(barrier.generation, (muggle_sync_t)cnt_phase);
+	EXPECT_EQ(barrier.arrived, 0);
+	EXPECT_EQ(barrier.n_waiters, 0);
+}
+
+#endif
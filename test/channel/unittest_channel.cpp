@@ -1,6 +1,7 @@
 #include <thread>
 #include <vector>
 #include <map>
+#include <chrono>
 #include "gtest/gtest.h"
 #include "muggle/c/muggle_c.h"
 
@@ -88,6 +89,193 @@ void test_chan(int flags, uint32_t cnt_writer)
 	muggle_channel_destroy(&chan);
 }
 
+void test_chan_batch(int flags, uint32_t cnt_writer, uint32_t batch_size)
+{
+	uint32_t capacity = 1024 * 4;
+	uint32_t cnt_msg = capacity * 32;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+
+	muggle_channel_t chan;
+	muggle_channel_init(&chan, capacity, flags);
+
+	std::map<uint32_t, uint32_t> thread_cnts;
+	for (uint32_t i = 0; i < cnt_writer; i++)
+	{
+		thread_cnts[i] = 0;
+	}
+
+	// write
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < cnt_writer; i++)
+	{
+		threads.push_back(std::thread([i, &chan, &msg_idx, &cnt_msg, &datas, batch_size]{
+			muggle_msleep(1);
+			uint32_t thread_msg_idx = 0;
+			std::vector<void*> batch(batch_size);
+
+			while (true)
+			{
+				uint32_t n = 0;
+				for (n = 0; n < batch_size; n++)
+				{
+					muggle_atomic_int cur_idx = muggle_atomic_fetch_add(
+						&msg_idx, 1, muggle_memory_order_relaxed);
+					if ((uint32_t)cur_idx >= cnt_msg)
+					{
+						break;
+					}
+
+					datas[cur_idx].idx = (uint32_t)cur_idx;
+					datas[cur_idx].thread_idx = i;
+					datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+					batch[n] = &datas[cur_idx];
+				}
+
+				uint32_t offset = 0;
+				while (offset < n)
+				{
+					uint32_t cnt = muggle_channel_write_n(
+						&chan, &batch[offset], n - offset);
+					offset += cnt;
+					if (cnt == 0)
+					{
+						muggle_msleep(1);
+					}
+				}
+
+				if (n < batch_size)
+				{
+					break;
+				}
+			}
+		}));
+	}
+
+	// read
+	std::vector<void*> recv_datas(batch_size);
+	uint32_t recv_cnt = 0;
+	while (recv_cnt < cnt_msg)
+	{
+		uint32_t n = muggle_channel_read_n(&chan, &recv_datas[0], batch_size);
+		ASSERT_GT(n, 0u);
+		ASSERT_LE(n, batch_size);
+		for (uint32_t k = 0; k < n; k++)
+		{
+			chan_data *data = (chan_data*)recv_datas[k];
+			ASSERT_LT(data->thread_idx, cnt_writer);
+			ASSERT_EQ(data->thread_msg_idx, thread_cnts[data->thread_idx]);
+			thread_cnts[data->thread_idx]++;
+			recv_cnt++;
+		}
+	}
+	ASSERT_EQ(recv_cnt, cnt_msg);
+
+	// join thread
+	for (uint32_t i = 0; i < cnt_writer; i++)
+	{
+		threads[i].join();
+	}
+
+	// free resource
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
+void test_chan_multi_reader(int flags, uint32_t cnt_writer, uint32_t cnt_reader)
+{
+	uint32_t capacity = 1024 * 4;
+	uint32_t cnt_msg = capacity * 32;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+	muggle_atomic_int *recv_flags =
+		(muggle_atomic_int*)malloc(cnt_msg * sizeof(muggle_atomic_int));
+	memset(recv_flags, 0, cnt_msg * sizeof(muggle_atomic_int));
+	chan_data end_msg;
+	memset(&end_msg, 0, sizeof(end_msg));
+
+	muggle_channel_t chan;
+	muggle_channel_init(&chan, capacity, flags);
+
+	// read
+	muggle_atomic_int recv_cnt = 0;
+	std::vector<std::thread> readers;
+	for (uint32_t i = 0; i < cnt_reader; i++)
+	{
+		readers.push_back(std::thread([&chan, &recv_cnt, &recv_flags, &end_msg]{
+			while (true)
+			{
+				chan_data *data = (chan_data*)muggle_channel_read(&chan);
+				if (data == &end_msg)
+				{
+					break;
+				}
+				muggle_atomic_fetch_add(
+					&recv_flags[data->idx], 1, muggle_memory_order_relaxed);
+				muggle_atomic_fetch_add(
+					&recv_cnt, 1, muggle_memory_order_relaxed);
+			}
+		}));
+	}
+
+	// write
+	std::vector<std::thread> writers;
+	for (uint32_t i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &chan, &msg_idx, &cnt_msg, &datas]{
+			uint32_t thread_msg_idx = 0;
+			while (true)
+			{
+				muggle_atomic_int cur_idx = muggle_atomic_fetch_add(
+					&msg_idx, 1, muggle_memory_order_relaxed);
+				if ((uint32_t)cur_idx >= cnt_msg)
+				{
+					break;
+				}
+
+				datas[cur_idx].idx = (uint32_t)cur_idx;
+				datas[cur_idx].thread_idx = i;
+				datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+
+				while (muggle_channel_write(&chan, &datas[cur_idx]) ==
+					MUGGLE_ERR_FULL)
+				{
+					muggle_thread_yield();
+				}
+			}
+		}));
+	}
+	for (uint32_t i = 0; i < cnt_writer; i++)
+	{
+		writers[i].join();
+	}
+
+	// notify readers exit
+	for (uint32_t i = 0; i < cnt_reader; i++)
+	{
+		while (muggle_channel_write(&chan, &end_msg) == MUGGLE_ERR_FULL)
+		{
+			muggle_thread_yield();
+		}
+	}
+	for (uint32_t i = 0; i < cnt_reader; i++)
+	{
+		readers[i].join();
+	}
+
+	// every message read exactly once
+	ASSERT_EQ((uint32_t)recv_cnt, cnt_msg);
+	for (uint32_t i = 0; i < cnt_msg; i++)
+	{
+		ASSERT_EQ(recv_flags[i], 1);
+	}
+
+	// free resource
+	free(recv_flags);
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
 uint32_t getProducerNum()
 {
 	int hc = (int)muggle_thread_hardware_concurrency();
@@ -203,6 +391,54 @@ TEST(channel, spin_w_busy_r)
 	test_chan(flags, getProducerNum());
 }
 
+TEST(channel, ticket_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_TICKET |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, ticket_w_mutex_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_TICKET |
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, ticket_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_TICKET |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, mcs_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_MCS |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, mcs_w_mutex_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_MCS |
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, mcs_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_MCS |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan(flags, getProducerNum());
+}
+
 TEST(channel, single_w_sync_r)
 {
 	int flags =
@@ -226,3 +462,388 @@ TEST(channel, single_w_busy_r)
 		MUGGLE_CHANNEL_FLAG_READ_BUSY;
 	test_chan(flags, 1);
 }
+
+TEST(channel, lockfree_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, lockfree_w_mutex_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE |
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, lockfree_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan(flags, getProducerNum());
+}
+
+TEST(channel, lockfree_multi_reader)
+{
+	int r_flags[] = {
+		MUGGLE_CHANNEL_FLAG_READ_SYNC,
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY,
+	};
+	for (size_t i = 0; i < sizeof(r_flags) / sizeof(r_flags[0]); i++)
+	{
+		test_chan_multi_reader(
+			MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE | r_flags[i], 4, 4);
+	}
+}
+
+TEST(channel, lockfree_capacity)
+{
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(
+		&chan, 16, MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE), 0);
+
+	chan_data datas[17];
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		ASSERT_EQ(muggle_channel_write(&chan, &datas[i]), MUGGLE_OK);
+	}
+	ASSERT_EQ(muggle_channel_write(&chan, &datas[16]), MUGGLE_ERR_FULL);
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		ASSERT_EQ(muggle_channel_read(&chan), (void*)&datas[i]);
+	}
+	ASSERT_EQ(muggle_channel_write(&chan, &datas[16]), MUGGLE_OK);
+	ASSERT_EQ(muggle_channel_read(&chan), (void*)&datas[16]);
+
+	muggle_channel_destroy(&chan);
+}
+
+TEST(channel, write_n_until_full)
+{
+	int r_flags[] = {
+		MUGGLE_CHANNEL_FLAG_READ_SYNC,
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY,
+	};
+	for (size_t i = 0; i < sizeof(r_flags) / sizeof(r_flags[0]); i++)
+	{
+		muggle_channel_t chan;
+		ASSERT_EQ(muggle_channel_init(
+			&chan, 16, MUGGLE_CHANNEL_FLAG_WRITE_SINGLE | r_flags[i]), 0);
+
+		chan_data datas[32];
+		void *ptrs[32];
+		for (uint32_t k = 0; k < 32; k++)
+		{
+			datas[k].idx = k;
+			ptrs[k] = &datas[k];
+		}
+
+		// write more than capacity, only part of datas was written
+		uint32_t n = muggle_channel_write_n(&chan, ptrs, 32);
+		ASSERT_GT(n, 0u);
+		ASSERT_LT(n, 16u);
+		ASSERT_EQ(muggle_channel_write_n(&chan, ptrs + n, 32 - n), 0u);
+		ASSERT_EQ(muggle_channel_write(&chan, ptrs[n]), MUGGLE_ERR_FULL);
+
+		// read with small batch, keep order
+		void *recv[4];
+		uint32_t recv_cnt = 0;
+		while (recv_cnt < n)
+		{
+			uint32_t cnt = muggle_channel_read_n(&chan, recv, 4);
+			ASSERT_GT(cnt, 0u);
+			ASSERT_LE(cnt, 4u);
+			for (uint32_t k = 0; k < cnt; k++)
+			{
+				ASSERT_EQ(((chan_data*)recv[k])->idx, recv_cnt++);
+			}
+		}
+
+		// space released
+		ASSERT_EQ(muggle_channel_write_n(&chan, ptrs + n, 4), 4u);
+		ASSERT_EQ(muggle_channel_read_n(&chan, recv, 4), 4u);
+		for (uint32_t k = 0; k < 4; k++)
+		{
+			ASSERT_EQ(((chan_data*)recv[k])->idx, n + k);
+		}
+
+		muggle_channel_destroy(&chan);
+	}
+}
+
+TEST(channel, batch_sync_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_SYNC |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_mutex_w_mutex_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_MUTEX |
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_spin_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_SPIN |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_ticket_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_TICKET |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_mcs_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_MCS |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_lockfree_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_lockfree_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan_batch(flags, getProducerNum(), 16);
+}
+
+TEST(channel, batch_single_w_sync_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE |
+		MUGGLE_CHANNEL_FLAG_READ_SYNC;
+	test_chan_batch(flags, 1, 64);
+}
+
+TEST(channel, batch_single_w_mutex_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE |
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX;
+	test_chan_batch(flags, 1, 64);
+}
+
+TEST(channel, batch_single_w_busy_r)
+{
+	int flags =
+		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE |
+		MUGGLE_CHANNEL_FLAG_READ_BUSY;
+	test_chan_batch(flags, 1, 64);
+}
+
+void test_chan_try_read(int flags)
+{
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, 8, flags), 0);
+
+	// empty channel
+	ASSERT_EQ(muggle_channel_try_read(&chan), nullptr);
+
+	void *datas[8];
+	ASSERT_EQ(muggle_channel_try_read_n(&chan, datas, 8), (uint32_t)0);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 20 * 1000 * 1000;
+	auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(muggle_channel_read_timeout(&chan, &timeout), nullptr);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	ASSERT_GE(elapsed, 15);
+
+	// with data
+	int arr[4] = { 0, 1, 2, 3 };
+	for (int i = 0; i < 4; i++)
+	{
+		ASSERT_EQ(muggle_channel_write(&chan, &arr[i]), 0);
+	}
+
+	ASSERT_EQ(muggle_channel_try_read(&chan), &arr[0]);
+	ASSERT_EQ(muggle_channel_read_timeout(&chan, &timeout), &arr[1]);
+	ASSERT_EQ(muggle_channel_try_read_n(&chan, datas, 8), (uint32_t)2);
+	ASSERT_EQ(datas[0], &arr[2]);
+	ASSERT_EQ(datas[1], &arr[3]);
+	ASSERT_EQ(muggle_channel_try_read(&chan), nullptr);
+
+	// wake up by writer before timeout
+	std::thread writer([&]{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		muggle_channel_write(&chan, &arr[0]);
+	});
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	ASSERT_EQ(muggle_channel_read_timeout(&chan, &timeout), &arr[0]);
+	writer.join();
+
+	muggle_channel_destroy(&chan);
+}
+
+TEST(channel, try_read)
+{
+	int w_flags[] = {
+		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE,
+		MUGGLE_CHANNEL_FLAG_WRITE_MUTEX,
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE,
+	};
+	int r_flags[] = {
+		MUGGLE_CHANNEL_FLAG_READ_SYNC,
+		MUGGLE_CHANNEL_FLAG_READ_MUTEX,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY,
+	};
+	for (size_t i = 0; i < sizeof(w_flags) / sizeof(w_flags[0]); i++)
+	{
+		for (size_t j = 0; j < sizeof(r_flags) / sizeof(r_flags[0]); j++)
+		{
+			test_chan_try_read(w_flags[i] | r_flags[j]);
+		}
+	}
+}
+
+struct chan_ev_reader
+{
+	muggle_channel_t *chan;
+	uint32_t cnt_msg;
+	uint32_t recv;
+	uint32_t cnt_wakeup;
+	uint32_t cnt_cb;
+};
+
+static void chan_ev_on_read(muggle_event_loop_t *evloop, muggle_event_context_t *ctx)
+{
+	chan_ev_reader *reader = (chan_ev_reader*)muggle_evloop_get_data(evloop);
+	muggle_channel_t *chan = (muggle_channel_t*)muggle_ev_ctx_data(ctx);
+	ASSERT_EQ(chan, reader->chan);
+
+	reader->cnt_cb++;
+	int n = muggle_channel_ev_clearup(chan);
+	ASSERT_GE(n, 0);
+	reader->cnt_wakeup += (uint32_t)n;
+
+	void *datas[64];
+	uint32_t cnt = 0;
+	while ((cnt = muggle_channel_try_read_n(chan, datas, 64)) > 0)
+	{
+		for (uint32_t i = 0; i < cnt; i++)
+		{
+			ASSERT_EQ(((chan_data*)datas[i])->idx, reader->recv);
+			reader->recv++;
+		}
+	}
+
+	if (reader->recv == reader->cnt_msg)
+	{
+		muggle_evloop_exit(evloop);
+	}
+}
+
+void test_chan_event(int flags)
+{
+	muggle_event_lib_init();
+
+	uint32_t capacity = 1024;
+	uint32_t cnt_msg = capacity * 16;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+	for (uint32_t i = 0; i < cnt_msg; i++)
+	{
+		datas[i].idx = i;
+	}
+
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, capacity, flags), 0);
+	ASSERT_TRUE(muggle_channel_ev_signal(&chan) != NULL);
+	ASSERT_NE(muggle_ev_signal_rfd(muggle_channel_ev_signal(&chan)), MUGGLE_INVALID_EVENT_FD);
+
+	muggle_event_loop_init_args_t ev_init_args;
+	memset(&ev_init_args, 0, sizeof(ev_init_args));
+	muggle_event_loop_t *evloop = muggle_evloop_new(&ev_init_args);
+	ASSERT_TRUE(evloop != NULL);
+
+	chan_ev_reader reader;
+	memset(&reader, 0, sizeof(reader));
+	reader.chan = &chan;
+	reader.cnt_msg = cnt_msg;
+	muggle_evloop_set_data(evloop, &reader);
+	muggle_evloop_set_cb_read(evloop, chan_ev_on_read);
+
+	muggle_event_context_t ctx;
+	ASSERT_EQ(muggle_channel_ev_add_to_evloop(&chan, evloop, &ctx), 0);
+
+	std::thread writer([&]{
+		uint32_t idx = 0;
+		while (idx < cnt_msg)
+		{
+			if (muggle_channel_write(&chan, &datas[idx]) == 0)
+			{
+				idx++;
+			}
+			else
+			{
+				muggle_thread_yield();
+			}
+		}
+	});
+
+	muggle_evloop_run(evloop);
+	writer.join();
+
+	ASSERT_EQ(reader.recv, cnt_msg);
+	ASSERT_GT(reader.cnt_wakeup, (uint32_t)0);
+	ASSERT_LE(reader.cnt_wakeup, reader.cnt_cb);
+
+	muggle_evloop_delete(evloop);
+	muggle_channel_destroy(&chan);
+	free(datas);
+}
+
+TEST(channel, single_w_event_r)
+{
+	test_chan_event(
+		MUGGLE_CHANNEL_FLAG_WRITE_SINGLE | MUGGLE_CHANNEL_FLAG_READ_EVENT);
+}
+
+TEST(channel, mutex_w_event_r)
+{
+	test_chan_event(
+		MUGGLE_CHANNEL_FLAG_WRITE_MUTEX | MUGGLE_CHANNEL_FLAG_READ_EVENT);
+}
+
+TEST(channel, lockfree_w_event_r)
+{
+	test_chan_event(
+		MUGGLE_CHANNEL_FLAG_WRITE_LOCKFREE | MUGGLE_CHANNEL_FLAG_READ_EVENT);
+}
+
+TEST(channel, event_fd_invalid_in_other_mode)
+{
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, 8, MUGGLE_CHANNEL_FLAG_READ_MUTEX), 0);
+	ASSERT_TRUE(muggle_channel_ev_signal(&chan) == NULL);
+	muggle_channel_destroy(&chan);
+}
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <stdlib.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#define EBR_NODE_MAGIC 0x5A5A5A5A
+#define EBR_NODE_POISON 0xDEADBEEF
+
+typedef struct {
+	uint32_t magic;
+	uint64_t value;
+} ebr_node_t;
+
+static std::atomic<uint64_t> s_ebr_freed(0);
+
+static void ebr_node_free(void *ptr)
+{
+	ebr_node_t *node = (ebr_node_t*)ptr;
+	node->magic = EBR_NODE_POISON;
+	s_ebr_freed.fetch_add(1);
+	free(node);
+}
+
+static ebr_node_t* ebr_node_new(uint64_t value)
+{
+	ebr_node_t *node = (ebr_node_t*)malloc(sizeof(ebr_node_t));
+	node->magic = EBR_NODE_MAGIC;
+	node->value = value;
+	return node;
+}
+
+TEST(ebr, register)
+{
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr, 2, 0, NULL), 0);
+
+	muggle_ebr_thread_t *thr1 = muggle_ebr_register(&ebr);
+	muggle_ebr_thread_t *thr2 = muggle_ebr_register(&ebr);
+	ASSERT_TRUE(thr1 != NULL);
+	ASSERT_TRUE(thr2 != NULL);
+	ASSERT_TRUE(thr1 != thr2);
+	ASSERT_TRUE(muggle_ebr_register(&ebr) == NULL);
+
+	muggle_ebr_unregister(thr1);
+	ASSERT_TRUE(muggle_ebr_register(&ebr) == thr1);
+
+	muggle_ebr_destroy(&ebr);
+}
+
+TEST(ebr, reader_block_reclaim)
+{
+	s_ebr_freed = 0;
+
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr, 4, 1024, ebr_node_free), 0);
+
+	muggle_ebr_thread_t *reader = muggle_ebr_register(&ebr);
+	muggle_ebr_thread_t *writer = muggle_ebr_register(&ebr);
+
+	muggle_ebr_enter(reader);
+	muggle_ebr_enter(reader);
+	muggle_ebr_exit(reader);
+
+	const int cnt = 16;
+	for (int i = 0; i < cnt; i++) {
+		ASSERT_EQ(muggle_ebr_retire(writer, ebr_node_new(i)), 0);
+	}
+
+	// reader still in critical section, epoch advance at most once
+	for (int i = 0; i < 8; i++) {
+		muggle_ebr_reclaim(writer);
+	}
+	ASSERT_EQ(s_ebr_freed.load(), 0);
+
+	muggle_ebr_exit(reader);
+
+	uint32_t n = 0;
+	for (int i = 0; i < 8; i++) {
+		n += muggle_ebr_reclaim(writer);
+	}
+	ASSERT_EQ(n, (uint32_t)cnt);
+	ASSERT_EQ(s_ebr_freed.load(), (uint64_t)cnt);
+
+	// retired but not reclaimed objects are freed in destroy
+	for (int i = 0; i < cnt; i++) {
+		ASSERT_EQ(muggle_ebr_retire(writer, ebr_node_new(i)), 0);
+	}
+	muggle_ebr_destroy(&ebr);
+	ASSERT_EQ(s_ebr_freed.load(), (uint64_t)cnt * 2);
+}
+
+TEST(ebr, concurrent)
+{
+	s_ebr_freed = 0;
+
+	const int n_reader = 4;
+	const int n_writer = 2;
+	const uint64_t cnt = 20000;
+
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr, n_reader + n_writer, 32, ebr_node_free), 0);
+
+	std::atomic<ebr_node_t*> shared(ebr_node_new(0));
+	std::atomic<int> stop(0);
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < n_reader; i++) {
+		readers.push_back(std::thread([&] {
+			muggle_ebr_thread_t *thr = muggle_ebr_register(&ebr);
+			ASSERT_TRUE(thr != NULL);
+			while (!stop.load()) {
+				muggle_ebr_enter(thr);
+				ebr_node_t *node = shared.load();
+				for (int j = 0; j < 8; j++) {
+					ASSERT_EQ(node->magic, (uint32_t)EBR_NODE_MAGIC);
+				}
+				muggle_ebr_exit(thr);
+			}
+			muggle_ebr_unregister(thr);
+		}));
+	}
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < n_writer; i++) {
+		writers.push_back(std::thread([&] {
+			muggle_ebr_thread_t *thr = muggle_ebr_register(&ebr);
+			ASSERT_TRUE(thr != NULL);
+			for (uint64_t j = 1; j <= cnt; j++) {
+				ebr_node_t *old = shared.exchange(ebr_node_new(j));
+				ASSERT_EQ(muggle_ebr_retire(thr, old), 0);
+			}
+			muggle_ebr_unregister(thr);
+		}));
+	}
+
+	for (auto &t : writers) {
+		t.join();
+	}
+	stop.store(1);
+	for (auto &t : readers) {
+		t.join();
+	}
+
+	muggle_ebr_destroy(&ebr);
+	ASSERT_EQ(s_ebr_freed.load(), cnt * n_writer);
+
+	ebr_node_free(shared.load());
+}
@@ -0,0 +1,91 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+TEST(eventcount, notify_without_waiter)
+{
+	muggle_eventcount_t ec;
+	muggle_eventcount_init(&ec);
+
+	// nothing to wake, epoch unchanged
+	muggle_eventcount_notify_one(&ec);
+	muggle_eventcount_notify_all(&ec);
+	EXPECT_EQ(ec.epoch, 0);
+
+	muggle_sync_t key = muggle_eventcount_prepare_wait(&ec);
+	muggle_eventcount_notify_one(&ec);
+	EXPECT_NE(ec.epoch, key);
+
+	// already notified, return immediately
+	muggle_eventcount_commit_wait(&ec, key);
+	EXPECT_EQ(ec.n_waiters, 0);
+}
+
+TEST(eventcount, lock_free_counter)
+{
+	muggle_eventcount_t ec;
+	muggle_eventcount_init(&ec);
+
+	const int cnt_consumer = 4;
+	const int cnt_per_consumer = 10000;
+	const int total = cnt_consumer * cnt_per_consumer;
+
+	// lock-free condition: available > 0
+	muggle_atomic_int available = 0;
+	muggle_atomic_int consumed = 0;
+
+	std::vector<std::thread> consumers;
+	for (int i = 0; i < cnt_consumer; i++)
+	{
+		consumers.push_back(std::thread([&] {
+			auto try_take = [&]() -> bool {
+				muggle_atomic_int v = muggle_atomic_load(
+					&available, muggle_memory_order_acquire);
+				while (v > 0)
+				{
+					if (muggle_atomic_cmp_exch_weak(&available, &v, v - 1,
+							muggle_memory_order_acq_rel))
+					{
+						return true;
+					}
+				}
+				return false;
+			};
+
+			for (int i = 0; i < cnt_per_consumer; i++)
+			{
+				while (!try_take())
+				{
+					muggle_sync_t key = muggle_eventcount_prepare_wait(&ec);
+					if (try_take())
+					{
+						muggle_eventcount_cancel_wait(&ec);
+						break;
+					}
+					muggle_eventcount_commit_wait(&ec, key);
+				}
+				muggle_atomic_fetch_add(&consumed, 1, muggle_memory_order_relaxed);
+			}
+		}));
+	}
+
+	for (int i = 0; i < total; i++)
+	{
+		muggle_atomic_fetch_add(&available, 1, muggle_memory_order_release);
+		muggle_eventcount_notify_one(&ec);
+	}
+
+	for (auto &th : consumers)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(consumed, total);
+	EXPECT_EQ(available, 0);
+	EXPECT_EQ(ec.n_waiters, 0);
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+TEST(latch, count_down)
+{
+	muggle_latch_t latch;
+	muggle_latch_init(&latch, 3);
+
+	EXPECT_FALSE(muggle_latch_try_wait(&latch));
+	muggle_latch_count_down(&latch, 2);
+	EXPECT_FALSE(muggle_latch_try_wait(&latch));
+	muggle_latch_count_down(&latch, 1);
+	EXPECT_TRUE(muggle_latch_try_wait(&latch));
+
+	// already reach zero, return immediately
+	muggle_latch_wait(&latch);
+}
+
+TEST(latch, start_gate)
+{
+	muggle_latch_t ready;
+	muggle_latch_t start;
+
+	const int cnt_thread = 8;
+	muggle_latch_init(&ready, cnt_thread);
+	muggle_latch_init(&start, 1);
+
+	muggle_atomic_int started = 0;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			muggle_latch_count_down(&ready, 1);
+			muggle_latch_wait(&start);
+			muggle_atomic_fetch_add(&started, 1, muggle_memory_order_relaxed);
+		}));
+	}
+
+	muggle_latch_wait(&ready);
+	EXPECT_EQ(muggle_atomic_load(&started, muggle_memory_order_relaxed), 0);
+	muggle_latch_count_down(&start, 1);
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+	EXPECT_EQ(started, cnt_thread);
+	EXPECT_EQ(start.n_waiters, 0);
+}
+
+TEST(latch, arrive_and_wait)
+{
+	muggle_latch_t latch;
+
+	const int cnt_thread = 8;
+	muggle_latch_init(&latch, cnt_thread);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			muggle_latch_arrive_and_wait(&latch);
+			EXPECT_TRUE(muggle_latch_try_wait(&latch));
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+}
+
+#endif
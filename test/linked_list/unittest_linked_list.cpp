@@ -19,6 +19,12 @@ public:
 		ret = muggle_linked_list_init(&list_[1], 8);
 		ASSERT_TRUE(ret);
 
+		ret = muggle_arena_init(&arena_, 256);
+		ASSERT_TRUE(ret);
+
+		ret = muggle_linked_list_init_arena(&list_[2], &arena_);
+		ASSERT_TRUE(ret);
+
 		for (int index = 0; index < (int)(sizeof(list_) / sizeof(list_[index])); index++)
 		{
 			ASSERT_EQ(muggle_linked_list_size(&list_[index]), (size_t)0);
@@ -29,12 +35,15 @@ public:
 	{
 		muggle_linked_list_destroy(&list_[0], test_utils_free_int, &test_utils_);
 		muggle_linked_list_destroy(&list_[1], test_utils_free_int, &test_utils_);
+		muggle_linked_list_destroy(&list_[2], test_utils_free_int, &test_utils_);
+		muggle_arena_destroy(&arena_);
 
 		muggle_debug_memory_leak_end(&mem_state_);
 	}
 
 protected:
-	muggle_linked_list_t list_[2];
+	muggle_linked_list_t list_[3];
+	muggle_arena_t arena_;
 
 	TestUtils test_utils_;
 	muggle_debug_memory_state mem_state_;
@@ -0,0 +1,346 @@
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#define MA_RING_PRODUCER 4
+#define MA_RING_MSG_PER_PRODUCER 4096
+
+typedef struct {
+	uint32_t producer;
+	uint32_t idx;
+} ma_ring_msg_t;
+
+static uint64_t s_last_stamp = 0;
+static uint32_t s_recv_idx[MA_RING_PRODUCER];
+static muggle_atomic_int s_total_recv = 0;
+static muggle_atomic_int s_out_of_order = 0;
+
+static void fn_ordered_cb(muggle_ma_ring_t *ring, void *data)
+{
+	MUGGLE_UNUSED(ring);
+
+	uint64_t stamp = muggle_ma_ring_get_stamp(data);
+	if (stamp < s_last_stamp)
+	{
+		muggle_atomic_fetch_add(&s_out_of_order, 1, muggle_memory_order_relaxed);
+	}
+	s_last_stamp = stamp;
+
+	ma_ring_msg_t *msg = (ma_ring_msg_t*)data;
+	if (msg->idx != s_recv_idx[msg->producer])
+	{
+		muggle_atomic_fetch_add(&s_out_of_order, 1, muggle_memory_order_relaxed);
+	}
+	s_recv_idx[msg->producer] = msg->idx + 1;
+
+	muggle_atomic_fetch_add(&s_total_recv, 1, muggle_memory_order_release);
+}
+
+TEST(ma_ring, ordered)
+{
+	memset(s_recv_idx, 0, sizeof(s_recv_idx));
+
+	muggle_ma_ring_ctx_set_capacity(256);
+	muggle_ma_ring_ctx_set_data_size(sizeof(ma_ring_msg_t));
+	muggle_ma_ring_ctx_set_callback(fn_ordered_cb);
+	// large reordering window, avoid producer be preempted between stamp
+	// and publish in busy test machine
+	muggle_ma_ring_ctx_set_ordered(true, 50 * 1000 * 1000);
+	muggle_ma_ring_backend_run();
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < MA_RING_PRODUCER; i++)
+	{
+		threads.push_back(std::thread([i]{
+			muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+			ASSERT_TRUE(ring != NULL);
+			for (uint32_t idx = 0; idx < MA_RING_MSG_PER_PRODUCER; idx++)
+			{
+				ma_ring_msg_t *msg = (ma_ring_msg_t*)muggle_ma_ring_alloc(ring);
+				msg->producer = i;
+				msg->idx = idx;
+				muggle_ma_ring_move(ring);
+			}
+			muggle_ma_ring_thread_ctx_cleanup();
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	ASSERT_EQ(
+		muggle_atomic_load(&s_total_recv, muggle_memory_order_acquire),
+		MA_RING_PRODUCER * MA_RING_MSG_PER_PRODUCER);
+	ASSERT_EQ(
+		muggle_atomic_load(&s_out_of_order, muggle_memory_order_relaxed), 0);
+
+	muggle_ma_ring_backend_stop();
+	muggle_ma_ring_ctx_set_ordered(false, 0);
+}
+
+static muggle_atomic_int s_cnt_recv = 0;
+
+static void fn_count_cb(muggle_ma_ring_t *ring, void *data)
+{
+	MUGGLE_UNUSED(ring);
+	MUGGLE_UNUSED(data);
+	muggle_atomic_fetch_add(&s_cnt_recv, 1, muggle_memory_order_relaxed);
+}
+
+static void test_wait_strategy(int wait_strategy)
+{
+	muggle_atomic_store(&s_cnt_recv, 0, muggle_memory_order_relaxed);
+
+	muggle_ma_ring_ctx_set_capacity(64);
+	muggle_ma_ring_ctx_set_data_size(sizeof(ma_ring_msg_t));
+	muggle_ma_ring_ctx_set_callback(fn_count_cb);
+	muggle_ma_ring_ctx_set_wait_strategy(wait_strategy);
+	muggle_ma_ring_backend_run();
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < MA_RING_PRODUCER; i++)
+	{
+		threads.push_back(std::thread([i]{
+			muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+			ASSERT_TRUE(ring != NULL);
+			for (uint32_t idx = 0; idx < MA_RING_MSG_PER_PRODUCER; idx++)
+			{
+				ma_ring_msg_t *msg = (ma_ring_msg_t*)muggle_ma_ring_alloc(ring);
+				msg->producer = i;
+				msg->idx = idx;
+				muggle_ma_ring_move(ring);
+
+				// let backend idle and park sometimes
+				if (idx % 1024 == 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				}
+			}
+			muggle_ma_ring_thread_ctx_cleanup();
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	ASSERT_EQ(
+		muggle_atomic_load(&s_cnt_recv, muggle_memory_order_relaxed),
+		MA_RING_PRODUCER * MA_RING_MSG_PER_PRODUCER);
+
+	muggle_ma_ring_backend_stop();
+	muggle_ma_ring_ctx_set_wait_strategy(MUGGLE_MA_RING_WAIT_SLEEP);
+}
+
+TEST(ma_ring, wait_sleep)
+{
+	test_wait_strategy(MUGGLE_MA_RING_WAIT_SLEEP);
+}
+
+TEST(ma_ring, wait_spin_yield)
+{
+	test_wait_strategy(MUGGLE_MA_RING_WAIT_SPIN_YIELD);
+}
+
+TEST(ma_ring, wait_futex)
+{
+	test_wait_strategy(MUGGLE_MA_RING_WAIT_FUTEX);
+}
+
+TEST(ma_ring, stop_drain)
+{
+	muggle_atomic_store(&s_cnt_recv, 0, muggle_memory_order_relaxed);
+
+	muggle_ma_ring_ctx_set_capacity(1024);
+	muggle_ma_ring_ctx_set_data_size(sizeof(ma_ring_msg_t));
+	muggle_ma_ring_ctx_set_callback(fn_count_cb);
+	muggle_ma_ring_ctx_set_wait_strategy(MUGGLE_MA_RING_WAIT_FUTEX);
+	muggle_ma_ring_backend_run();
+
+	std::thread th([]{
+		muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+		ASSERT_TRUE(ring != NULL);
+		for (uint32_t idx = 0; idx < 512; idx++)
+		{
+			ma_ring_msg_t *msg = (ma_ring_msg_t*)muggle_ma_ring_alloc(ring);
+			msg->producer = 0;
+			msg->idx = idx;
+			muggle_ma_ring_move(ring);
+		}
+
+		// stop without cleanup, backend must drain all records
+		muggle_ma_ring_backend_stop();
+		ASSERT_EQ(
+			muggle_atomic_load(&s_cnt_recv, muggle_memory_order_relaxed), 512);
+
+		// cleanup after backend stopped
+		muggle_ma_ring_thread_ctx_cleanup();
+	});
+	th.join();
+
+	muggle_ma_ring_ctx_set_wait_strategy(MUGGLE_MA_RING_WAIT_SLEEP);
+}
+
+#define MA_RING_VARLEN_MAX_BYTES 300
+
+static uint32_t s_varlen_recv_idx[MA_RING_PRODUCER];
+static muggle_atomic_int s_varlen_err = 0;
+
+static void fn_varlen_cb(muggle_ma_ring_t *ring, void *data)
+{
+	MUGGLE_UNUSED(ring);
+
+	uint32_t n_bytes = muggle_ma_ring_get_bytes(data);
+	ma_ring_msg_t *msg = (ma_ring_msg_t*)data;
+	if (n_bytes != sizeof(ma_ring_msg_t) + msg->idx % MA_RING_VARLEN_MAX_BYTES)
+	{
+		muggle_atomic_fetch_add(&s_varlen_err, 1, muggle_memory_order_relaxed);
+	}
+
+	unsigned char *p = (unsigned char*)(msg + 1);
+	for (uint32_t i = sizeof(ma_ring_msg_t); i < n_bytes; i++)
+	{
+		if (*p++ != (unsigned char)(msg->idx + i))
+		{
+			muggle_atomic_fetch_add(&s_varlen_err, 1, muggle_memory_order_relaxed);
+			break;
+		}
+	}
+
+	if (msg->idx != s_varlen_recv_idx[msg->producer])
+	{
+		muggle_atomic_fetch_add(&s_varlen_err, 1, muggle_memory_order_relaxed);
+	}
+	s_varlen_recv_idx[msg->producer] = msg->idx + 1;
+
+	muggle_atomic_fetch_add(&s_cnt_recv, 1, muggle_memory_order_relaxed);
+}
+
+static void test_varlen(uint32_t num_backend, int wait_strategy)
+{
+	memset(s_varlen_recv_idx, 0, sizeof(s_varlen_recv_idx));
+	muggle_atomic_store(&s_cnt_recv, 0, muggle_memory_order_relaxed);
+	muggle_atomic_store(&s_varlen_err, 0, muggle_memory_order_relaxed);
+
+	// small ring in cachelines, make writers wrap frequently
+	muggle_ma_ring_ctx_set_varlen(true);
+	muggle_ma_ring_ctx_set_capacity(64);
+	muggle_ma_ring_ctx_set_callback(fn_varlen_cb);
+	muggle_ma_ring_ctx_set_wait_strategy(wait_strategy);
+	ASSERT_EQ(muggle_ma_ring_ctx_set_backend_num(num_backend), 0);
+	muggle_ma_ring_backend_run();
+
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < MA_RING_PRODUCER; i++)
+	{
+		threads.push_back(std::thread([i]{
+			muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+			ASSERT_TRUE(ring != NULL);
+
+			// larger than ring capacity
+			ASSERT_TRUE(muggle_ma_ring_alloc_bytes(ring, 64 * 64) == NULL);
+
+			for (uint32_t idx = 0; idx < MA_RING_MSG_PER_PRODUCER; idx++)
+			{
+				uint32_t n_bytes =
+					sizeof(ma_ring_msg_t) + idx % MA_RING_VARLEN_MAX_BYTES;
+				ma_ring_msg_t *msg =
+					(ma_ring_msg_t*)muggle_ma_ring_alloc_bytes(ring, n_bytes);
+				ASSERT_TRUE(msg != NULL);
+				msg->producer = i;
+				msg->idx = idx;
+				unsigned char *p = (unsigned char*)(msg + 1);
+				for (uint32_t k = sizeof(ma_ring_msg_t); k < n_bytes; k++)
+				{
+					*p++ = (unsigned char)(idx + k);
+				}
+				muggle_ma_ring_move(ring);
+			}
+			muggle_ma_ring_thread_ctx_cleanup();
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	muggle_ma_ring_backend_stop();
+
+	ASSERT_EQ(
+		muggle_atomic_load(&s_cnt_recv, muggle_memory_order_relaxed),
+		MA_RING_PRODUCER * MA_RING_MSG_PER_PRODUCER);
+	ASSERT_EQ(
+		muggle_atomic_load(&s_varlen_err, muggle_memory_order_relaxed), 0);
+
+	muggle_ma_ring_ctx_set_varlen(false);
+	muggle_ma_ring_ctx_set_backend_num(1);
+	muggle_ma_ring_ctx_set_wait_strategy(MUGGLE_MA_RING_WAIT_SLEEP);
+}
+
+TEST(ma_ring, varlen)
+{
+	test_varlen(1, MUGGLE_MA_RING_WAIT_SLEEP);
+}
+
+TEST(ma_ring, varlen_multi_backend)
+{
+	test_varlen(3, MUGGLE_MA_RING_WAIT_FUTEX);
+}
+
+TEST(ma_ring, varlen_large_record)
+{
+	muggle_atomic_store(&s_cnt_recv, 0, muggle_memory_order_relaxed);
+
+	muggle_ma_ring_ctx_set_varlen(true);
+	muggle_ma_ring_ctx_set_capacity(64);
+	muggle_ma_ring_ctx_set_callback(fn_count_cb);
+	muggle_ma_ring_backend_run();
+
+	std::thread th([]{
+		muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+		ASSERT_TRUE(ring != NULL);
+
+		// more than half of ring can't always be placed
+		ASSERT_TRUE(muggle_ma_ring_alloc_bytes(ring, 32 * 64) == NULL);
+		ASSERT_TRUE(muggle_ma_ring_alloc_bytes(ring, 40 * 64) == NULL);
+
+		// half of ring records after a mid-ring write position, must not
+		// wait forever once backend drain the ring
+		uint32_t large = 32 * 64 - 64;
+		void *p = muggle_ma_ring_alloc_bytes(ring, 64);
+		ASSERT_TRUE(p != NULL);
+		muggle_ma_ring_move(ring);
+		for (int i = 0; i < 8; i++)
+		{
+			p = muggle_ma_ring_alloc_bytes(ring, large);
+			ASSERT_TRUE(p != NULL);
+			memset(p, 0, large);
+			muggle_ma_ring_move(ring);
+		}
+
+		muggle_ma_ring_thread_ctx_cleanup();
+	});
+	th.join();
+
+	muggle_ma_ring_backend_stop();
+
+	ASSERT_EQ(muggle_atomic_load(&s_cnt_recv, muggle_memory_order_relaxed), 9);
+
+	muggle_ma_ring_ctx_set_varlen(false);
+}
+
+TEST(ma_ring, multi_backend)
+{
+	ASSERT_NE(muggle_ma_ring_ctx_set_backend_num(0), 0);
+	ASSERT_NE(
+		muggle_ma_ring_ctx_set_backend_num(MUGGLE_MA_RING_MAX_BACKEND + 1), 0);
+	ASSERT_EQ(muggle_ma_ring_ctx_set_backend_num(2), 0);
+	test_wait_strategy(MUGGLE_MA_RING_WAIT_FUTEX);
+	muggle_ma_ring_ctx_set_backend_num(1);
+}
@@ -0,0 +1,91 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(mcslock, incr)
+{
+	int x = 0;
+
+	muggle_mcslock_t lock;
+	muggle_mcslock_init(&lock);
+
+	int cnt_thread = 8;
+	int incr_per_thread = 1024;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			muggle_mcslock_node_t node;
+			for (int i = 0; i < incr_per_thread; i++)
+			{
+				muggle_mcslock_lock(&lock, &node);
+				x++;
+				muggle_mcslock_unlock(&lock, &node);
+			}
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(x, cnt_thread * incr_per_thread);
+}
+
+TEST(mcslock, trylock)
+{
+	muggle_mcslock_t lock;
+	muggle_mcslock_init(&lock);
+
+	muggle_mcslock_node_t node1, node2;
+	ASSERT_TRUE(muggle_mcslock_trylock(&lock, &node1));
+	ASSERT_FALSE(muggle_mcslock_trylock(&lock, &node2));
+	muggle_mcslock_unlock(&lock, &node1);
+
+	ASSERT_TRUE(muggle_mcslock_trylock(&lock, &node2));
+	muggle_mcslock_unlock(&lock, &node2);
+}
+
+TEST(mcslock, fifo)
+{
+	muggle_mcslock_t lock;
+	muggle_mcslock_init(&lock);
+
+	muggle_mcslock_node_t owner_node;
+	muggle_mcslock_lock(&lock, &owner_node);
+
+	// waiters enqueue in order, they must get lock in the same order
+	int cnt_thread = 4;
+	std::vector<int> order;
+	std::vector<muggle_mcslock_node_t> nodes(cnt_thread);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&, i] {
+			muggle_mcslock_lock(&lock, &nodes[i]);
+			order.push_back(i);
+			muggle_mcslock_unlock(&lock, &nodes[i]);
+		}));
+
+		// wait thread enqueue
+		while (*(muggle_mcslock_node_t *volatile *)&lock.tail != &nodes[i])
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	muggle_mcslock_unlock(&lock, &owner_node);
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	ASSERT_EQ((int)order.size(), cnt_thread);
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		ASSERT_EQ(order[i], i);
+	}
+}
@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+class MirrorBytesBufferFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		bool ret = muggle_mirror_bytes_buffer_init(&bytes_buf_, 1);
+		ASSERT_TRUE(ret);
+	}
+
+	void TearDown()
+	{
+		muggle_mirror_bytes_buffer_destroy(&bytes_buf_);
+	}
+
+protected:
+	muggle_mirror_bytes_buffer_t bytes_buf_;
+};
+
+TEST_F(MirrorBytesBufferFixture, empty)
+{
+	int c = bytes_buf_.c;
+	ASSERT_GT(c, 0);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_writable(&bytes_buf_), c);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_readable(&bytes_buf_), 0);
+
+	char space[16];
+	ASSERT_FALSE(muggle_mirror_bytes_buffer_fetch(&bytes_buf_, 1, space));
+	ASSERT_FALSE(muggle_mirror_bytes_buffer_read(&bytes_buf_, 1, space));
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_reader_fc(&bytes_buf_, 1) == NULL);
+	ASSERT_FALSE(muggle_mirror_bytes_buffer_reader_move(&bytes_buf_, 1));
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_writer_fc(&bytes_buf_, c + 1) == NULL);
+	ASSERT_FALSE(muggle_mirror_bytes_buffer_writer_move(&bytes_buf_, c + 1));
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_writer_fc(&bytes_buf_, c) != NULL);
+}
+
+TEST_F(MirrorBytesBufferFixture, mirror_view)
+{
+	int c = bytes_buf_.c;
+	bytes_buf_.buffer[0] = 'a';
+	ASSERT_EQ(bytes_buf_.buffer[c], 'a');
+	bytes_buf_.buffer[c + c - 1] = 'z';
+	ASSERT_EQ(bytes_buf_.buffer[c - 1], 'z');
+}
+
+TEST_F(MirrorBytesBufferFixture, full)
+{
+	int c = bytes_buf_.c;
+	char *src = (char*)malloc(c);
+	char *dst = (char*)malloc(c);
+	for (int i = 0; i < c; i++)
+	{
+		src[i] = (char)i;
+	}
+
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_write(&bytes_buf_, c, src));
+	ASSERT_EQ(muggle_mirror_bytes_buffer_writable(&bytes_buf_), 0);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_readable(&bytes_buf_), c);
+	ASSERT_FALSE(muggle_mirror_bytes_buffer_write(&bytes_buf_, 1, src));
+
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_read(&bytes_buf_, c, dst));
+	ASSERT_EQ(memcmp(src, dst, c), 0);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_readable(&bytes_buf_), 0);
+
+	free(src);
+	free(dst);
+}
+
+TEST_F(MirrorBytesBufferFixture, wrap_contiguous)
+{
+	int c = bytes_buf_.c;
+	int half = c / 2;
+	char *src = (char*)malloc(c);
+	for (int i = 0; i < c; i++)
+	{
+		src[i] = (char)(i * 7);
+	}
+
+	// move positions near the end, so following region cross the wrap point
+	int head = c - half / 2;
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_writer_move(&bytes_buf_, head));
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_reader_move(&bytes_buf_, head));
+	ASSERT_EQ(muggle_mirror_bytes_buffer_writable(&bytes_buf_), c);
+
+	// writable region is contiguous for whole capacity
+	char *w = (char*)muggle_mirror_bytes_buffer_writer_fc(&bytes_buf_, c);
+	ASSERT_TRUE(w != NULL);
+	ASSERT_TRUE(w == bytes_buf_.buffer + head);
+	memcpy(w, src, half);
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_writer_move(&bytes_buf_, half));
+	ASSERT_EQ(bytes_buf_.w, head + half - c);
+
+	// readable region is contiguous across the wrap point
+	char *r = (char*)muggle_mirror_bytes_buffer_reader_fc(&bytes_buf_, half);
+	ASSERT_TRUE(r != NULL);
+	ASSERT_EQ(memcmp(r, src, half), 0);
+
+	char tmp[16];
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_fetch(&bytes_buf_, sizeof(tmp), tmp));
+	ASSERT_EQ(memcmp(tmp, src, sizeof(tmp)), 0);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_readable(&bytes_buf_), half);
+
+	ASSERT_TRUE(muggle_mirror_bytes_buffer_reader_move(&bytes_buf_, half));
+	ASSERT_EQ(bytes_buf_.r, bytes_buf_.w);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_readable(&bytes_buf_), 0);
+
+	muggle_mirror_bytes_buffer_clear(&bytes_buf_);
+	ASSERT_EQ(bytes_buf_.w, 0);
+	ASSERT_EQ(bytes_buf_.r, 0);
+	ASSERT_EQ(muggle_mirror_bytes_buffer_writable(&bytes_buf_), c);
+
+	free(src);
+}
+
+TEST_F(MirrorBytesBufferFixture, stream)
+{
+	int c = bytes_buf_.c;
+	char src[509];
+	char dst[509];
+
+	// odd message size, make positions wrap at every offset
+	int total = 0;
+	for (int i = 0; i < 4 * c; i += (int)sizeof(src))
+	{
+		for (int j = 0; j < (int)sizeof(src); j++)
+		{
+			src[j] = (char)(i + j);
+		}
+
+		ASSERT_TRUE(muggle_mirror_bytes_buffer_write(&bytes_buf_, sizeof(src), src));
+		ASSERT_TRUE(muggle_mirror_bytes_buffer_read(&bytes_buf_, sizeof(dst), dst));
+		ASSERT_EQ(memcmp(src, dst, sizeof(src)), 0);
+		total += (int)sizeof(src);
+	}
+	ASSERT_EQ(bytes_buf_.w, total % c);
+	ASSERT_EQ(bytes_buf_.r, total % c);
+}
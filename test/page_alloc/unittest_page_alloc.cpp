@@ -0,0 +1,182 @@
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+static void CheckMemory(void *ptr, size_t n)
+{
+	ASSERT_TRUE(ptr != NULL);
+	ASSERT_EQ((uintptr_t)ptr % MUGGLE_CACHE_LINE_SIZE, 0u);
+	memset(ptr, 0x5a, n);
+	ASSERT_EQ(((unsigned char*)ptr)[n - 1], 0x5a);
+}
+
+TEST(page_alloc, heap)
+{
+	void *p = muggle_page_alloc(NULL, 1000);
+	CheckMemory(p, 1000);
+	ASSERT_EQ(muggle_page_alloc_backing(p), 0u);
+	muggle_page_free(p);
+
+	muggle_page_alloc_attr_t attr;
+	muggle_page_alloc_attr_init(&attr);
+	p = muggle_page_alloc(&attr, 1000);
+	CheckMemory(p, 1000);
+	ASSERT_EQ(muggle_page_alloc_backing(p), 0u);
+	muggle_page_free(p);
+
+	muggle_page_free(NULL);
+}
+
+TEST(page_alloc, mapped)
+{
+	uint32_t flags[] = {
+		MUGGLE_PAGE_ALLOC_PREFAULT,
+		MUGGLE_PAGE_ALLOC_THP,
+		MUGGLE_PAGE_ALLOC_HUGETLB,
+		MUGGLE_PAGE_ALLOC_LOCK,
+		MUGGLE_PAGE_ALLOC_HUGETLB | MUGGLE_PAGE_ALLOC_LOCK | MUGGLE_PAGE_ALLOC_PREFAULT,
+	};
+	size_t sizes[] = { 1, 4096, 3 * 1024 * 1024 };
+
+	for (uint32_t f : flags)
+	{
+		for (size_t n : sizes)
+		{
+			muggle_page_alloc_attr_t attr;
+			muggle_page_alloc_attr_init(&attr);
+			attr.flags = f;
+
+			void *p = muggle_page_alloc(&attr, n);
+			CheckMemory(p, n);
+
+			// options are best effort, only those requested may take effect
+			uint32_t backing = muggle_page_alloc_backing(p);
+			ASSERT_TRUE(backing & MUGGLE_PAGE_ALLOC_MAPPED);
+			if (f & MUGGLE_PAGE_ALLOC_PREFAULT)
+			{
+				ASSERT_TRUE(backing & MUGGLE_PAGE_ALLOC_PREFAULT);
+			}
+			if (!(f & MUGGLE_PAGE_ALLOC_HUGETLB))
+			{
+				ASSERT_FALSE(backing & MUGGLE_PAGE_ALLOC_HUGETLB);
+			}
+			if (!(f & MUGGLE_PAGE_ALLOC_LOCK))
+			{
+				ASSERT_FALSE(backing & MUGGLE_PAGE_ALLOC_LOCK);
+			}
+
+			muggle_page_free(p);
+		}
+	}
+}
+
+TEST(page_alloc, numa_node)
+{
+	muggle_page_alloc_attr_t attr;
+	muggle_page_alloc_attr_init(&attr);
+	attr.numa_node = 0;
+	attr.flags = MUGGLE_PAGE_ALLOC_PREFAULT;
+
+	void *p = muggle_page_alloc(&attr, 64 * 1024);
+	CheckMemory(p, 64 * 1024);
+	ASSERT_TRUE(muggle_page_alloc_backing(p) & MUGGLE_PAGE_ALLOC_MAPPED);
+	muggle_page_free(p);
+}
+
+class TestPageAllocAttrFixture : public ::testing::Test
+{
+public:
+	void SetUp()
+	{
+		muggle_page_alloc_attr_init(&attr_);
+		attr_.flags = MUGGLE_PAGE_ALLOC_THP | MUGGLE_PAGE_ALLOC_PREFAULT;
+	}
+
+protected:
+	muggle_page_alloc_attr_t attr_;
+};
+
+TEST_F(TestPageAllocAttrFixture, channel)
+{
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init_attr(&chan, 8, 0, &attr_), 0);
+	ASSERT_TRUE(muggle_page_alloc_backing(chan.blocks) & MUGGLE_PAGE_ALLOC_PREFAULT);
+
+	for (intptr_t i = 1; i <= 4; i++)
+	{
+		ASSERT_EQ(muggle_channel_write(&chan, (void*)i), 0);
+	}
+	for (intptr_t i = 1; i <= 4; i++)
+	{
+		ASSERT_EQ(muggle_channel_read(&chan), (void*)i);
+	}
+
+	muggle_channel_destroy(&chan);
+}
+
+TEST_F(TestPageAllocAttrFixture, ring_buffer)
+{
+	muggle_ring_buffer_t r;
+	ASSERT_EQ(muggle_ring_buffer_init_attr(&r, 8, 0, &attr_), 0);
+	ASSERT_TRUE(muggle_page_alloc_backing(r.blocks) & MUGGLE_PAGE_ALLOC_PREFAULT);
+
+	for (intptr_t i = 1; i <= 4; i++)
+	{
+		ASSERT_EQ(muggle_ring_buffer_write(&r, (void*)i), 0);
+	}
+	for (intptr_t i = 1; i <= 4; i++)
+	{
+		ASSERT_EQ(muggle_ring_buffer_read(&r, (uint32_t)(i - 1)), (void*)i);
+	}
+
+	muggle_ring_buffer_destroy(&r);
+}
+
+TEST_F(TestPageAllocAttrFixture, ring_memory_pool)
+{
+	muggle_ring_memory_pool_t pool;
+	ASSERT_EQ(muggle_ring_memory_pool_init_attr(&pool, 8, 32, &attr_), 0);
+	ASSERT_TRUE(muggle_page_alloc_backing(pool.blocks) & MUGGLE_PAGE_ALLOC_PREFAULT);
+
+	void *p = muggle_ring_memory_pool_alloc(&pool);
+	ASSERT_TRUE(p != NULL);
+	memset(p, 0, 32);
+	muggle_ring_memory_pool_free(p);
+
+	muggle_ring_memory_pool_destroy(&pool);
+}
+
+TEST_F(TestPageAllocAttrFixture, ts_memory_pool)
+{
+	muggle_ts_memory_pool_t pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init_attr(&pool, 8, 32, &attr_), 0);
+	ASSERT_TRUE(muggle_page_alloc_backing(pool.data) & MUGGLE_PAGE_ALLOC_PREFAULT);
+	ASSERT_EQ(muggle_page_alloc_backing(pool.ptrs), 0u);
+
+	void *datas[7];
+	for (int i = 0; i < 7; i++)
+	{
+		datas[i] = muggle_ts_memory_pool_alloc(&pool);
+		ASSERT_TRUE(datas[i] != NULL);
+	}
+	ASSERT_TRUE(muggle_ts_memory_pool_alloc(&pool) == NULL);
+	for (int i = 0; i < 7; i++)
+	{
+		muggle_ts_memory_pool_free(datas[i]);
+	}
+
+	muggle_ts_memory_pool_destroy(&pool);
+}
+
+TEST_F(TestPageAllocAttrFixture, ma_ring)
+{
+	muggle_ma_ring_ctx_set_page_attr(&attr_);
+
+	muggle_ma_ring_t *ring = muggle_ma_ring_thread_ctx_init();
+	ASSERT_TRUE(ring != NULL);
+	ASSERT_TRUE(muggle_page_alloc_backing(ring->buffer) & MUGGLE_PAGE_ALLOC_PREFAULT);
+	muggle_ma_ring_thread_ctx_cleanup();
+
+	muggle_ma_ring_ctx_set_page_attr(NULL);
+	ASSERT_EQ(muggle_ma_ring_ctx_get()->page_attr.flags, 0u);
+}
@@ -496,3 +496,161 @@ TEST(ring_buffer, consume_all_msg_mul_producer_mul_consumer)
 		}
 	}
 }
+
+void test_try_read(int flag)
+{
+	muggle_ring_buffer_t r;
+	ASSERT_EQ(muggle_ring_buffer_init(&r, 8, flag), MUGGLE_OK);
+
+	uint32_t pos = 0;
+	ASSERT_EQ(muggle_ring_buffer_try_read(&r, pos), nullptr);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 20 * 1000 * 1000;
+	auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(muggle_ring_buffer_read_timeout(&r, pos, &timeout), nullptr);
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	ASSERT_GE(elapsed, 15);
+
+	int arr[2] = { 0, 1 };
+	muggle_ring_buffer_write(&r, &arr[0]);
+	muggle_ring_buffer_write(&r, &arr[1]);
+	ASSERT_EQ(muggle_ring_buffer_try_read(&r, pos++), &arr[0]);
+	ASSERT_EQ(muggle_ring_buffer_read_timeout(&r, pos++, &timeout), &arr[1]);
+	ASSERT_EQ(muggle_ring_buffer_try_read(&r, pos), nullptr);
+
+	std::thread writer([&]{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		muggle_ring_buffer_write(&r, &arr[0]);
+	});
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	ASSERT_EQ(muggle_ring_buffer_read_timeout(&r, pos, &timeout), &arr[0]);
+	writer.join();
+
+	muggle_ring_buffer_destroy(&r);
+}
+
+TEST(ring_buffer, try_read)
+{
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			test_try_read(w_flags[w_flag] | r_flags[r_flag]);
+		}
+	}
+}
+
+struct pipeline_entry
+{
+	uint32_t seq;
+	int decode;
+	int risk;
+	int audit;
+};
+
+void test_pipeline(int flag)
+{
+	muggle_ring_buffer_t r;
+	ASSERT_EQ(muggle_ring_buffer_init(&r, 8, flag), MUGGLE_OK);
+	uint32_t capacity = (uint32_t)r.capacity;
+
+	// decode -> (risk, audit) -> journal
+	muggle_ring_buffer_stage_t decode, risk, audit, journal;
+	ASSERT_EQ(muggle_ring_buffer_stage_init(&decode, &r, "decode", NULL, 0), MUGGLE_OK);
+
+	muggle_ring_buffer_stage_t *decode_deps[] = { &decode };
+	ASSERT_EQ(muggle_ring_buffer_stage_init(&risk, &r, "risk", decode_deps, 1), MUGGLE_OK);
+	ASSERT_EQ(muggle_ring_buffer_stage_init(&audit, &r, "audit", decode_deps, 1), MUGGLE_OK);
+
+	muggle_ring_buffer_stage_t *journal_deps[] = { &risk, &audit };
+	ASSERT_EQ(muggle_ring_buffer_stage_init(&journal, &r, "journal", journal_deps, 2), MUGGLE_OK);
+	ASSERT_EQ(muggle_ring_buffer_add_gating(&r, &journal), MUGGLE_OK);
+
+	// pre-allocated entries, reused after journal committed
+	uint32_t cnt_entry = capacity * 2;
+	std::vector<pipeline_entry> entries(cnt_entry);
+	uint32_t total = 20000;
+
+	auto run_stage = [&](muggle_ring_buffer_stage_t *stage, int which) {
+		uint32_t expect = 0;
+		while (expect < total)
+		{
+			uint32_t n = muggle_ring_buffer_stage_wait(stage);
+			for (uint32_t i = 0; i < n; i++)
+			{
+				pipeline_entry *entry =
+					(pipeline_entry*)muggle_ring_buffer_stage_get(stage, i);
+				ASSERT_EQ(entry->seq, expect);
+				switch (which)
+				{
+				case 0:
+					ASSERT_EQ(entry->decode, 0);
+					entry->decode = 1;
+					break;
+				case 1:
+					ASSERT_EQ(entry->decode, 1);
+					entry->risk = 1;
+					break;
+				case 2:
+					ASSERT_EQ(entry->decode, 1);
+					entry->audit = 1;
+					break;
+				default:
+					ASSERT_EQ(entry->risk, 1);
+					ASSERT_EQ(entry->audit, 1);
+					break;
+				}
+				expect++;
+			}
+			muggle_ring_buffer_stage_commit(stage, n);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.push_back(std::thread(run_stage, &decode, 0));
+	threads.push_back(std::thread(run_stage, &risk, 1));
+	threads.push_back(std::thread(run_stage, &audit, 2));
+	threads.push_back(std::thread(run_stage, &journal, 3));
+
+	for (uint32_t i = 0; i < total; i++)
+	{
+		pipeline_entry *entry = &entries[i % cnt_entry];
+		entry->seq = i;
+		entry->decode = 0;
+		entry->risk = 0;
+		entry->audit = 0;
+		muggle_ring_buffer_write(&r, entry);
+	}
+
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	muggle_ring_buffer_destroy(&r);
+}
+
+TEST(ring_buffer, pipeline)
+{
+	int flags[] = {
+		MUGGLE_RING_BUFFER_FLAG_SINGLE_WRITER | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+	};
+	for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+	{
+		test_pipeline(flags[i]);
+	}
+}
+
+TEST(ring_buffer, pipeline_invalid)
+{
+	muggle_ring_buffer_t r;
+	ASSERT_EQ(muggle_ring_buffer_init(&r, 8, MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE), MUGGLE_OK);
+	muggle_ring_buffer_stage_t stage;
+	ASSERT_NE(muggle_ring_buffer_stage_init(&stage, &r, "once", NULL, 0), MUGGLE_OK);
+	muggle_ring_buffer_destroy(&r);
+}
@@ -0,0 +1,94 @@
+#include <vector>
+#include <thread>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#if MUGGLE_C_HAVE_SYNC_OBJ
+
+TEST(semaphore, trywait)
+{
+	muggle_semaphore_t sem;
+	muggle_semaphore_init(&sem, 2);
+
+	EXPECT_TRUE(muggle_semaphore_trywait(&sem));
+	EXPECT_TRUE(muggle_semaphore_trywait(&sem));
+	EXPECT_FALSE(muggle_semaphore_trywait(&sem));
+
+	muggle_semaphore_post(&sem, 1);
+	EXPECT_TRUE(muggle_semaphore_trywait(&sem));
+	EXPECT_FALSE(muggle_semaphore_trywait(&sem));
+}
+
+TEST(semaphore, timedwait)
+{
+	muggle_semaphore_t sem;
+	muggle_semaphore_init(&sem, 0);
+
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = 20 * 1000000;
+
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_FALSE(muggle_semaphore_timedwait(&sem, &timeout));
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	EXPECT_GE(elapsed, 15);
+	EXPECT_EQ(sem.n_waiters, 0);
+
+	timeout.tv_sec = 5;
+	timeout.tv_nsec = 0;
+	std::thread poster([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		muggle_semaphore_post(&sem, 1);
+	});
+	EXPECT_TRUE(muggle_semaphore_timedwait(&sem, &timeout));
+	poster.join();
+
+	// NULL timeout wait infinite
+	std::thread poster2([&] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		muggle_semaphore_post(&sem, 1);
+	});
+	EXPECT_TRUE(muggle_semaphore_timedwait(&sem, NULL));
+	poster2.join();
+	EXPECT_EQ(sem.n_waiters, 0);
+}
+
+TEST(semaphore, producer_consumer)
+{
+	muggle_semaphore_t sem;
+	muggle_semaphore_init(&sem, 0);
+
+	const int cnt_consumer = 4;
+	const int cnt_per_consumer = 10000;
+	muggle_atomic_int consumed = 0;
+
+	std::vector<std::thread> consumers;
+	for (int i = 0; i < cnt_consumer; i++)
+	{
+		consumers.push_back(std::thread([&] {
+			for (int i = 0; i < cnt_per_consumer; i++)
+			{
+				muggle_semaphore_wait(&sem);
+				muggle_atomic_fetch_add(&consumed, 1, muggle_memory_order_relaxed);
+			}
+		}));
+	}
+
+	for (int i = 0; i < cnt_consumer * cnt_per_consumer; i++)
+	{
+		muggle_semaphore_post(&sem, 1);
+	}
+
+	for (auto &th : consumers)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(consumed, cnt_consumer * cnt_per_consumer);
+	EXPECT_EQ(sem.count, 0);
+	EXPECT_EQ(sem.n_waiters, 0);
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+typedef struct {
+	uint64_t a;
+	uint64_t b;
+	uint64_t c;
+	uint64_t d;
+} seqlock_snapshot_t;
+
+static void seqlock_snapshot_fill(seqlock_snapshot_t *snapshot, uint64_t v)
+{
+	snapshot->a = v;
+	snapshot->b = v * 2;
+	snapshot->c = v * 3;
+	snapshot->d = v * 4;
+}
+
+static void seqlock_snapshot_check(seqlock_snapshot_t *snapshot)
+{
+	ASSERT_EQ(snapshot->b, snapshot->a * 2);
+	ASSERT_EQ(snapshot->c, snapshot->a * 3);
+	ASSERT_EQ(snapshot->d, snapshot->a * 4);
+}
+
+TEST(seqlock, single_writer)
+{
+	muggle_seqlock_t seqlock;
+	muggle_seqlock_init(&seqlock);
+
+	seqlock_snapshot_t data;
+	seqlock_snapshot_fill(&data, 0);
+
+	const uint64_t cnt = 100000;
+	muggle_atomic_int stop = 0;
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; i++) {
+		readers.push_back(std::thread([&] {
+			uint64_t last = 0;
+			while (!muggle_atomic_load(&stop, muggle_memory_order_acquire)) {
+				seqlock_snapshot_t snapshot;
+				muggle_seqlock_read_copy(&seqlock, &snapshot, &data,
+										 sizeof(snapshot));
+				seqlock_snapshot_check(&snapshot);
+				ASSERT_GE(snapshot.a, last);
+				last = snapshot.a;
+			}
+		}));
+	}
+
+	for (uint64_t i = 1; i <= cnt; i++) {
+		muggle_seqlock_write_begin(&seqlock);
+		seqlock_snapshot_fill(&data, i);
+		muggle_seqlock_write_end(&seqlock);
+	}
+	muggle_atomic_store(&stop, 1, muggle_memory_order_release);
+
+	for (auto &th : readers) {
+		th.join();
+	}
+
+	seqlock_snapshot_t snapshot;
+	ASSERT_EQ(muggle_seqlock_read_copy(&seqlock, &snapshot, &data,
+									   sizeof(snapshot)),
+			  0);
+	ASSERT_EQ(snapshot.a, cnt);
+	seqlock_snapshot_check(&snapshot);
+}
+
+TEST(seqlock, multiple_writer)
+{
+	muggle_seqlock_t seqlock;
+	muggle_seqlock_init(&seqlock);
+
+	seqlock_snapshot_t data;
+	seqlock_snapshot_fill(&data, 0);
+
+	const int cnt_writer = 4;
+	const uint64_t cnt = 10000;
+	muggle_atomic_int stop = 0;
+
+	std::thread reader([&] {
+		while (!muggle_atomic_load(&stop, muggle_memory_order_acquire)) {
+			seqlock_snapshot_t snapshot;
+			muggle_atomic_int seq;
+			do {
+				seq = muggle_seqlock_read_begin(&seqlock);
+				snapshot = data;
+			} while (muggle_seqlock_read_retry(&seqlock, seq));
+			seqlock_snapshot_check(&snapshot);
+		}
+	});
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++) {
+		writers.push_back(std::thread([&] {
+			for (uint64_t i = 0; i < cnt; i++) {
+				muggle_seqlock_write_lock(&seqlock);
+				seqlock_snapshot_fill(&data, data.a + 1);
+				muggle_seqlock_write_unlock(&seqlock);
+			}
+		}));
+	}
+
+	for (auto &th : writers) {
+		th.join();
+	}
+	muggle_atomic_store(&stop, 1, muggle_memory_order_release);
+	reader.join();
+
+	ASSERT_EQ(data.a, cnt * cnt_writer);
+	seqlock_snapshot_check(&data);
+}
+
+TEST(seqlock, write_copy)
+{
+	muggle_seqlock_t seqlock;
+	muggle_seqlock_init(&seqlock);
+
+	seqlock_snapshot_t data, src, snapshot;
+	seqlock_snapshot_fill(&src, 5);
+	muggle_seqlock_write_copy(&seqlock, &data, &src, sizeof(data));
+	ASSERT_EQ(muggle_seqlock_read_copy(&seqlock, &snapshot, &data,
+									   sizeof(snapshot)),
+			  0);
+	ASSERT_EQ(snapshot.a, 5);
+	seqlock_snapshot_check(&snapshot);
+}
@@ -349,3 +349,441 @@ TEST_F(ShmRingBufFixture, lock)
 
 	ASSERT_EQ(total, expect_total);
 }
+
+class ShmRingBufModeFixture : public testing::Test {
+public:
+	void Open(uint32_t rb_flags)
+	{
+		k_name = "/tmp/";
+		k_num = 2;
+		uint32_t n_bytes = 1024 * MUGGLE_CACHE_LINE_SIZE;
+
+		shm_rbuf = muggle_shm_ringbuf_open(&shm, k_name, k_num,
+										   MUGGLE_SHM_FLAG_OPEN, 0);
+		if (shm_rbuf) {
+			muggle_shm_detach(&shm);
+			muggle_shm_rm(&shm);
+			shm_rbuf = NULL;
+		}
+
+		shm_rbuf = muggle_shm_ringbuf_open_ex(
+			&shm, k_name, k_num, MUGGLE_SHM_FLAG_CREAT, n_bytes, rb_flags);
+		ASSERT_TRUE(shm_rbuf != NULL);
+		ASSERT_TRUE(muggle_shm_ringbuf_is_ready(shm_rbuf));
+		ASSERT_EQ(shm_rbuf->flags, rb_flags);
+	}
+
+	virtual void SetUp() override
+	{
+		shm_rbuf = NULL;
+	}
+
+	virtual void TearDown() override
+	{
+		if (shm_rbuf) {
+			muggle_shm_detach(&shm);
+			muggle_shm_rm(&shm);
+			shm_rbuf = NULL;
+		}
+	}
+
+public:
+	const char *k_name;
+	int k_num;
+
+	muggle_shm_ringbuf_t *shm_rbuf;
+	muggle_shm_t shm;
+};
+
+TEST_F(ShmRingBufModeFixture, register)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BROADCAST);
+
+	int ids[MUGGLE_SHM_RINGBUF_MAX_READER];
+	for (int i = 0; i < MUGGLE_SHM_RINGBUF_MAX_READER; ++i) {
+		ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &ids[i]),
+				  0);
+		ASSERT_EQ(ids[i], i);
+	}
+
+	int id = -1;
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &id),
+			  MUGGLE_ERR_FULL);
+
+	muggle_shm_ringbuf_bcast_reader_unregister(shm_rbuf, ids[3]);
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &id), 0);
+	ASSERT_EQ(id, 3);
+}
+
+TEST_F(ShmRingBufModeFixture, register_not_bcast)
+{
+	Open(0);
+
+	int id = -1;
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &id),
+			  MUGGLE_ERR_INVALID_PARAM);
+}
+
+TEST_F(ShmRingBufModeFixture, slow_reader)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BROADCAST);
+
+	int fast = -1;
+	int slow = -1;
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &fast), 0);
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &slow), 0);
+
+	// writer gated on slow reader
+	uint32_t w_cnt = 0;
+	while (true) {
+		uint32_t *ptr = (uint32_t *)muggle_shm_ringbuf_bcast_w_alloc_bytes(
+			shm_rbuf, sizeof(uint32_t));
+		if (ptr == NULL) {
+			break;
+		}
+		*ptr = w_cnt++;
+		muggle_shm_ringbuf_bcast_w_move(shm_rbuf);
+
+		uint32_t n_bytes = 0;
+		ptr = (uint32_t *)muggle_shm_ringbuf_bcast_r_fetch(shm_rbuf, fast,
+														   &n_bytes);
+		ASSERT_TRUE(ptr != NULL);
+		ASSERT_EQ(n_bytes, sizeof(uint32_t));
+		ASSERT_EQ(*ptr, w_cnt - 1);
+		ASSERT_TRUE(muggle_shm_ringbuf_bcast_r_move(shm_rbuf, fast));
+	}
+	ASSERT_GT(w_cnt, 0);
+
+	muggle_sync_t lag = 0;
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_slowest_reader(shm_rbuf, &lag), slow);
+	ASSERT_GT(lag, shm_rbuf->n_cacheline - 3);
+
+	// evict slow reader, writer move on
+	muggle_shm_ringbuf_bcast_reader_evict(shm_rbuf, slow);
+	ASSERT_EQ(shm_rbuf->readers[slow].status,
+			  MUGGLE_SHM_RINGBUF_READER_EVICTED);
+	ASSERT_TRUE(muggle_shm_ringbuf_bcast_r_fetch(shm_rbuf, slow, NULL) == NULL);
+
+	void *ptr = muggle_shm_ringbuf_bcast_w_alloc_bytes(shm_rbuf,
+													   sizeof(uint32_t));
+	ASSERT_TRUE(ptr != NULL);
+	muggle_shm_ringbuf_bcast_w_move(shm_rbuf);
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_slowest_reader(shm_rbuf, NULL), fast);
+}
+
+TEST_F(ShmRingBufModeFixture, overwrite)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BROADCAST | MUGGLE_SHM_RINGBUF_FLAG_OVERWRITE);
+
+	int id = -1;
+	ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(shm_rbuf, &id), 0);
+
+	// write 3 laps of ring without read
+	uint32_t data_cacheline =
+		MUGGLE_SHM_RINGBUF_CAL_BYTES_CACHELINE(sizeof(uint32_t));
+	uint32_t n = 3 * shm_rbuf->n_cacheline / data_cacheline;
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t *ptr = (uint32_t *)muggle_shm_ringbuf_bcast_w_alloc_bytes(
+			shm_rbuf, sizeof(uint32_t));
+		ASSERT_TRUE(ptr != NULL);
+		*ptr = i;
+		muggle_shm_ringbuf_bcast_w_move(shm_rbuf);
+	}
+
+	// reader overrun, jump to oldest message and read to the end in order
+	uint32_t *ptr =
+		(uint32_t *)muggle_shm_ringbuf_bcast_r_fetch(shm_rbuf, id, NULL);
+	ASSERT_TRUE(ptr != NULL);
+	ASSERT_EQ(shm_rbuf->readers[id].n_overrun, 1);
+	uint32_t expected = *ptr;
+	ASSERT_GT(expected, 0);
+	while (ptr) {
+		ASSERT_EQ(*ptr, expected++);
+		ASSERT_TRUE(muggle_shm_ringbuf_bcast_r_move(shm_rbuf, id));
+		ptr = (uint32_t *)muggle_shm_ringbuf_bcast_r_fetch(shm_rbuf, id, NULL);
+	}
+	ASSERT_EQ(expected, n);
+
+	// data overwritten between fetch and move
+	ptr = (uint32_t *)muggle_shm_ringbuf_bcast_w_alloc_bytes(shm_rbuf,
+															  sizeof(uint32_t));
+	ASSERT_TRUE(ptr != NULL);
+	muggle_shm_ringbuf_bcast_w_move(shm_rbuf);
+	ptr = (uint32_t *)muggle_shm_ringbuf_bcast_r_fetch(shm_rbuf, id, NULL);
+	ASSERT_TRUE(ptr != NULL);
+	for (uint32_t i = 0; i < n; ++i) {
+		ASSERT_TRUE(muggle_shm_ringbuf_bcast_w_alloc_bytes(
+						shm_rbuf, sizeof(uint32_t)) != NULL);
+		muggle_shm_ringbuf_bcast_w_move(shm_rbuf);
+	}
+	ASSERT_FALSE(muggle_shm_ringbuf_bcast_r_move(shm_rbuf, id));
+	ASSERT_EQ(shm_rbuf->readers[id].n_overrun, 2);
+}
+
+TEST_F(ShmRingBufModeFixture, fan_out)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BROADCAST);
+
+	muggle_shm_ringbuf_t *rbuf = shm_rbuf;
+	const uint32_t n = 20000;
+	const int N_READER = 4;
+	std::thread *th_readers[N_READER];
+	int reader_ids[N_READER];
+	uint32_t read_cnt[N_READER];
+
+	for (int i = 0; i < N_READER; ++i) {
+		ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(rbuf,
+														   &reader_ids[i]),
+				  0);
+		read_cnt[i] = 0;
+	}
+
+	for (int i = 0; i < N_READER; ++i) {
+		th_readers[i] = new std::thread([rbuf, n, i, &reader_ids, &read_cnt] {
+			int id = reader_ids[i];
+			while (read_cnt[i] < n) {
+				uint32_t n_bytes = 0;
+				uint32_t *ptr = (uint32_t *)muggle_shm_ringbuf_bcast_r_fetch(
+					rbuf, id, &n_bytes);
+				if (ptr == NULL) {
+					muggle_thread_yield();
+					continue;
+				}
+				ASSERT_EQ(n_bytes, sizeof(uint32_t) * (1 + read_cnt[i] % 32));
+				ASSERT_EQ(*ptr, read_cnt[i]);
+				ASSERT_TRUE(muggle_shm_ringbuf_bcast_r_move(rbuf, id));
+				++read_cnt[i];
+			}
+			muggle_shm_ringbuf_bcast_reader_unregister(rbuf, id);
+		});
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t n_bytes = sizeof(uint32_t) * (1 + i % 32);
+		uint32_t *ptr = NULL;
+		while ((ptr = (uint32_t *)muggle_shm_ringbuf_bcast_w_alloc_bytes(
+					rbuf, n_bytes)) == NULL) {
+			muggle_thread_yield();
+		}
+		*ptr = i;
+		muggle_shm_ringbuf_bcast_w_move(rbuf);
+	}
+
+	for (int i = 0; i < N_READER; ++i) {
+		th_readers[i]->join();
+		delete th_readers[i];
+		ASSERT_EQ(read_cnt[i], n);
+	}
+}
+
+TEST_F(ShmRingBufModeFixture, fetch_wait_timeout)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BLOCKING);
+
+	struct timespec t1, t2;
+	struct timespec timeout = { 0, 20 * 1000 * 1000 };
+	timespec_get(&t1, TIME_UTC);
+	void *ptr = muggle_shm_ringbuf_r_fetch_wait(shm_rbuf, NULL, 16, &timeout);
+	timespec_get(&t2, TIME_UTC);
+	ASSERT_TRUE(ptr == NULL);
+
+	int64_t elapsed_ms = (int64_t)(t2.tv_sec - t1.tv_sec) * 1000 +
+						 (t2.tv_nsec - t1.tv_nsec) / 1000000;
+	ASSERT_GE(elapsed_ms, 15);
+
+	// zero timeout return immediately
+	timeout.tv_nsec = 0;
+	ptr = muggle_shm_ringbuf_r_fetch_wait(shm_rbuf, NULL, 0, &timeout);
+	ASSERT_TRUE(ptr == NULL);
+}
+
+static void test_shm_ringbuf_fetch_wait(muggle_shm_ringbuf_t *rbuf,
+										uint32_t spin_cnt)
+{
+	const uint32_t n = 2000;
+	std::thread th_reader([rbuf, n, spin_cnt] {
+		for (uint32_t i = 0; i < n; ++i) {
+			uint32_t n_bytes = 0;
+			uint32_t *ptr = (uint32_t *)muggle_shm_ringbuf_r_fetch_wait(
+				rbuf, &n_bytes, spin_cnt, NULL);
+			ASSERT_TRUE(ptr != NULL);
+			ASSERT_EQ(n_bytes, sizeof(uint32_t));
+			ASSERT_EQ(*ptr, i);
+			muggle_shm_ringbuf_r_move(rbuf);
+		}
+	});
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t *ptr = NULL;
+		while ((ptr = (uint32_t *)muggle_shm_ringbuf_w_alloc_bytes(
+					rbuf, sizeof(uint32_t))) == NULL) {
+			muggle_thread_yield();
+		}
+		*ptr = i;
+		muggle_shm_ringbuf_w_move(rbuf);
+
+		// let reader park sometimes
+		if (i % 100 == 0) {
+			muggle_msleep(1);
+		}
+	}
+
+	th_reader.join();
+}
+
+TEST_F(ShmRingBufModeFixture, fetch_wait_park)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BLOCKING);
+	test_shm_ringbuf_fetch_wait(shm_rbuf, 0);
+	ASSERT_EQ(shm_rbuf->n_waiters, 0);
+}
+
+TEST_F(ShmRingBufModeFixture, fetch_wait_spin_park)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BLOCKING);
+	test_shm_ringbuf_fetch_wait(shm_rbuf, 1024);
+	ASSERT_EQ(shm_rbuf->n_waiters, 0);
+}
+
+TEST_F(ShmRingBufModeFixture, fetch_wait_poll)
+{
+	// without blocking flag, reader poll with sleep
+	Open(0);
+	test_shm_ringbuf_fetch_wait(shm_rbuf, 16);
+}
+
+TEST_F(ShmRingBufModeFixture, bcast_fetch_wait)
+{
+	Open(MUGGLE_SHM_RINGBUF_FLAG_BROADCAST | MUGGLE_SHM_RINGBUF_FLAG_BLOCKING);
+
+	muggle_shm_ringbuf_t *rbuf = shm_rbuf;
+	const uint32_t n = 2000;
+	const int N_READER = 3;
+	std::thread *th_readers[N_READER];
+	int reader_ids[N_READER];
+
+	for (int i = 0; i < N_READER; ++i) {
+		ASSERT_EQ(muggle_shm_ringbuf_bcast_reader_register(rbuf,
+														   &reader_ids[i]),
+				  0);
+	}
+
+	for (int i = 0; i < N_READER; ++i) {
+		int id = reader_ids[i];
+		th_readers[i] = new std::thread([rbuf, n, id] {
+			for (uint32_t k = 0; k < n; ++k) {
+				uint32_t *ptr =
+					(uint32_t *)muggle_shm_ringbuf_bcast_r_fetch_wait(
+						rbuf, id, NULL, 0, NULL);
+				ASSERT_TRUE(ptr != NULL);
+				ASSERT_EQ(*ptr, k);
+				ASSERT_TRUE(muggle_shm_ringbuf_bcast_r_move(rbuf, id));
+			}
+		});
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t *ptr = NULL;
+		while ((ptr = (uint32_t *)muggle_shm_ringbuf_bcast_w_alloc_bytes(
+					rbuf, sizeof(uint32_t))) == NULL) {
+			muggle_thread_yield();
+		}
+		*ptr = i;
+		muggle_shm_ringbuf_bcast_w_move(rbuf);
+
+		if (i % 100 == 0) {
+			muggle_msleep(1);
+		}
+	}
+
+	for (int i = 0; i < N_READER; ++i) {
+		th_readers[i]->join();
+		delete th_readers[i];
+	}
+}
+
+TEST_F(ShmRingBufFixture, batch)
+{
+	muggle_shm_ringbuf_r_batch_t batch;
+
+	// staged messages invisible to reader
+	for (uint32_t i = 0; i < 8; ++i) {
+		uint32_t *ptr = (uint32_t *)muggle_shm_ringbuf_w_alloc_bytes(
+			shm_rbuf, sizeof(uint32_t));
+		ASSERT_TRUE(ptr != NULL);
+		*ptr = i;
+		muggle_shm_ringbuf_w_stage(shm_rbuf);
+	}
+	ASSERT_EQ(shm_rbuf->write_cursor, 0);
+	ASSERT_FALSE(muggle_shm_ringbuf_r_batch_begin(shm_rbuf, &batch));
+	ASSERT_TRUE(muggle_shm_ringbuf_r_batch_next(&batch, NULL) == NULL);
+
+	// publish once
+	muggle_shm_ringbuf_w_publish(shm_rbuf);
+	ASSERT_EQ(shm_rbuf->write_cursor, shm_rbuf->staged_cursor);
+
+	ASSERT_TRUE(muggle_shm_ringbuf_r_batch_begin(shm_rbuf, &batch));
+	uint32_t n_bytes = 0;
+	uint32_t *ptr = NULL;
+	uint32_t expected = 0;
+	while ((ptr = (uint32_t *)muggle_shm_ringbuf_r_batch_next(
+				&batch, &n_bytes)) != NULL) {
+		ASSERT_EQ(n_bytes, sizeof(uint32_t));
+		ASSERT_EQ(*ptr, expected++);
+	}
+	ASSERT_EQ(expected, 8);
+	ASSERT_EQ(batch.n_msg, 8);
+
+	// read cursor not move until commit
+	ASSERT_EQ(shm_rbuf->read_cursor, 0);
+	muggle_shm_ringbuf_r_batch_commit(&batch);
+	ASSERT_EQ(shm_rbuf->read_cursor, shm_rbuf->write_cursor);
+	ASSERT_FALSE(muggle_shm_ringbuf_r_batch_begin(shm_rbuf, &batch));
+}
+
+TEST_F(ShmRingBufFixture, batch_wrap)
+{
+	muggle_shm_ringbuf_t *rbuf = shm_rbuf;
+	const uint32_t n = 50000;
+	const uint32_t batch_size = 16;
+
+	std::thread th_reader([rbuf, n] {
+		uint32_t expected = 0;
+		muggle_shm_ringbuf_r_batch_t batch;
+		while (expected < n) {
+			if (!muggle_shm_ringbuf_r_batch_begin(rbuf, &batch)) {
+				muggle_thread_yield();
+				continue;
+			}
+
+			uint32_t n_bytes = 0;
+			uint32_t *ptr = NULL;
+			while ((ptr = (uint32_t *)muggle_shm_ringbuf_r_batch_next(
+						&batch, &n_bytes)) != NULL) {
+				ASSERT_EQ(n_bytes, sizeof(uint32_t) * (1 + expected % 40));
+				ASSERT_EQ(*ptr, expected);
+				++expected;
+			}
+			muggle_shm_ringbuf_r_batch_commit(&batch);
+		}
+	});
+
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t n_bytes = sizeof(uint32_t) * (1 + i % 40);
+		uint32_t *ptr = NULL;
+		while ((ptr = (uint32_t *)muggle_shm_ringbuf_w_alloc_bytes(
+					rbuf, n_bytes)) == NULL) {
+			muggle_shm_ringbuf_w_publish(rbuf);
+			muggle_thread_yield();
+		}
+		*ptr = i;
+		muggle_shm_ringbuf_w_stage(rbuf);
+
+		if ((i + 1) % batch_size == 0) {
+			muggle_shm_ringbuf_w_publish(rbuf);
+		}
+	}
+	muggle_shm_ringbuf_w_publish(rbuf);
+
+	th_reader.join();
+}
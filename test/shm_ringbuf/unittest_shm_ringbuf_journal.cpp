@@ -0,0 +1,194 @@
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+#include <thread>
+
+#define JOURNAL_PREFIX "/tmp/mugglec_unittest_journal"
+
+class ShmRingBufJournalFixture : public testing::Test {
+public:
+	virtual void SetUp() override
+	{
+		RemoveSegments();
+		n_bytes = 64 * MUGGLE_CACHE_LINE_SIZE;
+	}
+
+	virtual void TearDown() override
+	{
+		RemoveSegments();
+	}
+
+	void RemoveSegments()
+	{
+		char filepath[MUGGLE_MAX_PATH];
+		for (uint32_t seq = 0;; ++seq) {
+			snprintf(filepath, sizeof(filepath), "%s.%08u", JOURNAL_PREFIX,
+					 (unsigned int)seq);
+			if (!muggle_path_exists(filepath)) {
+				break;
+			}
+			muggle_os_remove(filepath);
+		}
+	}
+
+	void Write(muggle_shm_ringbuf_journal_t *journal, uint32_t beg,
+			   uint32_t end)
+	{
+		for (uint32_t i = beg; i < end; ++i) {
+			uint32_t *p = (uint32_t *)muggle_shm_ringbuf_journal_w_alloc_bytes(
+				journal, sizeof(uint32_t));
+			ASSERT_TRUE(p != NULL);
+			*p = i;
+			muggle_shm_ringbuf_journal_w_move(journal);
+		}
+	}
+
+	void Read(muggle_shm_ringbuf_journal_reader_t *reader, uint32_t beg,
+			  uint32_t end)
+	{
+		for (uint32_t i = beg; i < end; ++i) {
+			uint32_t n = 0;
+			uint32_t *p =
+				(uint32_t *)muggle_shm_ringbuf_journal_r_fetch(reader, &n);
+			ASSERT_TRUE(p != NULL);
+			ASSERT_EQ(n, (uint32_t)sizeof(uint32_t));
+			ASSERT_EQ(*p, i);
+			muggle_shm_ringbuf_journal_r_move(reader);
+		}
+	}
+
+public:
+	uint32_t n_bytes;
+};
+
+TEST_F(ShmRingBufJournalFixture, replay)
+{
+	muggle_shm_ringbuf_journal_t journal;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+
+	const uint32_t cnt = 100;
+	Write(&journal, 0, cnt);
+	ASSERT_GT(journal.seq, 2);
+	muggle_shm_ringbuf_journal_close(&journal);
+
+	// writer exited, replay from the first segment
+	muggle_shm_ringbuf_journal_reader_t reader;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_reader_open(&reader, JOURNAL_PREFIX,
+													 0, 0),
+			  0);
+	Read(&reader, 0, cnt);
+	ASSERT_TRUE(muggle_shm_ringbuf_journal_r_fetch(&reader, NULL) == NULL);
+	muggle_shm_ringbuf_journal_reader_close(&reader);
+}
+
+TEST_F(ShmRingBufJournalFixture, replay_from_checkpoint)
+{
+	muggle_shm_ringbuf_journal_t journal;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+
+	const uint32_t cnt = 100;
+	const uint32_t checkpoint = 37;
+	Write(&journal, 0, cnt);
+
+	uint32_t seq = 0;
+	uint32_t pos = 0;
+	muggle_shm_ringbuf_journal_reader_t reader;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_reader_open(&reader, JOURNAL_PREFIX,
+													 0, 0),
+			  0);
+	Read(&reader, 0, checkpoint);
+	muggle_shm_ringbuf_journal_reader_tell(&reader, &seq, &pos);
+	muggle_shm_ringbuf_journal_reader_close(&reader);
+	ASSERT_GT(seq, 0);
+
+	ASSERT_EQ(muggle_shm_ringbuf_journal_reader_open(&reader, JOURNAL_PREFIX,
+													 seq, pos),
+			  0);
+	Read(&reader, checkpoint, cnt);
+	ASSERT_TRUE(muggle_shm_ringbuf_journal_r_fetch(&reader, NULL) == NULL);
+	muggle_shm_ringbuf_journal_reader_close(&reader);
+
+	muggle_shm_ringbuf_journal_close(&journal);
+}
+
+TEST_F(ShmRingBufJournalFixture, writer_resume)
+{
+	muggle_shm_ringbuf_journal_t journal;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+	Write(&journal, 0, 50);
+	ASSERT_EQ(muggle_shm_ringbuf_journal_sync(&journal), 0);
+
+	// allocated but not moved message is discarded
+	ASSERT_TRUE(muggle_shm_ringbuf_journal_w_alloc_bytes(
+					&journal, sizeof(uint32_t)) != NULL);
+	uint32_t seq = journal.seq;
+	muggle_shm_ringbuf_journal_close(&journal);
+
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+	ASSERT_EQ(journal.seq, seq);
+	Write(&journal, 50, 100);
+	muggle_shm_ringbuf_journal_close(&journal);
+
+	muggle_shm_ringbuf_journal_reader_t reader;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_reader_open(&reader, JOURNAL_PREFIX,
+													 0, 0),
+			  0);
+	Read(&reader, 0, 100);
+	ASSERT_TRUE(muggle_shm_ringbuf_journal_r_fetch(&reader, NULL) == NULL);
+	muggle_shm_ringbuf_journal_reader_close(&reader);
+}
+
+TEST_F(ShmRingBufJournalFixture, live_follower)
+{
+	muggle_shm_ringbuf_journal_t journal;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+
+	const uint32_t cnt = 10000;
+
+	muggle_shm_ringbuf_journal_reader_t reader;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_reader_open(&reader, JOURNAL_PREFIX,
+													 0, 0),
+			  0);
+
+	std::thread reader_thread([&reader, cnt] {
+		uint32_t expect = 0;
+		while (expect < cnt) {
+			uint32_t *p =
+				(uint32_t *)muggle_shm_ringbuf_journal_r_fetch(&reader, NULL);
+			if (p == NULL) {
+				muggle_thread_yield();
+				continue;
+			}
+			ASSERT_EQ(*p, expect);
+			++expect;
+			muggle_shm_ringbuf_journal_r_move(&reader);
+		}
+	});
+
+	Write(&journal, 0, cnt);
+	reader_thread.join();
+
+	muggle_shm_ringbuf_journal_reader_close(&reader);
+	muggle_shm_ringbuf_journal_close(&journal);
+}
+
+TEST_F(ShmRingBufJournalFixture, too_large)
+{
+	muggle_shm_ringbuf_journal_t journal;
+	ASSERT_EQ(muggle_shm_ringbuf_journal_open(&journal, JOURNAL_PREFIX,
+											  n_bytes),
+			  0);
+	ASSERT_TRUE(muggle_shm_ringbuf_journal_w_alloc_bytes(&journal, n_bytes) ==
+				NULL);
+	ASSERT_EQ(journal.seq, 0);
+	muggle_shm_ringbuf_journal_close(&journal);
+}
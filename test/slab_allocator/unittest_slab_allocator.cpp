@@ -0,0 +1,208 @@
+#include <vector>
+#include <thread>
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(slab_allocator, classes)
+{
+	muggle_slab_allocator_t slab;
+	ASSERT_EQ(muggle_slab_allocator_init(&slab, 0, 8), 0);
+
+	muggle_slab_classes_t *classes = &slab.classes;
+	ASSERT_EQ(classes->sizes[0], 16u);
+	ASSERT_EQ(classes->sizes[3], 64u);
+	ASSERT_EQ(classes->sizes[4], 80u);
+	ASSERT_EQ(classes->sizes[7], 128u);
+	ASSERT_EQ(classes->sizes[8], 160u);
+	ASSERT_EQ(classes->sizes[classes->n_class - 1], (uint32_t)MUGGLE_SLAB_DEFAULT_MAX_SIZE);
+	for (uint32_t i = 1; i < classes->n_class; i++)
+	{
+		ASSERT_GT(classes->sizes[i], classes->sizes[i - 1]);
+	}
+
+	// every size is served by the smallest class which fit
+	for (uint32_t n = 0; n <= 4096; n++)
+	{
+		void *ptr = muggle_slab_allocator_alloc(&slab, n);
+		ASSERT_TRUE(ptr != NULL);
+		ASSERT_EQ((uintptr_t)ptr % 16, 0u);
+		memset(ptr, 0xff, n);
+
+		uint32_t idx = 0;
+		while (classes->sizes[idx] < n)
+		{
+			idx++;
+		}
+
+		muggle_slab_class_stats_t before;
+		ASSERT_TRUE(muggle_slab_allocator_get_stats(&slab, idx, &before));
+		muggle_slab_allocator_free(&slab, ptr);
+
+		muggle_slab_class_stats_t after;
+		ASSERT_TRUE(muggle_slab_allocator_get_stats(&slab, idx, &after));
+		ASSERT_EQ(after.n_free, before.n_free + 1);
+	}
+
+	muggle_slab_allocator_destroy(&slab);
+}
+
+TEST(slab_allocator, invalid_max_size)
+{
+	muggle_slab_allocator_t slab;
+	ASSERT_NE(muggle_slab_allocator_init(&slab, 8, 8), 0);
+	ASSERT_NE(muggle_slab_allocator_init(&slab, MUGGLE_SLAB_MAX_SIZE + 1, 8), 0);
+
+	ASSERT_EQ(muggle_slab_allocator_init(&slab, MUGGLE_SLAB_MAX_SIZE, 1), 0);
+	ASSERT_LE(slab.classes.n_class, (uint32_t)MUGGLE_SLAB_MAX_N_CLASS);
+	ASSERT_EQ(slab.classes.sizes[slab.classes.n_class - 1], (uint32_t)MUGGLE_SLAB_MAX_SIZE);
+	muggle_slab_allocator_destroy(&slab);
+}
+
+TEST(slab_allocator, large)
+{
+	muggle_slab_allocator_t slab;
+	ASSERT_EQ(muggle_slab_allocator_init(&slab, 1024, 8), 0);
+
+	size_t n = 1024 * 1024;
+	char *ptr = (char*)muggle_slab_allocator_alloc(&slab, n);
+	ASSERT_TRUE(ptr != NULL);
+	ASSERT_EQ((uintptr_t)ptr % 16, 0u);
+	memset(ptr, 0x5a, n);
+
+	muggle_slab_class_stats_t stats;
+	ASSERT_TRUE(muggle_slab_allocator_get_stats(&slab, slab.classes.n_class, &stats));
+	ASSERT_EQ(stats.size, 0u);
+	ASSERT_EQ(stats.n_alloc, 1u);
+	ASSERT_EQ(stats.n_free, 0u);
+
+	muggle_slab_allocator_free(&slab, ptr);
+	ASSERT_TRUE(muggle_slab_allocator_get_stats(&slab, slab.classes.n_class, &stats));
+	ASSERT_EQ(stats.n_free, 1u);
+
+	ASSERT_FALSE(muggle_slab_allocator_get_stats(&slab, slab.classes.n_class + 1, &stats));
+
+	muggle_slab_allocator_destroy(&slab);
+}
+
+TEST(slab_allocator, peak)
+{
+	muggle_slab_allocator_t slab;
+	ASSERT_EQ(muggle_slab_allocator_init(&slab, 0, 4), 0);
+
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 100; i++)
+	{
+		ptrs.push_back(muggle_slab_allocator_alloc(&slab, 100));
+		ASSERT_TRUE(ptrs.back() != NULL);
+	}
+	for (void *ptr : ptrs)
+	{
+		muggle_slab_allocator_free(&slab, ptr);
+	}
+	muggle_slab_allocator_free(&slab, NULL);
+
+	muggle_slab_class_stats_t stats;
+	ASSERT_TRUE(muggle_slab_allocator_get_stats(&slab, 6, &stats));
+	ASSERT_EQ(stats.size, 112u);
+	ASSERT_EQ(stats.n_alloc, 100u);
+	ASSERT_EQ(stats.n_free, 100u);
+	ASSERT_EQ(stats.peak, 100u);
+
+	muggle_slab_allocator_destroy(&slab);
+}
+
+TEST(ts_slab_allocator, fallback)
+{
+	muggle_ts_slab_allocator_t slab;
+	ASSERT_EQ(muggle_ts_slab_allocator_init(&slab, 0, 0, 0), 0);
+
+	// class pool capacity is 8, 7 blocks can be allocated
+	std::vector<void*> ptrs;
+	for (int i = 0; i < 16; i++)
+	{
+		void *ptr = muggle_ts_slab_allocator_alloc(&slab, 200);
+		ASSERT_TRUE(ptr != NULL);
+		ASSERT_EQ((uintptr_t)ptr % 16, 0u);
+		memset(ptr, i, 200);
+		ptrs.push_back(ptr);
+	}
+
+	void *large = muggle_ts_slab_allocator_alloc(&slab, 1024 * 1024);
+	ASSERT_TRUE(large != NULL);
+
+	for (void *ptr : ptrs)
+	{
+		muggle_ts_slab_allocator_free(&slab, ptr);
+	}
+	muggle_ts_slab_allocator_free(&slab, large);
+
+	muggle_slab_class_stats_t stats;
+	ASSERT_TRUE(muggle_ts_slab_allocator_get_stats(&slab, 10, &stats));
+	ASSERT_EQ(stats.size, 224u);
+	ASSERT_EQ(stats.n_alloc, 16u);
+	ASSERT_EQ(stats.n_free, 16u);
+	ASSERT_EQ(stats.n_fallback, 9u);
+
+	ASSERT_TRUE(muggle_ts_slab_allocator_get_stats(&slab, slab.classes.n_class, &stats));
+	ASSERT_EQ(stats.n_alloc, 1u);
+	ASSERT_EQ(stats.n_free, 1u);
+
+	muggle_ts_slab_allocator_destroy(&slab);
+}
+
+TEST(ts_slab_allocator, multi_thread)
+{
+	muggle_ts_slab_allocator_t slab;
+	ASSERT_EQ(muggle_ts_slab_allocator_init(&slab, 4096, 64 * 1024, 16), 0);
+
+	const int n_thread = 4;
+	const int n_round = 2000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < n_thread; t++)
+	{
+		threads.push_back(std::thread([&slab, t, n_round] {
+			std::vector<unsigned char*> ptrs;
+			for (int i = 0; i < n_round; i++)
+			{
+				size_t n = (size_t)((i * 37 + t * 101) % 5000) + 1;
+				unsigned char *ptr = (unsigned char*)muggle_ts_slab_allocator_alloc(&slab, n);
+				ASSERT_TRUE(ptr != NULL);
+				ptr[0] = (unsigned char)t;
+				ptr[n - 1] = (unsigned char)t;
+				ptrs.push_back(ptr);
+				if (ptrs.size() > 32)
+				{
+					for (unsigned char *p : ptrs)
+					{
+						ASSERT_EQ(p[0], (unsigned char)t);
+						muggle_ts_slab_allocator_free(&slab, p);
+					}
+					ptrs.clear();
+				}
+			}
+			for (unsigned char *p : ptrs)
+			{
+				muggle_ts_slab_allocator_free(&slab, p);
+			}
+			muggle_ts_memory_pool_thread_cache_cleanup();
+		}));
+	}
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	uint64_t n_alloc = 0, n_free = 0;
+	for (uint32_t i = 0; i <= slab.classes.n_class; i++)
+	{
+		muggle_slab_class_stats_t stats;
+		ASSERT_TRUE(muggle_ts_slab_allocator_get_stats(&slab, i, &stats));
+		n_alloc += stats.n_alloc;
+		n_free += stats.n_free;
+	}
+	ASSERT_EQ(n_alloc, (uint64_t)(n_thread * n_round));
+	ASSERT_EQ(n_free, n_alloc);
+
+	muggle_ts_slab_allocator_destroy(&slab);
+}
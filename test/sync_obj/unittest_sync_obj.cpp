@@ -81,3 +81,26 @@ TEST(sync_obj, not_support)
 }
 
 #endif
+
+#if MUGGLE_C_HAVE_SHARED_SYNC_OBJ
+
+TEST(sync_obj, shared_wait_wake)
+{
+	muggle_sync_t x = 0;
+
+	std::thread waiter([&]{
+		while (muggle_atomic_load(&x, muggle_memory_order_acquire) == 0)
+		{
+			muggle_sync_wait_shared(&x, 0, NULL);
+		}
+		EXPECT_EQ(x, 1);
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	muggle_atomic_store(&x, 1, muggle_memory_order_release);
+	muggle_sync_wake_all_shared(&x);
+
+	waiter.join();
+}
+
+#endif
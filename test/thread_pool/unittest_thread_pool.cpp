@@ -0,0 +1,153 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+typedef struct
+{
+	muggle_thread_pool_t *pool;
+	muggle_atomic_int cnt;
+	uint64_t *flags;
+} thread_pool_test_ctx_t;
+
+static void thread_pool_incr(void *args)
+{
+	thread_pool_test_ctx_t *ctx = (thread_pool_test_ctx_t*)args;
+	muggle_atomic_fetch_add(&ctx->cnt, 1, muggle_memory_order_relaxed);
+}
+
+static void thread_pool_nested(void *args)
+{
+	// submit sub-tasks in worker, and wait them in worker
+	thread_pool_test_ctx_t *ctx = (thread_pool_test_ctx_t*)args;
+	muggle_thread_pool_group_t group;
+	muggle_thread_pool_group_init(&group);
+	for (int i = 0; i < 16; i++)
+	{
+		muggle_thread_pool_submit(ctx->pool, &group, thread_pool_incr, ctx);
+	}
+	muggle_thread_pool_group_wait(ctx->pool, &group);
+}
+
+static void thread_pool_range(void *args, uint64_t begin, uint64_t end)
+{
+	thread_pool_test_ctx_t *ctx = (thread_pool_test_ctx_t*)args;
+	for (uint64_t i = begin; i < end; i++)
+	{
+		ctx->flags[i] += i;
+	}
+}
+
+class ThreadPoolFixture : public testing::TestWithParam<int>
+{
+public:
+	virtual void SetUp() override
+	{
+		ASSERT_EQ(muggle_thread_pool_init(&pool, 4, 64, GetParam()), 0);
+		ctx.pool = &pool;
+		ctx.cnt = 0;
+		ctx.flags = NULL;
+	}
+
+	virtual void TearDown() override
+	{
+		muggle_thread_pool_destroy(&pool);
+	}
+
+public:
+	muggle_thread_pool_t pool;
+	thread_pool_test_ctx_t ctx;
+};
+
+TEST_P(ThreadPoolFixture, submit)
+{
+	// larger than capacity, part of tasks run in caller
+	const int cnt = 10000;
+	muggle_thread_pool_group_t group;
+	muggle_thread_pool_group_init(&group);
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_thread_pool_submit(&pool, &group, thread_pool_incr, &ctx);
+	}
+	muggle_thread_pool_group_wait(&pool, &group);
+
+	ASSERT_EQ(ctx.cnt, cnt);
+}
+
+TEST_P(ThreadPoolFixture, nested)
+{
+	const int cnt = 256;
+	muggle_thread_pool_group_t group;
+	muggle_thread_pool_group_init(&group);
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_thread_pool_submit(&pool, &group, thread_pool_nested, &ctx);
+	}
+	muggle_thread_pool_group_wait(&pool, &group);
+
+	ASSERT_EQ(ctx.cnt, cnt * 16);
+}
+
+TEST_P(ThreadPoolFixture, multiple_submitter)
+{
+	const int cnt = 4096;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+	{
+		threads.push_back(std::thread([&] {
+			muggle_thread_pool_group_t group;
+			muggle_thread_pool_group_init(&group);
+			for (int i = 0; i < cnt; i++)
+			{
+				muggle_thread_pool_submit(&pool, &group, thread_pool_incr, &ctx);
+			}
+			muggle_thread_pool_group_wait(&pool, &group);
+		}));
+	}
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	ASSERT_EQ(ctx.cnt, cnt * 4);
+}
+
+TEST_P(ThreadPoolFixture, parallel_for)
+{
+	const uint64_t n = 100000;
+	std::vector<uint64_t> flags(n, 0);
+	ctx.flags = flags.data();
+
+	muggle_thread_pool_parallel_for(&pool, 0, n, 64, thread_pool_range, &ctx);
+	for (uint64_t i = 0; i < n; i++)
+	{
+		ASSERT_EQ(flags[i], i);
+	}
+
+	// grain 0 and empty range
+	muggle_thread_pool_parallel_for(&pool, 0, 1000, 0, thread_pool_range, &ctx);
+	muggle_thread_pool_parallel_for(&pool, 10, 10, 1, thread_pool_range, &ctx);
+	for (uint64_t i = 0; i < n; i++)
+	{
+		ASSERT_EQ(flags[i], i < 1000 ? i * 2 : i);
+	}
+}
+
+TEST_P(ThreadPoolFixture, idle)
+{
+	// workers park when idle, and wake up by new tasks
+	for (int round = 0; round < 8; round++)
+	{
+		muggle_msleep(5);
+
+		muggle_thread_pool_group_t group;
+		muggle_thread_pool_group_init(&group);
+		muggle_thread_pool_submit(&pool, &group, thread_pool_incr, &ctx);
+		muggle_thread_pool_group_wait(&pool, &group);
+	}
+	ASSERT_EQ(ctx.cnt, 8);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+	thread_pool, ThreadPoolFixture,
+	testing::Values(0, (int)MUGGLE_THREAD_POOL_FLAG_AFFINITY));
@@ -260,3 +260,91 @@ TEST(ts_memory_pool, busy_alloc_free)
 	muggle_ts_memory_pool_destroy(&pool);
 	free(datas);
 }
+
+TEST(ts_memory_pool, magazine_single_thread)
+{
+	muggle_ts_memory_pool_t pool;
+	muggle_ts_memory_pool_init(&pool, 64, sizeof(ts_data));
+	ASSERT_EQ(muggle_ts_memory_pool_set_magazine(&pool, 64), MUGGLE_ERR_INVALID_PARAM);
+	ASSERT_EQ(muggle_ts_memory_pool_set_magazine(&pool, 8), MUGGLE_OK);
+
+	// all blocks still could be allocated through magazine
+	std::vector<ts_data*> datas;
+	for (int i = 0; i < 63; i++)
+	{
+		ts_data *data = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+		ASSERT_TRUE(data != NULL);
+		data->idx = i;
+		datas.push_back(data);
+	}
+	ASSERT_TRUE(muggle_ts_memory_pool_alloc(&pool) == NULL);
+
+	// free into magazine, and alloc back from thread local LIFO
+	muggle_ts_memory_pool_free(datas.back());
+	ts_data *data = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+	ASSERT_EQ(data, datas.back());
+
+	for (auto p : datas)
+	{
+		muggle_ts_memory_pool_free(p);
+	}
+
+	// magazine keep at most 2 * magazine_size blocks, others return to pool
+	muggle_sync_t avail = MUGGLE_IDX_IN_POW_OF_2_RING(
+		pool.free_idx - pool.alloc_idx - 1, pool.capacity);
+	ASSERT_GE(avail, (muggle_sync_t)(63 - 16));
+
+	muggle_ts_memory_pool_thread_cache_cleanup();
+	avail = MUGGLE_IDX_IN_POW_OF_2_RING(
+		pool.free_idx - pool.alloc_idx - 1, pool.capacity);
+	ASSERT_EQ(avail, (muggle_sync_t)63);
+
+	muggle_ts_memory_pool_destroy(&pool);
+}
+
+TEST(ts_memory_pool, magazine_mul_thread)
+{
+	muggle_ts_memory_pool_t pool;
+	muggle_ts_memory_pool_init(&pool, 1024, sizeof(ts_data));
+	ASSERT_EQ(muggle_ts_memory_pool_set_magazine(&pool, 16), MUGGLE_OK);
+
+	const int cnt_thread = 4;
+	const int cnt_round = 2000;
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < cnt_thread; t++)
+	{
+		threads.push_back(std::thread([&pool, t, cnt_round] {
+			ts_data *local[32];
+			for (int r = 0; r < cnt_round; r++)
+			{
+				for (int i = 0; i < 32; i++)
+				{
+					do {
+						local[i] = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+					} while (local[i] == NULL);
+					local[i]->idx = i;
+					local[i]->thread_idx = t;
+				}
+				for (int i = 0; i < 32; i++)
+				{
+					ASSERT_EQ(local[i]->idx, i);
+					ASSERT_EQ(local[i]->thread_idx, t);
+					muggle_ts_memory_pool_free(local[i]);
+				}
+			}
+			muggle_ts_memory_pool_thread_cache_cleanup();
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	muggle_sync_t avail = MUGGLE_IDX_IN_POW_OF_2_RING(
+		pool.free_idx - pool.alloc_idx - 1, pool.capacity);
+	ASSERT_EQ(avail, (muggle_sync_t)1023);
+
+	muggle_ts_memory_pool_destroy(&pool);
+}
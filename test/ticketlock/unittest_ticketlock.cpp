@@ -0,0 +1,88 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(ticketlock, incr)
+{
+	int x = 0;
+
+	muggle_ticketlock_t lock;
+	muggle_ticketlock_init(&lock);
+
+	int cnt_thread = 8;
+	int incr_per_thread = 1024;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&] {
+			for (int i = 0; i < incr_per_thread; i++)
+			{
+				muggle_ticketlock_lock(&lock);
+				x++;
+				muggle_ticketlock_unlock(&lock);
+			}
+		}));
+	}
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	EXPECT_EQ(x, cnt_thread * incr_per_thread);
+}
+
+TEST(ticketlock, trylock)
+{
+	muggle_ticketlock_t lock;
+	muggle_ticketlock_init(&lock);
+
+	ASSERT_TRUE(muggle_ticketlock_trylock(&lock));
+	ASSERT_FALSE(muggle_ticketlock_trylock(&lock));
+	muggle_ticketlock_unlock(&lock);
+
+	ASSERT_TRUE(muggle_ticketlock_trylock(&lock));
+	muggle_ticketlock_unlock(&lock);
+}
+
+TEST(ticketlock, fifo)
+{
+	muggle_ticketlock_t lock;
+	muggle_ticketlock_init(&lock);
+
+	// waiters take tickets in order, they must get lock in the same order
+	muggle_ticketlock_lock(&lock);
+
+	int cnt_thread = 4;
+	std::vector<int> order;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&, i] {
+			muggle_ticketlock_lock(&lock);
+			order.push_back(i);
+			muggle_ticketlock_unlock(&lock);
+		}));
+
+		// wait thread take ticket
+		while (muggle_atomic_load(&lock.next, muggle_memory_order_relaxed) !=
+			   i + 2)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	muggle_ticketlock_unlock(&lock);
+
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	ASSERT_EQ((int)order.size(), cnt_thread);
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		ASSERT_EQ(order[i], i);
+	}
+}
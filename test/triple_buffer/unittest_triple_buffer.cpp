@@ -0,0 +1,107 @@
+#include <vector>
+#include <thread>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+typedef struct {
+	uint64_t a;
+	uint64_t b;
+	uint64_t c;
+	uint64_t d;
+} triple_buffer_state_t;
+
+static void triple_buffer_state_fill(triple_buffer_state_t *state, uint64_t v)
+{
+	state->a = v;
+	state->b = v * 2;
+	state->c = v * 3;
+	state->d = v * 4;
+}
+
+static void triple_buffer_state_check(triple_buffer_state_t *state)
+{
+	ASSERT_EQ(state->b, state->a * 2);
+	ASSERT_EQ(state->c, state->a * 3);
+	ASSERT_EQ(state->d, state->a * 4);
+}
+
+TEST(triple_buffer, latest_wins)
+{
+	muggle_triple_buffer_t tbuf;
+	ASSERT_EQ(muggle_triple_buffer_init(&tbuf, sizeof(triple_buffer_state_t)),
+			  0);
+
+	triple_buffer_state_t state;
+	ASSERT_FALSE(muggle_triple_buffer_r_has_new(&tbuf));
+	ASSERT_FALSE(muggle_triple_buffer_read(&tbuf, &state, sizeof(state)));
+	ASSERT_EQ(state.a, 0);
+
+	for (uint64_t i = 1; i <= 5; i++) {
+		triple_buffer_state_fill(&state, i);
+		muggle_triple_buffer_write(&tbuf, &state, sizeof(state));
+	}
+	ASSERT_TRUE(muggle_triple_buffer_r_has_new(&tbuf));
+
+	ASSERT_TRUE(muggle_triple_buffer_read(&tbuf, &state, sizeof(state)));
+	ASSERT_EQ(state.a, 5);
+	triple_buffer_state_check(&state);
+
+	// no new state, reader keep the latest one
+	bool updated = true;
+	triple_buffer_state_t *p = (triple_buffer_state_t *)
+		muggle_triple_buffer_r_fetch(&tbuf, &updated);
+	ASSERT_FALSE(updated);
+	ASSERT_EQ(p->a, 5);
+
+	// writer never write into buffer held by reader
+	for (uint64_t i = 6; i <= 10; i++) {
+		triple_buffer_state_t *w =
+			(triple_buffer_state_t *)muggle_triple_buffer_w_buf(&tbuf);
+		ASSERT_NE(w, p);
+		triple_buffer_state_fill(w, i);
+		muggle_triple_buffer_w_publish(&tbuf);
+	}
+	ASSERT_EQ(p->a, 5);
+
+	p = (triple_buffer_state_t *)muggle_triple_buffer_r_fetch(&tbuf, &updated);
+	ASSERT_TRUE(updated);
+	ASSERT_EQ(p->a, 10);
+
+	muggle_triple_buffer_destroy(&tbuf);
+}
+
+TEST(triple_buffer, concurrent)
+{
+	muggle_triple_buffer_t tbuf;
+	ASSERT_EQ(muggle_triple_buffer_init(&tbuf, sizeof(triple_buffer_state_t)),
+			  0);
+
+	const uint64_t cnt = 200000;
+
+	std::thread reader([&] {
+		uint64_t last = 0;
+		while (last != cnt) {
+			bool updated = false;
+			triple_buffer_state_t *state = (triple_buffer_state_t *)
+				muggle_triple_buffer_r_fetch(&tbuf, &updated);
+			triple_buffer_state_check(state);
+			if (updated) {
+				ASSERT_GT(state->a, last);
+			} else {
+				ASSERT_EQ(state->a, last);
+			}
+			last = state->a;
+		}
+	});
+
+	for (uint64_t i = 1; i <= cnt; i++) {
+		triple_buffer_state_t *state =
+			(triple_buffer_state_t *)muggle_triple_buffer_w_buf(&tbuf);
+		triple_buffer_state_fill(state, i);
+		muggle_triple_buffer_w_publish(&tbuf);
+	}
+
+	reader.join();
+
+	muggle_triple_buffer_destroy(&tbuf);
+}